@@ -0,0 +1,228 @@
+#pragma once
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+	struct Result
+	{
+		std::string name{};
+		// Per single operation (one vector, one matrix, one pixel, ...), not per call of the benchmark body
+		double nsPerOp{};
+		double opsPerSecond{};
+		// Operations done by one call of the benchmark body
+		size_t batchSize{ 1 };
+		size_t iterations{};
+	};
+
+	// Keeps the compiler from dropping a computation whose result is unused
+	template<typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		const volatile char sink{ *reinterpret_cast<const volatile char*>(&value) };
+		(void)sink;
+#endif
+	}
+
+	inline void ClobberMemory()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#endif
+	}
+
+	class Suite final
+	{
+	public:
+		Suite(std::string filter, double minSeconds) :
+			m_Filter{ std::move(filter) },
+			m_MinSeconds{ minSeconds }
+		{
+		}
+
+		// False when the name does not contain the filter, lets expensive setup be skipped
+		bool IsEnabled(const std::string& name) const
+		{
+			return m_Filter.empty() || name.find(m_Filter) != std::string::npos;
+		}
+
+		// Runs body in batches, doubling the batch until one takes at least minSeconds.
+		// Skipped when the name does not contain the filter.
+		template<typename Body>
+		void Add(const std::string& name, size_t opsPerCall, Body&& body)
+		{
+			if(!IsEnabled(name))
+				return;
+
+			using Clock = std::chrono::steady_clock;
+
+			// Warm up caches and branch predictors
+			body();
+
+			size_t iterations{ 1 };
+			double elapsed{};
+			while(true)
+			{
+				const auto start = Clock::now();
+				for(size_t i{ 0 }; i < iterations; ++i)
+				{
+					body();
+				}
+				elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+				if(elapsed >= m_MinSeconds || iterations >= (size_t{ 1 } << 40))
+					break;
+
+				iterations *= 2;
+			}
+
+			const double ops{ static_cast<double>(iterations) * static_cast<double>(opsPerCall) };
+
+			Result result{};
+			result.name = name;
+			result.nsPerOp = elapsed * 1e9 / ops;
+			result.opsPerSecond = ops / elapsed;
+			result.batchSize = opsPerCall;
+			result.iterations = iterations;
+			m_Results.push_back(result);
+
+			std::fprintf(stderr, "%-56s %10.3f ns/op %12.2f Mops/s\n", name.c_str(), result.nsPerOp, result.opsPerSecond / 1e6);
+		}
+
+		// out[i] = op(in[i]) over the whole input
+		template<typename In, typename Out, typename Op>
+		void AddMap(const std::string& name, const std::vector<In>& in, std::vector<Out>& out, Op op)
+		{
+			Add(name, in.size(), [&]
+			{
+				for(size_t i{ 0 }; i < in.size(); ++i)
+					out[i] = op(in[i]);
+				ClobberMemory();
+			});
+		}
+
+		// out[i] = op(in1[i], in2[i]) over the whole input
+		template<typename In1, typename In2, typename Out, typename Op>
+		void AddZip(const std::string& name, const std::vector<In1>& in1, const std::vector<In2>& in2, std::vector<Out>& out, Op op)
+		{
+			Add(name, in1.size(), [&]
+			{
+				for(size_t i{ 0 }; i < in1.size(); ++i)
+					out[i] = op(in1[i], in2[i]);
+				ClobberMemory();
+			});
+		}
+
+		// op(value[i]) on a fresh copy of in, for mutating members (Normalize, +=, ...)
+		template<typename T, typename Op>
+		void AddInPlace(const std::string& name, const std::vector<T>& in, std::vector<T>& scratch, Op op)
+		{
+			Add(name, in.size(), [&]
+			{
+				for(size_t i{ 0 }; i < in.size(); ++i)
+				{
+					scratch[i] = in[i];
+					op(scratch[i], i);
+				}
+				ClobberMemory();
+			});
+		}
+
+		const std::vector<Result>& GetResults() const { return m_Results; }
+
+	private:
+		std::string m_Filter;
+		double m_MinSeconds;
+		std::vector<Result> m_Results{};
+	};
+
+	// Inputs per benchmark call, small enough to stay in L1 for the scalar ops
+	constexpr size_t BATCH_SIZE{ 1024 };
+
+	inline std::vector<float> RandomFloats(size_t count, uint32_t seed, float min = -10.f, float max = 10.f)
+	{
+		std::mt19937 rng{ seed };
+		std::uniform_real_distribution<float> distribution{ min, max };
+		std::vector<float> values(count);
+		for(float& v : values)
+			v = distribution(rng);
+		return values;
+	}
+
+	// Builds count values of T from N random floats each
+	template<typename T, size_t N, typename Make>
+	std::vector<T> RandomValues(size_t count, uint32_t seed, Make make, float min = -10.f, float max = 10.f)
+	{
+		const std::vector<float> floats{ RandomFloats(count * N, seed, min, max) };
+		std::vector<T> values(count);
+		for(size_t i{ 0 }; i < count; ++i)
+			values[i] = make(&floats[i * N]);
+		return values;
+	}
+
+	// Wavy quad grid as OBJ text, every vertex has its own uv and normal. Also used by the OBJ tests.
+	inline std::string MakeGridOBJ(size_t quadsPerSide)
+	{
+		const size_t verticesPerSide{ quadsPerSide + 1 };
+		std::string text{};
+		text.reserve(verticesPerSide * verticesPerSide * 96 + quadsPerSide * quadsPerSide * 48);
+
+		char line[128]{};
+		for(size_t y{ 0 }; y < verticesPerSide; ++y)
+		{
+			for(size_t x{ 0 }; x < verticesPerSide; ++x)
+			{
+				const float u{ static_cast<float>(x) / static_cast<float>(quadsPerSide) };
+				const float v{ static_cast<float>(y) / static_cast<float>(quadsPerSide) };
+				const int length{ std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+					u * 100.f, std::sin(u * 20.f) * std::cos(v * 20.f), v * 100.f, u, v, 0.f, 1.f, 0.f) };
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+
+		for(size_t y{ 0 }; y < quadsPerSide; ++y)
+		{
+			for(size_t x{ 0 }; x < quadsPerSide; ++x)
+			{
+				const size_t i0{ y * verticesPerSide + x + 1 };
+				const size_t i1{ i0 + 1 };
+				const size_t i2{ i1 + verticesPerSide };
+				const size_t i3{ i0 + verticesPerSide };
+				const int length{ std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+					i0, i0, i0, i1, i1, i1, i2, i2, i2, i3, i3, i3) };
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+		return text;
+	}
+
+	// One per benchmark file, adds its benchmarks to the suite
+	void RunVectorBenchmarks(Suite& suite);
+	void RunMatrixBenchmarks(Suite& suite);
+	void RunColorBenchmarks(Suite& suite);
+	void RunMathHelpersBenchmarks(Suite& suite);
+	void RunObjBenchmarks(Suite& suite);
+	void RunMeshCacheBenchmarks(Suite& suite);
+	void RunTangentBenchmarks(Suite& suite);
+	void RunVertexCacheBenchmarks(Suite& suite);
+	void RunPackedVertexBenchmarks(Suite& suite);
+	void RunIndexFormatBenchmarks(Suite& suite);
+	void RunSimplifierBenchmarks(Suite& suite);
+	void RunLodBenchmarks(Suite& suite);
+	void RunMeshletBenchmarks(Suite& suite);
+	void RunFrustumBenchmarks(Suite& suite);
+	void RunOcclusionBenchmarks(Suite& suite);
+	void RunRenderQueueBenchmarks(Suite& suite);
+	void RunStateTrackingBenchmarks(Suite& suite);
+	void RunInstancingBenchmarks(Suite& suite);
+	void RunHalfBenchmarks(Suite& suite);
+}
@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	// One 1080p frame
+	constexpr size_t PIXEL_COUNT{ 1920 * 1080 };
+
+	struct Frame
+	{
+		std::vector<float> r, g, b;
+
+		explicit Frame(uint32_t seed) : r(PIXEL_COUNT), g(PIXEL_COUNT), b(PIXEL_COUNT)
+		{
+			// Some HDR values above 1 so MaxToOne and Saturate have work to do
+			std::mt19937 rng{ seed };
+			std::uniform_real_distribution<float> distribution{ 0.f, 1.5f };
+			for(size_t i{ 0 }; i < PIXEL_COUNT; ++i)
+			{
+				r[i] = distribution(rng);
+				g[i] = distribution(rng);
+				b[i] = distribution(rng);
+			}
+		}
+
+		ColorPlanes Planes() { return { r, g, b }; }
+	};
+
+	std::vector<ColorRGB> ToColors(Frame& frame)
+	{
+		std::vector<ColorRGB> colors(PIXEL_COUNT);
+		ColorRGB::FromPlanes(frame.Planes(), colors);
+		return colors;
+	}
+}
+
+namespace bench
+{
+	void RunColorBenchmarks(Suite& suite)
+	{
+		Frame frame1{ 1 };
+		Frame frame2{ 2 };
+		Frame out{ 3 };
+		std::vector<ColorRGB> colors1{ ToColors(frame1) };
+		std::vector<ColorRGB> colors2{ ToColors(frame2) };
+		std::vector<ColorRGB> colorsOut(PIXEL_COUNT);
+		std::vector<uint32_t> packed(PIXEL_COUNT);
+
+		// Scalar operators
+		const std::vector<ColorRGB> colorsA{ RandomValues<ColorRGB, 3>(BATCH_SIZE, 10, [](const float* f) { return ColorRGB{ f[0], f[1], f[2] }; }, 0.f, 2.f) };
+		const std::vector<ColorRGB> colorsB{ RandomValues<ColorRGB, 3>(BATCH_SIZE, 11, [](const float* f) { return ColorRGB{ f[0], f[1], f[2] }; }, 0.5f, 2.f) };
+		const std::vector<float> scalars{ RandomFloats(BATCH_SIZE, 12, 0.5f, 2.f) };
+		std::vector<ColorRGB> result(BATCH_SIZE);
+
+		suite.AddZip("ColorRGB/operator+", colorsA, colorsB, result, [](const ColorRGB& a, const ColorRGB& b) { return a + b; });
+		suite.AddZip("ColorRGB/operator-", colorsA, colorsB, result, [](const ColorRGB& a, const ColorRGB& b) { return a - b; });
+		suite.AddZip("ColorRGB/operator*(ColorRGB)", colorsA, colorsB, result, [](const ColorRGB& a, const ColorRGB& b) { return a * b; });
+		suite.AddZip("ColorRGB/operator*(float)", colorsA, scalars, result, [](const ColorRGB& a, float s) { return a * s; });
+		suite.AddZip("ColorRGB/operator*(float, ColorRGB)", scalars, colorsA, result, [](float s, const ColorRGB& a) { return s * a; });
+		suite.AddZip("ColorRGB/operator/(float)", colorsA, scalars, result, [](const ColorRGB& a, float s) { return a / s; });
+		suite.AddInPlace("ColorRGB/operator+=", colorsA, result, [&](ColorRGB& c, size_t i) { c += colorsB[i]; });
+		suite.AddInPlace("ColorRGB/operator-=", colorsA, result, [&](ColorRGB& c, size_t i) { c -= colorsB[i]; });
+		suite.AddInPlace("ColorRGB/operator*=(ColorRGB)", colorsA, result, [&](ColorRGB& c, size_t i) { c *= colorsB[i]; });
+		suite.AddInPlace("ColorRGB/operator/=(ColorRGB)", colorsA, result, [&](ColorRGB& c, size_t i) { c /= colorsB[i]; });
+		suite.AddInPlace("ColorRGB/operator*=(float)", colorsA, result, [&](ColorRGB& c, size_t i) { c *= scalars[i]; });
+		suite.AddInPlace("ColorRGB/operator/=(float)", colorsA, result, [&](ColorRGB& c, size_t i) { c /= scalars[i]; });
+		suite.AddInPlace("ColorRGB/MaxToOne", colorsA, result, [](ColorRGB& c, size_t) { c.MaxToOne(); });
+		suite.AddInPlace("ColorRGB/Saturate", colorsA, result, [](ColorRGB& c, size_t) { c.Saturate(); });
+		suite.AddZip("ColorRGB/Lerp", colorsA, colorsB, result, [](const ColorRGB& a, const ColorRGB& b) { return ColorRGB::Lerp(a, b, 0.25f); });
+
+		// Per pixel ColorRGB loops on a full frame, the baseline for the planar kernels
+		suite.Add("ColorRGB/Frame/Add/AoS", PIXEL_COUNT, [&]
+		{
+			for(size_t i{ 0 }; i < PIXEL_COUNT; ++i)
+				colorsOut[i] = colors1[i] + colors2[i];
+			ClobberMemory();
+		});
+		suite.Add("ColorRGB/Frame/Add/Planes", PIXEL_COUNT, [&]
+		{
+			ColorRGB::Add(frame1.Planes(), frame2.Planes(), out.Planes());
+			ClobberMemory();
+		});
+
+		suite.Add("ColorRGB/Frame/Multiply/AoS", PIXEL_COUNT, [&]
+		{
+			for(size_t i{ 0 }; i < PIXEL_COUNT; ++i)
+				colorsOut[i] = colors1[i] * colors2[i];
+			ClobberMemory();
+		});
+		suite.Add("ColorRGB/Frame/Multiply/Planes", PIXEL_COUNT, [&]
+		{
+			ColorRGB::Multiply(frame1.Planes(), frame2.Planes(), out.Planes());
+			ClobberMemory();
+		});
+
+		suite.Add("ColorRGB/Frame/Lerp/AoS", PIXEL_COUNT, [&]
+		{
+			for(size_t i{ 0 }; i < PIXEL_COUNT; ++i)
+				colorsOut[i] = ColorRGB::Lerp(colors1[i], colors2[i], 0.25f);
+			ClobberMemory();
+		});
+		suite.Add("ColorRGB/Frame/Lerp/Planes", PIXEL_COUNT, [&]
+		{
+			ColorRGB::Lerp(frame1.Planes(), frame2.Planes(), 0.25f, out.Planes());
+			ClobberMemory();
+		});
+
+		// In place kernels run on a copy so every iteration sees the same HDR input
+		suite.Add("ColorRGB/Frame/MaxToOne/AoS", PIXEL_COUNT, [&]
+		{
+			for(size_t i{ 0 }; i < PIXEL_COUNT; ++i)
+			{
+				colorsOut[i] = colors1[i];
+				colorsOut[i].MaxToOne();
+			}
+			ClobberMemory();
+		});
+		suite.Add("ColorRGB/Frame/MaxToOne/Planes", PIXEL_COUNT, [&]
+		{
+			ColorRGB::Multiply(frame1.Planes(), 1.f, out.Planes());
+			ColorRGB::MaxToOne(out.Planes());
+			ClobberMemory();
+		});
+
+		suite.Add("ColorRGB/Frame/Saturate/AoS", PIXEL_COUNT, [&]
+		{
+			for(size_t i{ 0 }; i < PIXEL_COUNT; ++i)
+			{
+				colorsOut[i] = colors1[i];
+				colorsOut[i].Saturate();
+			}
+			ClobberMemory();
+		});
+		suite.Add("ColorRGB/Frame/Saturate/Planes", PIXEL_COUNT, [&]
+		{
+			ColorRGB::Multiply(frame1.Planes(), 1.f, out.Planes());
+			ColorRGB::Saturate(out.Planes());
+			ClobberMemory();
+		});
+
+		suite.Add("ColorRGB/Frame/PackRGBA8/Linear", PIXEL_COUNT, [&]
+		{
+			ColorRGB::PackRGBA8(frame1.Planes(), packed);
+			ClobberMemory();
+		});
+		suite.Add("ColorRGB/Frame/PackRGBA8/sRGB", PIXEL_COUNT, [&]
+		{
+			ColorRGB::PackRGBA8(frame1.Planes(), packed, true);
+			ClobberMemory();
+		});
+	}
+}
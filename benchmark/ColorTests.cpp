@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "ScalarReference.h"
+
+#include <array>
+
+using namespace dae;
+
+namespace
+{
+	// Two packets and the tail of the 4 wide kernels
+	constexpr size_t MAX_COUNT{ 9 };
+	constexpr float SENTINEL{ 12345.f };
+
+	// r, g and b planes of count colors, with a sentinel after the last one that no kernel may write
+	struct Colors
+	{
+		std::array<std::vector<float>, 3> planes{};
+
+		Colors(size_t count, uint32_t seed)
+		{
+			// Negative and above 1, so Saturate and MaxToOne have both sides to clamp
+			const std::vector<float> floats{ bench::RandomFloats(count * 3, seed, -0.5f, 1.5f) };
+			for(size_t c{ 0 }; c < 3; ++c)
+			{
+				planes[c].assign(floats.begin() + c * count, floats.begin() + (c + 1) * count);
+				planes[c].push_back(SENTINEL);
+			}
+		}
+
+		size_t GetCount() const
+		{
+			return planes[0].size() - 1;
+		}
+
+		ColorPlanes Get()
+		{
+			return { { planes[0].data(), GetCount() }, { planes[1].data(), GetCount() }, { planes[2].data(), GetCount() } };
+		}
+
+		std::array<float*, 3> GetPointers()
+		{
+			return { planes[0].data(), planes[1].data(), planes[2].data() };
+		}
+
+		bool HasSentinel() const
+		{
+			return planes[0].back() == SENTINEL && planes[1].back() == SENTINEL && planes[2].back() == SENTINEL;
+		}
+
+		// Bit for bit, the sentinels included
+		bool operator==(const Colors& other) const
+		{
+			return planes == other.planes;
+		}
+	};
+
+	// With SIMD and in the DAE_COLOR_NO_SIMD build, bit for bit
+	void CheckPack(test::Suite& suite, Colors& colors, bool sRGB)
+	{
+		const size_t count{ colors.GetCount() };
+		std::vector<uint32_t> simd(count + 1, 0xDEADBEEF);
+		std::vector<uint32_t> reference(count + 1, 0xDEADBEEF);
+		ColorRGB::PackRGBA8(colors.Get(), { simd.data(), count }, sRGB);
+		scalar::ColorPackRGBA8(colors.GetPointers().data(), count, reference.data(), sRGB);
+		DAE_CHECK(suite, simd == reference);
+		DAE_CHECK(suite, simd[count] == 0xDEADBEEF);
+	}
+
+	uint32_t Gray(uint32_t value)
+	{
+		return value | (value << 8) | (value << 16) | 0xFF000000;
+	}
+}
+
+namespace test
+{
+	void RunColorTests(Suite& suite)
+	{
+		suite.Add("Color/SIMD/Arithmetic", [&]
+		{
+			for(size_t count{ 0 }; count <= MAX_COUNT; ++count)
+			{
+				Colors a{ count, static_cast<uint32_t>(count) };
+				Colors b{ count, static_cast<uint32_t>(count) + 100 };
+				const auto pA{ a.GetPointers() };
+				const auto pB{ b.GetPointers() };
+				const auto check = [&](const auto& simdOp, const auto& scalarOp)
+				{
+					Colors simd{ count, 0 };
+					Colors reference{ count, 0 };
+					simdOp(simd.Get());
+					scalarOp(reference.GetPointers().data());
+					DAE_CHECK(suite, simd == reference && simd.HasSentinel());
+				};
+
+				check([&](ColorPlanes out) { ColorRGB::Add(a.Get(), b.Get(), out); },
+					[&](float* const* ppOut) { scalar::ColorAdd(pA.data(), pB.data(), count, ppOut); });
+				check([&](ColorPlanes out) { ColorRGB::Multiply(a.Get(), b.Get(), out); },
+					[&](float* const* ppOut) { scalar::ColorMultiply(pA.data(), pB.data(), count, ppOut); });
+				check([&](ColorPlanes out) { ColorRGB::Multiply(a.Get(), 1.7f, out); },
+					[&](float* const* ppOut) { scalar::ColorMultiply(pA.data(), 1.7f, count, ppOut); });
+				check([&](ColorPlanes out) { ColorRGB::Lerp(a.Get(), b.Get(), 0.3f, out); },
+					[&](float* const* ppOut) { scalar::ColorLerp(pA.data(), pB.data(), 0.3f, count, ppOut); });
+
+				// Out aliasing an input
+				Colors simd{ a };
+				Colors reference{ a };
+				ColorRGB::Add(simd.Get(), b.Get(), simd.Get());
+				const auto pReference{ reference.GetPointers() };
+				scalar::ColorAdd(pReference.data(), pB.data(), count, pReference.data());
+				DAE_CHECK(suite, simd == reference && simd.HasSentinel());
+			}
+		});
+
+		suite.Add("Color/SIMD/MaxToOneAndSaturate", [&]
+		{
+			for(size_t count{ 0 }; count <= MAX_COUNT; ++count)
+			{
+				const Colors colors{ count, static_cast<uint32_t>(count) + 200 };
+				for(const bool isMaxToOne : { true, false })
+				{
+					Colors simd{ colors };
+					Colors reference{ colors };
+					if(isMaxToOne)
+					{
+						ColorRGB::MaxToOne(simd.Get());
+						scalar::ColorMaxToOne(reference.GetPointers().data(), count);
+					}
+					else
+					{
+						ColorRGB::Saturate(simd.Get());
+						scalar::ColorSaturate(reference.GetPointers().data(), count);
+					}
+					DAE_CHECK(suite, simd == reference && simd.HasSentinel());
+
+					for(size_t c{ 0 }; c < 3; ++c)
+					{
+						for(size_t i{ 0 }; i < count; ++i)
+							DAE_CHECK(suite, simd.planes[c][i] <= 1.f);
+					}
+				}
+			}
+		});
+
+		suite.Add("Color/SIMD/PackRGBA8", [&]
+		{
+			for(size_t count{ 0 }; count <= MAX_COUNT; ++count)
+			{
+				Colors colors{ count, static_cast<uint32_t>(count) + 300 };
+				for(const bool sRGB : { false, true })
+					CheckPack(suite, colors, sRGB);
+			}
+		});
+
+		// NaN, negative and above 1, in every SIMD lane and in the scalar tail
+		suite.Add("Color/PackRGBA8/OutOfRange", [&]
+		{
+			const std::array<float, MAX_COUNT> values{ NAN, -1.f, -0.f, 2.f, INFINITY, -INFINITY, 1.f, 0.f, 1e30f };
+			const std::array<uint32_t, MAX_COUNT> expected{ 0, 0, 0, 255, 255, 0, 255, 0, 255 };
+			for(size_t shift{ 0 }; shift < MAX_COUNT; ++shift)
+			{
+				Colors colors{ MAX_COUNT, 0 };
+				for(size_t c{ 0 }; c < 3; ++c)
+				{
+					for(size_t i{ 0 }; i < MAX_COUNT; ++i)
+						colors.planes[c][(i + shift + c) % MAX_COUNT] = values[i];
+				}
+
+				for(const bool sRGB : { false, true })
+				{
+					CheckPack(suite, colors, sRGB);
+					std::vector<uint32_t> packed(MAX_COUNT);
+					ColorRGB::PackRGBA8(colors.Get(), packed, sRGB);
+					for(size_t i{ 0 }; i < MAX_COUNT; ++i)
+					{
+						const uint32_t channels{ expected[i] | (expected[(i + MAX_COUNT - 1) % MAX_COUNT] << 8) | (expected[(i + MAX_COUNT - 2) % MAX_COUNT] << 16) };
+						DAE_CHECK(suite, packed[(i + shift) % MAX_COUNT] == (channels | 0xFF000000));
+					}
+				}
+
+				// Saturate takes NaN to 0 on both paths as well
+				Colors simd{ colors };
+				Colors reference{ colors };
+				ColorRGB::Saturate(simd.Get());
+				scalar::ColorSaturate(reference.GetPointers().data(), MAX_COUNT);
+				DAE_CHECK(suite, simd == reference);
+				DAE_CHECK(suite, simd.planes[0][shift] == 0.f);
+			}
+
+			// In range values land on the right codes, sRGB 0.5 is 188
+			Colors colors{ 2, 0 };
+			for(size_t c{ 0 }; c < 3; ++c)
+				colors.planes[c] = { 0.5f, 0.2f, SENTINEL };
+			std::vector<uint32_t> packed(2);
+			ColorRGB::PackRGBA8(colors.Get(), packed);
+			DAE_CHECK(suite, packed[0] == Gray(128) && packed[1] == Gray(51));
+			ColorRGB::PackRGBA8(colors.Get(), packed, true);
+			DAE_CHECK(suite, packed[0] == Gray(188) && packed[1] == Gray(124));
+		});
+
+		suite.Add("Color/Planes/RoundTrip", [&]
+		{
+			Colors colors{ MAX_COUNT, 400 };
+			std::vector<ColorRGB> interleaved(MAX_COUNT);
+			ColorRGB::FromPlanes(colors.Get(), interleaved);
+			DAE_CHECK(suite, interleaved[3].g == colors.planes[1][3]);
+
+			Colors back{ MAX_COUNT, 401 };
+			ColorRGB::ToPlanes(interleaved, back.Get());
+			DAE_CHECK(suite, back == colors);
+		});
+	}
+}
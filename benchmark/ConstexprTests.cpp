@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "Test.h"
+
+using namespace dae;
+
+// The math library is constexpr, make sure the common transforms really fold at compile time.
+// Nothing here runs, this file failing to compile is the failure.
+namespace
+{
+	static_assert(Vector3::Dot(Vector3::UnitX, Vector3::UnitY) == 0.f);
+	static_assert(Vector3::Cross(Vector3::UnitX, Vector3::UnitY).z == 1.f);
+	static_assert((Vector3{ 1, 2, 3 } + Vector3{ 1, 1, 1 } * 2.f).z == 5.f);
+	static_assert(Vector4{ Vector3{ 1, 2, 3 }, 1 }.GetXYZ().y == 2.f);
+	static_assert(Vector2::Cross(Vector2::UnitX, Vector2::UnitY) == 1.f);
+
+	static_assert(AreEqual(ConstexprSin(PI_DIV_2), 1.f, 1e-6f));
+	static_assert(AreEqual(ConstexprCos(PI), -1.f, 1e-6f));
+	static_assert(AreEqual(ConstexprSin(-7.f * PI_DIV_4), 0.70710678f, 1e-6f));
+
+	static_assert(Matrix::CreateTranslation(1, 2, 3).TransformPoint(Vector3::Zero).z == 3.f);
+	static_assert(Matrix::CreateScale(2, 2, 2).TransformVector(Vector3::UnitY).y == 2.f);
+	static_assert(AreEqual(Matrix::CreateRotationY(PI_DIV_2).TransformVector(Vector3::UnitX).z, -1.f, 1e-6f));
+	static_assert(AreEqual((Matrix::CreateRotationZ(0.3f) * Matrix::CreateRotationZ(-0.3f))[0][0], 1.f, 1e-6f));
+	static_assert(AreEqual(Matrix::Inverse(Matrix::CreateTranslation(1, 2, 3))[3][1], -2.f, 1e-6f));
+	static_assert(Matrix::Transpose(Matrix::CreateTranslation(1, 2, 3))[1][3] == 2.f);
+	static_assert(Matrix::CreatePerspectiveFovLH(1.f, 1.f, 0.1f, 100.f)[2][3] == 1.f);
+
+	// Folded at compile time through the scalar paths and the constexpr series
+	constexpr Matrix FOLDED_ROTATION{ Matrix::CreateRotation(0.3f, -1.2f, 2.5f) * Matrix::CreateTranslation(1, 2, 3) };
+	constexpr Matrix FOLDED_INVERSE{ Matrix::Inverse(FOLDED_ROTATION) };
+	constexpr Vector3 FOLDED_POINT{ FOLDED_ROTATION.TransformPoint(Vector3{ 4, -5, 6 }) };
+}
+
+namespace test
+{
+	void RunConstexprTests(Suite& suite)
+	{
+		// The same expressions at runtime go through std::sin / std::cos and the SIMD paths, the results have to agree
+		suite.Add("Constexpr/MatchesRuntime", [&]
+		{
+			volatile float pitch{ 0.3f };
+			const Matrix rotation{ Matrix::CreateRotation(pitch, -1.2f, 2.5f) * Matrix::CreateTranslation(1, 2, 3) };
+			const Matrix inverse{ Matrix::Inverse(rotation) };
+			const Vector3 point{ rotation.TransformPoint(Vector3{ 4, -5, 6 }) };
+
+			for(int r{ 0 }; r < 4; ++r)
+			{
+				for(int c{ 0 }; c < 4; ++c)
+				{
+					DAE_CHECK(suite, AreEqual(rotation[r][c], FOLDED_ROTATION[r][c], 1e-5f));
+					DAE_CHECK(suite, AreEqual(inverse[r][c], FOLDED_INVERSE[r][c], 1e-5f));
+				}
+			}
+			DAE_CHECK(suite, AreEqual(point.x, FOLDED_POINT.x, 1e-5f));
+			DAE_CHECK(suite, AreEqual(point.y, FOLDED_POINT.y, 1e-5f));
+			DAE_CHECK(suite, AreEqual(point.z, FOLDED_POINT.z, 1e-5f));
+		});
+	}
+}
@@ -0,0 +1,71 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "Frustum.h"
+#include "RigidTransform.h"
+
+using namespace dae;
+
+namespace
+{
+	// Objects scattered through a box around the camera, about one in twenty ends up in the frustum
+	BoundsSoA MakeBounds(size_t count)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 8, 21, -1.f, 1.f) };
+		const Vector3 boundsMin{ -1.f, -0.5f, -2.f };
+		const Vector3 boundsMax{ 1.f, 0.5f, 2.f };
+		const float boundsRadius{ (boundsMax - boundsMin).Magnitude() * 0.5f };
+
+		BoundsSoA bounds{};
+		bounds.Resize(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 8] };
+			const Quaternion rotation{ Quaternion::CreateFromAxisAngle(Vector3{ pRandom[0], pRandom[1], pRandom[2] }.Normalized(), pRandom[3] * PI) };
+			const float scale{ 1.5f + pRandom[4] };
+			const Affine3x4 worldTransform{ rotation.Rotate(Vector3::UnitX) * scale, rotation.Rotate(Vector3::UnitY) * scale,
+				rotation.Rotate(Vector3::UnitZ) * scale, Vector3{ pRandom[5], pRandom[6], pRandom[7] } * 100.f };
+			bounds.Set(i, worldTransform, boundsMin, boundsMax, boundsRadius);
+		}
+		return bounds;
+	}
+}
+
+namespace bench
+{
+	void RunFrustumBenchmarks(Suite& suite)
+	{
+		const std::string cullName{ "Frustum/100k/CullBounds" };
+		const std::string scalarName{ "Frustum/100k/Scalar" };
+		if(!suite.IsEnabled(cullName) && !suite.IsEnabled(scalarName))
+			return;
+
+		// Renderer camera: 45 degrees, 640x480, near 0.1, far 100, at the origin looking down +z
+		const Matrix viewProjection{ RigidTransform{}.Inverse().ToMatrix()
+			* Matrix::CreatePerspectiveFovLH(std::tan(22.5f * TO_RADIANS), 640.f / 480.f, 0.1f, 100.f) };
+		const Frustum frustum{ Frustum::FromViewProjection(viewProjection) };
+
+		constexpr size_t count{ 100000 };
+		const BoundsSoA bounds{ MakeBounds(count) };
+		std::vector<uint8_t> visible(count);
+		std::vector<uint8_t> scalarVisible(count);
+
+		// The match with the scalar test is checked in FrustumTests.cpp
+		const CullStats stats{ Utils::CullBounds(frustum, bounds, visible) };
+		std::fprintf(stderr, "Frustum: %zu of %zu objects culled\n", stats.culled, stats.tested);
+
+		suite.Add(cullName, count, [&]
+		{
+			bench::DoNotOptimize(Utils::CullBounds(frustum, bounds, visible).culled);
+		});
+		suite.Add(scalarName, count, [&]
+		{
+			for(size_t i{ 0 }; i < count; ++i)
+			{
+				scalarVisible[i] = static_cast<uint8_t>(frustum.IsVisible({ bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i] },
+					{ bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i] }, bounds.radius[i]));
+			}
+			bench::DoNotOptimize(scalarVisible.data());
+		});
+	}
+}
@@ -0,0 +1,178 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "Frustum.h"
+#include "RigidTransform.h"
+#include "ScalarReference.h"
+
+using namespace dae;
+
+namespace
+{
+	constexpr float PLANE_EPSILON{ 1e-5f };
+
+	// 90 degrees, square, near 1, far 10: every side plane is at 45 degrees
+	Matrix GetProjection()
+	{
+		return Matrix::CreatePerspectiveFovLH(1.f, 1.f, 1.f, 10.f);
+	}
+
+	bool IsPlane(const Vector4& plane, const Vector4& expected)
+	{
+		return AreEqual(plane.x, expected.x, PLANE_EPSILON) && AreEqual(plane.y, expected.y, PLANE_EPSILON)
+			&& AreEqual(plane.z, expected.z, PLANE_EPSILON) && AreEqual(plane.w, expected.w, 1e-4f);
+	}
+
+	// Boxes of about the frustum's size scattered around it, so a good share crosses one of the planes
+	BoundsSoA MakeBounds(size_t count, uint32_t seed)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 8, seed, -1.f, 1.f) };
+		BoundsSoA bounds{};
+		bounds.Resize(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 8] };
+			const Quaternion rotation{ Quaternion::CreateFromAxisAngle(Vector3{ pRandom[0], pRandom[1], pRandom[2] }.Normalized(), pRandom[3] * PI) };
+			const float scale{ 1.1f + pRandom[4] };
+			const Affine3x4 worldTransform{ rotation.Rotate(Vector3::UnitX) * scale, rotation.Rotate(Vector3::UnitY) * scale,
+				rotation.Rotate(Vector3::UnitZ) * scale, Vector3{ pRandom[5] * 12.f, pRandom[6] * 12.f, 5.f + pRandom[7] * 8.f } };
+			bounds.Set(i, worldTransform, { -1.f, -0.5f, -2.f }, { 1.f, 0.5f, 2.f }, 2.3f);
+		}
+		return bounds;
+	}
+
+	// The first count objects
+	BoundsSoA GetFirst(const BoundsSoA& bounds, size_t count)
+	{
+		BoundsSoA first{ bounds };
+		first.Resize(count);
+		return first;
+	}
+
+	std::vector<uint8_t> GetIsVisible(const Frustum& frustum, const BoundsSoA& bounds)
+	{
+		std::vector<uint8_t> visible(bounds.GetCount());
+		for(size_t i{ 0 }; i < bounds.GetCount(); ++i)
+		{
+			visible[i] = static_cast<uint8_t>(frustum.IsVisible({ bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i] },
+				{ bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i] }, bounds.radius[i]));
+		}
+		return visible;
+	}
+}
+
+namespace test
+{
+	void RunFrustumTests(Suite& suite)
+	{
+		suite.Add("Frustum/FromViewProjection/Planes", [&]
+		{
+			const float side{ 1.f / std::sqrt(2.f) };
+			const Frustum frustum{ Frustum::FromViewProjection(GetProjection()) };
+			DAE_CHECK(suite, IsPlane(frustum.planes[0], { side, 0.f, side, 0.f }));
+			DAE_CHECK(suite, IsPlane(frustum.planes[1], { -side, 0.f, side, 0.f }));
+			DAE_CHECK(suite, IsPlane(frustum.planes[2], { 0.f, side, side, 0.f }));
+			DAE_CHECK(suite, IsPlane(frustum.planes[3], { 0.f, -side, side, 0.f }));
+			DAE_CHECK(suite, IsPlane(frustum.planes[4], { 0.f, 0.f, 1.f, -1.f }));
+			DAE_CHECK(suite, IsPlane(frustum.planes[5], { 0.f, 0.f, -1.f, 10.f }));
+
+			// With a world matrix in front the planes are in object space: the object sits 5 further along z
+			const Frustum moved{ Frustum::FromViewProjection(Matrix::CreateTranslation(0.f, 0.f, 5.f) * GetProjection()) };
+			DAE_CHECK(suite, IsPlane(moved.planes[0], { side, 0.f, side, 5.f * side }));
+			DAE_CHECK(suite, IsPlane(moved.planes[4], { 0.f, 0.f, 1.f, 4.f }));
+			DAE_CHECK(suite, IsPlane(moved.planes[5], { 0.f, 0.f, -1.f, 5.f }));
+		});
+
+		// Inside every plane exactly when the clip space point is inside the D3D clip volume
+		suite.Add("Frustum/FromViewProjection/MatchesClipSpace", [&]
+		{
+			const Vector3 origin{ 3.f, -2.f, -4.f };
+			const Vector3 forward{ Vector3{ -0.3f, 0.2f, 1.f }.Normalized() };
+			const Vector3 right{ Vector3::Cross(Vector3::UnitY, forward).Normalized() };
+			const Matrix viewProjection{ RigidTransform::CreateLookAtLH(origin, forward, Vector3::Cross(forward, right)).Inverse().ToMatrix()
+				* Matrix::CreatePerspectiveFovLH(std::tan(22.5f * TO_RADIANS), 640.f / 480.f, 0.1f, 100.f) };
+			const Frustum frustum{ Frustum::FromViewProjection(viewProjection) };
+
+			const std::vector<float> floats{ bench::RandomFloats(3 * 20000, 37, -60.f, 60.f) };
+			size_t inside{ 0 };
+			for(size_t i{ 0 }; i < floats.size(); i += 3)
+			{
+				const Vector3 point{ origin + Vector3{ floats[i], floats[i + 1], floats[i + 2] } + forward * 50.f };
+				const Vector4 clip{ viewProjection.TransformPoint(Vector4{ point, 1.f }) };
+				float minDistance{ FLT_MAX };
+				for(const Vector4& plane : frustum.planes)
+					minDistance = std::min(minDistance, plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w);
+				// Points right on a plane can go either way
+				if(std::abs(minDistance) < 1e-3f)
+					continue;
+
+				const bool isClipInside{ std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && clip.z >= 0.f && clip.z <= clip.w };
+				DAE_CHECK(suite, isClipInside == (minDistance > 0.f));
+				inside += isClipInside;
+			}
+			DAE_CHECK(suite, inside > 1000 && inside < 19000);
+		});
+
+		// Visible, outside a side, behind the camera, crossing the far plane and past it
+		suite.Add("Frustum/CullBounds/Counters", [&]
+		{
+			const Frustum frustum{ Frustum::FromViewProjection(GetProjection()) };
+			const Vector3 centers[]{ { 0.f, 0.f, 5.f }, { 100.f, 0.f, 5.f }, { 0.f, 0.f, -5.f }, { 0.f, 0.f, 10.5f }, { 0.f, 0.f, 12.f } };
+			const uint8_t expected[]{ 1, 0, 0, 1, 0 };
+			BoundsSoA bounds{};
+			bounds.Resize(std::size(centers));
+			for(size_t i{ 0 }; i < std::size(centers); ++i)
+				bounds.Set(i, Affine3x4{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, centers[i] }, -Vector3{ 1.f, 1.f, 1.f }, { 1.f, 1.f, 1.f }, std::sqrt(3.f));
+
+			std::vector<uint8_t> visible(bounds.GetCount());
+			const CullStats stats{ Utils::CullBounds(frustum, bounds, visible) };
+			DAE_CHECK(suite, stats.tested == 5 && stats.culled == 3);
+			DAE_CHECK(suite, std::equal(visible.begin(), visible.end(), std::begin(expected)));
+
+			const BoundsSoA many{ MakeBounds(1000, 5) };
+			visible.resize(many.GetCount());
+			const CullStats manyStats{ Utils::CullBounds(frustum, many, visible) };
+			DAE_CHECK(suite, manyStats.tested == 1000);
+			DAE_CHECK(suite, manyStats.culled == static_cast<size_t>(std::count(visible.begin(), visible.end(), uint8_t{ 0 })));
+			DAE_CHECK(suite, manyStats.culled > 100 && manyStats.culled < 900);
+		});
+
+		// Bit for bit, against the DAE_FRUSTUM_NO_SIMD build. Without SSE both sides are the scalar code.
+		suite.Add("Frustum/CullBounds/MatchesScalar", [&]
+		{
+			const Frustum frustum{ Frustum::FromViewProjection(Matrix::CreateRotationY(0.4f) * GetProjection()) };
+			const BoundsSoA bounds{ MakeBounds(10007, 11) };
+			std::vector<uint8_t> visible(bounds.GetCount());
+			std::vector<uint8_t> scalarVisible(bounds.GetCount());
+			const CullStats stats{ Utils::CullBounds(frustum, bounds, visible) };
+
+			const float* arrays[]{ bounds.centerX.data(), bounds.centerY.data(), bounds.centerZ.data(), bounds.extentX.data(), bounds.extentY.data(),
+				bounds.extentZ.data(), bounds.radius.data() };
+			const size_t scalarCulled{ scalar::CullBounds(&frustum.planes[0].x, arrays, bounds.GetCount(), scalarVisible.data()) };
+			DAE_CHECK(suite, visible == scalarVisible);
+			DAE_CHECK(suite, stats.culled == scalarCulled);
+			DAE_CHECK(suite, visible == GetIsVisible(frustum, bounds));
+		});
+
+		// Every count around the 4 and 8 wide packets, nothing past the end may be written
+		suite.Add("Frustum/CullBounds/Tails", [&]
+		{
+			constexpr uint8_t SENTINEL{ 0xAB };
+			const Frustum frustum{ Frustum::FromViewProjection(GetProjection()) };
+			const BoundsSoA all{ MakeBounds(17, 23) };
+			for(size_t count{ 0 }; count <= all.GetCount(); ++count)
+			{
+				const BoundsSoA bounds{ GetFirst(all, count) };
+				std::vector<uint8_t> visible(count + 1, SENTINEL);
+				const CullStats stats{ Utils::CullBounds(frustum, bounds, visible) };
+				const std::vector<uint8_t> expected{ GetIsVisible(frustum, bounds) };
+
+				DAE_CHECK(suite, std::equal(expected.begin(), expected.end(), visible.begin()));
+				DAE_CHECK(suite, visible[count] == SENTINEL);
+				DAE_CHECK(suite, stats.tested == count);
+				DAE_CHECK(suite, stats.culled == static_cast<size_t>(std::count(expected.begin(), expected.end(), uint8_t{ 0 })));
+			}
+		});
+	}
+}
@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+using namespace dae;
+
+namespace bench
+{
+	void RunHalfBenchmarks(Suite& suite)
+	{
+		// Vertex attribute sized values, normals, uvs and positions in a few hundred units
+		const std::vector<float> floats{ RandomFloats(BATCH_SIZE, 80, -300.f, 300.f) };
+		std::vector<Half> halves(BATCH_SIZE);
+		Half::Convert(floats, halves);
+		std::vector<Half> halvesOut(BATCH_SIZE);
+		std::vector<float> floatsOut(BATCH_SIZE);
+
+		// One value at a time through the constexpr scalar conversions
+		suite.AddMap("Half/Half(float)", floats, halvesOut, [](float f) { return Half{ f }; });
+		suite.AddMap("Half/ToFloat", halves, floatsOut, [](Half h) { return h.ToFloat(); });
+
+		// The bulk conversions, F16C when the build has it
+		suite.Add("Half/Convert(float to half)", BATCH_SIZE, [&]
+		{
+			Half::Convert(floats, halvesOut);
+			ClobberMemory();
+		});
+		suite.Add("Half/Convert(half to float)", BATCH_SIZE, [&]
+		{
+			Half::Convert(halves, floatsOut);
+			ClobberMemory();
+		});
+
+		// Odd length, so the 4 wide block and the scalar tail are part of the cost
+		const size_t oddCount{ BATCH_SIZE - 3 };
+		suite.Add("Half/Convert(float to half, odd length)", oddCount, [&]
+		{
+			Half::Convert(std::span{ floats }.first(oddCount), halvesOut);
+			ClobberMemory();
+		});
+	}
+}
@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "ScalarReference.h"
+
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	constexpr uint16_t QUIET_BIT{ 0x0200 };
+	constexpr size_t PATTERN_COUNT{ 65536 };
+
+	bool IsHalfNaN(uint16_t bits)
+	{
+		return (bits & 0x7C00) == 0x7C00 && (bits & 0x3FF) != 0;
+	}
+
+	std::vector<Half> GetAllHalves()
+	{
+		std::vector<Half> halves(PATTERN_COUNT);
+		for(size_t i{ 0 }; i < PATTERN_COUNT; ++i)
+			halves[i] = Half::FromBits(static_cast<uint16_t>(i));
+		return halves;
+	}
+
+	// Every half as a float, the float halfway to the next half (the round to even ties) and one float either side
+	// of that, and random bit patterns over the whole float range (float subnormals, NaN payloads, overflow)
+	std::vector<float> GetFloatsToRound()
+	{
+		std::vector<float> floats{};
+		for(uint32_t bits{ 0 }; bits < PATTERN_COUNT; ++bits)
+		{
+			const uint16_t h{ static_cast<uint16_t>(bits) };
+			const float f{ Half::BitsToFloat(h) };
+			floats.push_back(f);
+			if(IsHalfNaN(h) || (h & 0x7FFF) >= 0x7BFF)
+				continue;
+
+			const float halfway{ (f + Half::BitsToFloat(static_cast<uint16_t>(h + 1))) * 0.5f };
+			floats.push_back(halfway);
+			floats.push_back(std::nextafter(halfway, 0.f));
+			floats.push_back(std::nextafter(halfway, std::copysign(INFINITY, f)));
+		}
+
+		std::mt19937 rng{ 75 };
+		for(size_t i{ 0 }; i < PATTERN_COUNT; ++i)
+			floats.push_back(std::bit_cast<float>(static_cast<uint32_t>(rng())));
+
+		for(const float special : { 65504.f, 65519.99f, 65520.f, 1e10f, INFINITY, -INFINITY, FLT_MIN, FLT_TRUE_MIN, 5.96e-8f, 2.98e-8f, 2.99e-8f })
+		{
+			floats.push_back(special);
+			floats.push_back(-special);
+		}
+		return floats;
+	}
+}
+
+namespace test
+{
+	void RunHalfTests(Suite& suite)
+	{
+		const std::vector<Half> allHalves{ GetAllHalves() };
+
+		suite.Add("Half/RoundTrip/AllPatterns", [&]
+		{
+			for(uint32_t bits{ 0 }; bits < PATTERN_COUNT; ++bits)
+			{
+				const uint16_t h{ static_cast<uint16_t>(bits) };
+				const float f{ Half::BitsToFloat(h) };
+				const uint16_t exponent{ static_cast<uint16_t>((h >> 10) & 0x1F) };
+				const float mantissa{ static_cast<float>(h & 0x3FF) };
+				const float sign{ (h & 0x8000) ? -1.f : 1.f };
+
+				if(IsHalfNaN(h))
+				{
+					// NaNs come back quieted with their payload
+					DAE_CHECK(suite, std::isnan(f));
+					DAE_CHECK(suite, Half::FloatToBits(f) == (h | QUIET_BIT));
+					continue;
+				}
+
+				if(exponent == 0x1F)
+					DAE_CHECK(suite, std::isinf(f) && std::signbit(f) == ((h & 0x8000) != 0));
+				else if(exponent == 0)
+					DAE_CHECK(suite, f == sign * std::ldexp(mantissa, -24));
+				else
+					DAE_CHECK(suite, f == sign * std::ldexp(1024.f + mantissa, exponent - 25));
+				DAE_CHECK(suite, Half::FloatToBits(f) == h);
+			}
+		});
+
+		// Bit for bit, against the DAE_HALF_NO_F16C build. Without F16C both sides are the scalar code.
+		suite.Add("Half/F16C/ToFloatMatchesScalar", [&]
+		{
+			std::vector<float> converted(PATTERN_COUNT);
+			std::vector<float> reference(PATTERN_COUNT);
+			Half::Convert(allHalves, converted);
+			scalar::ConvertToFloat(&allHalves[0].bits, PATTERN_COUNT, reference.data());
+			for(size_t i{ 0 }; i < PATTERN_COUNT; ++i)
+				DAE_CHECK(suite, std::bit_cast<uint32_t>(converted[i]) == std::bit_cast<uint32_t>(reference[i]));
+		});
+
+		suite.Add("Half/F16C/ToHalfMatchesScalar", [&]
+		{
+			const std::vector<float> floats{ GetFloatsToRound() };
+			std::vector<Half> converted(floats.size());
+			std::vector<uint16_t> reference(floats.size());
+			Half::Convert(floats, converted);
+			scalar::ConvertToHalf(floats.data(), floats.size(), reference.data());
+			for(size_t i{ 0 }; i < floats.size(); ++i)
+			{
+				DAE_CHECK(suite, converted[i].bits == reference[i]);
+				DAE_CHECK(suite, converted[i].bits == Half{ floats[i] }.bits);
+			}
+		});
+
+		// Every length and start offset around the 8 and 4 wide blocks, nothing past the end may be written
+		suite.Add("Half/Convert/Tails", [&]
+		{
+			const std::vector<float> floats{ GetFloatsToRound() };
+			constexpr uint16_t SENTINEL{ 0xABCD };
+			for(size_t offset{ 0 }; offset < 4; ++offset)
+			{
+				for(size_t count{ 0 }; count <= 21; ++count)
+				{
+					std::vector<Half> halves(count + 1, Half::FromBits(SENTINEL));
+					Half::Convert(std::span{ floats }.subspan(offset * 1001, count), halves);
+					std::vector<float> back(count + 1, -1.f);
+					Half::Convert(std::span{ halves }.first(count), back);
+
+					for(size_t i{ 0 }; i < count; ++i)
+					{
+						DAE_CHECK(suite, halves[i].bits == Half{ floats[offset * 1001 + i] }.bits);
+						DAE_CHECK(suite, std::bit_cast<uint32_t>(back[i]) == std::bit_cast<uint32_t>(halves[i].ToFloat()));
+					}
+					DAE_CHECK(suite, halves[count].bits == SENTINEL);
+					DAE_CHECK(suite, back[count] == -1.f);
+				}
+			}
+		});
+
+		suite.Add("Half/Convert/Vectors", [&]
+		{
+			const std::vector<Vector4> vectors{ { 1.f, -2.5f, 1e-6f, 70000.f }, { 0.1f, 0.2f, 0.3f, 0.4f }, { -0.f, 65504.f, 3.f, -1e-8f } };
+			std::vector<Half4> packed(vectors.size());
+			std::vector<Vector4> unpacked(vectors.size());
+			Half4::Convert(vectors, packed);
+			Half4::Convert(packed, unpacked);
+			for(size_t i{ 0 }; i < vectors.size(); ++i)
+			{
+				const Half4 expected{ vectors[i] };
+				DAE_CHECK(suite, packed[i].x.bits == expected.x.bits && packed[i].y.bits == expected.y.bits
+					&& packed[i].z.bits == expected.z.bits && packed[i].w.bits == expected.w.bits);
+				for(int c{ 0 }; c < 4; ++c)
+					DAE_CHECK(suite, std::bit_cast<uint32_t>(unpacked[i][c]) == std::bit_cast<uint32_t>(expected.ToVector4()[c]));
+			}
+		});
+	}
+}
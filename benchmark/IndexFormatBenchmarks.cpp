@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "IndexFormat.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+
+using namespace dae;
+
+namespace
+{
+	void RunMesh(bench::Suite& suite, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		const std::string convertName{ "IndexFormat/" + name + "/ConvertTo16BitIndices" };
+		const std::string splitName{ "IndexFormat/" + name + "/SplitFor16BitIndices" };
+
+		std::vector<uint16_t> indices16(indices.size());
+		if(Utils::FitsIn16BitIndices(vertices.size()))
+		{
+			std::fprintf(stderr, "%s: %zu vertices fit 16 bit indices, index buffer %zu -> %zu bytes\n",
+				name.c_str(), vertices.size(), indices.size() * sizeof(uint32_t), indices.size() * sizeof(uint16_t));
+
+			suite.Add(convertName, indices.size(), [&]
+			{
+				Utils::ConvertTo16BitIndices(indices, indices16);
+				bench::DoNotOptimize(indices16.data());
+			});
+			return;
+		}
+
+		const SplitMesh16 split{ Utils::SplitFor16BitIndices(indices, vertices.size()) };
+
+		const size_t sourceBytes{ vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t) };
+		const size_t splitBytes{ split.vertexRemap.size() * sizeof(Vertex) + split.indices.size() * sizeof(uint16_t) };
+		std::fprintf(stderr, "%s: %zu vertices split into %zu submeshes, %zu vertices (+%.2f%%), vertex + index buffers %zu -> %zu bytes\n",
+			name.c_str(), vertices.size(), split.submeshes.size(), split.vertexRemap.size(),
+			100.0 * static_cast<double>(split.vertexRemap.size() - vertices.size()) / static_cast<double>(vertices.size()), sourceBytes, splitBytes);
+
+		suite.Add(splitName, indices.size() / 3, [&]
+		{
+			bench::DoNotOptimize(Utils::SplitFor16BitIndices(indices, vertices.size()).indices.data());
+		});
+	}
+}
+
+namespace bench
+{
+	void RunIndexFormatBenchmarks(Suite& suite)
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		if(suite.IsEnabled("IndexFormat/vehicle/ConvertTo16BitIndices"))
+		{
+			const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+			if(file.IsOpen() && Utils::ParseOBJText(file.GetText(), vertices, indices))
+				RunMesh(suite, "vehicle", vertices, indices);
+		}
+
+		// 301^2 vertices, about 1.4 meshes worth of 16 bit indices
+		if(suite.IsEnabled("IndexFormat/grid300/SplitFor16BitIndices"))
+		{
+			Utils::ParseOBJText(MakeGridOBJ(300), vertices, indices);
+			RunMesh(suite, "grid300", vertices, indices);
+		}
+	}
+}
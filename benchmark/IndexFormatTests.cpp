@@ -0,0 +1,129 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "IndexFormat.h"
+#include "ObjParser.h"
+
+using namespace dae;
+
+namespace
+{
+	static_assert(Utils::FitsIn16BitIndices(0) && Utils::FitsIn16BitIndices(65536));
+	static_assert(!Utils::FitsIn16BitIndices(65537));
+
+	// Every submesh index has to point back to the source vertex of the same corner
+	bool IsSameMesh(const SplitMesh16& split, const std::vector<uint32_t>& indices)
+	{
+		if(split.indices.size() != indices.size())
+			return false;
+
+		for(const Submesh16& submesh : split.submeshes)
+		{
+			for(uint32_t i{ submesh.firstIndex }; i < submesh.firstIndex + submesh.indexCount; ++i)
+			{
+				if(split.indices[i] >= submesh.vertexCount || split.vertexRemap[submesh.baseVertex + split.indices[i]] != indices[i])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// Back to back ranges over the indices and the vertices, whole triangles, none over the limit
+	bool IsPartition(const SplitMesh16& split, size_t maxVertices)
+	{
+		uint32_t firstIndex{ 0 };
+		uint32_t baseVertex{ 0 };
+		for(const Submesh16& submesh : split.submeshes)
+		{
+			if(submesh.firstIndex != firstIndex || submesh.baseVertex != baseVertex || submesh.indexCount == 0 || submesh.indexCount % 3 != 0
+				|| submesh.vertexCount > maxVertices)
+				return false;
+			firstIndex += submesh.indexCount;
+			baseVertex += submesh.vertexCount;
+		}
+		return firstIndex == split.indices.size() && baseVertex == split.vertexRemap.size();
+	}
+
+	bool FitsInSubmesh(const SplitMesh16& split, const Submesh16& submesh, const uint32_t* pTriangle, size_t maxVertices)
+	{
+		std::vector<uint32_t> sourceVertices{ split.vertexRemap.begin() + submesh.baseVertex, split.vertexRemap.begin() + submesh.baseVertex + submesh.vertexCount };
+		for(size_t corner{ 0 }; corner < 3; ++corner)
+		{
+			if(std::find(sourceVertices.begin(), sourceVertices.end(), pTriangle[corner]) == sourceVertices.end())
+				sourceVertices.push_back(pTriangle[corner]);
+		}
+		return sourceVertices.size() <= maxVertices;
+	}
+}
+
+namespace test
+{
+	void RunIndexFormatTests(Suite& suite)
+	{
+		suite.Add("IndexFormat/Convert", [&]
+		{
+			const std::vector<uint32_t> indices{ 0, 1, 2, 65535, 7, 40000, 3 };
+			std::vector<uint16_t> out(indices.size() + 1, 0xABCD);
+			Utils::ConvertTo16BitIndices(indices, out);
+			DAE_CHECK(suite, std::equal(indices.begin(), indices.end(), out.begin()));
+			DAE_CHECK(suite, out.back() == 0xABCD);
+		});
+
+		suite.Add("IndexFormat/Split/Limits", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			Utils::ParseOBJText(bench::MakeGridOBJ(20), vertices, indices);
+
+			for(const size_t maxVertices : { size_t{ 3 }, size_t{ 4 }, size_t{ 5 }, size_t{ 64 }, size_t{ 100 }, Utils::MAX_16BIT_VERTICES })
+			{
+				const SplitMesh16 split{ Utils::SplitFor16BitIndices(indices, vertices.size(), maxVertices) };
+				DAE_CHECK(suite, IsSameMesh(split, indices));
+				DAE_CHECK(suite, IsPartition(split, maxVertices));
+				// A submesh only ends when the next triangle does not fit in it
+				for(size_t i{ 1 }; i < split.submeshes.size(); ++i)
+					DAE_CHECK(suite, !FitsInSubmesh(split, split.submeshes[i - 1], &indices[split.submeshes[i].firstIndex], maxVertices));
+			}
+
+			// When it all fits the split is one submesh over the whole mesh
+			const SplitMesh16 whole{ Utils::SplitFor16BitIndices(indices, vertices.size()) };
+			DAE_CHECK(suite, whole.submeshes.size() == 1 && whole.vertexRemap.size() == vertices.size());
+			DAE_CHECK(suite, Utils::SplitFor16BitIndices(indices, vertices.size(), 3).submeshes.size() == indices.size() / 3);
+		});
+
+		// A shared or repeated vertex in one triangle is only counted once
+		suite.Add("IndexFormat/Split/RepeatedCorners", [&]
+		{
+			const std::vector<uint32_t> indices{ 0, 1, 1, 2, 2, 2, 1, 2, 3, 4, 5, 4 };
+			const SplitMesh16 split{ Utils::SplitFor16BitIndices(indices, 6, 3) };
+			DAE_CHECK(suite, IsSameMesh(split, indices));
+			DAE_CHECK(suite, IsPartition(split, 3));
+			if(DAE_CHECK(suite, split.submeshes.size() == 3))
+			{
+				DAE_CHECK(suite, split.submeshes[0].indexCount == 6 && split.submeshes[0].vertexCount == 3);
+				DAE_CHECK(suite, split.submeshes[1].indexCount == 3 && split.submeshes[1].vertexCount == 3);
+				DAE_CHECK(suite, split.submeshes[2].indexCount == 3 && split.submeshes[2].vertexCount == 2);
+			}
+
+			const SplitMesh16 empty{ Utils::SplitFor16BitIndices({}, 0) };
+			DAE_CHECK(suite, empty.submeshes.empty() && empty.indices.empty() && empty.vertexRemap.empty());
+		});
+
+		// 301^2 vertices do not fit, every submesh has to
+		suite.Add("IndexFormat/Split/LargeGrid", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			Utils::ParseOBJText(bench::MakeGridOBJ(300), vertices, indices);
+			DAE_CHECK(suite, !Utils::FitsIn16BitIndices(vertices.size()));
+
+			const SplitMesh16 split{ Utils::SplitFor16BitIndices(indices, vertices.size()) };
+			DAE_CHECK(suite, IsSameMesh(split, indices));
+			DAE_CHECK(suite, IsPartition(split, Utils::MAX_16BIT_VERTICES));
+			DAE_CHECK(suite, split.submeshes.size() == 2);
+			// Cache ordered triangles share most vertices, the copies along the cut stay small
+			DAE_CHECK(suite, split.vertexRemap.size() < vertices.size() * 21 / 20);
+		});
+	}
+}
@@ -0,0 +1,71 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "InstanceBatching.h"
+
+using namespace dae;
+
+namespace
+{
+	struct Instance
+	{
+		uint32_t key{};
+		Affine3x4 worldTransform{};
+		Vector4 parameters{};
+	};
+
+	// Four meshes with two levels each, in random order like a culled and LOD selected crowd
+	std::vector<Instance> MakeInstances(size_t count)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 5, 29, 0.f, 1.f) };
+		std::vector<Instance> instances(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 5] };
+			const uint32_t mesh{ static_cast<uint32_t>(pRandom[0] * 3.99f) };
+			const uint32_t lod{ pRandom[1] < 0.5f ? 0u : 1u };
+			const Vector3 translation{ pRandom[2] * 100.f, pRandom[3] * 100.f, pRandom[4] * 100.f };
+			instances[i] = { InstanceBatch::MakeKey(mesh, lod), { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, translation },
+				{ pRandom[2], pRandom[3], pRandom[4], static_cast<float>(i) } };
+		}
+		return instances;
+	}
+
+	void RunCount(bench::Suite& suite, const std::string& name, size_t count)
+	{
+		const std::string buildName{ "Instancing/" + name + "/AddAndBuild" };
+		if(!suite.IsEnabled(buildName))
+			return;
+
+		const std::vector<Instance> instances{ MakeInstances(count) };
+
+		// Includes the adds, as a frame would
+		InstanceBatcher batcher{};
+		const auto addAndBuild = [&]
+		{
+			batcher.Clear();
+			for(const Instance& instance : instances)
+				batcher.Add(instance.key, instance.worldTransform, instance.parameters);
+			batcher.Build();
+		};
+
+		// That the batches hold the added instances is checked in InstancingTests.cpp
+		addAndBuild();
+		std::fprintf(stderr, "Instancing: %s, %zu instances in %zu draws\n", name.c_str(), batcher.GetInstanceCount(), batcher.GetBatches().size());
+
+		suite.Add(buildName, count, [&]
+		{
+			addAndBuild();
+			bench::DoNotOptimize(batcher.GetInstanceData().data());
+		});
+	}
+}
+
+namespace bench
+{
+	void RunInstancingBenchmarks(Suite& suite)
+	{
+		RunCount(suite, "1k", 1000);
+		RunCount(suite, "100k", 100000);
+	}
+}
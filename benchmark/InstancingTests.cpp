@@ -0,0 +1,161 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "InstanceBatching.h"
+
+#include <cstring>
+
+using namespace dae;
+
+namespace
+{
+	struct Instance
+	{
+		uint32_t key{};
+		Affine3x4 worldTransform{};
+		Vector4 parameters{};
+	};
+
+	// meshCount meshes with two levels each in random order, the fourth random number is the instance's own id
+	std::vector<Instance> MakeInstances(size_t count, uint32_t meshCount, uint32_t seed)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 5, seed, 0.f, 1.f) };
+		std::vector<Instance> instances(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 5] };
+			const uint32_t mesh{ static_cast<uint32_t>(pRandom[0] * (static_cast<float>(meshCount) - 0.01f)) };
+			const uint32_t lod{ pRandom[1] < 0.5f ? 0u : 1u };
+			const Vector3 translation{ pRandom[2] * 100.f, pRandom[3] * 100.f, pRandom[4] * 100.f };
+			instances[i] = { InstanceBatch::MakeKey(mesh, lod), { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, translation },
+				{ pRandom[2], pRandom[3], pRandom[4], static_cast<float>(i) } };
+		}
+		return instances;
+	}
+
+	void AddAndBuild(InstanceBatcher& batcher, std::span<const Instance> instances)
+	{
+		batcher.Clear();
+		for(const Instance& instance : instances)
+			batcher.Add(instance.key, instance.worldTransform, instance.parameters);
+		batcher.Build();
+	}
+
+	bool IsEqual(const InstanceData& a, const InstanceData& b)
+	{
+		return std::memcmp(&a, &b, sizeof(InstanceData)) == 0;
+	}
+
+	// One batch per key in ascending order, every batch holds only its own key and the instances in it keep the
+	// order they were added in
+	bool IsBatchingValid(const InstanceBatcher& batcher, std::span<const Instance> instances)
+	{
+		const std::span<const InstanceData> data{ batcher.GetInstanceData() };
+		const std::span<const InstanceBatch> batches{ batcher.GetBatches() };
+		size_t next{ 0 };
+		for(size_t b{ 0 }; b < batches.size(); ++b)
+		{
+			const InstanceBatch& batch{ batches[b] };
+			if(batch.firstInstance != next || batch.instanceCount == 0 || (b > 0 && batches[b - 1].key >= batch.key))
+				return false;
+
+			size_t source{ 0 };
+			for(uint32_t i{ batch.firstInstance }; i < batch.firstInstance + batch.instanceCount; ++i)
+			{
+				while(source < instances.size() && instances[source].key != batch.key)
+					++source;
+				if(source == instances.size())
+					return false;
+
+				const Instance& instance{ instances[source++] };
+				if(!IsEqual(data[i], InstanceData::Create(instance.worldTransform, instance.parameters)))
+					return false;
+			}
+			// Nothing of this key may be left over
+			while(source < instances.size() && instances[source].key != batch.key)
+				++source;
+			if(source != instances.size())
+				return false;
+			next += batch.instanceCount;
+		}
+		return next == instances.size() && data.size() == instances.size();
+	}
+}
+
+namespace test
+{
+	void RunInstancingTests(Suite& suite)
+	{
+		// The shader computes world.c = dot(float4(p, 1), column c), that has to be the transformed point
+		suite.Add("Instancing/InstanceData/Columns", [&]
+		{
+			const Quaternion rotation{ Quaternion::CreateFromAxisAngle(Vector3{ 1.f, 2.f, -0.5f }.Normalized(), 0.8f) };
+			const Affine3x4 worldTransform{ rotation.GetAxisX() * 2.f, rotation.GetAxisY() * 0.5f, rotation.GetAxisZ() * 3.f, { 4.f, -5.f, 6.f } };
+			const Vector4 parameters{ 0.2f, 0.4f, 0.6f, 0.8f };
+			const InstanceData data{ InstanceData::Create(worldTransform, parameters) };
+			for(const Vector3& point : { Vector3{ 0.f, 0.f, 0.f }, Vector3{ 1.f, -2.f, 3.f }, Vector3{ -7.f, 0.5f, 0.25f } })
+			{
+				const Vector4 p{ point, 1.f };
+				const Vector3 expected{ worldTransform.TransformPoint(point) };
+				DAE_CHECK(suite, AreEqual(Vector4::Dot(p, data.worldColumns[0]), expected.x, 1e-5f));
+				DAE_CHECK(suite, AreEqual(Vector4::Dot(p, data.worldColumns[1]), expected.y, 1e-5f));
+				DAE_CHECK(suite, AreEqual(Vector4::Dot(p, data.worldColumns[2]), expected.z, 1e-5f));
+			}
+			DAE_CHECK(suite, data.parameters.x == 0.2f && data.parameters.w == 0.8f);
+			DAE_CHECK(suite, InstanceData{}.parameters.x == 1.f && InstanceData{}.parameters.w == 0.f);
+		});
+
+		suite.Add("Instancing/Batch/Key", [&]
+		{
+			const InstanceBatch batch{ InstanceBatch::MakeKey(1234, 3) };
+			DAE_CHECK(suite, batch.GetMesh() == 1234 && batch.GetLod() == 3);
+			// Mesh major, so one mesh's levels are next to each other
+			DAE_CHECK(suite, InstanceBatch::MakeKey(1, 255) < InstanceBatch::MakeKey(2, 0));
+		});
+
+		// Random order goes through the counting sort, sorted order through the fast path
+		suite.Add("Instancing/Build/Valid", [&]
+		{
+			InstanceBatcher batcher{};
+			for(const size_t count : { size_t{ 1 }, size_t{ 1000 }, size_t{ 100000 } })
+			{
+				std::vector<Instance> instances{ MakeInstances(count, 4, static_cast<uint32_t>(count)) };
+				AddAndBuild(batcher, instances);
+				DAE_CHECK(suite, IsBatchingValid(batcher, instances));
+				DAE_CHECK(suite, batcher.GetInstanceCount() == count);
+				// Building again changes nothing, the keys follow the packed order
+				batcher.Build();
+				DAE_CHECK(suite, IsBatchingValid(batcher, instances));
+				if(count >= 1000)
+					DAE_CHECK(suite, batcher.GetBatches().size() == 8);
+
+				std::stable_sort(instances.begin(), instances.end(), [](const Instance& a, const Instance& b) { return a.key < b.key; });
+				AddAndBuild(batcher, instances);
+				DAE_CHECK(suite, IsBatchingValid(batcher, instances));
+			}
+
+			// Few large keys far apart, and a smaller set after a bigger one on the same batcher
+			const std::vector<Instance> sparse{ MakeInstances(500, 1000, 7) };
+			AddAndBuild(batcher, sparse);
+			DAE_CHECK(suite, IsBatchingValid(batcher, sparse));
+			const std::vector<Instance> small{ MakeInstances(20, 2, 8) };
+			AddAndBuild(batcher, small);
+			DAE_CHECK(suite, IsBatchingValid(batcher, small));
+		});
+
+		suite.Add("Instancing/Build/Empty", [&]
+		{
+			InstanceBatcher batcher{};
+			batcher.Build();
+			DAE_CHECK(suite, batcher.GetBatches().empty() && batcher.GetInstanceCount() == 0);
+
+			const std::vector<Instance> instances{ MakeInstances(100, 4, 3) };
+			AddAndBuild(batcher, instances);
+			batcher.Clear();
+			DAE_CHECK(suite, batcher.GetBatches().empty() && batcher.GetInstanceData().empty());
+			batcher.Build();
+			DAE_CHECK(suite, batcher.GetBatches().empty());
+		});
+	}
+}
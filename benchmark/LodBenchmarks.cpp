@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "LodSelection.h"
+#include "MappedFile.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+
+#include <array>
+
+using namespace dae;
+
+namespace
+{
+	constexpr std::array<float, 3> LOD_RATIOS{ 0.5f, 0.25f, 0.125f };
+	// Renderer camera, 45 degrees on a 720 pixel high viewport
+	const float PROJECTION_SCALE{ Utils::GetProjectionScale(std::tan(22.5f * TO_RADIANS), 720.f) };
+
+	LodChain MakeChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		LodChain chain{};
+		for(const LodLevel& level : Utils::GenerateLods(vertices, indices, LOD_RATIOS))
+		{
+			chain.errors.push_back(level.error);
+			chain.triangleCounts.push_back(level.indexCount / 3);
+		}
+
+		Vector3 boundsMin{ vertices.front().position };
+		Vector3 boundsMax{ vertices.front().position };
+		for(const Vertex& vertex : vertices)
+		{
+			boundsMin = Vector3::Min(boundsMin, vertex.position);
+			boundsMax = Vector3::Max(boundsMax, vertex.position);
+		}
+		chain.boundsCenter = (boundsMin + boundsMax) * 0.5f;
+		chain.boundsRadius = (boundsMax - boundsMin).Magnitude() * 0.5f;
+		return chain;
+	}
+
+	// Square field of instances in front of the camera, spaced a few vehicle lengths apart
+	std::vector<LodInstance> MakeInstances(const LodChain& chain, size_t count)
+	{
+		const size_t side{ static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count)))) };
+		const float spacing{ chain.boundsRadius * 4.f };
+
+		std::vector<LodInstance> instances(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const Vector3 position{ (static_cast<float>(i % side) - static_cast<float>(side) * 0.5f) * spacing, 0.f, static_cast<float>(i / side + 1) * spacing };
+			instances[i].pChain = &chain;
+			instances[i].SetWorldTransform(Affine3x4{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, position });
+		}
+		return instances;
+	}
+
+	// Switches while the camera shakes by a fraction of a vehicle, all of them are popping
+	size_t CountShakeSwitches(std::vector<LodInstance> instances, const LodSettings& settings, float amplitude)
+	{
+		size_t switches{ 0 };
+		Utils::SelectLods(instances, Vector3::Zero, PROJECTION_SCALE, settings);
+		for(int frame{ 0 }; frame < 64; ++frame)
+		{
+			const Vector3 cameraPosition{ 0.f, 0.f, frame % 2 == 0 ? amplitude : -amplitude };
+			switches += Utils::SelectLods(instances, cameraPosition, PROJECTION_SCALE, settings).changed;
+		}
+		return switches;
+	}
+}
+
+namespace bench
+{
+	void RunLodBenchmarks(Suite& suite)
+	{
+		const std::string selectName{ "Lod/vehicle/SelectLods" };
+		if(!suite.IsEnabled(selectName + "1k") && !suite.IsEnabled(selectName + "100k"))
+			return;
+
+		const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		if(!file.IsOpen() || !Utils::ParseOBJText(file.GetText(), vertices, indices))
+		{
+			std::fprintf(stderr, "Lod benchmark skipped, could not import vehicle.obj\n");
+			return;
+		}
+		const LodChain chain{ MakeChain(vertices, indices) };
+
+		for(const size_t count : { size_t{ 1000 }, size_t{ 100000 } })
+		{
+			const std::string name{ selectName + (count == 1000 ? "1k" : "100k") };
+			if(!suite.IsEnabled(name))
+				continue;
+
+			std::vector<LodInstance> instances{ MakeInstances(chain, count) };
+			const LodStats stats{ Utils::SelectLods(instances, Vector3::Zero, PROJECTION_SCALE) };
+			std::fprintf(stderr, "%zu vehicles: %zu of %zu triangles drawn (%.1f%% saved)\n", count, stats.drawnTriangles, stats.fullTriangles,
+				100.0 * static_cast<double>(stats.GetTrianglesSaved()) / static_cast<double>(stats.fullTriangles));
+
+			const float shake{ chain.boundsRadius * 0.05f };
+			std::fprintf(stderr, "%zu vehicles, camera shaking 64 frames: %zu switches without hysteresis, %zu with\n", count,
+				CountShakeSwitches(instances, LodSettings{ 1.f, 0.f }, shake), CountShakeSwitches(instances, LodSettings{}, shake));
+
+			suite.Add(name, count, [&]
+			{
+				bench::DoNotOptimize(Utils::SelectLods(instances, Vector3::Zero, PROJECTION_SCALE).drawnTriangles);
+			});
+		}
+	}
+}
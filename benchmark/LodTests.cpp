@@ -0,0 +1,150 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "LodSelection.h"
+
+using namespace dae;
+
+namespace
+{
+	// One pixel of error per object unit at distance 1, so a level's switch distance is its error / threshold
+	constexpr float PROJECTION_SCALE{ 1.f };
+	static_assert(Utils::GetProjectionScale(0.5f, 720.f) == 720.f);
+
+	LodChain MakeChain()
+	{
+		LodChain chain{};
+		chain.errors = { 0.f, 10.f, 40.f, 160.f };
+		chain.triangleCounts = { 8000, 4000, 2000, 1000 };
+		chain.boundsCenter = { 1.f, 2.f, 3.f };
+		chain.boundsRadius = 2.f;
+		return chain;
+	}
+
+	// An instance whose bounding sphere is distance away from the camera at the origin, along z
+	LodInstance MakeInstance(const LodChain& chain, float distance)
+	{
+		LodInstance instance{ &chain };
+		instance.SetWorldTransform(Affine3x4{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, Vector3{ 0.f, 0.f, distance + chain.boundsRadius } - chain.boundsCenter });
+		return instance;
+	}
+
+	uint32_t SelectAt(LodInstance& instance, float distance, const LodSettings& settings)
+	{
+		const Vector3 cameraPosition{ 0.f, 0.f, (instance.center.z - instance.radius) - distance };
+		Utils::SelectLods({ &instance, 1 }, cameraPosition, PROJECTION_SCALE, settings);
+		return instance.lod;
+	}
+}
+
+namespace test
+{
+	void RunLodTests(Suite& suite)
+	{
+		const LodChain chain{ MakeChain() };
+
+		suite.Add("Lod/WorldTransform", [&]
+		{
+			LodInstance instance{ &chain };
+			instance.SetWorldTransform(Affine3x4{ Vector3::UnitX * 2.f, Vector3::UnitY * 0.5f, Vector3::UnitZ * 3.f, Vector3{ 10.f, 0.f, 0.f } });
+			DAE_CHECK(suite, instance.scale == 3.f);
+			DAE_CHECK(suite, instance.radius == 6.f);
+			DAE_CHECK(suite, instance.center.x == 12.f && instance.center.y == 1.f && instance.center.z == 9.f);
+		});
+
+		// Without hysteresis the coarsest level whose error stays under a pixel
+		suite.Add("Lod/Select/CoarsestUnderThreshold", [&]
+		{
+			const LodSettings settings{ 1.f, 0.f };
+			const float distances[]{ 1.f, 9.9f, 10.1f, 39.f, 41.f, 159.f, 161.f, 1e5f };
+			const uint32_t expected[]{ 0, 0, 1, 1, 2, 2, 3, 3 };
+			for(size_t i{ 0 }; i < std::size(distances); ++i)
+			{
+				LodInstance instance{ MakeInstance(chain, distances[i]) };
+				DAE_CHECK(suite, SelectAt(instance, distances[i], settings) == expected[i]);
+			}
+
+			// Twice the threshold halves the distances, a scaled up instance doubles them
+			LodInstance instance{ MakeInstance(chain, 25.f) };
+			DAE_CHECK(suite, SelectAt(instance, 25.f, LodSettings{ 2.f, 0.f }) == 2);
+			instance.SetWorldTransform(Affine3x4{ Vector3::UnitX * 2.f, Vector3::UnitY * 2.f, Vector3::UnitZ * 2.f, Vector3::Zero });
+			DAE_CHECK(suite, SelectAt(instance, 25.f, settings) == 1);
+		});
+
+		suite.Add("Lod/Select/CameraInside", [&]
+		{
+			LodInstance instance{ MakeInstance(chain, 1000.f) };
+			instance.lod = 3;
+			Utils::SelectLods({ &instance, 1 }, instance.center, PROJECTION_SCALE);
+			DAE_CHECK(suite, instance.lod == 0);
+			// Inside the sphere but not at its centre
+			instance.lod = 3;
+			Utils::SelectLods({ &instance, 1 }, instance.center + Vector3::UnitX * (instance.radius * 0.9f), PROJECTION_SCALE);
+			DAE_CHECK(suite, instance.lod == 0);
+		});
+
+		// Going coarser waits for 0.75 pixels, going finer happens at 1
+		suite.Add("Lod/Select/Hysteresis", [&]
+		{
+			const LodSettings settings{ 1.f, 0.25f };
+			LodInstance instance{ MakeInstance(chain, 1.f) };
+			DAE_CHECK(suite, SelectAt(instance, 1.f, settings) == 0);
+			DAE_CHECK(suite, SelectAt(instance, 12.f, settings) == 0);
+			DAE_CHECK(suite, SelectAt(instance, 13.4f, settings) == 1);
+			DAE_CHECK(suite, SelectAt(instance, 50.f, settings) == 1);
+			DAE_CHECK(suite, SelectAt(instance, 53.4f, settings) == 2);
+			// Back in, the level is kept down to the plain switch distance
+			DAE_CHECK(suite, SelectAt(instance, 41.f, settings) == 2);
+			DAE_CHECK(suite, SelectAt(instance, 39.f, settings) == 1);
+			DAE_CHECK(suite, SelectAt(instance, 10.1f, settings) == 1);
+			DAE_CHECK(suite, SelectAt(instance, 9.9f, settings) == 0);
+			// Far enough a jump skips levels either way
+			DAE_CHECK(suite, SelectAt(instance, 1000.f, settings) == 3);
+			DAE_CHECK(suite, SelectAt(instance, 5.f, settings) == 0);
+		});
+
+		// A camera moving back and forth around a switch distance pops every frame without hysteresis, never with it
+		suite.Add("Lod/Select/NoPopping", [&]
+		{
+			for(const float switchDistance : { 10.f, 40.f, 160.f })
+			{
+				LodInstance plain{ MakeInstance(chain, switchDistance) };
+				LodInstance banded{ MakeInstance(chain, switchDistance) };
+				// Settled on the far side first
+				SelectAt(plain, switchDistance * 1.05f, LodSettings{ 1.f, 0.f });
+				SelectAt(banded, switchDistance * 1.05f, LodSettings{});
+				size_t plainSwitches{ 0 };
+				size_t bandedSwitches{ 0 };
+				for(int frame{ 0 }; frame < 16; ++frame)
+				{
+					const float distance{ switchDistance * (frame % 2 == 0 ? 0.95f : 1.05f) };
+					const uint32_t plainLod{ plain.lod };
+					const uint32_t bandedLod{ banded.lod };
+					plainSwitches += SelectAt(plain, distance, LodSettings{ 1.f, 0.f }) != plainLod;
+					bandedSwitches += SelectAt(banded, distance, LodSettings{}) != bandedLod;
+				}
+				DAE_CHECK(suite, plainSwitches == 16);
+				DAE_CHECK(suite, bandedSwitches == 0);
+			}
+		});
+
+		suite.Add("Lod/Select/Stats", [&]
+		{
+			std::vector<LodInstance> instances{ MakeInstance(chain, 1.f), MakeInstance(chain, 20.f), MakeInstance(chain, 100.f), MakeInstance(chain, 500.f) };
+			const LodStats stats{ Utils::SelectLods(instances, Vector3::Zero, PROJECTION_SCALE, LodSettings{ 1.f, 0.f }) };
+			DAE_CHECK(suite, stats.instances == 4);
+			DAE_CHECK(suite, stats.changed == 3);
+			DAE_CHECK(suite, stats.fullTriangles == 4 * 8000);
+			DAE_CHECK(suite, stats.drawnTriangles == 8000 + 4000 + 2000 + 1000);
+			DAE_CHECK(suite, stats.GetTrianglesSaved() == 4 * 8000 - 15000);
+			DAE_CHECK(suite, Utils::SelectLods(instances, Vector3::Zero, PROJECTION_SCALE, LodSettings{ 1.f, 0.f }).changed == 0);
+
+			// A chain with only the full mesh never switches
+			LodChain single{ MakeChain() };
+			single.errors.resize(1);
+			single.triangleCounts.resize(1);
+			LodInstance instance{ MakeInstance(single, 1e5f) };
+			DAE_CHECK(suite, SelectAt(instance, 1e5f, LodSettings{}) == 0);
+		});
+	}
+}
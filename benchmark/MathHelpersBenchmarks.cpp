@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+using namespace dae;
+
+namespace
+{
+	struct SinCosResult
+	{
+		float sine;
+		float cosine;
+	};
+}
+
+namespace bench
+{
+	void RunMathHelpersBenchmarks(Suite& suite)
+	{
+		const std::vector<float> a{ RandomFloats(BATCH_SIZE, 60) };
+		const std::vector<float> b{ RandomFloats(BATCH_SIZE, 61) };
+		const std::vector<float> factors{ RandomFloats(BATCH_SIZE, 62, 0.f, 1.f) };
+		const std::vector<float> angles{ RandomFloats(BATCH_SIZE, 63, -2.f * PI, 2.f * PI) };
+		std::vector<int> ints(BATCH_SIZE);
+		for(size_t i{ 0 }; i < BATCH_SIZE; ++i)
+			ints[i] = static_cast<int>(a[i] * 100.f);
+
+		std::vector<float> floats(BATCH_SIZE);
+		std::vector<int> intsOut(BATCH_SIZE);
+		std::vector<uint8_t> bools(BATCH_SIZE);
+		std::vector<SinCosResult> sinCos(BATCH_SIZE);
+
+		suite.AddMap("MathHelpers/Square", a, floats, [](float v) { return Square(v); });
+		suite.AddZip("MathHelpers/Lerpf", a, b, floats, [](float v1, float v2) { return Lerpf(v1, v2, 0.25f); });
+		suite.AddMap("MathHelpers/Abs", a, floats, [](float v) { return Abs(v); });
+		suite.AddZip("MathHelpers/AreEqual", a, b, bools, [](float v1, float v2) { return AreEqual(v1, v2, 0.5f); });
+		suite.AddMap("MathHelpers/Clamp(int)", ints, intsOut, [](int v) { return Clamp(v, -500, 500); });
+		suite.AddMap("MathHelpers/Clamp(float)", a, floats, [](float v) { return Clamp(v, -5.f, 5.f); });
+		suite.AddMap("MathHelpers/Wrap", a, floats, [](float v) { return Wrap(v, -180.f, 180.f); });
+		suite.AddMap("MathHelpers/Saturate", factors, floats, [](float v) { return Saturate(v * 2.f - 0.5f); });
+
+		suite.AddMap("MathHelpers/ConstexprSin", angles, floats, [](float angle) { return ConstexprSin(angle); });
+		suite.AddMap("MathHelpers/ConstexprCos", angles, floats, [](float angle) { return ConstexprCos(angle); });
+		suite.AddMap("MathHelpers/Sin", angles, floats, [](float angle) { return Sin(angle); });
+		suite.AddMap("MathHelpers/Cos", angles, floats, [](float angle) { return Cos(angle); });
+		suite.AddMap("MathHelpers/SinCos/Precise", angles, sinCos, [](float angle)
+		{
+			SinCosResult result{};
+			SinCos(angle, result.sine, result.cosine);
+			return result;
+		});
+		suite.AddMap("MathHelpers/SinCos/Fast", angles, sinCos, [](float angle)
+		{
+			SinCosResult result{};
+			SinCos(angle, result.sine, result.cosine, TrigMode::Fast);
+			return result;
+		});
+		suite.AddMap("MathHelpers/SinCosFast", angles, sinCos, [](float angle)
+		{
+			SinCosResult result{};
+			SinCosFast(angle, result.sine, result.cosine);
+			return result;
+		});
+	}
+}
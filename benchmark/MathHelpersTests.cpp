@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "ScalarReference.h"
+
+#include <cstring>
+
+using namespace dae;
+
+namespace
+{
+	// Largest abs error of SinCosFast against std::sin / std::cos over count evenly spaced angles in [-range, range]
+	float GetMaxSinCosError(float range, size_t count)
+	{
+		float maxError{};
+		for(size_t i{ 0 }; i <= count; ++i)
+		{
+			const float angle{ -range + 2.f * range * static_cast<float>(i) / static_cast<float>(count) };
+			float sine{}, cosine{};
+			SinCos(angle, sine, cosine, TrigMode::Fast);
+			maxError = std::max({ maxError, std::abs(sine - std::sin(angle)), std::abs(cosine - std::cos(angle)) });
+		}
+		return maxError;
+	}
+}
+
+namespace test
+{
+	void RunMathHelpersTests(Suite& suite)
+	{
+		// The bounds in the TrigMode / SinCosFast doc comments
+		suite.Add("MathHelpers/SinCosFast/ErrorBelow10", [&]
+		{
+			DAE_CHECK(suite, GetMaxSinCosError(10.f, 1 << 20) <= 4e-7f);
+		});
+
+		suite.Add("MathHelpers/SinCosFast/ErrorBelow1e3", [&]
+		{
+			DAE_CHECK(suite, GetMaxSinCosError(1e3f, 1 << 20) <= 6e-5f);
+		});
+
+		suite.Add("MathHelpers/SinCosFast/ErrorBelow1e4", [&]
+		{
+			DAE_CHECK(suite, GetMaxSinCosError(1e4f, 1 << 20) <= 8e-4f);
+		});
+
+		suite.Add("MathHelpers/SinCos/PreciseIsStd", [&]
+		{
+			for(const float angle : bench::RandomFloats(4096, 70, -100.f, 100.f))
+			{
+				float sine{}, cosine{};
+				SinCos(angle, sine, cosine);
+				DAE_CHECK(suite, sine == std::sin(angle) && cosine == std::cos(angle));
+			}
+		});
+
+		// The 4 wide SIMD builder against the DAE_MATRIX_NO_SIMD build, same reduction and polynomials in the same order.
+		// Odd count so the scalar tail runs too.
+		suite.Add("MathHelpers/CreateRotations/SIMDMatchesScalar", [&]
+		{
+			constexpr size_t count{ 1023 };
+			const std::vector<Vector3> angles{ bench::RandomValues<Vector3, 3>(count, 71, [](const float* f) { return Vector3{ f[0], f[1], f[2] }; }, -20.f, 20.f) };
+
+			for(const TrigMode mode : { TrigMode::Fast, TrigMode::Precise })
+			{
+				std::vector<Matrix> simd(count);
+				std::vector<Matrix> reference(count);
+				Matrix::CreateRotations(angles, simd, mode);
+				scalar::CreateRotations(&angles[0].x, count, &reference[0][0].x, mode == TrigMode::Fast);
+				for(size_t i{ 0 }; i < count; ++i)
+					DAE_CHECK(suite, std::memcmp(&simd[i], &reference[i], sizeof(Matrix)) == 0);
+			}
+		});
+
+		// And the batch is the same rotation as the one at a time builder and the Rx * Ry * Rz product
+		suite.Add("MathHelpers/CreateRotations/MatchesProduct", [&]
+		{
+			const std::vector<Vector3> angles{ bench::RandomValues<Vector3, 3>(64, 72, [](const float* f) { return Vector3{ f[0], f[1], f[2] }; }, -PI, PI) };
+			std::vector<Matrix> batch(angles.size());
+			Matrix::CreateRotations(angles, batch, TrigMode::Fast);
+
+			for(size_t i{ 0 }; i < angles.size(); ++i)
+			{
+				const Matrix product{ Matrix::CreateRotationX(angles[i].x) * Matrix::CreateRotationY(angles[i].y) * Matrix::CreateRotationZ(angles[i].z) };
+				for(int r{ 0 }; r < 4; ++r)
+				{
+					for(int c{ 0 }; c < 4; ++c)
+						DAE_CHECK(suite, AreEqual(batch[i][r][c], product[r][c], 2e-6f));
+				}
+			}
+		});
+	}
+}
@@ -0,0 +1,170 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+using namespace dae;
+
+namespace
+{
+	struct CameraState
+	{
+		Vector3 origin;
+		Vector3 forward;
+		Vector3 up;
+	};
+
+	std::vector<Vector3> RandomVector3s(uint32_t seed, float min = -10.f, float max = 10.f)
+	{
+		return bench::RandomValues<Vector3, 3>(bench::BATCH_SIZE, seed, [](const float* f) { return Vector3{ f[0], f[1], f[2] }; }, min, max);
+	}
+
+	// Rotation, scale and translation, always invertible
+	std::vector<Matrix> RandomMatrices(uint32_t seed)
+	{
+		return bench::RandomValues<Matrix, 9>(bench::BATCH_SIZE, seed, [](const float* f)
+		{
+			return Matrix::CreateScale(1.f + Abs(f[0]) * 0.1f, 1.f + Abs(f[1]) * 0.1f, 1.f + Abs(f[2]) * 0.1f)
+				* Matrix::CreateRotation(f[3], f[4], f[5])
+				* Matrix::CreateTranslation(f[6], f[7], f[8]);
+		});
+	}
+
+	std::vector<CameraState> RandomCameras(uint32_t seed)
+	{
+		return bench::RandomValues<CameraState, 6>(bench::BATCH_SIZE, seed, [](const float* f)
+		{
+			return CameraState{ { f[0], f[1], f[2] }, Vector3{ f[3], f[4], 1.f + Abs(f[5]) }.Normalized(), Vector3::UnitY };
+		});
+	}
+}
+
+namespace bench
+{
+	void RunMatrixBenchmarks(Suite& suite)
+	{
+		const std::vector<Matrix> a{ RandomMatrices(50) };
+		const std::vector<Matrix> b{ RandomMatrices(51) };
+		const std::vector<Vector3> points{ RandomVector3s(52) };
+		const std::vector<Vector3> angles{ RandomVector3s(53, -PI, PI) };
+		const std::vector<Vector3> scales{ RandomVector3s(54, 0.5f, 2.f) };
+		const std::vector<float> scalars{ RandomFloats(BATCH_SIZE, 55, -PI, PI) };
+		const std::vector<CameraState> cameras{ RandomCameras(56) };
+		std::vector<Vector4> points4(BATCH_SIZE);
+		for(size_t i{ 0 }; i < BATCH_SIZE; ++i)
+			points4[i] = points[i].ToPoint4();
+
+		std::vector<Matrix> matrices(BATCH_SIZE);
+		std::vector<Vector3> vectors(BATCH_SIZE);
+		std::vector<Vector4> vectors4(BATCH_SIZE);
+
+		// Constructors and accessors
+		suite.AddMap("Matrix/Matrix(Vector3 x4)", points, matrices, [](const Vector3& p) { return Matrix{ p, p, p, p }; });
+		suite.AddMap("Matrix/Matrix(Vector4 x4)", points4, matrices, [](const Vector4& p) { return Matrix{ p, p, p, p }; });
+		suite.AddMap("Matrix/GetAxisX", a, vectors, [](const Matrix& m) { return m.GetAxisX(); });
+		suite.AddMap("Matrix/GetAxisY", a, vectors, [](const Matrix& m) { return m.GetAxisY(); });
+		suite.AddMap("Matrix/GetAxisZ", a, vectors, [](const Matrix& m) { return m.GetAxisZ(); });
+		suite.AddMap("Matrix/GetTranslation", a, vectors, [](const Matrix& m) { return m.GetTranslation(); });
+		suite.AddMap("Matrix/operator[]", a, vectors4, [](const Matrix& m) { return m[2]; });
+
+		// Products, inverse and transpose
+		suite.AddZip("Matrix/operator*", a, b, matrices, [](const Matrix& m1, const Matrix& m2) { return m1 * m2; });
+		suite.AddInPlace("Matrix/operator*=", a, matrices, [&](Matrix& m, size_t i) { m *= b[i]; });
+		suite.AddMap("Matrix/Transpose(Matrix)", a, matrices, [](const Matrix& m) { return Matrix::Transpose(m); });
+		suite.AddInPlace("Matrix/Transpose", a, matrices, [](Matrix& m, size_t) { m.Transpose(); });
+		suite.AddMap("Matrix/Inverse(Matrix)", a, matrices, [](const Matrix& m) { return Matrix::Inverse(m); });
+		suite.AddInPlace("Matrix/Inverse", a, matrices, [](Matrix& m, size_t) { m.Inverse(); });
+
+		// Single element transforms
+		suite.AddZip("Matrix/TransformVector", a, points, vectors, [](const Matrix& m, const Vector3& v) { return m.TransformVector(v); });
+		suite.AddZip("Matrix/TransformVector(x, y, z)", a, points, vectors, [](const Matrix& m, const Vector3& v) { return m.TransformVector(v.x, v.y, v.z); });
+		suite.AddZip("Matrix/TransformPoint", a, points, vectors, [](const Matrix& m, const Vector3& p) { return m.TransformPoint(p); });
+		suite.AddZip("Matrix/TransformPoint(x, y, z)", a, points, vectors, [](const Matrix& m, const Vector3& p) { return m.TransformPoint(p.x, p.y, p.z); });
+		suite.AddZip("Matrix/TransformPoint(Vector4)", a, points4, vectors4, [](const Matrix& m, const Vector4& p) { return m.TransformPoint(p); });
+		suite.AddZip("Matrix/TransformPoint(x, y, z, w)", a, points4, vectors4, [](const Matrix& m, const Vector4& p) { return m.TransformPoint(p.x, p.y, p.z, p.w); });
+
+		// Batch transforms, ops are points
+		const Matrix& m{ a[0] };
+		suite.Add("Matrix/TransformPoints(Vector3)", BATCH_SIZE, [&]
+		{
+			m.TransformPoints(points, vectors);
+			ClobberMemory();
+		});
+		suite.Add("Matrix/TransformPoints(Vector4)", BATCH_SIZE, [&]
+		{
+			m.TransformPoints(points, vectors4);
+			ClobberMemory();
+		});
+		suite.Add("Matrix/TransformPoints(Vector4, perspectiveDivide)", BATCH_SIZE, [&]
+		{
+			m.TransformPoints(points, vectors4, true);
+			ClobberMemory();
+		});
+		suite.Add("Matrix/TransformVectors(Vector3)", BATCH_SIZE, [&]
+		{
+			m.TransformVectors(points, vectors);
+			ClobberMemory();
+		});
+
+		std::vector<float> xs(BATCH_SIZE), ys(BATCH_SIZE), zs(BATCH_SIZE);
+		for(size_t i{ 0 }; i < BATCH_SIZE; ++i)
+		{
+			xs[i] = points[i].x;
+			ys[i] = points[i].y;
+			zs[i] = points[i].z;
+		}
+		std::vector<float> outXs(BATCH_SIZE), outYs(BATCH_SIZE), outZs(BATCH_SIZE), outWs(BATCH_SIZE);
+		suite.Add("Matrix/TransformPoints(SoA)", BATCH_SIZE, [&]
+		{
+			m.TransformPoints(xs, ys, zs, outXs, outYs, outZs, outWs);
+			ClobberMemory();
+		});
+		suite.Add("Matrix/TransformPoints(SoA, perspectiveDivide)", BATCH_SIZE, [&]
+		{
+			m.TransformPoints(xs, ys, zs, outXs, outYs, outZs, outWs, true);
+			ClobberMemory();
+		});
+		suite.Add("Matrix/TransformVectors(SoA)", BATCH_SIZE, [&]
+		{
+			m.TransformVectors(xs, ys, zs, outXs, outYs, outZs);
+			ClobberMemory();
+		});
+
+		// Factories
+		suite.AddMap("Matrix/CreateTranslation", points, matrices, [](const Vector3& t) { return Matrix::CreateTranslation(t); });
+		suite.AddMap("Matrix/CreateTranslation(x, y, z)", points, matrices, [](const Vector3& t) { return Matrix::CreateTranslation(t.x, t.y, t.z); });
+		suite.AddMap("Matrix/CreateScale", scales, matrices, [](const Vector3& s) { return Matrix::CreateScale(s); });
+		suite.AddMap("Matrix/CreateScale(x, y, z)", scales, matrices, [](const Vector3& s) { return Matrix::CreateScale(s.x, s.y, s.z); });
+		suite.AddMap("Matrix/CreateRotationX", scalars, matrices, [](float angle) { return Matrix::CreateRotationX(angle); });
+		suite.AddMap("Matrix/CreateRotationY", scalars, matrices, [](float angle) { return Matrix::CreateRotationY(angle); });
+		suite.AddMap("Matrix/CreateRotationZ", scalars, matrices, [](float angle) { return Matrix::CreateRotationZ(angle); });
+		suite.AddMap("Matrix/CreateRotationX*Y*Z", angles, matrices, [](const Vector3& r)
+		{
+			return Matrix::CreateRotationX(r.x) * Matrix::CreateRotationY(r.y) * Matrix::CreateRotationZ(r.z);
+		});
+		suite.AddMap("Matrix/CreateRotation/Precise", angles, matrices, [](const Vector3& r) { return Matrix::CreateRotation(r); });
+		suite.AddMap("Matrix/CreateRotation/Fast", angles, matrices, [](const Vector3& r) { return Matrix::CreateRotation(r, TrigMode::Fast); });
+		suite.AddMap("Matrix/CreateRotation(pitch, yaw, roll)", angles, matrices, [](const Vector3& r) { return Matrix::CreateRotation(r.x, r.y, r.z); });
+		suite.Add("Matrix/CreateRotations/Precise", BATCH_SIZE, [&]
+		{
+			Matrix::CreateRotations(angles, matrices, TrigMode::Precise);
+			ClobberMemory();
+		});
+		suite.Add("Matrix/CreateRotations/Fast", BATCH_SIZE, [&]
+		{
+			Matrix::CreateRotations(angles, matrices, TrigMode::Fast);
+			ClobberMemory();
+		});
+		suite.AddMap("Matrix/CreateLookAtLH", cameras, matrices, [](const CameraState& c) { return Matrix::CreateLookAtLH(c.origin, c.forward, c.up); });
+		suite.AddMap("Matrix/CreatePerspectiveFovLH", scales, matrices, [](const Vector3& s) { return Matrix::CreatePerspectiveFovLH(s.x, s.y, 0.1f, 100.f); });
+
+		// Same work as Camera::CalculateViewMatrix, which is private and needs SDL for the rest of Camera
+		suite.AddMap("Camera/CalculateViewMatrix", cameras, matrices, [](const CameraState& c)
+		{
+			const RigidTransform cameraToWorld{ RigidTransform::CreateLookAtLH(c.origin, c.forward, c.up) };
+			return cameraToWorld.Inverse().ToMatrix();
+		});
+		suite.AddMap("Camera/CalculateViewMatrix/GeneralInverse", cameras, matrices, [](const CameraState& c)
+		{
+			return Matrix::Inverse(Matrix::CreateLookAtLH(c.origin, c.forward, c.up));
+		});
+	}
+}
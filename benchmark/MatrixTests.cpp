@@ -0,0 +1,295 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "ScalarReference.h"
+
+#include <cstring>
+
+using namespace dae;
+
+namespace
+{
+	// SIMD results against the DAE_MATRIX_NO_SIMD build. Multiply and transform only differ by fused multiply adds,
+	// inverse also by the order its dot products are summed in.
+	constexpr uint32_t TRANSFORM_MAX_ULPS{ 4 };
+	constexpr uint32_t INVERSE_MAX_ULPS{ 32 };
+	constexpr size_t COUNT{ 1024 };
+
+	const float* GetFloats(const Matrix& m)
+	{
+		return &m[0].x;
+	}
+
+	// Any values, for multiply and transpose
+	std::vector<Matrix> RandomMatrices(uint32_t seed)
+	{
+		return bench::RandomValues<Matrix, 16>(COUNT, seed, [](const float* f)
+		{
+			return Matrix{ { f[0], f[1], f[2], f[3] }, { f[4], f[5], f[6], f[7] }, { f[8], f[9], f[10], f[11] }, { f[12], f[13], f[14], f[15] } };
+		});
+	}
+
+	// Scale, rotation and translation, half of them with a perspective projection after it. Always invertible.
+	std::vector<Matrix> RandomInvertibleMatrices(uint32_t seed)
+	{
+		std::vector<Matrix> matrices{ bench::RandomValues<Matrix, 9>(COUNT, seed, [](const float* f)
+		{
+			return Matrix::CreateScale(1.f + Abs(f[0]) * 0.1f, 1.f + Abs(f[1]) * 0.1f, 1.f + Abs(f[2]) * 0.1f)
+				* Matrix::CreateRotation(f[3], f[4], f[5])
+				* Matrix::CreateTranslation(f[6], f[7], f[8]);
+		}) };
+		const Matrix projection{ Matrix::CreatePerspectiveFovLH(0.4f, 1.33f, 0.1f, 100.f) };
+		for(size_t i{ 0 }; i < matrices.size(); i += 2)
+			matrices[i] *= projection;
+		return matrices;
+	}
+
+	// Largest |a[r][k] * b[k][c]| of every output element, the scale of its rounding error
+	float GetProductMagnitude(const Matrix& a, const Matrix& b, int r, int c)
+	{
+		float magnitude{};
+		for(int k{ 0 }; k < 4; ++k)
+			magnitude = std::max(magnitude, std::abs(a[r][k] * b[k][c]));
+		return magnitude;
+	}
+
+	float GetRowMagnitude(const Matrix& m, int r)
+	{
+		return std::max({ std::abs(m[r].x), std::abs(m[r].y), std::abs(m[r].z), std::abs(m[r].w) });
+	}
+
+	float GetMaxMagnitude(const Matrix& m)
+	{
+		return std::max({ GetRowMagnitude(m, 0), GetRowMagnitude(m, 1), GetRowMagnitude(m, 2), GetRowMagnitude(m, 3) });
+	}
+
+	// Sum of the magnitudes of the terms of a transformed point or vector, the scale of its rounding error
+	float GetTransformMagnitude(const Matrix& m, const Vector3& p, bool isPoint)
+	{
+		return (Vector3{ m[0] } * p.x).Magnitude() + (Vector3{ m[1] } * p.y).Magnitude() + (Vector3{ m[2] } * p.z).Magnitude()
+			+ (isPoint ? Vector3{ m[3] }.Magnitude() : 0.f);
+	}
+
+	// w = 2 exactly, so the divide does not add rounding of its own
+	Matrix GetBatchMatrix(const std::vector<Matrix>& matrices, size_t count)
+	{
+		Matrix m{ matrices[count * 2 + 1] };
+		m[3].w = 2.f;
+		return m;
+	}
+}
+
+namespace test
+{
+	void RunMatrixTests(Suite& suite)
+	{
+		const std::vector<Matrix> a{ RandomMatrices(60) };
+		const std::vector<Matrix> b{ RandomMatrices(61) };
+		const std::vector<Matrix> invertible{ RandomInvertibleMatrices(62) };
+		const std::vector<Vector3> points{ bench::RandomValues<Vector3, 3>(COUNT, 63, [](const float* f) { return Vector3{ f[0], f[1], f[2] }; }) };
+
+		suite.Add("Matrix/SIMD/Multiply", [&]
+		{
+			for(size_t i{ 0 }; i < COUNT; ++i)
+			{
+				const Matrix simd{ a[i] * b[i] };
+				Matrix reference{};
+				scalar::Multiply(GetFloats(a[i]), GetFloats(b[i]), &reference[0].x);
+				for(int r{ 0 }; r < 4; ++r)
+				{
+					for(int c{ 0 }; c < 4; ++c)
+						DAE_CHECK(suite, IsNearUlps(simd[r][c], reference[r][c], TRANSFORM_MAX_ULPS, GetProductMagnitude(a[i], b[i], r, c)));
+				}
+			}
+		});
+
+		suite.Add("Matrix/SIMD/Transpose", [&]
+		{
+			for(size_t i{ 0 }; i < COUNT; ++i)
+			{
+				const Matrix simd{ Matrix::Transpose(a[i]) };
+				Matrix reference{};
+				scalar::Transpose(GetFloats(a[i]), &reference[0].x);
+				DAE_CHECK(suite, std::memcmp(&simd, &reference, sizeof(Matrix)) == 0);
+			}
+		});
+
+		suite.Add("Matrix/SIMD/Inverse", [&]
+		{
+			for(const Matrix& m : invertible)
+			{
+				const Matrix simd{ Matrix::Inverse(m) };
+				Matrix reference{};
+				scalar::Inverse(GetFloats(m), &reference[0].x);
+				for(int r{ 0 }; r < 4; ++r)
+				{
+					for(int c{ 0 }; c < 4; ++c)
+						DAE_CHECK(suite, IsNearUlps(simd[r][c], reference[r][c], INVERSE_MAX_ULPS, GetRowMagnitude(reference, r)));
+				}
+
+				// And it really is the inverse, relative to the largest elements of both (a bound on the condition number)
+				const Matrix identity{ m * simd };
+				const float tolerance{ 1e-5f * GetMaxMagnitude(m) * GetMaxMagnitude(simd) };
+				for(int r{ 0 }; r < 4; ++r)
+				{
+					for(int c{ 0 }; c < 4; ++c)
+						DAE_CHECK(suite, AreEqual(identity[r][c], r == c ? 1.f : 0.f, tolerance));
+				}
+			}
+		});
+
+		suite.Add("Matrix/SIMD/TransformPoint", [&]
+		{
+			for(size_t i{ 0 }; i < COUNT; ++i)
+			{
+				const Matrix& m{ invertible[i] };
+				const Vector3 simd{ m.TransformPoint(points[i]) };
+				const Vector4 simd4{ m.TransformPoint(points[i].ToPoint4()) };
+				Vector3 reference{};
+				Vector4 reference4{};
+				scalar::TransformPoint(GetFloats(m), &points[i].x, &reference.x);
+				scalar::TransformPoint4(GetFloats(m), &points[i].x, &reference4.x);
+
+				const float magnitude{ GetTransformMagnitude(m, points[i], true) };
+				for(int c{ 0 }; c < 3; ++c)
+				{
+					DAE_CHECK(suite, IsNearUlps(simd[c], reference[c], TRANSFORM_MAX_ULPS, magnitude));
+					DAE_CHECK(suite, IsNearUlps(simd4[c], reference4[c], TRANSFORM_MAX_ULPS, magnitude));
+				}
+				DAE_CHECK(suite, IsNearUlps(simd4.w, reference4.w, TRANSFORM_MAX_ULPS, magnitude));
+			}
+		});
+
+		// Batches of every length up to a few packets, so the SIMD loop and the scalar tail both run
+		suite.Add("Matrix/SIMD/TransformPoints(Vector4)", [&]
+		{
+			std::vector<Vector4> batch(COUNT);
+			for(size_t count{ 0 }; count <= 19; ++count)
+			{
+				for(const bool perspectiveDivide : { false, true })
+				{
+					const Matrix m{ GetBatchMatrix(invertible, count) };
+					m.TransformPoints({ points.data(), count }, batch, perspectiveDivide);
+
+					for(size_t i{ 0 }; i < count; ++i)
+					{
+						Vector4 reference{};
+						scalar::TransformPoint4(GetFloats(m), &points[i].x, &reference.x);
+						if(perspectiveDivide)
+							reference = { reference.x / reference.w, reference.y / reference.w, reference.z / reference.w, reference.w };
+
+						const float magnitude{ GetTransformMagnitude(m, points[i], true) };
+						for(int c{ 0 }; c < 4; ++c)
+							DAE_CHECK(suite, IsNearUlps(batch[i][c], reference[c], TRANSFORM_MAX_ULPS, magnitude));
+					}
+				}
+			}
+		});
+
+		// Points and vectors, also in place like Utils::TransformVertices does with the normals. The value past the
+		// batch may not be written.
+		suite.Add("Matrix/SIMD/TransformPoints(Vector3)", [&]
+		{
+			constexpr float SENTINEL{ 12345.f };
+			for(size_t count{ 0 }; count <= 19; ++count)
+			{
+				for(const bool isPoint : { true, false })
+				{
+					const Matrix& m{ invertible[count * 2] };
+					std::vector<Vector3> batch(count + 1, Vector3{ SENTINEL, SENTINEL, SENTINEL });
+					std::vector<Vector3> inPlace(points.begin(), points.begin() + count);
+					if(isPoint)
+					{
+						m.TransformPoints({ points.data(), count }, batch);
+						m.TransformPoints(inPlace, inPlace);
+					}
+					else
+					{
+						m.TransformVectors({ points.data(), count }, batch);
+						m.TransformVectors(inPlace, inPlace);
+					}
+
+					for(size_t i{ 0 }; i < count; ++i)
+					{
+						Vector3 reference{};
+						if(isPoint)
+							scalar::TransformPoint(GetFloats(m), &points[i].x, &reference.x);
+						else
+							scalar::TransformVector(GetFloats(m), &points[i].x, &reference.x);
+
+						const float magnitude{ GetTransformMagnitude(m, points[i], isPoint) };
+						for(int c{ 0 }; c < 3; ++c)
+						{
+							DAE_CHECK(suite, IsNearUlps(batch[i][c], reference[c], TRANSFORM_MAX_ULPS, magnitude));
+							DAE_CHECK(suite, IsNearUlps(inPlace[i][c], reference[c], TRANSFORM_MAX_ULPS, magnitude));
+						}
+					}
+					DAE_CHECK(suite, batch[count].x == SENTINEL && batch[count].y == SENTINEL && batch[count].z == SENTINEL);
+				}
+			}
+		});
+
+		// The 8 and 4 wide SoA packets and the tail, w is written before the divide
+		suite.Add("Matrix/SIMD/TransformPoints(SoA)", [&]
+		{
+			constexpr float SENTINEL{ 12345.f };
+			std::vector<float> xs(COUNT), ys(COUNT), zs(COUNT);
+			for(size_t i{ 0 }; i < COUNT; ++i)
+			{
+				xs[i] = points[i].x;
+				ys[i] = points[i].y;
+				zs[i] = points[i].z;
+			}
+
+			for(size_t count{ 0 }; count <= 19; ++count)
+			{
+				const Matrix m{ GetBatchMatrix(invertible, count) };
+				const std::span<const float> inXs{ xs.data(), count }, inYs{ ys.data(), count }, inZs{ zs.data(), count };
+				for(const int mode : { 0, 1, 2 })
+				{
+					// 0: points, 1: points with the divide, 2: vectors
+					std::vector<float> outXs(count + 1, SENTINEL), outYs(count + 1, SENTINEL), outZs(count + 1, SENTINEL), outWs(count + 1, SENTINEL);
+					if(mode == 2)
+						m.TransformVectors(inXs, inYs, inZs, outXs, outYs, outZs);
+					else
+						m.TransformPoints(inXs, inYs, inZs, outXs, outYs, outZs, outWs, mode == 1);
+
+					for(size_t i{ 0 }; i < count; ++i)
+					{
+						Vector4 reference{};
+						if(mode == 2)
+							scalar::TransformVector(GetFloats(m), &points[i].x, &reference.x);
+						else
+							scalar::TransformPoint4(GetFloats(m), &points[i].x, &reference.x);
+						if(mode == 1)
+							reference = { reference.x / reference.w, reference.y / reference.w, reference.z / reference.w, reference.w };
+
+						const float magnitude{ GetTransformMagnitude(m, points[i], mode != 2) };
+						DAE_CHECK(suite, IsNearUlps(outXs[i], reference.x, TRANSFORM_MAX_ULPS, magnitude));
+						DAE_CHECK(suite, IsNearUlps(outYs[i], reference.y, TRANSFORM_MAX_ULPS, magnitude));
+						DAE_CHECK(suite, IsNearUlps(outZs[i], reference.z, TRANSFORM_MAX_ULPS, magnitude));
+						if(mode != 2)
+							DAE_CHECK(suite, IsNearUlps(outWs[i], reference.w, TRANSFORM_MAX_ULPS, magnitude));
+					}
+					DAE_CHECK(suite, outXs[count] == SENTINEL && outYs[count] == SENTINEL && outZs[count] == SENTINEL && outWs[count] == SENTINEL);
+				}
+			}
+		});
+
+		suite.Add("Matrix/SIMD/TransformVector", [&]
+		{
+			for(size_t i{ 0 }; i < COUNT; ++i)
+			{
+				const Matrix& m{ invertible[i] };
+				const Vector3 simd{ m.TransformVector(points[i]) };
+				Vector3 reference{};
+				scalar::TransformVector(GetFloats(m), &points[i].x, &reference.x);
+
+				const float magnitude{ GetTransformMagnitude(m, points[i], false) };
+				for(int c{ 0 }; c < 3; ++c)
+					DAE_CHECK(suite, IsNearUlps(simd[c], reference[c], TRANSFORM_MAX_ULPS, magnitude));
+			}
+		});
+	}
+}
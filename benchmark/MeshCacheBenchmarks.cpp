@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "MeshCache.h"
+
+using namespace dae;
+
+namespace
+{
+	// Stands in for CreateBuffer, which copies the initial data once
+	struct UploadBuffers
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		void Upload(const MeshCache& cache)
+		{
+			vertices.resize(cache.GetVertices().size());
+			indices.resize(cache.GetIndices().size());
+			std::memcpy(vertices.data(), cache.GetVertices().data(), cache.GetVertices().size_bytes());
+			std::memcpy(indices.data(), cache.GetIndices().data(), cache.GetIndices().size_bytes());
+			bench::DoNotOptimize(vertices.data());
+			bench::DoNotOptimize(indices.data());
+		}
+	};
+
+	void RunCacheFile(bench::Suite& suite, const std::string& name, const std::string& objPath)
+	{
+		const std::string coldName{ "MeshCache/" + name + "/Cold(import + write)" };
+		const std::string warmName{ "MeshCache/" + name + "/Warm(mapped)" };
+		if(!suite.IsEnabled(coldName) && !suite.IsEnabled(warmName))
+			return;
+
+		const std::string cachePath{ (std::filesystem::temp_directory_path() / ("dae_benchmark_" + name + ".dmesh")).string() };
+		std::filesystem::remove(cachePath);
+
+		MeshCache cache{};
+		UploadBuffers buffers{};
+		if(!cache.Load(objPath, cachePath) || !cache.WasRebuilt())
+		{
+			std::fprintf(stderr, "MeshCache benchmark skipped, could not build %s\n", cachePath.c_str());
+			return;
+		}
+
+		cache.Close();
+
+		suite.Add(coldName, 1, [&]
+		{
+			std::filesystem::remove(cachePath);
+			cache.Load(objPath, cachePath);
+			buffers.Upload(cache);
+			cache.Close();
+		});
+		suite.Add(warmName, 1, [&]
+		{
+			cache.Load(objPath, cachePath);
+			buffers.Upload(cache);
+			cache.Close();
+		});
+
+		std::filesystem::remove(cachePath);
+	}
+}
+
+namespace bench
+{
+	void RunMeshCacheBenchmarks(Suite& suite)
+	{
+		RunCacheFile(suite, "vehicle", DAE_RESOURCE_DIR "/vehicle.obj");
+
+		const std::string gridName{ "grid700" };
+		if(suite.IsEnabled("MeshCache/" + gridName + "/Cold(import + write)") || suite.IsEnabled("MeshCache/" + gridName + "/Warm(mapped)"))
+		{
+			const std::string gridPath{ (std::filesystem::temp_directory_path() / "dae_benchmark_grid700.obj").string() };
+			std::ofstream{ gridPath, std::ios::binary } << MakeGridOBJ(700);
+			RunCacheFile(suite, gridName, gridPath);
+			std::filesystem::remove(gridPath);
+		}
+	}
+}
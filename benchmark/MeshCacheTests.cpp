@@ -0,0 +1,302 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "MeshCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace dae;
+
+namespace
+{
+	// An OBJ with its cache next to it in the temp directory, both removed again
+	struct TempMesh
+	{
+		std::string objPath{ (std::filesystem::temp_directory_path() / "dae_test_mesh.obj").string() };
+		std::string cachePath{ MeshCache::GetCachePath(objPath) };
+
+		explicit TempMesh(const std::string& text)
+		{
+			Write(text);
+			std::filesystem::remove(cachePath);
+		}
+		~TempMesh()
+		{
+			std::filesystem::remove(objPath);
+			std::filesystem::remove(cachePath);
+		}
+
+		void Write(const std::string& text) const
+		{
+			std::ofstream{ objPath, std::ios::binary | std::ios::trunc } << text;
+		}
+		void Touch() const
+		{
+			std::filesystem::last_write_time(objPath, std::filesystem::last_write_time(objPath) + std::chrono::seconds{ 5 });
+		}
+	};
+
+	bool IsImport(const MeshCache& cache, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		return cache.GetVertices().size() == vertices.size()
+			&& std::memcmp(cache.GetVertices().data(), vertices.data(), cache.GetVertices().size_bytes()) == 0
+			&& std::equal(indices.begin(), indices.end(), cache.GetIndices().begin(), cache.GetIndices().end());
+	}
+
+	bool Contains(const Vector3& boundsMin, const Vector3& boundsMax, const Vector3& point)
+	{
+		return point.x >= boundsMin.x && point.y >= boundsMin.y && point.z >= boundsMin.z
+			&& point.x <= boundsMax.x && point.y <= boundsMax.y && point.z <= boundsMax.z;
+	}
+}
+
+namespace test
+{
+	void RunMeshCacheTests(Suite& suite)
+	{
+		const std::string grid{ bench::MakeGridOBJ(40) };
+
+		suite.Add("MeshCache/Load/MatchesImport", [&]
+		{
+			const TempMesh mesh{ grid };
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			Utils::ParseOBJText(grid, vertices, indices, Utils::ObjImportOptions{});
+
+			MeshCache cache{};
+			DAE_CHECK(suite, cache.Load(mesh.objPath));
+			DAE_CHECK(suite, cache.WasRebuilt());
+			DAE_CHECK(suite, cache.GetImportStats().vertices == vertices.size());
+			DAE_CHECK(suite, IsImport(cache, vertices, indices));
+
+			// The second load maps what the first one wrote
+			DAE_CHECK(suite, cache.Load(mesh.objPath));
+			DAE_CHECK(suite, !cache.WasRebuilt());
+			DAE_CHECK(suite, IsImport(cache, vertices, indices));
+
+			DAE_CHECK(suite, cache.Open(mesh.cachePath));
+			DAE_CHECK(suite, IsImport(cache, vertices, indices));
+		});
+
+		suite.Add("MeshCache/Load/Bounds", [&]
+		{
+			const TempMesh mesh{ grid };
+			MeshCache cache{};
+			const float lodRatios[]{ 0.5f };
+			if(!DAE_CHECK(suite, cache.Load(mesh.objPath, {}, lodRatios)))
+				return;
+
+			DAE_CHECK(suite, !cache.GetSubmeshes().empty());
+			DAE_CHECK(suite, cache.GetSubmeshes().front().firstIndex == 0 && cache.GetSubmeshes().front().indexCount == 40 * 40 * 6);
+			for(const Vertex& vertex : cache.GetVertices())
+				DAE_CHECK(suite, Contains(cache.GetBoundsMin(), cache.GetBoundsMax(), vertex.position));
+			for(const SubmeshRange& submesh : cache.GetSubmeshes())
+			{
+				if(!DAE_CHECK(suite, submesh.firstIndex + submesh.indexCount <= cache.GetIndices().size()))
+					continue;
+				for(const uint32_t index : cache.GetIndices().subspan(submesh.firstIndex, submesh.indexCount))
+					DAE_CHECK(suite, Contains(submesh.boundsMin, submesh.boundsMax, cache.GetVertices()[index].position));
+			}
+		});
+
+		// Built from the full level only, mapped back as written
+		suite.Add("MeshCache/Load/Meshlets", [&]
+		{
+			const TempMesh mesh{ grid };
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			Utils::ParseOBJText(grid, vertices, indices, Utils::ObjImportOptions{});
+			const MeshletMesh expected{ Utils::BuildMeshlets(vertices, indices) };
+			const auto isExpected = [&](const MeshletMesh& meshletMesh)
+			{
+				return meshletMesh.meshlets.size() == expected.meshlets.size() && !expected.meshlets.empty()
+					&& std::memcmp(meshletMesh.meshlets.data(), expected.meshlets.data(), expected.meshlets.size() * sizeof(Meshlet)) == 0
+					&& std::memcmp(meshletMesh.bounds.data(), expected.bounds.data(), expected.bounds.size() * sizeof(MeshletBounds)) == 0
+					&& meshletMesh.vertices == expected.vertices && meshletMesh.triangles == expected.triangles;
+			};
+
+			MeshCache cache{};
+			const float lodRatios[]{ 0.5f };
+			DAE_CHECK(suite, cache.Load(mesh.objPath, {}, lodRatios) && cache.WasRebuilt());
+			DAE_CHECK(suite, isExpected(cache.CopyMeshletMesh()));
+			DAE_CHECK(suite, cache.Load(mesh.objPath, {}, lodRatios) && !cache.WasRebuilt());
+			const MeshletMesh mapped{ cache.CopyMeshletMesh() };
+			cache.Close();
+			DAE_CHECK(suite, isExpected(mapped));
+			DAE_CHECK(suite, cache.GetMeshlets().empty() && cache.GetMeshletTriangles().empty());
+		});
+
+		// Encoded at import, so a Mesh uploads them from the mapping
+		suite.Add("MeshCache/Load/PackedVertices", [&]
+		{
+			const TempMesh mesh{ grid };
+			MeshCache cache{};
+			for(int load{ 0 }; load < 2; ++load)
+			{
+				if(!DAE_CHECK(suite, cache.Load(mesh.objPath) && cache.WasRebuilt() == (load == 0)))
+					return;
+
+				const std::span<const Vertex> vertices{ cache.GetVertices() };
+				const PositionQuantization& quantization{ cache.GetPositionQuantization() };
+				const PositionQuantization expectedQuantization{ Utils::GetPositionQuantization(vertices) };
+				DAE_CHECK(suite, std::memcmp(&quantization, &expectedQuantization, sizeof(PositionQuantization)) == 0);
+
+				std::vector<PackedVertex> expected(vertices.size());
+				Utils::PackVertices(vertices, quantization, expected);
+				DAE_CHECK(suite, cache.GetPackedVertices().size() == vertices.size());
+				DAE_CHECK(suite, std::memcmp(cache.GetPackedVertices().data(), expected.data(), cache.GetPackedVertices().size_bytes()) == 0);
+			}
+			cache.Close();
+			DAE_CHECK(suite, cache.GetPackedVertices().empty());
+		});
+
+		// Chosen at import: a mesh whose vertices fit gets every index as 16 bit too, at the same position
+		suite.Add("MeshCache/Load/Indices16", [&]
+		{
+			const TempMesh mesh{ grid };
+			MeshCache cache{};
+			const float lodRatios[]{ 0.5f };
+			for(int load{ 0 }; load < 2; ++load)
+			{
+				if(!DAE_CHECK(suite, cache.Load(mesh.objPath, {}, lodRatios) && cache.WasRebuilt() == (load == 0)))
+					return;
+
+				const std::span<const uint32_t> indices{ cache.GetIndices() };
+				DAE_CHECK(suite, std::equal(indices.begin(), indices.end(), cache.GetIndices16().begin(), cache.GetIndices16().end()));
+				DAE_CHECK(suite, cache.GetSubmeshes16().empty());
+			}
+
+			// Nothing to split, the flag only changes the options
+			DAE_CHECK(suite, cache.Load(mesh.objPath, {}, lodRatios, true) && cache.WasRebuilt());
+			DAE_CHECK(suite, cache.GetIndices16().size() == cache.GetIndices().size() && cache.GetSubmeshes16().empty());
+			cache.Close();
+			DAE_CHECK(suite, cache.GetIndices16().empty());
+		});
+
+		// Too many vertices for 16 bit: 32 bit only, or split per level with the 32 bit indices pointing at the copies
+		suite.Add("MeshCache/Load/Split16", [&]
+		{
+			const TempMesh mesh{ bench::MakeGridOBJ(260) };
+			MeshCache cache{};
+			const float lodRatios[]{ 0.5f };
+			if(!DAE_CHECK(suite, cache.Load(mesh.objPath, {}, lodRatios) && cache.GetSubmeshes().size() == 2))
+				return;
+			DAE_CHECK(suite, !Utils::FitsIn16BitIndices(cache.GetVertices().size()));
+			DAE_CHECK(suite, cache.GetIndices16().empty() && cache.GetSubmeshes16().empty());
+
+			// Positions every index draws without the split
+			std::vector<Vector3> drawn{};
+			for(const uint32_t index : cache.GetIndices())
+				drawn.push_back(cache.GetVertices()[index].position);
+
+			for(int load{ 0 }; load < 2; ++load)
+			{
+				if(!DAE_CHECK(suite, cache.Load(mesh.objPath, {}, lodRatios, true) && cache.WasRebuilt() == (load == 0)))
+					return;
+
+				const std::span<const Vertex> vertices{ cache.GetVertices() };
+				const std::span<const uint32_t> indices{ cache.GetIndices() };
+				const std::span<const uint16_t> indices16{ cache.GetIndices16() };
+				const std::span<const Submesh16> submeshes16{ cache.GetSubmeshes16() };
+				if(!DAE_CHECK(suite, indices.size() == drawn.size() && indices16.size() == indices.size() && submeshes16.size() > 2))
+					return;
+
+				bool isSame{ true };
+				for(size_t i{ 0 }; i < indices.size(); ++i)
+					isSame = isSame && std::memcmp(&vertices[indices[i]].position, &drawn[i], sizeof(Vector3)) == 0;
+				DAE_CHECK(suite, isSame);
+
+				// Level after level, each tiled by its submeshes in order
+				size_t next{ 0 };
+				for(const SubmeshRange& level : cache.GetSubmeshes())
+				{
+					uint32_t firstIndex{ level.firstIndex };
+					for(; next < submeshes16.size() && firstIndex < level.firstIndex + level.indexCount; ++next)
+					{
+						const Submesh16& submesh{ submeshes16[next] };
+						DAE_CHECK(suite, submesh.firstIndex == firstIndex && submesh.vertexCount <= Utils::MAX_16BIT_VERTICES);
+						DAE_CHECK(suite, submesh.baseVertex + submesh.vertexCount <= vertices.size());
+						bool isLocal{ true };
+						for(uint32_t i{ submesh.firstIndex }; i < submesh.firstIndex + submesh.indexCount; ++i)
+							isLocal = isLocal && indices16[i] < submesh.vertexCount && indices[i] == submesh.baseVertex + indices16[i];
+						DAE_CHECK(suite, isLocal);
+						firstIndex += submesh.indexCount;
+					}
+					DAE_CHECK(suite, firstIndex == level.firstIndex + level.indexCount);
+				}
+				DAE_CHECK(suite, next == submeshes16.size());
+
+				// The meshlets index the split vertices
+				DAE_CHECK(suite, !cache.GetMeshlets().empty());
+				for(const uint32_t index : cache.GetMeshletVertices())
+					DAE_CHECK(suite, index < vertices.size());
+			}
+		});
+
+		suite.Add("MeshCache/Load/Rebuild", [&]
+		{
+			const TempMesh mesh{ grid };
+			MeshCache cache{};
+			cache.Load(mesh.objPath);
+
+			// Touched but unchanged: the hash matches, the new write time is stored
+			mesh.Touch();
+			DAE_CHECK(suite, cache.Load(mesh.objPath) && !cache.WasRebuilt());
+			DAE_CHECK(suite, cache.Load(mesh.objPath) && !cache.WasRebuilt());
+
+			// Other import options or LOD ratios
+			Utils::ObjImportOptions options{};
+			options.weldEpsilon = 1e-3f;
+			DAE_CHECK(suite, cache.Load(mesh.objPath, options) && cache.WasRebuilt());
+			DAE_CHECK(suite, cache.Load(mesh.objPath, options) && !cache.WasRebuilt());
+			const float lodRatios[]{ 0.5f };
+			DAE_CHECK(suite, cache.Load(mesh.objPath, options, lodRatios) && cache.WasRebuilt());
+			// Only the thread count differs, that gives the same cache
+			options.threadCount = 1;
+			DAE_CHECK(suite, cache.Load(mesh.objPath, options, lodRatios) && !cache.WasRebuilt());
+
+			// Same size, other content
+			std::string changed{ grid };
+			changed[changed.find("v 0.000000") + 2] = '1';
+			mesh.Write(changed);
+			mesh.Touch();
+			DAE_CHECK(suite, cache.Load(mesh.objPath, options, lodRatios) && cache.WasRebuilt());
+			// The first vertex moved to x = 1, which is not on the grid
+			DAE_CHECK(suite, std::any_of(cache.GetVertices().begin(), cache.GetVertices().end(), [](const Vertex& vertex) { return vertex.position.x == 1.f; }));
+		});
+
+		suite.Add("MeshCache/Open/RejectsBadFiles", [&]
+		{
+			const TempMesh mesh{ grid };
+			MeshCache cache{};
+			cache.Load(mesh.objPath);
+			cache.Close();
+			const uintmax_t size{ std::filesystem::file_size(mesh.cachePath) };
+
+			// Arrays running past the end
+			std::filesystem::resize_file(mesh.cachePath, size / 2);
+			DAE_CHECK(suite, !cache.Open(mesh.cachePath));
+			DAE_CHECK(suite, cache.GetVertices().empty() && cache.GetIndices().empty());
+			// Loading through the OBJ replaces it
+			DAE_CHECK(suite, cache.Load(mesh.objPath) && cache.WasRebuilt());
+			cache.Close();
+			DAE_CHECK(suite, std::filesystem::file_size(mesh.cachePath) == size);
+
+			std::ofstream{ mesh.cachePath, std::ios::binary | std::ios::trunc } << "DMSH";
+			DAE_CHECK(suite, !cache.Open(mesh.cachePath));
+			std::ofstream{ mesh.cachePath, std::ios::binary | std::ios::trunc } << std::string(size, 'x');
+			DAE_CHECK(suite, !cache.Open(mesh.cachePath));
+
+			// Without the source any valid cache is used, without either there is nothing to load
+			DAE_CHECK(suite, cache.Load(mesh.objPath) && cache.WasRebuilt());
+			std::filesystem::remove(mesh.objPath);
+			DAE_CHECK(suite, cache.Load(mesh.objPath) && !cache.WasRebuilt());
+			cache.Close();
+			std::filesystem::remove(mesh.cachePath);
+			DAE_CHECK(suite, !cache.Load(mesh.objPath));
+		});
+	}
+}
@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "MappedFile.h"
+#include "Meshlet.h"
+#include "ObjParser.h"
+#include "RigidTransform.h"
+
+using namespace dae;
+
+namespace
+{
+	struct Viewpoint
+	{
+		const char* pName{};
+		Vector3 origin{};
+	};
+
+	// Renderer camera: 45 degrees, 640x480, near 0.1, far 100, looking at the vehicle at the origin
+	Matrix GetViewProjection(const Vector3& origin)
+	{
+		const Vector3 forward{ (-origin).Normalized() };
+		const Vector3 right{ Vector3::Cross(Vector3::UnitY, forward).Normalized() };
+		const Vector3 up{ Vector3::Cross(forward, right) };
+		const Matrix view{ RigidTransform::CreateLookAtLH(origin, forward, up).Inverse().ToMatrix() };
+		return view * Matrix::CreatePerspectiveFovLH(std::tan(22.5f * TO_RADIANS), 640.f / 480.f, 0.1f, 100.f);
+	}
+}
+
+namespace bench
+{
+	void RunMeshletBenchmarks(Suite& suite)
+	{
+		const std::string buildName{ "Meshlet/vehicle/BuildMeshlets" };
+		const std::string cullName{ "Meshlet/vehicle/CullMeshlets" };
+		if(!suite.IsEnabled(buildName) && !suite.IsEnabled(cullName))
+			return;
+
+		const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		if(!file.IsOpen() || !Utils::ParseOBJText(file.GetText(), vertices, indices))
+		{
+			std::fprintf(stderr, "Meshlet benchmark skipped, could not import vehicle.obj\n");
+			return;
+		}
+
+		// Around the vehicle at the renderer's distance, and one close enough to cut off most of it
+		const Viewpoint viewpoints[]
+		{
+			{ "front", { 0.f, 10.f, -50.f } },
+			{ "side", { 50.f, 10.f, 0.f } },
+			{ "back", { 0.f, 10.f, 50.f } },
+			{ "above", { 0.f, 50.f, -5.f } },
+			{ "close", { 5.f, 3.f, -15.f } }
+		};
+
+		// No limit on the normals, the default, cones shaped late (big meshlets) and from the first triangle on (small meshlets)
+		struct Shape
+		{
+			float minNormalDot{};
+			size_t minConeTriangles{};
+		};
+		std::vector<uint32_t> visibleMeshlets{};
+		for(const Shape& shape : { Shape{ -1.f, Utils::MIN_MESHLET_CONE_TRIANGLES }, Shape{ 0.3f, Utils::MIN_MESHLET_CONE_TRIANGLES }, Shape{ 0.3f, 32 }, Shape{ 0.3f, 0 }, Shape{ 0.7f, 0 } })
+		{
+			const MeshletMesh meshletMesh{ Utils::BuildMeshlets(vertices, indices, Utils::MAX_MESHLET_VERTICES, Utils::MAX_MESHLET_TRIANGLES,
+				shape.minNormalDot, shape.minConeTriangles) };
+			size_t conedMeshlets{ 0 };
+			for(const MeshletBounds& bounds : meshletMesh.bounds)
+				conedMeshlets += bounds.coneCutoff < 1.f;
+			std::fprintf(stderr, "vehicle, min normal dot %.1f from %zu triangles: %zu meshlets, %.1f vertices and %.1f triangles on average, %zu with a usable normal cone\n",
+				shape.minNormalDot, shape.minConeTriangles, meshletMesh.meshlets.size(), static_cast<double>(meshletMesh.vertices.size()) / static_cast<double>(meshletMesh.meshlets.size()),
+				static_cast<double>(meshletMesh.triangles.size() / 3) / static_cast<double>(meshletMesh.meshlets.size()), conedMeshlets);
+
+			for(const Viewpoint& viewpoint : viewpoints)
+			{
+				visibleMeshlets.clear();
+				const MeshletCullStats stats{ Utils::CullMeshlets(meshletMesh, GetViewProjection(viewpoint.origin), viewpoint.origin, visibleMeshlets) };
+				std::fprintf(stderr, "  %s: %.1f%% of the triangles culled, %zu meshlets outside the frustum, %zu back facing\n", viewpoint.pName,
+					100.f * stats.GetCulledTriangleRatio(), stats.frustumCulledMeshlets, stats.backfaceCulledMeshlets);
+			}
+		}
+
+		suite.Add(buildName, indices.size() / 3, [&]
+		{
+			bench::DoNotOptimize(Utils::BuildMeshlets(vertices, indices).meshlets.data());
+		});
+
+		const MeshletMesh meshletMesh{ Utils::BuildMeshlets(vertices, indices) };
+		const Matrix viewProjection{ GetViewProjection(viewpoints[0].origin) };
+		suite.Add(cullName, meshletMesh.meshlets.size(), [&]
+		{
+			visibleMeshlets.clear();
+			Utils::CullMeshlets(meshletMesh, viewProjection, viewpoints[0].origin, visibleMeshlets);
+			bench::DoNotOptimize(visibleMeshlets.data());
+		});
+	}
+}
@@ -0,0 +1,246 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "MappedFile.h"
+#include "Meshlet.h"
+#include "ObjParser.h"
+#include "RigidTransform.h"
+
+#include <array>
+
+using namespace dae;
+
+namespace
+{
+	using Triangle = std::array<uint32_t, 3>;
+
+	// Renderer camera looking at the origin, like the meshlet benchmark
+	Matrix GetViewProjection(const Vector3& origin)
+	{
+		const Vector3 forward{ (-origin).Normalized() };
+		const Vector3 right{ Vector3::Cross(Vector3::UnitY, forward).Normalized() };
+		const Vector3 up{ Vector3::Cross(forward, right) };
+		const Matrix view{ RigidTransform::CreateLookAtLH(origin, forward, up).Inverse().ToMatrix() };
+		return view * Matrix::CreatePerspectiveFovLH(std::tan(22.5f * TO_RADIANS), 640.f / 480.f, 0.1f, 100.f);
+	}
+
+	// Every triangle rotated to start at its smallest index, which keeps the winding, then sorted
+	std::vector<Triangle> GetSortedTriangles(std::span<const uint32_t> indices)
+	{
+		std::vector<Triangle> triangles{};
+		for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+		{
+			Triangle triangle{ indices[i], indices[i + 1], indices[i + 2] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	// Limits, contiguous ranges and local indices inside the meshlet
+	bool IsWellFormed(const MeshletMesh& meshletMesh, size_t maxVertices, size_t maxTriangles)
+	{
+		if(meshletMesh.bounds.size() != meshletMesh.meshlets.size())
+			return false;
+
+		uint32_t vertexOffset{ 0 }, triangleOffset{ 0 };
+		for(const Meshlet& meshlet : meshletMesh.meshlets)
+		{
+			if(meshlet.vertexOffset != vertexOffset || meshlet.triangleOffset != triangleOffset || meshlet.vertexCount > maxVertices
+				|| meshlet.triangleCount > maxTriangles || meshlet.triangleCount == 0)
+				return false;
+			for(uint32_t i{ 0 }; i < meshlet.triangleCount * 3; ++i)
+			{
+				if(meshletMesh.triangles[(triangleOffset * 3) + i] >= meshlet.vertexCount)
+					return false;
+			}
+			vertexOffset += meshlet.vertexCount;
+			triangleOffset += meshlet.triangleCount;
+		}
+		return vertexOffset == meshletMesh.vertices.size() && triangleOffset * 3 == meshletMesh.triangles.size();
+	}
+
+	float GetAverageTriangleCount(const MeshletMesh& meshletMesh)
+	{
+		return static_cast<float>(meshletMesh.triangles.size() / 3) / static_cast<float>(std::max<size_t>(meshletMesh.meshlets.size(), 1));
+	}
+
+	// count separate triangles of size 1 along x, spacing apart
+	void MakeScatteredTriangles(size_t count, float spacing, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float x{ static_cast<float>(i) * (1.f + spacing) };
+			for(const Vector3& position : { Vector3{ x, 0.f, 0.f }, Vector3{ x, 1.f, 0.f }, Vector3{ x + 1.f, 0.f, 0.f } })
+			{
+				indices.push_back(static_cast<uint32_t>(vertices.size()));
+				vertices.push_back({ position });
+			}
+		}
+	}
+}
+
+namespace test
+{
+	void RunMeshletTests(Suite& suite)
+	{
+		const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+		std::vector<Vertex> vehicleVertices{};
+		std::vector<uint32_t> vehicleIndices{};
+		const bool hasVehicle{ file.IsOpen() && Utils::ParseOBJText(file.GetText(), vehicleVertices, vehicleIndices) };
+
+		std::vector<Vertex> gridVertices{};
+		std::vector<uint32_t> gridIndices{};
+		Utils::ParseOBJText(bench::MakeGridOBJ(60), gridVertices, gridIndices);
+
+		suite.Add("Meshlet/Build/Limits", [&]
+		{
+			DAE_CHECK(suite, hasVehicle);
+			DAE_CHECK(suite, IsWellFormed(Utils::BuildMeshlets(vehicleVertices, vehicleIndices), Utils::MAX_MESHLET_VERTICES, Utils::MAX_MESHLET_TRIANGLES));
+			DAE_CHECK(suite, IsWellFormed(Utils::BuildMeshlets(vehicleVertices, vehicleIndices, 32, 16), 32, 16));
+			DAE_CHECK(suite, IsWellFormed(Utils::BuildMeshlets(vehicleVertices, vehicleIndices, 64, 124, 0.7f, 0), 64, 124));
+			DAE_CHECK(suite, IsWellFormed(Utils::BuildMeshlets(gridVertices, gridIndices), Utils::MAX_MESHLET_VERTICES, Utils::MAX_MESHLET_TRIANGLES));
+			DAE_CHECK(suite, Utils::BuildMeshlets(gridVertices, std::span<const uint32_t>{}).meshlets.empty());
+		});
+
+		// Same triangles with the same winding, each in exactly one meshlet
+		suite.Add("Meshlet/Build/CoversEveryTriangle", [&]
+		{
+			for(const auto& [vertices, indices] : { std::pair{ &vehicleVertices, &vehicleIndices }, std::pair{ &gridVertices, &gridIndices } })
+			{
+				const std::vector<Triangle> expected{ GetSortedTriangles(*indices) };
+				for(const size_t minConeTriangles : { Utils::MIN_MESHLET_CONE_TRIANGLES, size_t{ 0 } })
+				{
+					const MeshletMesh meshletMesh{ Utils::BuildMeshlets(*vertices, *indices, Utils::MAX_MESHLET_VERTICES, Utils::MAX_MESHLET_TRIANGLES,
+						0.3f, minConeTriangles) };
+					DAE_CHECK(suite, GetSortedTriangles(Utils::GetMeshletIndices(meshletMesh)) == expected);
+				}
+			}
+		});
+
+		// Every vertex in the sphere, every triangle normal in the cone
+		suite.Add("Meshlet/Build/Bounds", [&]
+		{
+			const MeshletMesh meshletMesh{ Utils::BuildMeshlets(vehicleVertices, vehicleIndices) };
+			const std::vector<uint32_t> indices{ Utils::GetMeshletIndices(meshletMesh) };
+			size_t conedMeshlets{ 0 };
+			for(size_t m{ 0 }; m < meshletMesh.meshlets.size(); ++m)
+			{
+				const Meshlet& meshlet{ meshletMesh.meshlets[m] };
+				const MeshletBounds& bounds{ meshletMesh.bounds[m] };
+				for(uint32_t v{ 0 }; v < meshlet.vertexCount; ++v)
+				{
+					const Vector3& position{ vehicleVertices[meshletMesh.vertices[meshlet.vertexOffset + v]].position };
+					DAE_CHECK(suite, (position - bounds.center).Magnitude() <= bounds.radius * 1.0001f + 1e-5f);
+				}
+				if(bounds.coneCutoff >= 1.f)
+					continue;
+
+				++conedMeshlets;
+				const float minDot{ std::sqrt(1.f - bounds.coneCutoff * bounds.coneCutoff) };
+				for(uint32_t t{ meshlet.triangleOffset }; t < meshlet.triangleOffset + meshlet.triangleCount; ++t)
+				{
+					const Vector3& p0{ vehicleVertices[indices[t * 3]].position };
+					const Vector3 normal{ Vector3::Cross(vehicleVertices[indices[t * 3 + 1]].position - p0, vehicleVertices[indices[t * 3 + 2]].position - p0) };
+					if(normal.Magnitude() > 0.f)
+						DAE_CHECK(suite, Vector3::Dot(normal.Normalized(), bounds.coneAxis) >= minDot - 1e-4f);
+				}
+			}
+			DAE_CHECK(suite, conedMeshlets > 0);
+		});
+
+		// The default keeps the meshlets filled, tight cones are opt in and trade size for culling
+		suite.Add("Meshlet/Build/Fill", [&]
+		{
+			const MeshletMesh filled{ Utils::BuildMeshlets(vehicleVertices, vehicleIndices) };
+			const MeshletMesh tight{ Utils::BuildMeshlets(vehicleVertices, vehicleIndices, Utils::MAX_MESHLET_VERTICES, Utils::MAX_MESHLET_TRIANGLES, 0.7f, 0) };
+			DAE_CHECK(suite, GetAverageTriangleCount(filled) > 16.f);
+			DAE_CHECK(suite, GetAverageTriangleCount(tight) < GetAverageTriangleCount(filled));
+
+			// A grid is one connected surface, the triangle limit is reached before the vertex one
+			DAE_CHECK(suite, GetAverageTriangleCount(Utils::BuildMeshlets(gridVertices, gridIndices)) > 60.f);
+		});
+
+		// Separate triangles close together share a meshlet, far apart ones do not
+		suite.Add("Meshlet/Build/JoinsNearbyParts", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			MakeScatteredTriangles(20, 0.1f, vertices, indices);
+			DAE_CHECK(suite, Utils::BuildMeshlets(vertices, indices).meshlets.size() == 1);
+			MakeScatteredTriangles(20, 100.f, vertices, indices);
+			DAE_CHECK(suite, Utils::BuildMeshlets(vertices, indices).meshlets.size() == 20);
+		});
+
+		// A culled meshlet may not have a vertex in the frustum or a triangle facing the camera
+		suite.Add("Meshlet/Cull/Conservative", [&]
+		{
+			const MeshletMesh meshletMesh{ Utils::BuildMeshlets(vehicleVertices, vehicleIndices, Utils::MAX_MESHLET_VERTICES, Utils::MAX_MESHLET_TRIANGLES, 0.7f, 0) };
+			const std::vector<uint32_t> indices{ Utils::GetMeshletIndices(meshletMesh) };
+			size_t frustumCulled{ 0 }, backfaceCulled{ 0 };
+			for(const Vector3& origin : { Vector3{ 0.f, 10.f, -50.f }, Vector3{ 50.f, 10.f, 0.f }, Vector3{ 0.f, 50.f, -5.f }, Vector3{ 5.f, 3.f, -15.f } })
+			{
+				const Matrix viewProjection{ GetViewProjection(origin) };
+				std::vector<uint32_t> visibleMeshlets{};
+				const MeshletCullStats stats{ Utils::CullMeshlets(meshletMesh, viewProjection, origin, visibleMeshlets) };
+				DAE_CHECK(suite, stats.meshlets == meshletMesh.meshlets.size() && stats.triangles == indices.size() / 3);
+				DAE_CHECK(suite, visibleMeshlets.size() + stats.frustumCulledMeshlets + stats.backfaceCulledMeshlets == stats.meshlets);
+				DAE_CHECK(suite, std::is_sorted(visibleMeshlets.begin(), visibleMeshlets.end()));
+				frustumCulled += stats.frustumCulledMeshlets;
+				backfaceCulled += stats.backfaceCulledMeshlets;
+
+				size_t culledTriangles{ 0 };
+				for(uint32_t m{ 0 }; m < meshletMesh.meshlets.size(); ++m)
+				{
+					if(std::binary_search(visibleMeshlets.begin(), visibleMeshlets.end(), m))
+						continue;
+
+					const Meshlet& meshlet{ meshletMesh.meshlets[m] };
+					culledTriangles += meshlet.triangleCount;
+					for(uint32_t t{ meshlet.triangleOffset }; t < meshlet.triangleOffset + meshlet.triangleCount; ++t)
+					{
+						const Vector3& p0{ vehicleVertices[indices[t * 3]].position };
+						const Vector3 normal{ Vector3::Cross(vehicleVertices[indices[t * 3 + 1]].position - p0, vehicleVertices[indices[t * 3 + 2]].position - p0) };
+						const bool isBackFacing{ Vector3::Dot(normal, p0 - origin) >= -1e-4f * normal.Magnitude() };
+
+						bool isOutside{ true };
+						for(uint32_t c{ 0 }; c < 3; ++c)
+						{
+							const Vector4 clip{ viewProjection.TransformPoint(Vector4{ vehicleVertices[indices[t * 3 + c]].position, 1.f }) };
+							isOutside = isOutside && !(std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && clip.z >= 0.f && clip.z <= clip.w);
+						}
+						DAE_CHECK(suite, isBackFacing || isOutside);
+					}
+				}
+				DAE_CHECK(suite, stats.culledTriangles == culledTriangles);
+			}
+			DAE_CHECK(suite, frustumCulled > 0 && backfaceCulled > 0);
+		});
+
+		// The default cones still cull the back of the vehicle from every side
+		suite.Add("Meshlet/Cull/Default", [&]
+		{
+			const MeshletMesh meshletMesh{ Utils::BuildMeshlets(vehicleVertices, vehicleIndices) };
+			for(const Vector3& origin : { Vector3{ 0.f, 10.f, -50.f }, Vector3{ 50.f, 10.f, 0.f }, Vector3{ 0.f, 10.f, 50.f }, Vector3{ 0.f, 50.f, -5.f } })
+			{
+				std::vector<uint32_t> visibleMeshlets{};
+				const MeshletCullStats stats{ Utils::CullMeshlets(meshletMesh, GetViewProjection(origin), origin, visibleMeshlets) };
+				DAE_CHECK(suite, stats.frustumCulledMeshlets == 0 && stats.GetCulledTriangleRatio() > 0.05f);
+			}
+		});
+
+		suite.Add("Meshlet/Cull/TwoSided", [&]
+		{
+			const MeshletMesh meshletMesh{ Utils::BuildMeshlets(vehicleVertices, vehicleIndices, Utils::MAX_MESHLET_VERTICES, Utils::MAX_MESHLET_TRIANGLES, 0.7f, 0) };
+			const Vector3 origin{ 0.f, 10.f, -50.f };
+			std::vector<uint32_t> visibleMeshlets{};
+			const MeshletCullStats stats{ Utils::CullMeshlets(meshletMesh, GetViewProjection(origin), origin, visibleMeshlets, false) };
+			DAE_CHECK(suite, stats.backfaceCulledMeshlets == 0);
+			DAE_CHECK(suite, visibleMeshlets.size() == meshletMesh.meshlets.size() - stats.frustumCulledMeshlets);
+		});
+	}
+}
@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "LegacyObjParser.h"
+
+#include <cstring>
+#include <thread>
+#include "MappedFile.h"
+#include "ObjParser.h"
+
+using namespace dae;
+
+namespace
+{
+	size_t CountLines(std::string_view text)
+	{
+		return static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+	}
+
+	bool AreEqual(const std::vector<Vertex>& v1, const std::vector<Vertex>& v2)
+	{
+		return v1.size() == v2.size() && (v1.empty() || std::memcmp(v1.data(), v2.data(), v1.size() * sizeof(Vertex)) == 0);
+	}
+
+	// The legacy parser only has the cheap tangents, everything else has to match
+	bool HaveEqualAttributes(const std::vector<Vertex>& v1, const std::vector<Vertex>& v2)
+	{
+		return std::equal(v1.begin(), v1.end(), v2.begin(), v2.end(), [](const Vertex& a, const Vertex& b)
+		{
+			return std::memcmp(&a.position, &b.position, sizeof(Vector3)) == 0 && std::memcmp(&a.normal, &b.normal, sizeof(Vector3)) == 0
+				&& std::memcmp(&a.uv, &b.uv, sizeof(Vector2)) == 0;
+		});
+	}
+
+	void RunObjThreads(bench::Suite& suite, const std::string& name, size_t quadsPerSide)
+	{
+		const std::string sequentialName{ "OBJ/" + name + "/ParseOBJText(1 thread)" };
+		// At least two so the chunked path runs even on a single core machine
+		const uint32_t threadCount{ std::max(std::thread::hardware_concurrency(), 2u) };
+		const std::string parallelName{ "OBJ/" + name + "/ParseOBJText(" + std::to_string(threadCount) + " threads)" };
+		// The text is tens of MB, only made when something runs
+		if(!suite.IsEnabled(sequentialName) && !suite.IsEnabled(parallelName))
+			return;
+
+		const std::string text{ bench::MakeGridOBJ(quadsPerSide) };
+		const size_t lineCount{ CountLines(text) };
+
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		std::vector<Vertex> sequentialVertices{};
+		std::vector<uint32_t> sequentialIndices{};
+
+		// The parallel import has to match the sequential one exactly
+		Utils::ObjImportOptions sequential{};
+		sequential.threadCount = 1;
+		Utils::ObjImportOptions parallel{};
+		parallel.threadCount = threadCount;
+		Utils::ParseOBJText(text, sequentialVertices, sequentialIndices, sequential);
+		Utils::ParseOBJText(text, vertices, indices, parallel);
+		if(!AreEqual(vertices, sequentialVertices) || indices != sequentialIndices)
+			std::fprintf(stderr, "Parallel OBJ import differs from the sequential one on %s\n", name.c_str());
+
+		suite.Add(sequentialName, lineCount, [&]
+		{
+			Utils::ParseOBJText(text, vertices, indices, sequential);
+			bench::DoNotOptimize(vertices.data());
+		});
+		suite.Add(parallelName, lineCount, [&]
+		{
+			Utils::ParseOBJText(text, vertices, indices, parallel);
+			bench::DoNotOptimize(vertices.data());
+		});
+	}
+
+	void RunObjFile(bench::Suite& suite, const std::string& name, const std::string& path)
+	{
+		const MappedFile file{ path };
+		if(!file.IsOpen())
+		{
+			std::fprintf(stderr, "OBJ benchmark skipped, could not open %s\n", path.c_str());
+			return;
+		}
+
+		// Ops are lines of the file
+		const size_t lineCount{ CountLines(file.GetText()) };
+
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		std::vector<Vertex> legacyVertices{};
+		std::vector<uint32_t> legacyIndices{};
+		// Without welding or reordering the attributes and indices must match the old parser exactly
+		Utils::ObjImportOptions unwelded{};
+		unwelded.weldVertices = false;
+		Utils::ObjImportOptions unoptimized{ unwelded };
+		unoptimized.optimizeVertexCache = false;
+		bench::LegacyParseOBJ(path, legacyVertices, legacyIndices);
+		Utils::ParseOBJText(file.GetText(), vertices, indices, unoptimized);
+		if(!HaveEqualAttributes(vertices, legacyVertices) || indices != legacyIndices)
+			std::fprintf(stderr, "OBJ parsers disagree on %s\n", path.c_str());
+
+		Utils::ObjImportOptions epsilonWelded{};
+		epsilonWelded.weldEpsilon = 1e-5f;
+		Utils::ObjImportStats stats{};
+		Utils::ParseOBJText(file.GetText(), vertices, indices, epsilonWelded, &stats);
+		std::fprintf(stderr, "%s: %zu face corners, %zu vertices after index welding, %zu after epsilon welding (%.2fx reduction)\n",
+			name.c_str(), stats.faceCorners, stats.indexWeldedVertices, stats.vertices, stats.GetVertexReductionRatio());
+
+		suite.Add("OBJ/" + name + "/Legacy(ifstream)", lineCount, [&]
+		{
+			bench::LegacyParseOBJ(path, vertices, indices);
+			bench::DoNotOptimize(vertices.data());
+		});
+		suite.Add("OBJ/" + name + "/ParseOBJ(mapped)", lineCount, [&]
+		{
+			const MappedFile mapped{ path };
+			Utils::ParseOBJText(mapped.GetText(), vertices, indices);
+			bench::DoNotOptimize(vertices.data());
+		});
+		suite.Add("OBJ/" + name + "/ParseOBJText(in memory)", lineCount, [&]
+		{
+			Utils::ParseOBJText(file.GetText(), vertices, indices);
+			bench::DoNotOptimize(vertices.data());
+		});
+		suite.Add("OBJ/" + name + "/ParseOBJText(in memory, no welding)", lineCount, [&]
+		{
+			Utils::ParseOBJText(file.GetText(), vertices, indices, unwelded);
+			bench::DoNotOptimize(vertices.data());
+		});
+		suite.Add("OBJ/" + name + "/ParseOBJText(in memory, epsilon welding)", lineCount, [&]
+		{
+			Utils::ParseOBJText(file.GetText(), vertices, indices, epsilonWelded);
+			bench::DoNotOptimize(vertices.data());
+		});
+	}
+}
+
+namespace bench
+{
+	void RunObjBenchmarks(Suite& suite)
+	{
+		RunObjFile(suite, "vehicle", DAE_RESOURCE_DIR "/vehicle.obj");
+		RunObjFile(suite, "fireFX", DAE_RESOURCE_DIR "/fireFX.obj");
+		RunObjThreads(suite, "grid700", 700);
+	}
+}
@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "ObjParser.h"
+
+#include <cstring>
+
+using namespace dae;
+
+namespace
+{
+	// Unit cube, 8 positions, 6 normals and 4 uvs shared between the faces: 24 distinct face corners
+	constexpr const char* CUBE_OBJ{
+		"v -1 -1 -1\nv 1 -1 -1\nv 1 1 -1\nv -1 1 -1\nv -1 -1 1\nv 1 -1 1\nv 1 1 1\nv -1 1 1\n"
+		"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+		"vn 0 0 -1\nvn 0 0 1\nvn -1 0 0\nvn 1 0 0\nvn 0 -1 0\nvn 0 1 0\n"
+		"f 1/1/1 4/4/1 3/3/1 2/2/1\n"
+		"f 5/1/2 6/2/2 7/3/2 8/4/2\n"
+		"f 1/1/3 5/2/3 8/3/3 4/4/3\n"
+		"f 2/1/4 3/4/4 7/3/4 6/2/4\n"
+		"f 1/1/5 2/2/5 6/3/5 5/4/5\n"
+		"f 4/1/6 8/2/6 7/3/6 3/4/6\n" };
+
+	// Two quads on one edge, the second repeats the shared positions 1e-6 off instead of indexing them
+	constexpr const char* SPLIT_EDGE_OBJ{
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 1.000001 0 0\nv 1.000001 1 0\nv 2 0 0\nv 2 1 0\n"
+		"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvt 2 0\nvt 2 1\n"
+		"vn 0 0 1\n"
+		"f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+		"f 5/2/1 7/5/1 8/6/1 6/3/1\n" };
+
+	bool HaveEqualAttributes(const Vertex& a, const Vertex& b)
+	{
+		return std::memcmp(&a.position, &b.position, sizeof(Vector3)) == 0 && std::memcmp(&a.normal, &b.normal, sizeof(Vector3)) == 0
+			&& std::memcmp(&a.uv, &b.uv, sizeof(Vector2)) == 0;
+	}
+
+	// bench::MakeGridOBJ with the faces to the previous row right after each row of vertices, indexed from the end
+	// (negative indices). Resolving those needs the attribute counts of every chunk before the face.
+	std::string MakeRelativeGridOBJ(size_t quadsPerSide)
+	{
+		const size_t verticesPerSide{ quadsPerSide + 1 };
+		std::string text{};
+		char line[128]{};
+		for(size_t y{ 0 }; y < verticesPerSide; ++y)
+		{
+			for(size_t x{ 0 }; x < verticesPerSide; ++x)
+			{
+				const float u{ static_cast<float>(x) / static_cast<float>(quadsPerSide) };
+				const float v{ static_cast<float>(y) / static_cast<float>(quadsPerSide) };
+				const int length{ std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+					u * 100.f, std::sin(u * 20.f) * std::cos(v * 20.f), v * 100.f, u, v, 0.f, 1.f, 0.f) };
+				text.append(line, static_cast<size_t>(length));
+			}
+			if(y == 0)
+				continue;
+
+			for(size_t x{ 0 }; x < quadsPerSide; ++x)
+			{
+				const long long i0{ -static_cast<long long>(2 * verticesPerSide - x) };
+				const long long i1{ i0 + 1 };
+				const long long i2{ i1 + static_cast<long long>(verticesPerSide) };
+				const long long i3{ i0 + static_cast<long long>(verticesPerSide) };
+				const int length{ std::snprintf(line, sizeof(line), "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+					i0, i0, i0, i1, i1, i1, i2, i2, i2, i3, i3, i3) };
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+		return text;
+	}
+
+	bool AreEqual(const std::vector<Vertex>& v1, const std::vector<Vertex>& v2)
+	{
+		return v1.size() == v2.size() && (v1.empty() || std::memcmp(v1.data(), v2.data(), v1.size() * sizeof(Vertex)) == 0);
+	}
+
+	Utils::ObjImportOptions GetUnoptimizedOptions(bool weldVertices)
+	{
+		Utils::ObjImportOptions options{};
+		options.weldVertices = weldVertices;
+		options.optimizeVertexCache = false;
+		return options;
+	}
+}
+
+namespace test
+{
+	void RunObjTests(Suite& suite)
+	{
+		suite.Add("OBJ/Weld/IndexTriples", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			Utils::ObjImportStats stats{};
+			DAE_CHECK(suite, Utils::ParseOBJText(CUBE_OBJ, vertices, indices, Utils::ObjImportOptions{}, &stats));
+			// Corners of the polygons, before the quads are triangulated
+			DAE_CHECK(suite, stats.faceCorners == 24);
+			DAE_CHECK(suite, stats.indexWeldedVertices == 24);
+			DAE_CHECK(suite, stats.vertices == 24 && vertices.size() == 24);
+			DAE_CHECK(suite, stats.triangles == 12 && indices.size() == 36);
+			DAE_CHECK(suite, std::all_of(indices.begin(), indices.end(), [&](uint32_t index) { return index < vertices.size(); }));
+
+			const std::string grid{ bench::MakeGridOBJ(10) };
+			DAE_CHECK(suite, Utils::ParseOBJText(grid, vertices, indices, Utils::ObjImportOptions{}, &stats));
+			DAE_CHECK(suite, stats.faceCorners == 10 * 10 * 4);
+			DAE_CHECK(suite, vertices.size() == 11 * 11);
+			DAE_CHECK(suite, indices.size() == 10 * 10 * 6);
+		});
+
+		// Welding only shares vertices, every triangle corner keeps its attributes
+		suite.Add("OBJ/Weld/KeepsCorners", [&]
+		{
+			for(const std::string& text : { std::string{ CUBE_OBJ }, bench::MakeGridOBJ(20) })
+			{
+				std::vector<Vertex> welded{}, unwelded{};
+				std::vector<uint32_t> weldedIndices{}, unweldedIndices{};
+				Utils::ObjImportStats stats{};
+				Utils::ParseOBJText(text, welded, weldedIndices, GetUnoptimizedOptions(true));
+				Utils::ParseOBJText(text, unwelded, unweldedIndices, GetUnoptimizedOptions(false), &stats);
+
+				DAE_CHECK(suite, unwelded.size() == stats.faceCorners);
+				DAE_CHECK(suite, welded.size() <= unwelded.size());
+				if(!DAE_CHECK(suite, weldedIndices.size() == unweldedIndices.size()))
+					continue;
+				for(size_t i{ 0 }; i < weldedIndices.size(); ++i)
+					DAE_CHECK(suite, HaveEqualAttributes(welded[weldedIndices[i]], unwelded[unweldedIndices[i]]));
+			}
+		});
+
+		suite.Add("OBJ/Weld/Epsilon", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			Utils::ObjImportStats stats{};
+			Utils::ParseOBJText(SPLIT_EDGE_OBJ, vertices, indices, Utils::ObjImportOptions{}, &stats);
+			DAE_CHECK(suite, stats.indexWeldedVertices == 8 && vertices.size() == 8);
+
+			Utils::ObjImportOptions options{};
+			options.weldEpsilon = 1e-4f;
+			Utils::ParseOBJText(SPLIT_EDGE_OBJ, vertices, indices, options, &stats);
+			DAE_CHECK(suite, stats.indexWeldedVertices == 8);
+			DAE_CHECK(suite, stats.vertices == 6 && vertices.size() == 6);
+			DAE_CHECK(suite, indices.size() == 12);
+		});
+
+		suite.Add("OBJ/Weld/DropsCollapsedTriangles", [&]
+		{
+			std::vector<Vertex> vertices{
+				{ { 0.f, 0.f, 0.f } }, { { 1e-6f, 0.f, 0.f } }, { { 0.f, 1.f, 0.f } }, { { 1.f, 1.f, 0.f } }, { { 1.f, 0.f, 0.f } }
+			};
+			// The first triangle loses an edge when vertex 0 and 1 merge, the second one stays
+			std::vector<uint32_t> indices{ 0, 1, 2, 1, 3, 4 };
+			const size_t vertexCount{ Utils::WeldVertices(vertices, indices, 1e-4f) };
+
+			DAE_CHECK(suite, vertexCount == 4 && vertices.size() == 4);
+			if(DAE_CHECK(suite, indices.size() == 3))
+			{
+				DAE_CHECK(suite, vertices[indices[1]].position.x == 1.f && vertices[indices[1]].position.y == 1.f);
+				DAE_CHECK(suite, vertices[indices[2]].position.x == 1.f && vertices[indices[2]].position.y == 0.f);
+			}
+		});
+
+		// Both texts are several MB, so they are split into chunks. The result may not depend on the thread count.
+		suite.Add("OBJ/Parallel/MatchesSequential", [&]
+		{
+			for(const std::string& text : { bench::MakeGridOBJ(300), MakeRelativeGridOBJ(300) })
+			{
+				std::vector<Vertex> sequentialVertices{};
+				std::vector<uint32_t> sequentialIndices{};
+				Utils::ObjImportOptions options{};
+				options.threadCount = 1;
+				DAE_CHECK(suite, Utils::ParseOBJText(text, sequentialVertices, sequentialIndices, options));
+				DAE_CHECK(suite, sequentialVertices.size() == 301 * 301);
+
+				for(const uint32_t threadCount : { 2u, 3u, 8u })
+				{
+					std::vector<Vertex> vertices{};
+					std::vector<uint32_t> indices{};
+					options.threadCount = threadCount;
+					DAE_CHECK(suite, Utils::ParseOBJText(text, vertices, indices, options));
+					DAE_CHECK(suite, AreEqual(vertices, sequentialVertices));
+					DAE_CHECK(suite, indices == sequentialIndices);
+				}
+			}
+		});
+
+		// Same vertices and faces in the same order, only the indexing differs
+		suite.Add("OBJ/Parallel/RelativeIndices", [&]
+		{
+			std::vector<Vertex> absoluteVertices{}, relativeVertices{};
+			std::vector<uint32_t> absoluteIndices{}, relativeIndices{};
+			Utils::ObjImportOptions options{};
+			options.threadCount = 1;
+			DAE_CHECK(suite, Utils::ParseOBJText(bench::MakeGridOBJ(300), absoluteVertices, absoluteIndices, options));
+			options.threadCount = 4;
+			DAE_CHECK(suite, Utils::ParseOBJText(MakeRelativeGridOBJ(300), relativeVertices, relativeIndices, options));
+			DAE_CHECK(suite, AreEqual(relativeVertices, absoluteVertices));
+			DAE_CHECK(suite, relativeIndices == absoluteIndices);
+		});
+
+		suite.Add("OBJ/Parallel/MalformedFails", [&]
+		{
+			// The bad index sits in the last chunk, every chunk has to report back
+			const std::string text{ bench::MakeGridOBJ(300) + "f 1/1/1 2/2/2 999999999/1/1\n" };
+			for(const uint32_t threadCount : { 1u, 4u })
+			{
+				std::vector<Vertex> vertices{};
+				std::vector<uint32_t> indices{};
+				Utils::ObjImportOptions options{};
+				options.threadCount = threadCount;
+				DAE_CHECK(suite, !Utils::ParseOBJText(text, vertices, indices, options));
+			}
+		});
+	}
+}
@@ -0,0 +1,79 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "OcclusionCuller.h"
+#include "RigidTransform.h"
+
+using namespace dae;
+
+namespace
+{
+	// Boxes scattered behind and around the vehicle, as seen from the renderer camera
+	BoundsSoA MakeBounds(size_t count)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 4, 22, 0.f, 1.f) };
+		BoundsSoA bounds{};
+		bounds.Resize(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 4] };
+			const float halfSize{ 0.25f + pRandom[3] * 0.75f };
+			bounds.Set(i, Affine3x4{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ,
+				Vector3{ pRandom[0] * 40.f - 20.f, pRandom[1] * 30.f - 15.f, pRandom[2] * 40.f + 5.f } },
+				Vector3{ -halfSize, -halfSize, -halfSize }, Vector3{ halfSize, halfSize, halfSize }, halfSize * std::sqrt(3.f));
+		}
+		return bounds;
+	}
+}
+
+namespace bench
+{
+	void RunOcclusionBenchmarks(Suite& suite)
+	{
+		const std::string renderName{ "Occlusion/vehicle/RenderOccluders" };
+		const std::string testName{ "Occlusion/10k/TestBounds" };
+		if(!suite.IsEnabled(renderName) && !suite.IsEnabled(testName))
+			return;
+
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+		if(!file.IsOpen() || !Utils::ParseOBJText(file.GetText(), vertices, indices))
+			return;
+
+		std::vector<Vector3> positions(vertices.size());
+		for(size_t i{ 0 }; i < vertices.size(); ++i)
+			positions[i] = vertices[i].position;
+
+		// Renderer camera: 45 degrees, 640x480, near 0.1, far 100, 50 units in front of the vehicle
+		const Matrix viewProjection{ RigidTransform{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, Vector3{ 0.f, 0.f, -50.f } }.Inverse().ToMatrix()
+			* Matrix::CreatePerspectiveFovLH(std::tan(22.5f * TO_RADIANS), 640.f / 480.f, 0.1f, 100.f) };
+
+		constexpr size_t count{ 10000 };
+		const BoundsSoA bounds{ MakeBounds(count) };
+		std::vector<uint8_t> visible(count);
+
+		OcclusionCuller culler{};
+		culler.AddOccluder(positions, indices, viewProjection);
+		const size_t triangleCount{ culler.RenderOccluders() };
+
+		const CullStats frustumStats{ Utils::CullBounds(Frustum::FromViewProjection(viewProjection), bounds, visible) };
+		const CullStats stats{ culler.TestBounds(bounds, viewProjection, visible) };
+		std::fprintf(stderr, "Occlusion: %zu occluder triangles, %zu of %zu objects in the frustum, %zu of them occluded\n",
+			triangleCount, frustumStats.tested - frustumStats.culled, frustumStats.tested, stats.culled);
+
+		suite.Add(renderName, triangleCount, [&]
+		{
+			culler.Clear();
+			culler.AddOccluder(positions, indices, viewProjection);
+			bench::DoNotOptimize(culler.RenderOccluders());
+		});
+		suite.Add(testName, count, [&]
+		{
+			std::fill(visible.begin(), visible.end(), uint8_t{ 1 });
+			bench::DoNotOptimize(culler.TestBounds(bounds, viewProjection, visible).culled);
+		});
+	}
+}
@@ -0,0 +1,279 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "OcclusionCuller.h"
+#include "RigidTransform.h"
+
+#include <cfloat>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace dae;
+
+namespace
+{
+	// Renderer projection: 45 degrees, 640x480, near 0.1, far 100
+	Matrix GetProjection()
+	{
+		return Matrix::CreatePerspectiveFovLH(std::tan(22.5f * TO_RADIANS), 640.f / 480.f, 0.1f, 100.f);
+	}
+
+	Matrix GetViewProjection(const Vector3& origin)
+	{
+		const Vector3 forward{ (-origin).Normalized() };
+		const Vector3 right{ Vector3::Cross(Vector3::UnitY, forward).Normalized() };
+		const Vector3 up{ Vector3::Cross(forward, right) };
+		return RigidTransform::CreateLookAtLH(origin, forward, up).Inverse().ToMatrix() * GetProjection();
+	}
+
+	// Boxes scattered through the space the camera looks into, half of them behind the vehicle
+	BoundsSoA MakeBounds(size_t count, const Vector3& origin)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 4, 22, 0.f, 1.f) };
+		const Vector3 forward{ (-origin).Normalized() };
+		BoundsSoA bounds{};
+		bounds.Resize(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 4] };
+			const float halfSize{ 0.25f + pRandom[3] * 0.75f };
+			const Vector3 center{ Vector3{ pRandom[0] * 40.f - 20.f, pRandom[1] * 30.f - 15.f, pRandom[2] * 40.f - 20.f } + forward * 15.f };
+			bounds.Set(i, Affine3x4{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, center },
+				Vector3{ -halfSize, -halfSize, -halfSize }, Vector3{ halfSize, halfSize, halfSize }, halfSize * std::sqrt(3.f));
+		}
+		return bounds;
+	}
+
+	// Axis aligned square of side 2 * halfSize at depth z, facing the camera at the origin
+	void AddSquare(float centerX, float centerY, float z, float halfSize, std::vector<Vector3>& positions, std::vector<uint32_t>& indices)
+	{
+		const uint32_t first{ static_cast<uint32_t>(positions.size()) };
+		positions.push_back({ centerX - halfSize, centerY - halfSize, z });
+		positions.push_back({ centerX - halfSize, centerY + halfSize, z });
+		positions.push_back({ centerX + halfSize, centerY + halfSize, z });
+		positions.push_back({ centerX + halfSize, centerY - halfSize, z });
+		for(const uint32_t corner : { 0u, 1u, 2u, 0u, 2u, 3u })
+			indices.push_back(first + corner);
+	}
+
+	bool IsBoxVisible(const OcclusionCuller& culler, const Vector3& center, float halfSize, const Matrix& viewProjection)
+	{
+		const Vector3 extents{ halfSize, halfSize, halfSize };
+		return culler.IsVisible(center - extents, center + extents, viewProjection);
+	}
+
+	std::string ReadFile(const std::string& path)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	}
+
+	// Plain z-buffer at the culler's resolution, the nearest depth of every pixel center
+	std::vector<float> RasterizeReference(const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, const Matrix& worldViewProjection, uint32_t width, uint32_t height)
+	{
+		std::vector<float> depths(size_t{ width } * height, 1.f);
+		std::vector<Vector3> screen(positions.size());
+		for(size_t i{ 0 }; i < positions.size(); ++i)
+		{
+			const Vector4 clip{ worldViewProjection.TransformPoint(positions[i].x, positions[i].y, positions[i].z, 1.f) };
+			screen[i] = { (clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(width), (0.5f - clip.y / clip.w * 0.5f) * static_cast<float>(height), clip.z / clip.w };
+		}
+
+		for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+		{
+			const Vector3& p0{ screen[indices[i]] };
+			const Vector3& p1{ screen[indices[i + 1]] };
+			const Vector3& p2{ screen[indices[i + 2]] };
+			const float area{ (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y) };
+			if(area == 0.f)
+				continue;
+
+			const int minX{ std::max(static_cast<int>(std::min({ p0.x, p1.x, p2.x })), 0) };
+			const int minY{ std::max(static_cast<int>(std::min({ p0.y, p1.y, p2.y })), 0) };
+			const int maxX{ std::min(static_cast<int>(std::max({ p0.x, p1.x, p2.x })), static_cast<int>(width) - 1) };
+			const int maxY{ std::min(static_cast<int>(std::max({ p0.y, p1.y, p2.y })), static_cast<int>(height) - 1) };
+			for(int y{ minY }; y <= maxY; ++y)
+			{
+				for(int x{ minX }; x <= maxX; ++x)
+				{
+					const float px{ static_cast<float>(x) + 0.5f };
+					const float py{ static_cast<float>(y) + 0.5f };
+					const float w0{ ((p1.x - px) * (p2.y - py) - (p2.x - px) * (p1.y - py)) / area };
+					const float w1{ ((p2.x - px) * (p0.y - py) - (p0.x - px) * (p2.y - py)) / area };
+					const float w2{ 1.f - w0 - w1 };
+					if(w0 < 0.f || w1 < 0.f || w2 < 0.f)
+						continue;
+
+					float& depth{ depths[size_t(y) * width + x] };
+					depth = std::min(depth, w0 * p0.z + w1 * p1.z + w2 * p2.z);
+				}
+			}
+		}
+		return depths;
+	}
+
+	// An occluded box must be behind the reference depth on every pixel of its screen rectangle
+	bool IsBehindReference(const std::vector<float>& depths, uint32_t width, uint32_t height, const Vector3& boundsMin, const Vector3& boundsMax, const Matrix& viewProjection)
+	{
+		float minX{ FLT_MAX }, minY{ FLT_MAX }, maxX{ -FLT_MAX }, maxY{ -FLT_MAX }, zMin{ FLT_MAX };
+		for(int corner{ 0 }; corner < 8; ++corner)
+		{
+			const Vector4 clip{ viewProjection.TransformPoint((corner & 1) ? boundsMax.x : boundsMin.x,
+				(corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z, 1.f) };
+			const float x{ (clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(width) };
+			const float y{ (0.5f - clip.y / clip.w * 0.5f) * static_cast<float>(height) };
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+			zMin = std::min(zMin, clip.z / clip.w);
+		}
+
+		for(int y{ std::max(static_cast<int>(minY), 0) }; y <= std::min(static_cast<int>(maxY), static_cast<int>(height) - 1); ++y)
+		{
+			for(int x{ std::max(static_cast<int>(minX), 0) }; x <= std::min(static_cast<int>(maxX), static_cast<int>(width) - 1); ++x)
+			{
+				if(depths[size_t(y) * width + x] >= zMin)
+					return false;
+			}
+		}
+		return true;
+	}
+}
+
+namespace test
+{
+	void RunOcclusionTests(Suite& suite)
+	{
+		// A wall filling the screen at z 10: behind it is hidden, in front of it and through the gap is not
+		suite.Add("Occlusion/Wall/HidesWhatIsBehind", [&]
+		{
+			std::vector<Vector3> positions{};
+			std::vector<uint32_t> indices{};
+			AddSquare(-11.f, 0.f, 10.f, 10.f, positions, indices);
+			AddSquare(11.f, 0.f, 10.f, 10.f, positions, indices);
+			const Matrix viewProjection{ GetProjection() };
+
+			OcclusionCuller culler{};
+			culler.AddOccluder(positions, indices, viewProjection);
+			DAE_CHECK(suite, culler.RenderOccluders() == 4);
+
+			DAE_CHECK(suite, !IsBoxVisible(culler, { -6.f, 1.f, 20.f }, 1.f, viewProjection));
+			DAE_CHECK(suite, !IsBoxVisible(culler, { 12.f, -1.f, 60.f }, 3.f, viewProjection));
+			DAE_CHECK(suite, IsBoxVisible(culler, { -3.f, 1.f, 5.f }, 1.f, viewProjection));
+			// Crossing the wall, and behind the 2 unit gap between the two halves
+			DAE_CHECK(suite, IsBoxVisible(culler, { 3.f, 0.f, 10.f }, 1.f, viewProjection));
+			DAE_CHECK(suite, IsBoxVisible(culler, { 0.f, 0.f, 20.f }, 0.5f, viewProjection));
+			// Crossing the near plane
+			DAE_CHECK(suite, IsBoxVisible(culler, { 0.f, 0.f, 0.f }, 1.f, viewProjection));
+
+			// Nothing hides anything once cleared
+			culler.Clear();
+			DAE_CHECK(suite, culler.RenderOccluders() == 0);
+			DAE_CHECK(suite, IsBoxVisible(culler, { -6.f, 1.f, 20.f }, 1.f, viewProjection));
+		});
+
+		// Nothing may be culled that a plain z-buffer shows, from several sides of the vehicle
+		suite.Add("Occlusion/Vehicle/Conservative", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+			if(!DAE_CHECK(suite, file.IsOpen() && Utils::ParseOBJText(file.GetText(), vertices, indices)))
+				return;
+
+			std::vector<Vector3> positions(vertices.size());
+			for(size_t i{ 0 }; i < vertices.size(); ++i)
+				positions[i] = vertices[i].position;
+
+			for(const Vector3& origin : { Vector3{ 0.f, 0.f, -50.f }, Vector3{ 30.f, 10.f, 0.f }, Vector3{ -5.f, 40.f, 20.f } })
+			{
+				const Matrix viewProjection{ GetViewProjection(origin) };
+				const BoundsSoA bounds{ MakeBounds(2000, origin) };
+				std::vector<uint8_t> visible(bounds.GetCount());
+
+				OcclusionCuller culler{};
+				culler.AddOccluder(positions, indices, viewProjection);
+				DAE_CHECK(suite, culler.RenderOccluders() > 0);
+				const CullStats frustumStats{ Utils::CullBounds(Frustum::FromViewProjection(viewProjection), bounds, visible) };
+				const CullStats stats{ culler.TestBounds(bounds, viewProjection, visible) };
+				DAE_CHECK(suite, stats.tested == frustumStats.tested - frustumStats.culled);
+				DAE_CHECK(suite, stats.culled > 0);
+
+				const std::vector<float> reference{ RasterizeReference(positions, indices, viewProjection, culler.GetWidth(), culler.GetHeight()) };
+				for(size_t i{ 0 }; i < bounds.GetCount(); ++i)
+				{
+					const Vector3 center{ bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i] };
+					const Vector3 extents{ bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i] };
+					if(!culler.IsVisible(center - extents, center + extents, viewProjection))
+						DAE_CHECK(suite, IsBehindReference(reference, culler.GetWidth(), culler.GetHeight(), center - extents, center + extents, viewProjection));
+				}
+			}
+		});
+
+		// The bins are rasterized on their own threads, the buffer may not depend on how many there are
+		suite.Add("Occlusion/Threads/SameDepth", [&]
+		{
+			std::vector<Vector3> positions{};
+			std::vector<uint32_t> indices{};
+			const std::vector<float> floats{ bench::RandomFloats(300 * 3, 41, -1.f, 1.f) };
+			for(size_t i{ 0 }; i < floats.size(); i += 3)
+				AddSquare(floats[i] * 30.f, floats[i + 1] * 20.f, 30.f + floats[i + 2] * 20.f, 2.f, positions, indices);
+			const Matrix viewProjection{ GetProjection() };
+			const BoundsSoA bounds{ MakeBounds(2000, { 0.f, 0.f, -15.f }) };
+
+			const std::string path{ (std::filesystem::temp_directory_path() / "dae_test_depth.pgm").string() };
+			std::string firstImage{};
+			std::vector<uint8_t> firstVisible{};
+			for(const uint32_t threadCount : { 1u, 2u, 7u })
+			{
+				OcclusionCuller culler{ 256, 192, threadCount };
+				culler.AddOccluder(positions, indices, viewProjection);
+				culler.RenderOccluders();
+				std::vector<uint8_t> visible(bounds.GetCount(), 1);
+				culler.TestBounds(bounds, viewProjection, visible);
+				DAE_CHECK(suite, culler.WriteDepthImage(path));
+				const std::string image{ ReadFile(path) };
+				if(firstImage.empty())
+				{
+					firstImage = image;
+					firstVisible = visible;
+					continue;
+				}
+				DAE_CHECK(suite, image == firstImage);
+				DAE_CHECK(suite, visible == firstVisible);
+			}
+			std::filesystem::remove(path);
+
+			// Binary PGM, one byte per pixel
+			const std::string header{ "P5\n256 192\n255\n" };
+			DAE_CHECK(suite, firstImage.size() == header.size() + 256 * 192 && firstImage.compare(0, header.size(), header) == 0);
+		});
+
+		// Only the objects still visible are tested, the others stay culled
+		suite.Add("Occlusion/TestBounds/Counters", [&]
+		{
+			std::vector<Vector3> positions{};
+			std::vector<uint32_t> indices{};
+			AddSquare(0.f, 0.f, 10.f, 30.f, positions, indices);
+			const Matrix viewProjection{ GetProjection() };
+			OcclusionCuller culler{};
+			culler.AddOccluder(positions, indices, viewProjection);
+			culler.RenderOccluders();
+
+			BoundsSoA bounds{};
+			bounds.Resize(4);
+			const Vector3 centers[]{ { 0.f, 0.f, 5.f }, { 0.f, 0.f, 20.f }, { 2.f, 0.f, 30.f }, { -2.f, 0.f, 5.f } };
+			for(size_t i{ 0 }; i < 4; ++i)
+				bounds.Set(i, Affine3x4{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, centers[i] }, { -1.f, -1.f, -1.f }, { 1.f, 1.f, 1.f }, std::sqrt(3.f));
+			std::vector<uint8_t> visible{ 1, 1, 0, 0 };
+			const CullStats stats{ culler.TestBounds(bounds, viewProjection, visible) };
+			DAE_CHECK(suite, stats.tested == 2 && stats.culled == 1);
+			DAE_CHECK(suite, (visible == std::vector<uint8_t>{ 1, 0, 0, 0 }));
+		});
+	}
+}
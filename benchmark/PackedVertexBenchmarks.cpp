@@ -0,0 +1,56 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "PackedVertex.h"
+
+using namespace dae;
+
+namespace
+{
+	void RunObjFile(bench::Suite& suite, const std::string& name, const std::string& path)
+	{
+		const std::string packName{ "PackedVertex/" + name + "/PackVertices" };
+		const std::string unpackName{ "PackedVertex/" + name + "/UnpackVertex" };
+		if(!suite.IsEnabled(packName) && !suite.IsEnabled(unpackName))
+			return;
+
+		const MappedFile file{ path };
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		if(!file.IsOpen() || !Utils::ParseOBJText(file.GetText(), vertices, indices))
+		{
+			std::fprintf(stderr, "PackedVertex benchmark skipped, could not import %s\n", path.c_str());
+			return;
+		}
+
+		const PositionQuantization quantization{ Utils::GetPositionQuantization(vertices) };
+		std::vector<PackedVertex> packed(vertices.size());
+		Utils::PackVertices(vertices, quantization, packed);
+
+		const PackingError error{ Utils::MeasurePackingError(vertices, packed, quantization) };
+		std::fprintf(stderr, "%s: %zu -> %zu bytes per vertex, max error position %.6f (%.2e of the bounds), normal %.4f deg, tangent %.4f deg, uv %.6f, %zu flipped signs\n",
+			name.c_str(), sizeof(Vertex), sizeof(PackedVertex), error.maxPosition, error.maxRelativePosition, error.maxNormalAngle, error.maxTangentAngle, error.maxUV, error.flippedSigns);
+
+		suite.Add(packName, vertices.size(), [&]
+		{
+			Utils::PackVertices(vertices, quantization, packed);
+			bench::DoNotOptimize(packed.data());
+		});
+		suite.Add(unpackName, vertices.size(), [&]
+		{
+			for(const PackedVertex& vertex : packed)
+				bench::DoNotOptimize(Utils::UnpackVertex(vertex, quantization));
+		});
+	}
+}
+
+namespace bench
+{
+	void RunPackedVertexBenchmarks(Suite& suite)
+	{
+		// Quality loss on the asset the renderer packs
+		RunObjFile(suite, "vehicle", DAE_RESOURCE_DIR "/vehicle.obj");
+	}
+}
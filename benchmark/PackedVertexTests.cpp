@@ -0,0 +1,151 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "PackedVertex.h"
+
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	// 16 bit octahedral directions come back within this, the worst case is around the centre of the octants
+	constexpr float MAX_DIRECTION_DEGREES{ 0.01f };
+
+	float GetAngleDegrees(const Vector3& v1, const Vector3& v2)
+	{
+		return std::atan2(Vector3::Cross(v1, v2).Magnitude(), Vector3::Dot(v1, v2)) * TO_DEGREES;
+	}
+
+	// Random unit vectors plus the axes, the octant centres and the fold lines of the lower half
+	std::vector<Vector3> GetDirections()
+	{
+		std::vector<Vector3> directions{
+			Vector3::UnitX, -Vector3::UnitX, Vector3::UnitY, -Vector3::UnitY, Vector3::UnitZ, -Vector3::UnitZ,
+			Vector3{ 1.f, 1.f, -1e-7f }.Normalized(), Vector3{ -1.f, 0.f, -1e-7f }.Normalized(), Vector3{ 0.f, -1.f, -1.f }.Normalized()
+		};
+		for(const float z : { 1.f, -1.f })
+			for(const float y : { 1.f, -1.f })
+				for(const float x : { 1.f, -1.f })
+					directions.push_back(Vector3{ x, y, z }.Normalized());
+
+		std::mt19937 rng{ 16 };
+		std::normal_distribution<float> distribution{};
+		for(size_t i{ 0 }; i < 100000; ++i)
+			directions.push_back(Vector3{ distribution(rng), distribution(rng), distribution(rng) }.Normalized());
+		return directions;
+	}
+
+	std::vector<Vertex> MakeVertices(const std::vector<Vector3>& directions)
+	{
+		std::mt19937 rng{ 61 };
+		std::uniform_real_distribution<float> distribution{ -1.f, 1.f };
+		std::vector<Vertex> vertices(directions.size());
+		for(size_t i{ 0 }; i < vertices.size(); ++i)
+		{
+			Vertex& vertex{ vertices[i] };
+			vertex.position = { distribution(rng) * 40.f + 3.f, distribution(rng) * 0.5f, distribution(rng) * 1000.f };
+			vertex.normal = directions[i];
+			vertex.tangent = Vector4{ directions[directions.size() - 1 - i], i % 3 == 0 ? -1.f : 1.f };
+			vertex.uv = { distribution(rng) * 4.f, distribution(rng) };
+		}
+		return vertices;
+	}
+}
+
+namespace test
+{
+	void RunPackedVertexTests(Suite& suite)
+	{
+		const std::vector<Vector3> directions{ GetDirections() };
+
+		suite.Add("PackedVertex/Octahedral/RoundTrip", [&]
+		{
+			for(const Vector3& direction : directions)
+			{
+				const Vector2 encoded{ Utils::EncodeOctahedral(direction) };
+				DAE_CHECK(suite, Abs(encoded.x) <= 1.f && Abs(encoded.y) <= 1.f);
+				// The upper half inside the diamond, the lower half folded outside it
+				if(direction.z > 1e-5f)
+					DAE_CHECK(suite, Abs(encoded.x) + Abs(encoded.y) < 1.f);
+				else if(direction.z < -1e-5f)
+					DAE_CHECK(suite, Abs(encoded.x) + Abs(encoded.y) > 1.f);
+				DAE_CHECK(suite, GetAngleDegrees(Utils::DecodeOctahedral(encoded), direction) < 1e-4f);
+			}
+			// Not normalized on the way in
+			DAE_CHECK(suite, GetAngleDegrees(Utils::DecodeOctahedral(Utils::EncodeOctahedral({ 0.f, -3.f, -4.f })), { 0.f, -0.6f, -0.8f }) < 1e-4f);
+		});
+
+		suite.Add("PackedVertex/Pack/ErrorBounds", [&]
+		{
+			const std::vector<Vertex> vertices{ MakeVertices(directions) };
+			const PositionQuantization quantization{ Utils::GetPositionQuantization(vertices) };
+			std::vector<PackedVertex> packed(vertices.size());
+			Utils::PackVertices(vertices, quantization, packed);
+
+			// Half a step of 16 bits per axis, plus float rounding in the decode
+			const Vector3 maxPositionError{ quantization.scale * (0.5f / 65535.f) + Vector3{ 1e-6f, 1e-6f, 1e-6f } * quantization.scale.Magnitude() };
+			for(size_t i{ 0 }; i < vertices.size(); ++i)
+			{
+				const Vertex& source{ vertices[i] };
+				const Vertex unpacked{ Utils::UnpackVertex(packed[i], quantization) };
+				DAE_CHECK(suite, Abs(unpacked.position.x - source.position.x) <= maxPositionError.x);
+				DAE_CHECK(suite, Abs(unpacked.position.y - source.position.y) <= maxPositionError.y);
+				DAE_CHECK(suite, Abs(unpacked.position.z - source.position.z) <= maxPositionError.z);
+				DAE_CHECK(suite, GetAngleDegrees(unpacked.normal, source.normal) < MAX_DIRECTION_DEGREES);
+				DAE_CHECK(suite, GetAngleDegrees(unpacked.tangent.GetXYZ(), source.tangent.GetXYZ()) < MAX_DIRECTION_DEGREES);
+				DAE_CHECK(suite, unpacked.tangent.w == source.tangent.w);
+				DAE_CHECK(suite, unpacked.uv.x == Half{ source.uv.x }.ToFloat() && unpacked.uv.y == Half{ source.uv.y }.ToFloat());
+			}
+
+			const PackingError error{ Utils::MeasurePackingError(vertices, packed, quantization) };
+			DAE_CHECK(suite, error.flippedSigns == 0);
+			DAE_CHECK(suite, error.maxNormalAngle > 0.f && error.maxNormalAngle < MAX_DIRECTION_DEGREES);
+			DAE_CHECK(suite, error.maxTangentAngle > 0.f && error.maxTangentAngle < MAX_DIRECTION_DEGREES);
+			DAE_CHECK(suite, error.maxRelativePosition < 1.f / 65535.f);
+		});
+
+		suite.Add("PackedVertex/Pack/BoundsAndFlatAxis", [&]
+		{
+			// Flat in y, the bounds corners have to land on 0 and 65535 exactly
+			std::vector<Vertex> vertices(3);
+			vertices[0].position = { -2.f, 7.f, 1.f };
+			vertices[1].position = { 6.f, 7.f, -3.f };
+			vertices[2].position = { 0.5f, 7.f, 0.f };
+			const PositionQuantization quantization{ Utils::GetPositionQuantization(vertices) };
+			DAE_CHECK(suite, quantization.scale.x == 8.f && quantization.scale.y == 0.f && quantization.scale.z == 4.f);
+
+			std::vector<PackedVertex> packed(vertices.size());
+			Utils::PackVertices(vertices, quantization, packed);
+			DAE_CHECK(suite, packed[0].position[0] == 0 && packed[1].position[0] == UINT16_MAX);
+			DAE_CHECK(suite, packed[1].position[2] == 0 && packed[0].position[2] == UINT16_MAX);
+			for(const PackedVertex& vertex : packed)
+				DAE_CHECK(suite, Utils::UnpackVertex(vertex, quantization).position.y == 7.f);
+			DAE_CHECK(suite, Utils::UnpackVertex(packed[0], quantization).position.x == -2.f);
+			DAE_CHECK(suite, Utils::UnpackVertex(packed[1], quantization).position.x == 6.f);
+
+			DAE_CHECK(suite, Utils::GetPositionQuantization({}).scale.x == 1.f);
+		});
+
+		suite.Add("PackedVertex/Pack/Vehicle", [&]
+		{
+			const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			if(!DAE_CHECK(suite, file.IsOpen() && Utils::ParseOBJText(file.GetText(), vertices, indices)))
+				return;
+
+			const PositionQuantization quantization{ Utils::GetPositionQuantization(vertices) };
+			std::vector<PackedVertex> packed(vertices.size());
+			Utils::PackVertices(vertices, quantization, packed);
+			const PackingError error{ Utils::MeasurePackingError(vertices, packed, quantization) };
+			DAE_CHECK(suite, error.flippedSigns == 0);
+			DAE_CHECK(suite, error.maxNormalAngle < MAX_DIRECTION_DEGREES && error.maxTangentAngle < MAX_DIRECTION_DEGREES);
+			DAE_CHECK(suite, error.maxRelativePosition < 1.f / 65535.f);
+			// Half keeps 11 significant bits, the vehicle's uvs are inside [0, 1]
+			DAE_CHECK(suite, error.maxUV <= 1.f / 4096.f);
+		});
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <array>
+#include <vector>
+
+#include "StateTrackingContext.h"
+
+// Shared by the state tracking benchmark and tests
+namespace bench
+{
+	// Stands in for the device context: keeps the bindings the calls leave behind, counts the calls and records the
+	// bound state at every draw. Applying a pass binds pass specific states, samplers and resources like an effect does.
+	class RecordingContext final : public dae::RenderContext
+	{
+	public:
+		struct State
+		{
+			uint32_t topology{};
+			void* pInputLayout{};
+			std::array<void*, dae::StateTrackingContext::MAX_VERTEX_BUFFERS> vertexBuffers{};
+			void* pIndexBuffer{};
+			uint32_t indexFormat{};
+			void* pRasterizerState{};
+			void* pBlendState{};
+			void* pDepthStencilState{};
+			void* pRenderTargetView{};
+			std::array<void*, 2> samplers{};
+			std::array<void*, 4> shaderResources{};
+			void* pPass{};
+
+			bool operator==(const State&) const = default;
+		};
+
+		std::vector<State> draws{};
+		size_t calls{};
+		// Forwarded calls of every kind, indexed by StateCall
+		std::array<size_t, static_cast<size_t>(dae::StateCall::Count)> kindCalls{};
+
+		size_t GetCalls(dae::StateCall call) const { return kindCalls[static_cast<size_t>(call)]; }
+		const State& GetState() const { return m_State; }
+
+		void SetPrimitiveTopology(uint32_t topology) override { Count(dae::StateCall::Topology); m_State.topology = topology; }
+		void SetInputLayout(void* pInputLayout) override { Count(dae::StateCall::InputLayout); m_State.pInputLayout = pInputLayout; }
+		void SetVertexBuffer(uint32_t slot, void* pBuffer, uint32_t, uint32_t) override { Count(dae::StateCall::VertexBuffer); m_State.vertexBuffers[slot] = pBuffer; }
+		void SetIndexBuffer(void* pBuffer, uint32_t format, uint32_t) override { Count(dae::StateCall::IndexBuffer); m_State.pIndexBuffer = pBuffer; m_State.indexFormat = format; }
+		void SetRasterizerState(void* pState) override { Count(dae::StateCall::Rasterizer); m_State.pRasterizerState = pState; }
+		void SetBlendState(void* pState) override { Count(dae::StateCall::Blend); m_State.pBlendState = pState; }
+		void SetDepthStencilState(void* pState, uint32_t) override { Count(dae::StateCall::DepthStencil); m_State.pDepthStencilState = pState; }
+		void SetRenderTarget(void* pRenderTargetView, void*) override { Count(dae::StateCall::RenderTarget); m_State.pRenderTargetView = pRenderTargetView; }
+		void SetSampler(dae::ShaderStage stage, uint32_t slot, void* pSampler) override
+		{
+			Count(dae::StateCall::Sampler);
+			if(stage == dae::ShaderStage::Pixel && slot < m_State.samplers.size())
+				m_State.samplers[slot] = pSampler;
+		}
+		void SetShaderResource(dae::ShaderStage stage, uint32_t slot, void* pView) override
+		{
+			Count(dae::StateCall::ShaderResource);
+			if(stage == dae::ShaderStage::Pixel && slot < m_State.shaderResources.size())
+				m_State.shaderResources[slot] = pView;
+		}
+		void ApplyPass(void* pPass) override
+		{
+			Count(dae::StateCall::Pass);
+			m_State.pPass = pPass;
+			m_State.pRasterizerState = pPass;
+			m_State.pBlendState = pPass;
+			m_State.pDepthStencilState = pPass;
+			m_State.samplers.fill(pPass);
+			m_State.shaderResources.fill(pPass);
+		}
+		void DrawIndexed(uint32_t, uint32_t, int32_t) override { draws.push_back(m_State); }
+		void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override { draws.push_back(m_State); }
+
+	private:
+		State m_State{};
+
+		void Count(dae::StateCall call)
+		{
+			++calls;
+			++kindCalls[static_cast<size_t>(call)];
+		}
+	};
+
+	// Fake object pointers, only compared
+	inline void* MakeHandle(size_t kind, size_t index)
+	{
+		return reinterpret_cast<void*>((kind << 24 | index) * 16 + 16);
+	}
+
+	// One frame of a sorted queue like Mesh::Render issues it: 16 effects, runs of 8 draws of one of 64 meshes,
+	// and every 4th draw binds its own texture in slot 1
+	inline void RenderFrame(dae::RenderContext& context, dae::StateTrackingContext* pTracker, size_t drawCount)
+	{
+		if(pTracker)
+			pTracker->BeginFrame();
+		context.SetRenderTarget(MakeHandle(0, 0), MakeHandle(0, 1));
+
+		for(size_t i{ 0 }; i < drawCount; ++i)
+		{
+			const size_t material{ i * 16 / drawCount };
+			const size_t mesh{ (i / 8) % 64 };
+			context.SetPrimitiveTopology(4);
+			context.SetInputLayout(MakeHandle(1, material % 2));
+			context.SetVertexBuffer(0, MakeHandle(2, mesh), 32, 0);
+			context.SetIndexBuffer(MakeHandle(3, mesh), 57, 0);
+			if(pTracker)
+				pTracker->InvalidatePass();
+			context.ApplyPass(MakeHandle(4, material));
+			if(i % 4 == 0)
+				context.SetShaderResource(dae::ShaderStage::Pixel, 1, MakeHandle(5, i));
+			context.DrawIndexed(36, 0, 0);
+		}
+	}
+}
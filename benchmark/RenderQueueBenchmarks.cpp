@@ -0,0 +1,71 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+using namespace dae;
+
+namespace
+{
+	// One in ten draws transparent, 64 materials, depths spread over the renderer's 0.1 - 100 range
+	std::vector<RenderItem> MakeItems(size_t count)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 3, 23, 0.f, 1.f) };
+		std::vector<RenderItem> items(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 3] };
+			const RenderPass pass{ pRandom[0] < 0.1f ? RenderPass::Transparent : RenderPass::Opaque };
+			const uint16_t material{ static_cast<uint16_t>(pRandom[1] * 63.99f) };
+			items[i] = { RenderQueue::MakeKey(pass, material, 0.1f + pRandom[2] * 99.9f, 0.1f, 100.f), static_cast<uint32_t>(i) };
+		}
+		return items;
+	}
+
+	void RunCount(bench::Suite& suite, const std::string& name, size_t count)
+	{
+		const std::string sortName{ "RenderQueue/" + name + "/Sort" };
+		const std::string stdSortName{ "RenderQueue/" + name + "/StdStableSort" };
+		if(!suite.IsEnabled(sortName) && !suite.IsEnabled(stdSortName))
+			return;
+
+		const std::vector<RenderItem> items{ MakeItems(count) };
+		const auto byKey = [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; };
+
+		// Both include filling the queue, as a frame would
+		RenderQueue queue{};
+		const auto submitAndSort = [&]
+		{
+			queue.Clear();
+			for(const RenderItem& item : items)
+				queue.Submit(item.key, item.drawIndex);
+			queue.Sort();
+		};
+
+		// The match with std::stable_sort is checked in RenderQueueTests.cpp
+		std::vector<RenderItem> sorted{};
+		suite.Add(sortName, count, [&]
+		{
+			submitAndSort();
+			bench::DoNotOptimize(queue.GetItems().data());
+		});
+		suite.Add(stdSortName, count, [&]
+		{
+			sorted = items;
+			std::stable_sort(sorted.begin(), sorted.end(), byKey);
+			bench::DoNotOptimize(sorted.data());
+		});
+	}
+}
+
+namespace bench
+{
+	void RunRenderQueueBenchmarks(Suite& suite)
+	{
+		RunCount(suite, "10k", 10000);
+		RunCount(suite, "100k", 100000);
+		RunCount(suite, "1M", 1000000);
+	}
+}
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "RenderQueue.h"
+
+using namespace dae;
+
+namespace
+{
+	constexpr float NEAR_PLANE{ 0.1f };
+	constexpr float FAR_PLANE{ 100.f };
+
+	struct Draw
+	{
+		RenderPass pass{};
+		uint16_t material{};
+		float depth{};
+	};
+
+	// materialCount materials and depthSteps distinct depths, few of both gives many equal keys
+	std::vector<Draw> MakeDraws(size_t count, uint16_t materialCount, uint32_t depthSteps, uint32_t seed)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(count * 3, seed, 0.f, 1.f) };
+		std::vector<Draw> draws(count);
+		for(size_t i{ 0 }; i < count; ++i)
+		{
+			const float* pRandom{ &floats[i * 3] };
+			draws[i].pass = pRandom[0] < 0.2f ? RenderPass::Transparent : RenderPass::Opaque;
+			draws[i].material = static_cast<uint16_t>(pRandom[1] * (static_cast<float>(materialCount) - 0.01f));
+			draws[i].depth = NEAR_PLANE + std::floor(pRandom[2] * static_cast<float>(depthSteps)) / static_cast<float>(depthSteps) * (FAR_PLANE - NEAR_PLANE);
+		}
+		return draws;
+	}
+
+	uint64_t MakeKey(const Draw& draw)
+	{
+		return RenderQueue::MakeKey(draw.pass, draw.material, draw.depth, NEAR_PLANE, FAR_PLANE);
+	}
+
+	void Submit(RenderQueue& queue, const std::vector<Draw>& draws)
+	{
+		queue.Clear();
+		for(size_t i{ 0 }; i < draws.size(); ++i)
+			queue.Submit(MakeKey(draws[i]), static_cast<uint32_t>(i));
+	}
+
+	bool MatchesStableSort(const RenderQueue& queue, const std::vector<Draw>& draws)
+	{
+		std::vector<RenderItem> expected(draws.size());
+		for(size_t i{ 0 }; i < draws.size(); ++i)
+			expected[i] = { MakeKey(draws[i]), static_cast<uint32_t>(i) };
+		std::stable_sort(expected.begin(), expected.end(), [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; });
+
+		const std::span<const RenderItem> items{ queue.GetItems() };
+		return std::equal(items.begin(), items.end(), expected.begin(), expected.end(),
+			[](const RenderItem& a, const RenderItem& b) { return a.key == b.key && a.drawIndex == b.drawIndex; });
+	}
+}
+
+namespace test
+{
+	void RunRenderQueueTests(Suite& suite)
+	{
+		suite.Add("RenderQueue/MakeKey/Order", [&]
+		{
+			const auto key = [](RenderPass pass, uint16_t material, float depth) { return RenderQueue::MakeKey(pass, material, depth, NEAR_PLANE, FAR_PLANE); };
+			constexpr RenderPass opaque{ RenderPass::Opaque };
+			constexpr RenderPass transparent{ RenderPass::Transparent };
+
+			// Every opaque draw goes first
+			DAE_CHECK(suite, key(opaque, 0xFFFF, FAR_PLANE) < key(transparent, 0, FAR_PLANE));
+			// Opaque: material first, then front to back
+			DAE_CHECK(suite, key(opaque, 3, 1.f) < key(opaque, 3, 2.f));
+			DAE_CHECK(suite, key(opaque, 3, 90.f) < key(opaque, 4, 1.f));
+			// Transparent: back to front whatever the material, which only breaks ties
+			DAE_CHECK(suite, key(transparent, 9, 2.f) < key(transparent, 1, 1.f));
+			DAE_CHECK(suite, key(transparent, 1, 5.f) < key(transparent, 2, 5.f));
+
+			// Out of range and NaN depths clamp, the free low bits stay 0
+			DAE_CHECK(suite, key(opaque, 7, -5.f) == key(opaque, 7, NEAR_PLANE));
+			DAE_CHECK(suite, key(opaque, 7, 1e9f) == key(opaque, 7, FAR_PLANE));
+			DAE_CHECK(suite, key(opaque, 7, NAN) == key(opaque, 7, NEAR_PLANE));
+			DAE_CHECK(suite, key(transparent, 7, 1e9f) == key(transparent, 7, FAR_PLANE));
+			DAE_CHECK(suite, RenderQueue::MakeKey(opaque, 7, 3.f, 1.f, 1.f) == key(opaque, 7, NEAR_PLANE));
+			for(const RenderPass pass : { opaque, transparent })
+				DAE_CHECK(suite, (key(pass, 0xFFFF, 50.f) & 0x3FFFFF) == 0);
+		});
+
+		// Around the insertion sort limit and in the radix range, with many equal keys to catch unstable passes
+		suite.Add("RenderQueue/Sort/MatchesStableSort", [&]
+		{
+			RenderQueue queue{};
+			for(const size_t count : { 0, 1, 2, 63, 64, 65, 1000, 100000 })
+			{
+				for(const auto& [materialCount, depthSteps] : { std::pair{ uint16_t{ 3 }, 4u }, std::pair{ uint16_t{ 64 }, 1u << 20 } })
+				{
+					const std::vector<Draw> draws{ MakeDraws(count, materialCount, depthSteps, static_cast<uint32_t>(count) + depthSteps) };
+					// The same queue is sorted again and again, the kept sort buffer may not leak into the next frame
+					Submit(queue, draws);
+					queue.Sort();
+					DAE_CHECK(suite, queue.GetItems().size() == count);
+					DAE_CHECK(suite, MatchesStableSort(queue, draws));
+				}
+			}
+		});
+
+		// Every key the same, or differing in a single digit, so the radix sort skips most passes
+		suite.Add("RenderQueue/Sort/ConstantDigits", [&]
+		{
+			RenderQueue queue{};
+			std::vector<Draw> draws(1000, Draw{ RenderPass::Opaque, 5, 10.f });
+			Submit(queue, draws);
+			queue.Sort();
+			DAE_CHECK(suite, MatchesStableSort(queue, draws));
+
+			for(size_t i{ 0 }; i < draws.size(); ++i)
+				draws[i].material = static_cast<uint16_t>((i * 7) % 3);
+			Submit(queue, draws);
+			queue.Sort();
+			DAE_CHECK(suite, MatchesStableSort(queue, draws));
+		});
+
+		// What the renderer relies on: opaque grouped by material front to back, then transparent back to front
+		suite.Add("RenderQueue/Sort/DrawOrder", [&]
+		{
+			const std::vector<Draw> draws{ MakeDraws(5000, 8, 1u << 20, 77) };
+			RenderQueue queue{};
+			Submit(queue, draws);
+			queue.Sort();
+
+			const std::span<const RenderItem> items{ queue.GetItems() };
+			for(size_t i{ 1 }; i < items.size(); ++i)
+			{
+				const Draw& previous{ draws[items[i - 1].drawIndex] };
+				const Draw& draw{ draws[items[i].drawIndex] };
+				DAE_CHECK(suite, previous.pass <= draw.pass);
+				if(previous.pass != draw.pass)
+					continue;
+
+				if(draw.pass == RenderPass::Opaque)
+					DAE_CHECK(suite, previous.material < draw.material || (previous.material == draw.material && previous.depth <= draw.depth));
+				else
+					DAE_CHECK(suite, previous.depth >= draw.depth);
+			}
+		});
+	}
+}
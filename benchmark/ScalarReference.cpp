@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "ScalarReference.h"
+
+#include <cstring>
+
+#include "Frustum.h"
+
+#if DAE_MATRIX_SIMD || DAE_COLOR_SIMD || DAE_HALF_F16C || DAE_FRUSTUM_SIMD
+#error ScalarReference.cpp has to be built with DAE_MATRIX_NO_SIMD, DAE_COLOR_NO_SIMD, DAE_HALF_NO_F16C and DAE_FRUSTUM_NO_SIMD
+#endif
+
+using namespace dae;
+
+namespace
+{
+	Matrix LoadMatrix(const float* pMatrix)
+	{
+		const float* p{ pMatrix };
+		return { { p[0], p[1], p[2], p[3] }, { p[4], p[5], p[6], p[7] }, { p[8], p[9], p[10], p[11] }, { p[12], p[13], p[14], p[15] } };
+	}
+
+	void StoreMatrix(const Matrix& m, float* pOut)
+	{
+		std::memcpy(pOut, &m, sizeof(Matrix));
+	}
+
+	ConstColorPlanes GetPlanes(const float* const* ppColors, size_t count)
+	{
+		return { { ppColors[0], count }, { ppColors[1], count }, { ppColors[2], count } };
+	}
+
+	ColorPlanes GetPlanes(float* const* ppColors, size_t count)
+	{
+		return { { ppColors[0], count }, { ppColors[1], count }, { ppColors[2], count } };
+	}
+}
+
+namespace scalar
+{
+	void Multiply(const float* pA, const float* pB, float* pOut)
+	{
+		StoreMatrix(LoadMatrix(pA) * LoadMatrix(pB), pOut);
+	}
+
+	void Inverse(const float* pMatrix, float* pOut)
+	{
+		StoreMatrix(Matrix::Inverse(LoadMatrix(pMatrix)), pOut);
+	}
+
+	void Transpose(const float* pMatrix, float* pOut)
+	{
+		StoreMatrix(Matrix::Transpose(LoadMatrix(pMatrix)), pOut);
+	}
+
+	void TransformPoint(const float* pMatrix, const float* pPoint, float* pOut)
+	{
+		const Vector3 p{ LoadMatrix(pMatrix).TransformPoint(pPoint[0], pPoint[1], pPoint[2]) };
+		std::memcpy(pOut, &p, sizeof(Vector3));
+	}
+
+	void TransformPoint4(const float* pMatrix, const float* pPoint, float* pOut)
+	{
+		const Vector4 p{ LoadMatrix(pMatrix).TransformPoint(pPoint[0], pPoint[1], pPoint[2], 1.f) };
+		std::memcpy(pOut, &p, sizeof(Vector4));
+	}
+
+	void TransformVector(const float* pMatrix, const float* pVector, float* pOut)
+	{
+		const Vector3 v{ LoadMatrix(pMatrix).TransformVector(pVector[0], pVector[1], pVector[2]) };
+		std::memcpy(pOut, &v, sizeof(Vector3));
+	}
+
+	void CreateRotations(const float* pEulerAngles, size_t count, float* pOut, bool isFast)
+	{
+		std::vector<Vector3> eulerAngles(count);
+		for(size_t i{ 0 }; i < count; ++i)
+			eulerAngles[i] = { pEulerAngles[i * 3], pEulerAngles[i * 3 + 1], pEulerAngles[i * 3 + 2] };
+		std::vector<Matrix> rotations(count);
+		Matrix::CreateRotations(eulerAngles, rotations, isFast ? TrigMode::Fast : TrigMode::Precise);
+		for(size_t i{ 0 }; i < count; ++i)
+			StoreMatrix(rotations[i], pOut + i * 16);
+	}
+
+	void ColorAdd(const float* const* ppC1, const float* const* ppC2, size_t count, float* const* ppOut)
+	{
+		ColorRGB::Add(GetPlanes(ppC1, count), GetPlanes(ppC2, count), GetPlanes(ppOut, count));
+	}
+
+	void ColorMultiply(const float* const* ppC1, const float* const* ppC2, size_t count, float* const* ppOut)
+	{
+		ColorRGB::Multiply(GetPlanes(ppC1, count), GetPlanes(ppC2, count), GetPlanes(ppOut, count));
+	}
+
+	void ColorMultiply(const float* const* ppColors, float s, size_t count, float* const* ppOut)
+	{
+		ColorRGB::Multiply(GetPlanes(ppColors, count), s, GetPlanes(ppOut, count));
+	}
+
+	void ColorLerp(const float* const* ppC1, const float* const* ppC2, float factor, size_t count, float* const* ppOut)
+	{
+		ColorRGB::Lerp(GetPlanes(ppC1, count), GetPlanes(ppC2, count), factor, GetPlanes(ppOut, count));
+	}
+
+	void ColorMaxToOne(float* const* ppColors, size_t count)
+	{
+		ColorRGB::MaxToOne(GetPlanes(ppColors, count));
+	}
+
+	void ColorSaturate(float* const* ppColors, size_t count)
+	{
+		ColorRGB::Saturate(GetPlanes(ppColors, count));
+	}
+
+	void ColorPackRGBA8(const float* const* ppColors, size_t count, uint32_t* pOut, bool sRGB)
+	{
+		ColorRGB::PackRGBA8(GetPlanes(ppColors, count), std::span{ pOut, count }, sRGB);
+	}
+
+	void ConvertToHalf(const float* pIn, size_t count, uint16_t* pOut)
+	{
+		std::vector<Half> halves(count);
+		Half::Convert(std::span{ pIn, count }, halves);
+		for(size_t i{ 0 }; i < count; ++i)
+			pOut[i] = halves[i].bits;
+	}
+
+	void ConvertToFloat(const uint16_t* pIn, size_t count, float* pOut)
+	{
+		std::vector<Half> halves(count);
+		for(size_t i{ 0 }; i < count; ++i)
+			halves[i] = Half::FromBits(pIn[i]);
+		Half::Convert(halves, std::span{ pOut, count });
+	}
+
+	size_t CullBounds(const float* pPlanes, const float* const* ppBounds, size_t count, uint8_t* pVisible)
+	{
+		Frustum frustum{};
+		std::memcpy(frustum.planes.data(), pPlanes, sizeof(frustum.planes));
+		BoundsSoA bounds{};
+		std::vector<float>* arrays[]{ &bounds.centerX, &bounds.centerY, &bounds.centerZ, &bounds.extentX, &bounds.extentY, &bounds.extentZ, &bounds.radius };
+		for(size_t a{ 0 }; a < std::size(arrays); ++a)
+			arrays[a]->assign(ppBounds[a], ppBounds[a] + count);
+		return Utils::CullBounds(frustum, bounds, std::span{ pVisible, count }).culled;
+	}
+}
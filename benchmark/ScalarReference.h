@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// The math sources built a second time with every SIMD path switched off (DAE_MATRIX_NO_SIMD, ...), so the tests can
+// compare both backends in one run. That build lives in namespace daeScalar (the dae namespace renamed by a define)
+// so the two sets of inline functions never collide, this interface only passes plain floats between them.
+namespace scalar
+{
+	// Matrices are 16 floats, row major like dae::Matrix
+	void Multiply(const float* pA, const float* pB, float* pOut);
+	void Inverse(const float* pMatrix, float* pOut);
+	void Transpose(const float* pMatrix, float* pOut);
+	// 3 floats in, 3 (or 4 for TransformPoint4) out
+	void TransformPoint(const float* pMatrix, const float* pPoint, float* pOut);
+	void TransformPoint4(const float* pMatrix, const float* pPoint, float* pOut);
+	void TransformVector(const float* pMatrix, const float* pVector, float* pOut);
+	// count {pitch, yaw, roll} triples in, count matrices out
+	void CreateRotations(const float* pEulerAngles, size_t count, float* pOut, bool isFast);
+
+	// ColorRGB batch kernels without SIMD. Colors are the 3 planes r, g, b of count floats each, out may alias an input.
+	void ColorAdd(const float* const* ppC1, const float* const* ppC2, size_t count, float* const* ppOut);
+	void ColorMultiply(const float* const* ppC1, const float* const* ppC2, size_t count, float* const* ppOut);
+	void ColorMultiply(const float* const* ppColors, float s, size_t count, float* const* ppOut);
+	void ColorLerp(const float* const* ppC1, const float* const* ppC2, float factor, size_t count, float* const* ppOut);
+	void ColorMaxToOne(float* const* ppColors, size_t count);
+	void ColorSaturate(float* const* ppColors, size_t count);
+	void ColorPackRGBA8(const float* const* ppColors, size_t count, uint32_t* pOut, bool sRGB);
+
+	// Half::Convert without F16C, halves as their bits
+	void ConvertToHalf(const float* pIn, size_t count, uint16_t* pOut);
+	void ConvertToFloat(const uint16_t* pIn, size_t count, float* pOut);
+
+	// Utils::CullBounds without SIMD. pPlanes are the 6 frustum planes as x y z w, ppBounds the 7 BoundsSoA arrays in
+	// member order (center x y z, extent x y z, radius) of count floats each. Returns the number culled.
+	size_t CullBounds(const float* pPlanes, const float* const* ppBounds, size_t count, uint8_t* pVisible);
+}
@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "MappedFile.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+
+#include <array>
+
+using namespace dae;
+
+namespace
+{
+	constexpr std::array<float, 3> LOD_RATIOS{ 0.5f, 0.25f, 0.125f };
+
+	void RunMesh(bench::Suite& suite, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		const std::string simplifyName{ "Simplifier/" + name + "/SimplifyMesh50" };
+		const std::string lodsName{ "Simplifier/" + name + "/GenerateLods" };
+
+		std::vector<uint32_t> lodIndices{ indices };
+		const std::vector<LodLevel> levels{ Utils::GenerateLods(vertices, lodIndices, LOD_RATIOS) };
+		for(size_t level{ 0 }; level < levels.size(); ++level)
+		{
+			std::fprintf(stderr, "%s LOD%zu: %u triangles (%.1f%%), error %.6f\n", name.c_str(), level, levels[level].indexCount / 3,
+				100.0 * static_cast<double>(levels[level].indexCount) / static_cast<double>(indices.size()), levels[level].error);
+		}
+
+		suite.Add(simplifyName, indices.size() / 3, [&]
+		{
+			bench::DoNotOptimize(Utils::SimplifyMesh(vertices, indices, indices.size() / 6 * 3).data());
+		});
+		suite.Add(lodsName, indices.size() / 3, [&]
+		{
+			lodIndices = indices;
+			bench::DoNotOptimize(Utils::GenerateLods(vertices, lodIndices, LOD_RATIOS).data());
+		});
+	}
+}
+
+namespace bench
+{
+	void RunSimplifierBenchmarks(Suite& suite)
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		const std::string vehicleName{ "Simplifier/vehicle/" };
+		if(suite.IsEnabled(vehicleName + "SimplifyMesh50") || suite.IsEnabled(vehicleName + "GenerateLods"))
+		{
+			const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+			if(file.IsOpen() && Utils::ParseOBJText(file.GetText(), vertices, indices))
+				RunMesh(suite, "vehicle", vertices, indices);
+		}
+
+		// Open borders on all four sides and a seam free surface
+		const std::string gridName{ "Simplifier/grid200/" };
+		if(suite.IsEnabled(gridName + "SimplifyMesh50") || suite.IsEnabled(gridName + "GenerateLods"))
+		{
+			Utils::ParseOBJText(MakeGridOBJ(200), vertices, indices);
+			RunMesh(suite, "grid200", vertices, indices);
+		}
+	}
+}
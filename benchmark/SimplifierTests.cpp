@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "MappedFile.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+
+#include <array>
+
+using namespace dae;
+
+namespace
+{
+	constexpr std::array<float, 3> LOD_RATIOS{ 0.5f, 0.25f, 0.125f };
+
+	Vector3 GetTriangleNormal(const std::vector<Vertex>& vertices, const uint32_t* pTriangle)
+	{
+		const Vector3& p0{ vertices[pTriangle[0]].position };
+		return Vector3::Cross(vertices[pTriangle[1]].position - p0, vertices[pTriangle[2]].position - p0);
+	}
+
+	// Valid indices, no collapsed triangles
+	bool IsValidMesh(std::span<const uint32_t> indices, size_t vertexCount)
+	{
+		if(indices.size() % 3 != 0)
+			return false;
+
+		for(size_t i{ 0 }; i < indices.size(); i += 3)
+		{
+			if(indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount
+				|| indices[i] == indices[i + 1] || indices[i + 1] == indices[i + 2] || indices[i] == indices[i + 2])
+				return false;
+		}
+		return true;
+	}
+
+	bool ImportVehicle(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+		return file.IsOpen() && Utils::ParseOBJText(file.GetText(), vertices, indices);
+	}
+}
+
+namespace test
+{
+	void RunSimplifierTests(Suite& suite)
+	{
+		// A height field, every triangle faces the same side of y and no collapse may flip one
+		suite.Add("Simplifier/Simplify/Grid", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			Utils::ParseOBJText(bench::MakeGridOBJ(60), vertices, indices);
+			// The importer flips the winding to left handed
+			const float facing{ GetTriangleNormal(vertices, &indices[0]).y > 0.f ? 1.f : -1.f };
+			for(size_t i{ 0 }; i < indices.size(); i += 3)
+				DAE_CHECK(suite, GetTriangleNormal(vertices, &indices[i]).y * facing > 0.f);
+
+			float previousError{ 0.f };
+			for(const float ratio : { 0.5f, 0.25f, 0.1f })
+			{
+				const size_t target{ static_cast<size_t>(static_cast<float>(indices.size() / 3) * ratio) * 3 };
+				float error{};
+				const std::vector<uint32_t> simplified{ Utils::SimplifyMesh(vertices, indices, target, &error) };
+				DAE_CHECK(suite, IsValidMesh(simplified, vertices.size()));
+				DAE_CHECK(suite, simplified.size() <= target && simplified.size() + 6 >= target);
+				for(size_t i{ 0 }; i < simplified.size(); i += 3)
+					DAE_CHECK(suite, GetTriangleNormal(vertices, &simplified[i]).y * facing > 0.f);
+
+				// Less triangles cost more error, the height field is only 2 units high
+				DAE_CHECK(suite, error > previousError && error < 2.f);
+				previousError = error;
+			}
+
+			float error{ -1.f };
+			DAE_CHECK(suite, Utils::SimplifyMesh(vertices, indices, indices.size(), &error).size() == indices.size());
+			DAE_CHECK(suite, error == 0.f);
+		});
+
+		suite.Add("Simplifier/Lods/Layout", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> source{};
+			Utils::ParseOBJText(bench::MakeGridOBJ(60), vertices, source);
+
+			std::vector<uint32_t> indices{ source };
+			const std::vector<LodLevel> levels{ Utils::GenerateLods(vertices, indices, LOD_RATIOS, 1) };
+			if(!DAE_CHECK(suite, levels.size() == LOD_RATIOS.size() + 1))
+				return;
+
+			// The input stays in front, the levels follow it back to back
+			DAE_CHECK(suite, std::equal(source.begin(), source.end(), indices.begin()));
+			DAE_CHECK(suite, levels[0].firstIndex == 0 && levels[0].indexCount == source.size() && levels[0].error == 0.f);
+			for(size_t level{ 1 }; level < levels.size(); ++level)
+			{
+				DAE_CHECK(suite, levels[level].firstIndex == levels[level - 1].firstIndex + levels[level - 1].indexCount);
+				DAE_CHECK(suite, levels[level].error > levels[level - 1].error);
+				DAE_CHECK(suite, IsValidMesh(std::span{ indices }.subspan(levels[level].firstIndex, levels[level].indexCount), vertices.size()));
+			}
+			DAE_CHECK(suite, levels.back().firstIndex + levels.back().indexCount == indices.size());
+
+			// Simplified in parallel the levels are the same
+			std::vector<uint32_t> parallelIndices{ source };
+			const std::vector<LodLevel> parallelLevels{ Utils::GenerateLods(vertices, parallelIndices, LOD_RATIOS, 4) };
+			DAE_CHECK(suite, parallelIndices == indices && parallelLevels.size() == levels.size());
+		});
+
+		// The seams lock the vehicle at about 29%, the eighth would be a near copy of the quarter
+		suite.Add("Simplifier/Lods/DropsNearDuplicates", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			if(!DAE_CHECK(suite, ImportVehicle(vertices, indices)))
+				return;
+
+			const size_t triangleCount{ indices.size() / 3 };
+			const std::vector<LodLevel> levels{ Utils::GenerateLods(vertices, indices, LOD_RATIOS) };
+			for(size_t level{ 1 }; level < levels.size(); ++level)
+			{
+				DAE_CHECK(suite, static_cast<float>(levels[level].indexCount) <= static_cast<float>(levels[level - 1].indexCount) * Utils::MAX_LOD_TRIANGLE_FRACTION);
+				DAE_CHECK(suite, levels[level].error > levels[level - 1].error);
+			}
+			if(DAE_CHECK(suite, levels.size() == 3))
+			{
+				DAE_CHECK(suite, levels[1].indexCount / 3 <= triangleCount / 2 && levels[1].indexCount / 3 + 3 >= triangleCount / 2);
+				// Misses the quarter, but by less than a third
+				DAE_CHECK(suite, levels[2].indexCount / 3 < triangleCount / 3);
+			}
+			DAE_CHECK(suite, levels.back().firstIndex + levels.back().indexCount == indices.size());
+
+			// Nothing left to simplify: only the input
+			std::vector<uint32_t> triangle{ 0, 1, 2 };
+			DAE_CHECK(suite, Utils::GenerateLods(vertices, triangle, LOD_RATIOS).size() == 1 && triangle.size() == 3);
+		});
+	}
+}
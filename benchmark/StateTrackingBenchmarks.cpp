@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include "RecordingContext.h"
+
+using namespace dae;
+
+namespace bench
+{
+	void RunStateTrackingBenchmarks(Suite& suite)
+	{
+		const std::string trackedName{ "StateTracking/10k/Tracked" };
+		const std::string directName{ "StateTracking/10k/Direct" };
+		if(!suite.IsEnabled(trackedName) && !suite.IsEnabled(directName))
+			return;
+
+		constexpr size_t drawCount{ 10000 };
+		RecordingContext direct{};
+		RecordingContext tracked{};
+		StateTrackingContext tracker{ tracked };
+
+		// Twice, the second frame starts with the bindings of the first one
+		for(int frame{ 0 }; frame < 2; ++frame)
+		{
+			RenderFrame(direct, nullptr, drawCount);
+			RenderFrame(tracker, &tracker, drawCount);
+		}
+		// That the draws see the same state either way is checked in StateTrackingTests.cpp
+		const StateStats& stats{ tracker.GetStats() };
+		std::fprintf(stderr, "StateTracking: %zu draws, %u calls issued, %u dropped (%zu device calls unfiltered, %zu filtered)\n",
+			static_cast<size_t>(stats.draws), stats.GetIssued(), stats.GetElided(), direct.calls / 2, tracked.calls / 2);
+
+		suite.Add(trackedName, drawCount, [&]
+		{
+			tracked.draws.clear();
+			RenderFrame(tracker, &tracker, drawCount);
+			bench::DoNotOptimize(tracked.draws.data());
+		});
+		suite.Add(directName, drawCount, [&]
+		{
+			direct.draws.clear();
+			RenderFrame(direct, nullptr, drawCount);
+			bench::DoNotOptimize(direct.draws.data());
+		});
+	}
+}
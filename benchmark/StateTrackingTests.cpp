@@ -0,0 +1,193 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "RecordingContext.h"
+
+#include <functional>
+
+using namespace dae;
+using bench::MakeHandle;
+using bench::RecordingContext;
+
+namespace
+{
+	using Call = std::function<void(RenderContext&)>;
+
+	// Calls of one kind that each bind something else than the one before, also through the other arguments and slots
+	struct CallKind
+	{
+		StateCall call{};
+		std::vector<Call> variants{};
+	};
+
+	std::vector<CallKind> GetCallKinds()
+	{
+		return {
+			{ StateCall::Topology, { [](RenderContext& c) { c.SetPrimitiveTopology(4); }, [](RenderContext& c) { c.SetPrimitiveTopology(5); } } },
+			{ StateCall::InputLayout, { [](RenderContext& c) { c.SetInputLayout(MakeHandle(1, 0)); }, [](RenderContext& c) { c.SetInputLayout(MakeHandle(1, 1)); } } },
+			{ StateCall::VertexBuffer, {
+				[](RenderContext& c) { c.SetVertexBuffer(0, MakeHandle(2, 0), 32, 0); },
+				[](RenderContext& c) { c.SetVertexBuffer(0, MakeHandle(2, 1), 32, 0); },
+				[](RenderContext& c) { c.SetVertexBuffer(0, MakeHandle(2, 1), 16, 0); },
+				[](RenderContext& c) { c.SetVertexBuffer(0, MakeHandle(2, 1), 16, 64); },
+				[](RenderContext& c) { c.SetVertexBuffer(1, MakeHandle(2, 1), 16, 64); } } },
+			{ StateCall::IndexBuffer, {
+				[](RenderContext& c) { c.SetIndexBuffer(MakeHandle(3, 0), 57, 0); },
+				[](RenderContext& c) { c.SetIndexBuffer(MakeHandle(3, 1), 57, 0); },
+				[](RenderContext& c) { c.SetIndexBuffer(MakeHandle(3, 1), 42, 0); },
+				[](RenderContext& c) { c.SetIndexBuffer(MakeHandle(3, 1), 42, 12); } } },
+			{ StateCall::Rasterizer, { [](RenderContext& c) { c.SetRasterizerState(MakeHandle(6, 0)); }, [](RenderContext& c) { c.SetRasterizerState(nullptr); } } },
+			{ StateCall::Blend, { [](RenderContext& c) { c.SetBlendState(MakeHandle(7, 0)); }, [](RenderContext& c) { c.SetBlendState(MakeHandle(7, 1)); } } },
+			{ StateCall::DepthStencil, {
+				[](RenderContext& c) { c.SetDepthStencilState(MakeHandle(8, 0), 0); },
+				[](RenderContext& c) { c.SetDepthStencilState(MakeHandle(8, 0), 1); },
+				[](RenderContext& c) { c.SetDepthStencilState(MakeHandle(8, 1), 1); } } },
+			{ StateCall::RenderTarget, {
+				[](RenderContext& c) { c.SetRenderTarget(MakeHandle(0, 0), MakeHandle(0, 1)); },
+				[](RenderContext& c) { c.SetRenderTarget(MakeHandle(0, 0), nullptr); },
+				[](RenderContext& c) { c.SetRenderTarget(MakeHandle(0, 2), nullptr); } } },
+			{ StateCall::Sampler, {
+				[](RenderContext& c) { c.SetSampler(ShaderStage::Pixel, 0, MakeHandle(9, 0)); },
+				[](RenderContext& c) { c.SetSampler(ShaderStage::Pixel, 0, MakeHandle(9, 1)); },
+				[](RenderContext& c) { c.SetSampler(ShaderStage::Pixel, 3, MakeHandle(9, 1)); },
+				[](RenderContext& c) { c.SetSampler(ShaderStage::Vertex, 3, MakeHandle(9, 1)); } } },
+			{ StateCall::ShaderResource, {
+				[](RenderContext& c) { c.SetShaderResource(ShaderStage::Pixel, 0, MakeHandle(5, 0)); },
+				[](RenderContext& c) { c.SetShaderResource(ShaderStage::Pixel, 0, MakeHandle(5, 1)); },
+				[](RenderContext& c) { c.SetShaderResource(ShaderStage::Pixel, 15, MakeHandle(5, 1)); },
+				[](RenderContext& c) { c.SetShaderResource(ShaderStage::Vertex, 15, MakeHandle(5, 1)); } } },
+			{ StateCall::Pass, { [](RenderContext& c) { c.ApplyPass(MakeHandle(4, 0)); }, [](RenderContext& c) { c.ApplyPass(MakeHandle(4, 1)); } } }
+		};
+	}
+
+	size_t GetIndex(StateCall call)
+	{
+		return static_cast<size_t>(call);
+	}
+}
+
+namespace test
+{
+	void RunStateTrackingTests(Suite& suite)
+	{
+		// Every change goes through once, repeating it is dropped and counted as elided
+		suite.Add("StateTracking/Elide/EveryCall", [&]
+		{
+			const std::vector<CallKind> kinds{ GetCallKinds() };
+			DAE_CHECK(suite, kinds.size() == GetIndex(StateCall::Count));
+			for(const CallKind& kind : kinds)
+			{
+				RecordingContext recorder{};
+				StateTrackingContext tracker{ recorder };
+				for(size_t v{ 0 }; v < kind.variants.size(); ++v)
+				{
+					kind.variants[v](tracker);
+					kind.variants[v](tracker);
+					DAE_CHECK(suite, recorder.GetCalls(kind.call) == v + 1);
+				}
+				const StateStats& stats{ tracker.GetStats() };
+				DAE_CHECK(suite, stats.issued[GetIndex(kind.call)] == kind.variants.size());
+				DAE_CHECK(suite, stats.elided[GetIndex(kind.call)] == kind.variants.size());
+				DAE_CHECK(suite, stats.GetIssued() == kind.variants.size() && stats.GetElided() == kind.variants.size());
+				DAE_CHECK(suite, recorder.calls == kind.variants.size());
+			}
+		});
+
+		// Mesh::Render calls InvalidatePass before every draw: the pass is applied every time, the input assembler only once
+		suite.Add("StateTracking/Pass/InvalidateAndApply", [&]
+		{
+			RecordingContext recorder{};
+			StateTrackingContext tracker{ recorder };
+			void* const pPass{ MakeHandle(4, 0) };
+			for(int draw{ 0 }; draw < 3; ++draw)
+			{
+				tracker.SetInputLayout(MakeHandle(1, 0));
+				tracker.SetVertexBuffer(0, MakeHandle(2, 0), 32, 0);
+				tracker.InvalidatePass();
+				tracker.ApplyPass(pPass);
+				tracker.DrawIndexed(36, 0, 0);
+			}
+			DAE_CHECK(suite, recorder.GetCalls(StateCall::Pass) == 3);
+			DAE_CHECK(suite, recorder.GetCalls(StateCall::InputLayout) == 1 && recorder.GetCalls(StateCall::VertexBuffer) == 1);
+			DAE_CHECK(suite, recorder.draws.size() == 3 && recorder.draws.back().pPass == pPass);
+
+			// Without InvalidatePass the same pass is dropped
+			tracker.ApplyPass(pPass);
+			DAE_CHECK(suite, recorder.GetCalls(StateCall::Pass) == 3);
+
+			// The pass bound its own states: setting one goes through even when it was set before, and then the
+			// pass has to be applied again
+			tracker.SetRasterizerState(MakeHandle(6, 0));
+			tracker.SetRasterizerState(MakeHandle(6, 0));
+			DAE_CHECK(suite, recorder.GetCalls(StateCall::Rasterizer) == 1);
+			tracker.ApplyPass(pPass);
+			DAE_CHECK(suite, recorder.GetCalls(StateCall::Pass) == 4);
+			tracker.SetRasterizerState(MakeHandle(6, 0));
+			DAE_CHECK(suite, recorder.GetCalls(StateCall::Rasterizer) == 2);
+			DAE_CHECK(suite, recorder.GetState().pRasterizerState == MakeHandle(6, 0));
+
+			// Same for a texture, the state at the draw is what the unfiltered calls would leave
+			tracker.ApplyPass(pPass);
+			tracker.SetShaderResource(ShaderStage::Pixel, 1, MakeHandle(5, 0));
+			tracker.DrawIndexed(36, 0, 0);
+			DAE_CHECK(suite, recorder.draws.back().shaderResources[1] == MakeHandle(5, 0));
+			DAE_CHECK(suite, recorder.draws.back().pRasterizerState == pPass);
+		});
+
+		suite.Add("StateTracking/BeginFrame/Resets", [&]
+		{
+			RecordingContext recorder{};
+			StateTrackingContext tracker{ recorder };
+			const std::vector<CallKind> kinds{ GetCallKinds() };
+			const auto issueFrame = [&]
+			{
+				tracker.BeginFrame();
+				for(int repeat{ 0 }; repeat < 2; ++repeat)
+				{
+					for(const CallKind& kind : kinds)
+						kind.variants.front()(tracker);
+				}
+				tracker.DrawIndexedInstanced(36, 10, 0, 0, 0);
+			};
+
+			issueFrame();
+			const StateStats first{ tracker.GetStats() };
+			const size_t firstCalls{ recorder.calls };
+			DAE_CHECK(suite, first.draws == 1 && first.instances == 10);
+			DAE_CHECK(suite, first.GetIssued() > 0 && first.GetElided() > 0);
+
+			tracker.BeginFrame();
+			const StateStats& stats{ tracker.GetStats() };
+			DAE_CHECK(suite, stats.GetIssued() == 0 && stats.GetElided() == 0 && stats.draws == 0 && stats.instances == 0);
+
+			// Nothing is known anymore, the first frame's calls all go through again
+			issueFrame();
+			DAE_CHECK(suite, recorder.calls == 2 * firstCalls);
+			DAE_CHECK(suite, tracker.GetStats().issued == first.issued && tracker.GetStats().elided == first.elided);
+
+			// Invalidate forgets the bindings but keeps counting
+			tracker.Invalidate();
+			kinds.front().variants.front()(tracker);
+			DAE_CHECK(suite, tracker.GetStats().issued[GetIndex(kinds.front().call)] == first.issued[GetIndex(kinds.front().call)] + 1);
+		});
+
+		// A whole frame like the renderer's, twice so the second one starts on the first one's bindings
+		suite.Add("StateTracking/Frame/MatchesDirect", [&]
+		{
+			constexpr size_t drawCount{ 1000 };
+			RecordingContext direct{};
+			RecordingContext tracked{};
+			StateTrackingContext tracker{ tracked };
+			for(int frame{ 0 }; frame < 2; ++frame)
+			{
+				bench::RenderFrame(direct, nullptr, drawCount);
+				bench::RenderFrame(tracker, &tracker, drawCount);
+			}
+			DAE_CHECK(suite, direct.draws.size() == 2 * drawCount);
+			DAE_CHECK(suite, direct.draws == tracked.draws);
+			DAE_CHECK(suite, tracked.calls < direct.calls);
+			DAE_CHECK(suite, tracker.GetStats().draws == drawCount);
+			DAE_CHECK(suite, tracker.GetStats().GetIssued() == tracked.calls / 2);
+		});
+	}
+}
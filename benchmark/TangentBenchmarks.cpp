@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <array>
+#include <thread>
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "TangentSpace.h"
+
+using namespace dae;
+
+namespace
+{
+	// The unnormalized per triangle accumulation the importer used before, for reference
+	void CheapTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		for(Vertex& vertex : vertices)
+			vertex.tangent = {};
+
+		for(size_t i{ 0 }; i < indices.size(); i += 3)
+		{
+			Vertex& v0{ vertices[indices[i]] };
+			Vertex& v1{ vertices[indices[i + 1]] };
+			Vertex& v2{ vertices[indices[i + 2]] };
+
+			const Vector3 edge0{ v1.position - v0.position };
+			const Vector3 edge1{ v2.position - v0.position };
+			const Vector2 diffX{ v1.uv.x - v0.uv.x, v2.uv.x - v0.uv.x };
+			const Vector2 diffY{ v1.uv.y - v0.uv.y, v2.uv.y - v0.uv.y };
+			const Vector3 tangent{ (edge0 * diffY.y - edge1 * diffY.x) * (1.f / Vector2::Cross(diffX, diffY)) };
+			v0.tangent += Vector4{ tangent, 0.f };
+			v1.tangent += Vector4{ tangent, 0.f };
+			v2.tangent += Vector4{ tangent, 0.f };
+		}
+	}
+
+	// Wavy grid with the UVs mirrored in the right half, like a symmetric model with shared texture space
+	void MakeGridMesh(size_t quadsPerSide, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		const size_t verticesPerSide{ quadsPerSide + 1 };
+		vertices.resize(verticesPerSide * verticesPerSide);
+		for(size_t y{ 0 }; y < verticesPerSide; ++y)
+		{
+			for(size_t x{ 0 }; x < verticesPerSide; ++x)
+			{
+				const float u{ static_cast<float>(x) / static_cast<float>(quadsPerSide) };
+				const float v{ static_cast<float>(y) / static_cast<float>(quadsPerSide) };
+				const float height{ std::sin(u * 20.f) * std::cos(v * 20.f) };
+
+				Vertex& vertex{ vertices[y * verticesPerSide + x] };
+				vertex.position = { u * 100.f, height, v * 100.f };
+				vertex.normal = Vector3{ -0.2f * std::cos(u * 20.f) * std::cos(v * 20.f), 1.f, 0.2f * std::sin(u * 20.f) * std::sin(v * 20.f) }.Normalized();
+				vertex.uv = { u < 0.5f ? u * 2.f : 2.f - u * 2.f, v };
+			}
+		}
+
+		indices.clear();
+		indices.reserve(quadsPerSide * quadsPerSide * 6);
+		for(size_t y{ 0 }; y < quadsPerSide; ++y)
+		{
+			for(size_t x{ 0 }; x < quadsPerSide; ++x)
+			{
+				const uint32_t i0{ static_cast<uint32_t>(y * verticesPerSide + x) };
+				const uint32_t i1{ i0 + 1 };
+				const uint32_t i2{ i1 + static_cast<uint32_t>(verticesPerSide) };
+				const uint32_t i3{ i0 + static_cast<uint32_t>(verticesPerSide) };
+				indices.insert(indices.end(), { i0, i2, i1, i0, i3, i2 });
+			}
+		}
+	}
+
+	// At least two so the parallel path is measured even on a single core
+	const uint32_t PARALLEL_THREAD_COUNT{ std::max(std::thread::hardware_concurrency(), 2u) };
+
+	std::array<std::string, 3> GetBenchmarkNames(const std::string& meshName)
+	{
+		return {
+			"Tangents/" + meshName + "/Cheap(reference)",
+			"Tangents/" + meshName + "/GenerateTangents(1 thread)",
+			"Tangents/" + meshName + "/GenerateTangents(" + std::to_string(PARALLEL_THREAD_COUNT) + " threads)"
+		};
+	}
+
+	// Meshes are only made when one of their benchmarks runs
+	bool IsMeshEnabled(const bench::Suite& suite, const std::string& meshName)
+	{
+		const std::array<std::string, 3> names{ GetBenchmarkNames(meshName) };
+		return std::any_of(names.begin(), names.end(), [&](const std::string& name) { return suite.IsEnabled(name); });
+	}
+
+	void RunMesh(bench::Suite& suite, const std::string& name, std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		const size_t triangleCount{ indices.size() / 3 };
+		const uint32_t threadCount{ PARALLEL_THREAD_COUNT };
+		const std::array<std::string, 3> names{ GetBenchmarkNames(name) };
+
+		std::vector<Vertex> sequential{ vertices };
+		Utils::GenerateTangents(vertices, indices, threadCount);
+
+		const size_t mirrored{ static_cast<size_t>(std::count_if(vertices.begin(), vertices.end(), [](const Vertex& v) { return v.tangent.w < 0.f; })) };
+		std::fprintf(stderr, "%s: %zu triangles, %zu vertices, %zu with a mirrored frame\n", name.c_str(), triangleCount, vertices.size(), mirrored);
+
+		suite.Add(names[0], triangleCount, [&]
+		{
+			CheapTangents(sequential, indices);
+			bench::DoNotOptimize(sequential.data());
+		});
+		suite.Add(names[1], triangleCount, [&]
+		{
+			Utils::GenerateTangents(vertices, indices, 1);
+			bench::DoNotOptimize(vertices.data());
+		});
+		suite.Add(names[2], triangleCount, [&]
+		{
+			Utils::GenerateTangents(vertices, indices, threadCount);
+			bench::DoNotOptimize(vertices.data());
+		});
+	}
+}
+
+namespace bench
+{
+	void RunTangentBenchmarks(Suite& suite)
+	{
+		if(IsMeshEnabled(suite, "vehicle"))
+		{
+			const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			if(file.IsOpen() && Utils::ParseOBJText(file.GetText(), vertices, indices))
+				RunMesh(suite, "vehicle", vertices, indices);
+		}
+
+		// 2 * 1581^2 is just under 5M triangles
+		if(IsMeshEnabled(suite, "grid5M"))
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			MakeGridMesh(1581, vertices, indices);
+			RunMesh(suite, "grid5M", vertices, indices);
+		}
+	}
+}
@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "ObjParser.h"
+#include "TangentSpace.h"
+
+#include <cstring>
+
+using namespace dae;
+
+namespace
+{
+	constexpr float EPSILON{ 1e-4f };
+
+	// Separate quad (two triangles) in the xy plane facing -z, uv.x follows uAxis and uv.y follows vAxis
+	void AddQuad(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const Vector2& uAxis, const Vector2& vAxis, float offsetX)
+	{
+		const uint32_t first{ static_cast<uint32_t>(vertices.size()) };
+		for(const Vector2& corner : { Vector2{ 0.f, 0.f }, Vector2{ 1.f, 0.f }, Vector2{ 1.f, 1.f }, Vector2{ 0.f, 1.f } })
+		{
+			Vertex vertex{};
+			vertex.position = { corner.x + offsetX, corner.y, 0.f };
+			vertex.normal = { 0.f, 0.f, -1.f };
+			vertex.uv = { Vector2::Dot(corner, uAxis), Vector2::Dot(corner, vAxis) };
+			vertices.push_back(vertex);
+		}
+		indices.insert(indices.end(), { first, first + 2, first + 1, first, first + 3, first + 2 });
+	}
+
+	Vector3 GetBitangent(const Vertex& vertex)
+	{
+		return Vector3::Cross(vertex.normal, vertex.tangent.GetXYZ()) * vertex.tangent.w;
+	}
+
+	// Grid from the OBJ tests with its uvs mirrored in the right half
+	void MakeMirroredGrid(size_t quadsPerSide, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		Utils::ParseOBJText(bench::MakeGridOBJ(quadsPerSide), vertices, indices);
+		for(Vertex& vertex : vertices)
+			vertex.uv.x = vertex.uv.x < 0.5f ? vertex.uv.x * 2.f : 2.f - vertex.uv.x * 2.f;
+	}
+}
+
+namespace test
+{
+	void RunTangentTests(Suite& suite)
+	{
+		// The frame follows the uv directions, mirrored or rotated uvs flip or turn it
+		suite.Add("Tangents/Quad/FollowsUVs", [&]
+		{
+			const Vector2 uvAxes[][2]{
+				{ { 1.f, 0.f }, { 0.f, 1.f } },
+				{ { -1.f, 0.f }, { 0.f, 1.f } },
+				{ { 1.f, 0.f }, { 0.f, -1.f } },
+				{ { 0.f, 1.f }, { 1.f, 0.f } },
+				{ { 0.f, -2.f }, { 3.f, 0.f } }
+			};
+			for(const auto& axes : uvAxes)
+			{
+				std::vector<Vertex> vertices{};
+				std::vector<uint32_t> indices{};
+				AddQuad(vertices, indices, axes[0], axes[1], 0.f);
+				Utils::GenerateTangents(vertices, indices, 1);
+
+				const Vector3 uDirection{ Vector3{ axes[0].x, axes[0].y, 0.f }.Normalized() };
+				const Vector3 vDirection{ Vector3{ axes[1].x, axes[1].y, 0.f }.Normalized() };
+				const float handedness{ Vector2::Cross(axes[0], axes[1]) > 0.f ? -1.f : 1.f };
+				for(const Vertex& vertex : vertices)
+				{
+					DAE_CHECK(suite, Vector3::Dot(vertex.tangent.GetXYZ(), uDirection) > 1.f - EPSILON);
+					DAE_CHECK(suite, Vector3::Dot(GetBitangent(vertex), vDirection) > 1.f - EPSILON);
+					DAE_CHECK(suite, vertex.tangent.w == handedness);
+				}
+			}
+		});
+
+		suite.Add("Tangents/Grid/Orthonormal", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			MakeMirroredGrid(60, vertices, indices);
+			// Leftovers from the import may not leak into the result
+			for(Vertex& vertex : vertices)
+				vertex.tangent = { 5.f, 5.f, 5.f, 0.f };
+			Utils::GenerateTangents(vertices, indices, 1);
+
+			size_t mirrored{};
+			for(const Vertex& vertex : vertices)
+			{
+				const Vector3 tangent{ vertex.tangent.GetXYZ() };
+				DAE_CHECK(suite, std::abs(tangent.Magnitude() - 1.f) < EPSILON);
+				DAE_CHECK(suite, std::abs(Vector3::Dot(tangent, vertex.normal)) < EPSILON);
+				DAE_CHECK(suite, vertex.tangent.w == 1.f || vertex.tangent.w == -1.f);
+				mirrored += vertex.tangent.w != vertices.front().tangent.w;
+			}
+			// Both halves are there, the seam column goes either way
+			DAE_CHECK(suite, mirrored >= 60 * 61 / 2 && mirrored <= 61 * 61 / 2 + 61);
+		});
+
+		suite.Add("Tangents/DegenerateUVs", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			AddQuad(vertices, indices, { 0.f, 0.f }, { 0.f, 0.f }, 0.f);
+			// Only the second quad has usable uvs, the first still needs a valid frame
+			AddQuad(vertices, indices, { 1.f, 0.f }, { 0.f, 1.f }, 2.f);
+			Utils::GenerateTangents(vertices, indices, 1);
+			for(const Vertex& vertex : vertices)
+			{
+				DAE_CHECK(suite, std::isfinite(vertex.tangent.x) && std::isfinite(vertex.tangent.y) && std::isfinite(vertex.tangent.z));
+				DAE_CHECK(suite, std::abs(vertex.tangent.GetXYZ().Magnitude() - 1.f) < EPSILON);
+				DAE_CHECK(suite, std::abs(Vector3::Dot(vertex.tangent.GetXYZ(), vertex.normal)) < EPSILON);
+			}
+			DAE_CHECK(suite, vertices[4].tangent.x > 1.f - EPSILON);
+		});
+
+		// Big enough for the parallel path, the frames may not depend on the thread count
+		suite.Add("Tangents/Parallel/MatchesSequential", [&]
+		{
+			std::vector<Vertex> sequential{};
+			std::vector<uint32_t> indices{};
+			MakeMirroredGrid(200, sequential, indices);
+			Utils::GenerateTangents(sequential, indices, 1);
+
+			for(const uint32_t threadCount : { 2u, 3u, 8u })
+			{
+				std::vector<Vertex> vertices{ sequential };
+				for(Vertex& vertex : vertices)
+					vertex.tangent = {};
+				Utils::GenerateTangents(vertices, indices, threadCount);
+				DAE_CHECK(suite, std::memcmp(vertices.data(), sequential.data(), vertices.size() * sizeof(Vertex)) == 0);
+			}
+		});
+	}
+}
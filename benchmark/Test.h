@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace test
+{
+	class Suite final
+	{
+	public:
+		explicit Suite(std::string filter) :
+			m_Filter{ std::move(filter) }
+		{
+		}
+
+		// False when the name does not contain the filter, lets expensive setup be skipped
+		bool IsEnabled(const std::string& name) const
+		{
+			return m_Filter.empty() || name.find(m_Filter) != std::string::npos;
+		}
+
+		// Runs body once, the test fails when any Check inside it fails. Skipped when the name does not contain the filter.
+		template<typename Body>
+		void Add(const std::string& name, Body&& body)
+		{
+			if(!IsEnabled(name))
+				return;
+
+			m_CheckFailures = 0;
+			body();
+
+			++m_TestCount;
+			if(m_CheckFailures > 0)
+				++m_FailedCount;
+			std::fprintf(stderr, "%-56s %s\n", name.c_str(), m_CheckFailures > 0 ? "FAILED" : "ok");
+		}
+
+		// Only the first few failures of one test are printed, a broken kernel would flood the output otherwise
+		bool Check(bool condition, const char* expression, const char* file, int line)
+		{
+			if(!condition)
+			{
+				if(m_CheckFailures < 8)
+					std::fprintf(stderr, "  %s(%d): check failed: %s\n", file, line, expression);
+				++m_CheckFailures;
+			}
+			return condition;
+		}
+
+		size_t GetTestCount() const { return m_TestCount; }
+		size_t GetFailedCount() const { return m_FailedCount; }
+
+	private:
+		std::string m_Filter;
+		size_t m_TestCount{};
+		size_t m_FailedCount{};
+		size_t m_CheckFailures{};
+	};
+
+	// Distance in representable floats, 0 for equal values (and +0 / -0)
+	inline uint32_t GetUlpDistance(float a, float b)
+	{
+		if(std::isnan(a) || std::isnan(b))
+			return UINT32_MAX;
+
+		// Map the sign magnitude bits onto one monotonic integer line
+		const auto toOrdered = [](float f)
+		{
+			const int32_t bits{ std::bit_cast<int32_t>(f) };
+			return bits < 0 ? static_cast<int64_t>(INT32_MIN) - bits : static_cast<int64_t>(bits);
+		};
+		const int64_t distance{ toOrdered(a) - toOrdered(b) };
+		return static_cast<uint32_t>(std::min<int64_t>(distance < 0 ? -distance : distance, UINT32_MAX));
+	}
+
+	// Within maxUlps of expected, counted at magnitude when that is larger. Results of sums that cancel towards zero
+	// carry the rounding error of their largest term, magnitude is that term.
+	inline bool IsNearUlps(float actual, float expected, uint32_t maxUlps, float magnitude = 0.f)
+	{
+		if(GetUlpDistance(actual, expected) <= maxUlps)
+			return true;
+
+		const float scale{ std::max(std::abs(expected), std::abs(magnitude)) };
+		const float ulp{ std::nextafter(scale, INFINITY) - scale };
+		return std::abs(actual - expected) <= static_cast<float>(maxUlps) * ulp;
+	}
+
+	// One per test file, adds its tests to the suite
+	void RunMatrixTests(Suite& suite);
+	void RunConstexprTests(Suite& suite);
+	void RunMathHelpersTests(Suite& suite);
+	void RunHalfTests(Suite& suite);
+	void RunColorTests(Suite& suite);
+	void RunObjTests(Suite& suite);
+	void RunThreadPoolTests(Suite& suite);
+	void RunMeshCacheTests(Suite& suite);
+	void RunTangentTests(Suite& suite);
+	void RunVertexCacheTests(Suite& suite);
+	void RunPackedVertexTests(Suite& suite);
+	void RunIndexFormatTests(Suite& suite);
+	void RunSimplifierTests(Suite& suite);
+	void RunLodTests(Suite& suite);
+	void RunMeshletTests(Suite& suite);
+	void RunFrustumTests(Suite& suite);
+	void RunOcclusionTests(Suite& suite);
+	void RunRenderQueueTests(Suite& suite);
+	void RunStateTrackingTests(Suite& suite);
+	void RunInstancingTests(Suite& suite);
+}
+
+#define DAE_CHECK(suite, condition) (suite).Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
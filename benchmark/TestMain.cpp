@@ -0,0 +1,49 @@
+#include "pch.h"
+#include "Test.h"
+
+#include <cstring>
+
+int main(int argc, char* argv[])
+{
+	std::string filter{};
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		if(std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else
+		{
+			std::fprintf(stderr, "Usage: Tests [--filter <substring>]\n");
+			return 1;
+		}
+	}
+
+	test::Suite suite{ filter };
+	test::RunMatrixTests(suite);
+	test::RunConstexprTests(suite);
+	test::RunMathHelpersTests(suite);
+	test::RunHalfTests(suite);
+	test::RunColorTests(suite);
+	test::RunObjTests(suite);
+	test::RunThreadPoolTests(suite);
+	test::RunMeshCacheTests(suite);
+	test::RunTangentTests(suite);
+	test::RunVertexCacheTests(suite);
+	test::RunPackedVertexTests(suite);
+	test::RunIndexFormatTests(suite);
+	test::RunSimplifierTests(suite);
+	test::RunLodTests(suite);
+	test::RunMeshletTests(suite);
+	test::RunFrustumTests(suite);
+	test::RunOcclusionTests(suite);
+	test::RunRenderQueueTests(suite);
+	test::RunStateTrackingTests(suite);
+	test::RunInstancingTests(suite);
+
+	std::fprintf(stderr, "%zu of %zu tests passed\n", suite.GetTestCount() - suite.GetFailedCount(), suite.GetTestCount());
+	if(suite.GetTestCount() == 0)
+	{
+		std::fprintf(stderr, "No test matches '%s'\n", filter.c_str());
+		return 1;
+	}
+	return suite.GetFailedCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "ThreadPool.h"
+
+#include <atomic>
+
+using namespace dae;
+
+namespace test
+{
+	void RunThreadPoolTests(Suite& suite)
+	{
+		suite.Add("ThreadPool/ParallelFor/EveryTaskOnce", [&]
+		{
+			ThreadPool pool{ 4 };
+			DAE_CHECK(suite, pool.GetThreadCount() == 4);
+
+			// Several rounds on the same pool, with fewer and more tasks than threads
+			for(const size_t taskCount : { size_t{ 0 }, size_t{ 1 }, size_t{ 3 }, size_t{ 1000 } })
+			{
+				std::vector<std::atomic<int>> runs(taskCount);
+				pool.ParallelFor(taskCount, [&](size_t task) { ++runs[task]; });
+				DAE_CHECK(suite, std::all_of(runs.begin(), runs.end(), [](const std::atomic<int>& count) { return count == 1; }));
+			}
+		});
+
+		suite.Add("ThreadPool/ParallelForRanges/CoversEveryIndex", [&]
+		{
+			ThreadPool pool{ 3 };
+			for(const size_t rangeCount : { size_t{ 1 }, size_t{ 7 }, size_t{ 64 } })
+			{
+				std::vector<int> covered(1001);
+				std::atomic<size_t> ranges{};
+				pool.ParallelForRanges(covered.size(), rangeCount, [&](size_t begin, size_t end, size_t)
+				{
+					for(size_t i{ begin }; i < end; ++i)
+						++covered[i];
+					++ranges;
+				});
+				DAE_CHECK(suite, ranges == rangeCount);
+				DAE_CHECK(suite, std::all_of(covered.begin(), covered.end(), [](int count) { return count == 1; }));
+			}
+		});
+	}
+}
@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+using namespace dae;
+
+namespace
+{
+	std::vector<Vector2> RandomVector2s(uint32_t seed)
+	{
+		return bench::RandomValues<Vector2, 2>(bench::BATCH_SIZE, seed, [](const float* f) { return Vector2{ f[0], f[1] }; });
+	}
+
+	std::vector<Vector3> RandomVector3s(uint32_t seed)
+	{
+		return bench::RandomValues<Vector3, 3>(bench::BATCH_SIZE, seed, [](const float* f) { return Vector3{ f[0], f[1], f[2] }; });
+	}
+
+	std::vector<Vector4> RandomVector4s(uint32_t seed)
+	{
+		return bench::RandomValues<Vector4, 4>(bench::BATCH_SIZE, seed, [](const float* f) { return Vector4{ f[0], f[1], f[2], f[3] }; });
+	}
+
+	std::vector<int> RandomIndices(uint32_t seed, int count)
+	{
+		const std::vector<float> floats{ bench::RandomFloats(bench::BATCH_SIZE, seed, 0.f, static_cast<float>(count)) };
+		std::vector<int> indices(floats.size());
+		for(size_t i{ 0 }; i < floats.size(); ++i)
+			indices[i] = std::min(static_cast<int>(floats[i]), count - 1);
+		return indices;
+	}
+
+	void RunVector2(bench::Suite& suite)
+	{
+		const std::vector<Vector2> a{ RandomVector2s(20) };
+		const std::vector<Vector2> b{ RandomVector2s(21) };
+		const std::vector<float> scalars{ bench::RandomFloats(bench::BATCH_SIZE, 22, 0.5f, 2.f) };
+		const std::vector<int> indices{ RandomIndices(23, 2) };
+		std::vector<Vector2> vectors(bench::BATCH_SIZE);
+		std::vector<float> floats(bench::BATCH_SIZE);
+
+		suite.AddZip("Vector2/Vector2(from, to)", a, b, vectors, [](const Vector2& from, const Vector2& to) { return Vector2{ from, to }; });
+		suite.AddMap("Vector2/Magnitude", a, floats, [](const Vector2& v) { return v.Magnitude(); });
+		suite.AddMap("Vector2/SqrMagnitude", a, floats, [](const Vector2& v) { return v.SqrMagnitude(); });
+		suite.AddInPlace("Vector2/Normalize", a, vectors, [](Vector2& v, size_t) { v.Normalize(); });
+		suite.AddMap("Vector2/Normalized", a, vectors, [](const Vector2& v) { return v.Normalized(); });
+		suite.AddZip("Vector2/Dot", a, b, floats, [](const Vector2& v1, const Vector2& v2) { return Vector2::Dot(v1, v2); });
+		suite.AddZip("Vector2/Cross", a, b, floats, [](const Vector2& v1, const Vector2& v2) { return Vector2::Cross(v1, v2); });
+		suite.AddZip("Vector2/operator*(float)", a, scalars, vectors, [](const Vector2& v, float s) { return v * s; });
+		suite.AddZip("Vector2/operator*(float, Vector2)", scalars, a, vectors, [](float s, const Vector2& v) { return s * v; });
+		suite.AddZip("Vector2/operator/(float)", a, scalars, vectors, [](const Vector2& v, float s) { return v / s; });
+		suite.AddZip("Vector2/operator+", a, b, vectors, [](const Vector2& v1, const Vector2& v2) { return v1 + v2; });
+		suite.AddZip("Vector2/operator-", a, b, vectors, [](const Vector2& v1, const Vector2& v2) { return v1 - v2; });
+		suite.AddMap("Vector2/operator-()", a, vectors, [](const Vector2& v) { return -v; });
+		suite.AddInPlace("Vector2/operator+=", a, vectors, [&](Vector2& v, size_t i) { v += b[i]; });
+		suite.AddInPlace("Vector2/operator-=", a, vectors, [&](Vector2& v, size_t i) { v -= b[i]; });
+		suite.AddInPlace("Vector2/operator/=", a, vectors, [&](Vector2& v, size_t i) { v /= scalars[i]; });
+		suite.AddInPlace("Vector2/operator*=", a, vectors, [&](Vector2& v, size_t i) { v *= scalars[i]; });
+		suite.AddZip("Vector2/operator[]", a, indices, floats, [](const Vector2& v, int index) { return v[index]; });
+	}
+
+	void RunVector3(bench::Suite& suite)
+	{
+		const std::vector<Vector3> a{ RandomVector3s(30) };
+		const std::vector<Vector3> b{ RandomVector3s(31) };
+		const std::vector<Vector4> a4{ RandomVector4s(32) };
+		const std::vector<float> scalars{ bench::RandomFloats(bench::BATCH_SIZE, 33, 0.5f, 2.f) };
+		const std::vector<int> indices{ RandomIndices(34, 3) };
+		std::vector<Vector3> vectors(bench::BATCH_SIZE);
+		std::vector<Vector4> vectors4(bench::BATCH_SIZE);
+		std::vector<Vector2> vectors2(bench::BATCH_SIZE);
+		std::vector<float> floats(bench::BATCH_SIZE);
+
+		suite.AddZip("Vector3/Vector3(from, to)", a, b, vectors, [](const Vector3& from, const Vector3& to) { return Vector3{ from, to }; });
+		suite.AddMap("Vector3/Vector3(Vector4)", a4, vectors, [](const Vector4& v) { return Vector3{ v }; });
+		suite.AddMap("Vector3/Magnitude", a, floats, [](const Vector3& v) { return v.Magnitude(); });
+		suite.AddMap("Vector3/SqrMagnitude", a, floats, [](const Vector3& v) { return v.SqrMagnitude(); });
+		suite.AddInPlace("Vector3/Normalize", a, vectors, [](Vector3& v, size_t) { v.Normalize(); });
+		suite.AddMap("Vector3/Normalized", a, vectors, [](const Vector3& v) { return v.Normalized(); });
+		suite.AddZip("Vector3/Dot", a, b, floats, [](const Vector3& v1, const Vector3& v2) { return Vector3::Dot(v1, v2); });
+		suite.AddZip("Vector3/Cross", a, b, vectors, [](const Vector3& v1, const Vector3& v2) { return Vector3::Cross(v1, v2); });
+		suite.AddZip("Vector3/Project", a, b, vectors, [](const Vector3& v1, const Vector3& v2) { return Vector3::Project(v1, v2); });
+		suite.AddZip("Vector3/Reject", a, b, vectors, [](const Vector3& v1, const Vector3& v2) { return Vector3::Reject(v1, v2); });
+		suite.AddZip("Vector3/Reflect", a, b, vectors, [](const Vector3& v1, const Vector3& v2) { return Vector3::Reflect(v1, v2); });
+		suite.AddMap("Vector3/ToPoint4", a, vectors4, [](const Vector3& v) { return v.ToPoint4(); });
+		suite.AddMap("Vector3/ToVector4", a, vectors4, [](const Vector3& v) { return v.ToVector4(); });
+		suite.AddMap("Vector3/GetXY", a, vectors2, [](const Vector3& v) { return v.GetXY(); });
+		suite.AddZip("Vector3/operator*(float)", a, scalars, vectors, [](const Vector3& v, float s) { return v * s; });
+		suite.AddZip("Vector3/operator*(float, Vector3)", scalars, a, vectors, [](float s, const Vector3& v) { return s * v; });
+		suite.AddZip("Vector3/operator/(float)", a, scalars, vectors, [](const Vector3& v, float s) { return v / s; });
+		suite.AddZip("Vector3/operator+", a, b, vectors, [](const Vector3& v1, const Vector3& v2) { return v1 + v2; });
+		suite.AddZip("Vector3/operator-", a, b, vectors, [](const Vector3& v1, const Vector3& v2) { return v1 - v2; });
+		suite.AddMap("Vector3/operator-()", a, vectors, [](const Vector3& v) { return -v; });
+		suite.AddInPlace("Vector3/operator+=", a, vectors, [&](Vector3& v, size_t i) { v += b[i]; });
+		suite.AddInPlace("Vector3/operator-=", a, vectors, [&](Vector3& v, size_t i) { v -= b[i]; });
+		suite.AddInPlace("Vector3/operator/=", a, vectors, [&](Vector3& v, size_t i) { v /= scalars[i]; });
+		suite.AddInPlace("Vector3/operator*=", a, vectors, [&](Vector3& v, size_t i) { v *= scalars[i]; });
+		suite.AddZip("Vector3/operator[]", a, indices, floats, [](const Vector3& v, int index) { return v[index]; });
+	}
+
+	void RunVector4(bench::Suite& suite)
+	{
+		const std::vector<Vector4> a{ RandomVector4s(40) };
+		const std::vector<Vector4> b{ RandomVector4s(41) };
+		const std::vector<Vector3> a3{ RandomVector3s(42) };
+		const std::vector<float> scalars{ bench::RandomFloats(bench::BATCH_SIZE, 43, 0.5f, 2.f) };
+		const std::vector<int> indices{ RandomIndices(44, 4) };
+		std::vector<Vector4> vectors(bench::BATCH_SIZE);
+		std::vector<Vector3> vectors3(bench::BATCH_SIZE);
+		std::vector<Vector2> vectors2(bench::BATCH_SIZE);
+		std::vector<float> floats(bench::BATCH_SIZE);
+
+		suite.AddZip("Vector4/Vector4(Vector3, w)", a3, scalars, vectors, [](const Vector3& v, float w) { return Vector4{ v, w }; });
+		suite.AddMap("Vector4/Magnitude", a, floats, [](const Vector4& v) { return v.Magnitude(); });
+		suite.AddMap("Vector4/SqrMagnitude", a, floats, [](const Vector4& v) { return v.SqrMagnitude(); });
+		suite.AddInPlace("Vector4/Normalize", a, vectors, [](Vector4& v, size_t) { v.Normalize(); });
+		suite.AddMap("Vector4/Normalized", a, vectors, [](const Vector4& v) { return v.Normalized(); });
+		suite.AddMap("Vector4/GetXY", a, vectors2, [](const Vector4& v) { return v.GetXY(); });
+		suite.AddMap("Vector4/GetXYZ", a, vectors3, [](const Vector4& v) { return v.GetXYZ(); });
+		suite.AddZip("Vector4/Dot", a, b, floats, [](const Vector4& v1, const Vector4& v2) { return Vector4::Dot(v1, v2); });
+		suite.AddZip("Vector4/operator*(float)", a, scalars, vectors, [](const Vector4& v, float s) { return v * s; });
+		suite.AddZip("Vector4/operator+", a, b, vectors, [](const Vector4& v1, const Vector4& v2) { return v1 + v2; });
+		suite.AddZip("Vector4/operator-", a, b, vectors, [](const Vector4& v1, const Vector4& v2) { return v1 - v2; });
+		suite.AddInPlace("Vector4/operator+=", a, vectors, [&](Vector4& v, size_t i) { v += b[i]; });
+		suite.AddZip("Vector4/operator[]", a, indices, floats, [](const Vector4& v, int index) { return v[index]; });
+	}
+}
+
+namespace bench
+{
+	void RunVectorBenchmarks(Suite& suite)
+	{
+		RunVector2(suite);
+		RunVector3(suite);
+		RunVector4(suite);
+	}
+}
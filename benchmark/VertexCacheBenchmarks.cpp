@@ -0,0 +1,102 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "VertexCache.h"
+
+using namespace dae;
+
+namespace
+{
+	using Triangle = std::array<uint32_t, 3>;
+
+	void PrintCacheStats(const std::string& name, const std::vector<uint32_t>& indices, size_t vertexCount, const char* label)
+	{
+		const Utils::VertexCacheStats fifo16{ Utils::AnalyzeVertexCache(indices, vertexCount, 16, Utils::VertexCacheType::FIFO) };
+		const Utils::VertexCacheStats fifo32{ Utils::AnalyzeVertexCache(indices, vertexCount, 32, Utils::VertexCacheType::FIFO) };
+		const Utils::VertexCacheStats lru32{ Utils::AnalyzeVertexCache(indices, vertexCount, 32, Utils::VertexCacheType::LRU) };
+		std::fprintf(stderr, "%s %-10s ACMR/ATVR FIFO16 %.3f/%.3f, FIFO32 %.3f/%.3f, LRU32 %.3f/%.3f\n", name.c_str(), label,
+			fifo16.GetACMR(), fifo16.GetATVR(), fifo32.GetACMR(), fifo32.GetATVR(), lru32.GetACMR(), lru32.GetATVR());
+	}
+
+	// vertices and indices come in the imported order
+	void RunMesh(bench::Suite& suite, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		const size_t triangleCount{ indices.size() / 3 };
+
+		std::vector<Vertex> optimizedVertices{ vertices };
+		std::vector<uint32_t> optimizedIndices{ indices };
+		Utils::OptimizeVertexCache(optimizedIndices, optimizedVertices.size());
+		const std::vector<uint32_t> cacheOrder{ optimizedIndices };
+		Utils::OptimizeVertexFetch(optimizedVertices, optimizedIndices);
+
+		PrintCacheStats(name, indices, vertices.size(), "imported");
+		PrintCacheStats(name, optimizedIndices, optimizedVertices.size(), "optimized");
+
+		std::vector<uint32_t> scratchIndices{};
+		std::vector<Vertex> scratchVertices{};
+		suite.Add("VertexCache/" + name + "/OptimizeVertexCache", triangleCount, [&]
+		{
+			scratchIndices = indices;
+			Utils::OptimizeVertexCache(scratchIndices, vertices.size());
+			bench::DoNotOptimize(scratchIndices.data());
+		});
+		suite.Add("VertexCache/" + name + "/OptimizeVertexFetch", triangleCount, [&]
+		{
+			scratchVertices = vertices;
+			scratchIndices = cacheOrder;
+			Utils::OptimizeVertexFetch(scratchVertices, scratchIndices);
+			bench::DoNotOptimize(scratchVertices.data());
+		});
+		suite.Add("VertexCache/" + name + "/AnalyzeVertexCache(FIFO16)", triangleCount, [&]
+		{
+			bench::DoNotOptimize(Utils::AnalyzeVertexCache(indices, vertices.size()));
+		});
+	}
+
+	bool ImportUnoptimized(std::string_view text, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		Utils::ObjImportOptions options{};
+		options.optimizeVertexCache = false;
+		return Utils::ParseOBJText(text, vertices, indices, options);
+	}
+
+	bool IsMeshEnabled(const bench::Suite& suite, const std::string& name)
+	{
+		return suite.IsEnabled("VertexCache/" + name + "/OptimizeVertexCache") || suite.IsEnabled("VertexCache/" + name + "/OptimizeVertexFetch")
+			|| suite.IsEnabled("VertexCache/" + name + "/AnalyzeVertexCache(FIFO16)");
+	}
+}
+
+namespace bench
+{
+	void RunVertexCacheBenchmarks(Suite& suite)
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		if(IsMeshEnabled(suite, "vehicle"))
+		{
+			const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+			if(file.IsOpen() && ImportUnoptimized(file.GetText(), vertices, indices))
+				RunMesh(suite, "vehicle", vertices, indices);
+		}
+
+		// Row order is already decent, the shuffled copy stands in for exporters that scatter triangles
+		if(IsMeshEnabled(suite, "grid300") || IsMeshEnabled(suite, "grid300 shuffled"))
+		{
+			ImportUnoptimized(MakeGridOBJ(300), vertices, indices);
+			RunMesh(suite, "grid300", vertices, indices);
+
+			std::vector<Triangle> triangles(indices.size() / 3);
+			std::memcpy(triangles.data(), indices.data(), indices.size() * sizeof(uint32_t));
+			std::shuffle(triangles.begin(), triangles.end(), std::mt19937{ 42 });
+			std::memcpy(indices.data(), triangles.data(), indices.size() * sizeof(uint32_t));
+			RunMesh(suite, "grid300 shuffled", vertices, indices);
+		}
+	}
+}
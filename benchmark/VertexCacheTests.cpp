@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "Test.h"
+
+#include "Benchmark.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "VertexCache.h"
+
+#include <array>
+#include <cstring>
+
+using namespace dae;
+
+namespace
+{
+	using Triangle = std::array<uint32_t, 3>;
+
+	// Triangles rotated to start at their lowest index, sorted. Same winding, order does not matter.
+	std::vector<Triangle> GetCanonicalTriangles(const std::vector<uint32_t>& indices)
+	{
+		std::vector<Triangle> triangles(indices.size() / 3);
+		for(size_t i{ 0 }; i < triangles.size(); ++i)
+		{
+			Triangle& triangle{ triangles[i] };
+			std::copy(indices.begin() + i * 3, indices.begin() + i * 3 + 3, triangle.begin());
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	// Same vertex at every corner, with the indices of both sides pointing into their own vertex buffer
+	bool HaveSameCorners(const std::vector<Vertex>& vertices1, const std::vector<uint32_t>& indices1, const std::vector<Vertex>& vertices2, const std::vector<uint32_t>& indices2)
+	{
+		return std::equal(indices1.begin(), indices1.end(), indices2.begin(), indices2.end(), [&](uint32_t index1, uint32_t index2)
+		{
+			return std::memcmp(&vertices1[index1], &vertices2[index2], sizeof(Vertex)) == 0;
+		});
+	}
+
+	bool ImportUnoptimized(std::string_view text, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		Utils::ObjImportOptions options{};
+		options.optimizeVertexCache = false;
+		return Utils::ParseOBJText(text, vertices, indices, options);
+	}
+}
+
+namespace test
+{
+	void RunVertexCacheTests(Suite& suite)
+	{
+		suite.Add("VertexCache/Analyze/FIFOAndLRU", [&]
+		{
+			// With 3 entries the shared vertex 0 drops out of a FIFO, the LRU keeps it because it was hit
+			const std::vector<uint32_t> indices{ 0, 1, 2, 0, 3, 4, 0, 4, 5 };
+			const Utils::VertexCacheStats fifo{ Utils::AnalyzeVertexCache(indices, 6, 3, Utils::VertexCacheType::FIFO) };
+			const Utils::VertexCacheStats lru{ Utils::AnalyzeVertexCache(indices, 6, 3, Utils::VertexCacheType::LRU) };
+			DAE_CHECK(suite, fifo.triangles == 3 && fifo.vertices == 6);
+			DAE_CHECK(suite, fifo.transforms == 7);
+			DAE_CHECK(suite, lru.transforms == 6);
+			DAE_CHECK(suite, lru.GetACMR() == 2.f && lru.GetATVR() == 1.f);
+
+			const std::vector<uint32_t> repeated{ 0, 1, 2, 2, 1, 0, 0, 1, 2 };
+			DAE_CHECK(suite, Utils::AnalyzeVertexCache(repeated, 3).transforms == 3);
+			DAE_CHECK(suite, Utils::AnalyzeVertexCache({}, 0).GetACMR() == 0.f);
+		});
+
+		// Both passes may only reorder, and the cache has to end up better than the imported row order or a shuffle
+		suite.Add("VertexCache/Optimize/KeepsTriangles", [&]
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> imported{};
+			ImportUnoptimized(bench::MakeGridOBJ(60), vertices, imported);
+			std::vector<uint32_t> shuffled{ imported };
+			std::vector<Triangle> triangles(shuffled.size() / 3);
+			std::memcpy(triangles.data(), shuffled.data(), shuffled.size() * sizeof(uint32_t));
+			std::shuffle(triangles.begin(), triangles.end(), std::mt19937{ 42 });
+			std::memcpy(shuffled.data(), triangles.data(), shuffled.size() * sizeof(uint32_t));
+
+			for(const std::vector<uint32_t>& indices : { imported, shuffled })
+			{
+				std::vector<uint32_t> cacheOrder{ indices };
+				Utils::OptimizeVertexCache(cacheOrder, vertices.size());
+				DAE_CHECK(suite, GetCanonicalTriangles(cacheOrder) == GetCanonicalTriangles(indices));
+
+				const float before{ Utils::AnalyzeVertexCache(indices, vertices.size()).GetACMR() };
+				const float after{ Utils::AnalyzeVertexCache(cacheOrder, vertices.size()).GetACMR() };
+				DAE_CHECK(suite, after < before);
+				// A regular grid can get 0.5, Forsyth gets within about 0.2 of it with 16 FIFO entries
+				DAE_CHECK(suite, after < 0.75f);
+
+				std::vector<Vertex> fetchVertices{ vertices };
+				std::vector<uint32_t> fetchOrder{ cacheOrder };
+				Utils::OptimizeVertexFetch(fetchVertices, fetchOrder);
+				DAE_CHECK(suite, HaveSameCorners(vertices, cacheOrder, fetchVertices, fetchOrder));
+				DAE_CHECK(suite, Utils::AnalyzeVertexCache(fetchOrder, fetchVertices.size()).transforms == Utils::AnalyzeVertexCache(cacheOrder, vertices.size()).transforms);
+			}
+		});
+
+		suite.Add("VertexCache/Fetch/FirstUseOrder", [&]
+		{
+			std::vector<Vertex> vertices(6);
+			for(size_t i{ 0 }; i < vertices.size(); ++i)
+				vertices[i].position.x = static_cast<float>(i);
+			// Vertex 1 is never used
+			std::vector<uint32_t> indices{ 5, 3, 0, 0, 3, 4, 2, 4, 3 };
+			const size_t vertexCount{ Utils::OptimizeVertexFetch(vertices, indices) };
+
+			DAE_CHECK(suite, vertexCount == 5 && vertices.size() == 5);
+			DAE_CHECK(suite, (indices == std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3, 4, 3, 1 }));
+			const float expectedX[]{ 5.f, 3.f, 0.f, 4.f, 2.f };
+			for(size_t i{ 0 }; i < vertices.size(); ++i)
+				DAE_CHECK(suite, vertices[i].position.x == expectedX[i]);
+		});
+
+		suite.Add("VertexCache/Optimize/Vehicle", [&]
+		{
+			const MappedFile file{ DAE_RESOURCE_DIR "/vehicle.obj" };
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			if(!DAE_CHECK(suite, file.IsOpen() && ImportUnoptimized(file.GetText(), vertices, indices)))
+				return;
+
+			std::vector<uint32_t> cacheOrder{ indices };
+			Utils::OptimizeVertexCache(cacheOrder, vertices.size());
+			DAE_CHECK(suite, GetCanonicalTriangles(cacheOrder) == GetCanonicalTriangles(indices));
+			DAE_CHECK(suite, Utils::AnalyzeVertexCache(cacheOrder, vertices.size()).transforms <= Utils::AnalyzeVertexCache(indices, vertices.size()).transforms);
+		});
+	}
+}
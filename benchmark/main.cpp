@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: Benchmarks [--filter <substring>] [--min-time <seconds>] [--json <file|->]\n"
+			"  Human readable results go to stderr, JSON to the given file or stdout for '-'\n");
+	}
+
+	std::string EscapeJSON(const std::string& text)
+	{
+		std::string escaped{};
+		escaped.reserve(text.size());
+		for(const char c : text)
+		{
+			if(c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	const char* GetCompiler()
+	{
+#if defined(__clang__)
+		return "clang " __clang_version__;
+#elif defined(__GNUC__)
+		return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+		return "msvc";
+#else
+		return "unknown";
+#endif
+	}
+
+	// The paths the math library compiled in, results are only comparable between runs with the same set
+	std::string GetSIMDPaths()
+	{
+		std::string paths{};
+		const auto add = [&](const char* name, bool enabled)
+		{
+			if(!enabled)
+				return;
+			if(!paths.empty())
+				paths += ' ';
+			paths += name;
+		};
+		add("matrix-sse", DAE_MATRIX_SIMD);
+		add("color-sse", DAE_COLOR_SIMD);
+		add("f16c", DAE_HALF_F16C);
+#if defined(__AVX__)
+		add("avx", true);
+#endif
+#if defined(__FMA__) || defined(__AVX2__)
+		add("fma", true);
+#endif
+		return paths;
+	}
+
+	void WriteJSON(std::ostream& stream, const std::vector<bench::Result>& results)
+	{
+		char date[32]{};
+		const std::time_t now{ std::time(nullptr) };
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+		stream << "{\n";
+		stream << "  \"context\": {\n";
+		stream << "    \"date\": \"" << date << "\",\n";
+		stream << "    \"compiler\": \"" << EscapeJSON(GetCompiler()) << "\",\n";
+		stream << "    \"simd\": \"" << GetSIMDPaths() << "\"\n";
+		stream << "  },\n";
+		stream << "  \"benchmarks\": [\n";
+		for(size_t i{ 0 }; i < results.size(); ++i)
+		{
+			const bench::Result& r{ results[i] };
+			char line[512]{};
+			std::snprintf(line, sizeof(line),
+				"    { \"name\": \"%s\", \"ns_per_op\": %.4f, \"ops_per_second\": %.1f, \"batch_size\": %zu, \"iterations\": %zu }%s\n",
+				EscapeJSON(r.name).c_str(), r.nsPerOp, r.opsPerSecond, r.batchSize, r.iterations, i + 1 < results.size() ? "," : "");
+			stream << line;
+		}
+		stream << "  ]\n";
+		stream << "}\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string filter{};
+	std::string jsonPath{};
+	double minSeconds{ 0.1 };
+
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const bool hasValue{ i + 1 < argc };
+		if(std::strcmp(argv[i], "--filter") == 0 && hasValue)
+			filter = argv[++i];
+		else if(std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+			minSeconds = std::atof(argv[++i]);
+		else if(std::strcmp(argv[i], "--json") == 0 && hasValue)
+			jsonPath = argv[++i];
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	bench::Suite suite{ filter, minSeconds };
+	bench::RunVectorBenchmarks(suite);
+	bench::RunMatrixBenchmarks(suite);
+	bench::RunColorBenchmarks(suite);
+	bench::RunMathHelpersBenchmarks(suite);
+	bench::RunObjBenchmarks(suite);
+	bench::RunMeshCacheBenchmarks(suite);
+	bench::RunTangentBenchmarks(suite);
+	bench::RunVertexCacheBenchmarks(suite);
+	bench::RunPackedVertexBenchmarks(suite);
+	bench::RunIndexFormatBenchmarks(suite);
+	bench::RunSimplifierBenchmarks(suite);
+	bench::RunLodBenchmarks(suite);
+	bench::RunMeshletBenchmarks(suite);
+	bench::RunFrustumBenchmarks(suite);
+	bench::RunOcclusionBenchmarks(suite);
+	bench::RunRenderQueueBenchmarks(suite);
+	bench::RunStateTrackingBenchmarks(suite);
+	bench::RunInstancingBenchmarks(suite);
+	bench::RunHalfBenchmarks(suite);
+
+	if(jsonPath == "-")
+	{
+		WriteJSON(std::cout, suite.GetResults());
+	}
+	else if(!jsonPath.empty())
+	{
+		std::ofstream file{ jsonPath };
+		if(!file)
+		{
+			std::fprintf(stderr, "Could not open %s\n", jsonPath.c_str());
+			return 1;
+		}
+		WriteJSON(file, suite.GetResults());
+	}
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "Matrix.h"
+
+namespace dae
+{
+	// Affine transform without the constant (0,0,0,1) column of a Matrix.
+	// Same row-vector convention as Matrix: p' = p.x * axisX + p.y * axisY + p.z * axisZ + translation
+	struct Affine3x4
+	{
+		Vector3 axisX{ Vector3::UnitX };
+		Vector3 axisY{ Vector3::UnitY };
+		Vector3 axisZ{ Vector3::UnitZ };
+		Vector3 translation{ Vector3::Zero };
+
+		constexpr Affine3x4() = default;
+		constexpr Affine3x4(const Vector3& _axisX, const Vector3& _axisY, const Vector3& _axisZ, const Vector3& _translation):
+			axisX{ _axisX }, axisY{ _axisY }, axisZ{ _axisZ }, translation{ _translation }
+		{
+		}
+
+		// Drops the fourth column, only valid for matrices that are affine
+		explicit constexpr Affine3x4(const Matrix& m):
+			axisX{ m[0] }, axisY{ m[1] }, axisZ{ m[2] }, translation{ m[3] }
+		{
+		}
+
+		constexpr Matrix ToMatrix() const
+		{
+			return { axisX, axisY, axisZ, translation };
+		}
+
+		constexpr Vector3 TransformVector(const Vector3& v) const
+		{
+			return axisX * v.x + axisY * v.y + axisZ * v.z;
+		}
+
+		constexpr Vector3 TransformPoint(const Vector3& p) const
+		{
+			return TransformVector(p) + translation;
+		}
+
+		// General 3x3 inverse through cross products (no 4x4 cofactors needed)
+		constexpr Affine3x4 Inverse() const
+		{
+			const Vector3 bc = Vector3::Cross(axisY, axisZ);
+			const Vector3 ca = Vector3::Cross(axisZ, axisX);
+			const Vector3 ab = Vector3::Cross(axisX, axisY);
+
+			const float det = Vector3::Dot(axisX, bc);
+			assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+			const float invDet = 1.f / det;
+
+			Affine3x4 result{
+				Vector3{ bc.x, ca.x, ab.x } * invDet,
+				Vector3{ bc.y, ca.y, ab.y } * invDet,
+				Vector3{ bc.z, ca.z, ab.z } * invDet,
+				Vector3::Zero
+			};
+			result.translation = -result.TransformVector(translation);
+			return result;
+		}
+
+		// this first, then a
+		constexpr Affine3x4 operator*(const Affine3x4& a) const
+		{
+			return {
+				a.TransformVector(axisX),
+				a.TransformVector(axisY),
+				a.TransformVector(axisZ),
+				a.TransformPoint(translation)
+			};
+		}
+
+		// Fused affine * full matrix (world * viewProjection), skips the known zero column
+		constexpr Matrix operator*(const Matrix& m) const
+		{
+			const Vector4& m0 = m[0];
+			const Vector4& m1 = m[1];
+			const Vector4& m2 = m[2];
+			return {
+				m0 * axisX.x + m1 * axisX.y + m2 * axisX.z,
+				m0 * axisY.x + m1 * axisY.y + m2 * axisY.z,
+				m0 * axisZ.x + m1 * axisZ.y + m2 * axisZ.z,
+				m0 * translation.x + m1 * translation.y + m2 * translation.z + m[3]
+			};
+		}
+
+		static constexpr Affine3x4 CreateTranslation(const Vector3& t)
+		{
+			return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+		}
+
+		static constexpr Affine3x4 CreateScale(const Vector3& s)
+		{
+			return { Vector3::UnitX * s.x, Vector3::UnitY * s.y, Vector3::UnitZ * s.z, Vector3::Zero };
+		}
+	};
+}
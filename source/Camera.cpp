@@ -102,8 +102,7 @@ void Camera::Update(const Timer* pTimer)
 		m_CameraOrientation.y = Wrap(m_CameraOrientation.y, -180.f, 180.f);
 		//m_CameraOrientation.z = Wrap(m_CameraOrientation.z, -10.0f, 10.0f);
 
-		//const Matrix finalRotation = Matrix::CreateRotation(m_CameraOrientation * TO_RADIANS);
-		const Matrix finalRotation = Matrix::CreateRotationX(m_CameraOrientation.x * TO_RADIANS) * Matrix::CreateRotationY(m_CameraOrientation.y * TO_RADIANS);
+		const Matrix finalRotation = Matrix::CreateRotation(m_CameraOrientation.x * TO_RADIANS, m_CameraOrientation.y * TO_RADIANS, 0.f);
 		m_Forward = finalRotation.TransformVector(Vector3::UnitZ);
 		m_Forward.Normalize();
 
@@ -119,8 +118,10 @@ void Camera::Update(const Timer* pTimer)
 
 void Camera::CalculateViewMatrix()
 {
-	m_InvViewMatrix = Matrix::CreateLookAtLH(m_Origin, m_Forward, m_Up);
-	m_ViewMatrix = m_InvViewMatrix.Inverse();
+	// The camera is a rigid transform, so the view matrix is a transpose + translation instead of a general inverse
+	m_CameraToWorld = RigidTransform::CreateLookAtLH(m_Origin, m_Forward, m_Up);
+	m_InvViewMatrix = m_CameraToWorld.ToMatrix();
+	m_ViewMatrix = m_CameraToWorld.Inverse().ToMatrix();
 }
 
 void Camera::CalculateProjectionMatrix()
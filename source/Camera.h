@@ -31,8 +31,13 @@ public:
 
 
 	Matrix GetViewMatrix() const { return m_ViewMatrix; };
-	Matrix GetInverseViewMatrix() const { return Matrix::Inverse(m_ViewMatrix); };
+	Matrix GetInverseViewMatrix() const { return m_InvViewMatrix; };
+	const RigidTransform& GetCameraToWorld() const { return m_CameraToWorld; };
 	Matrix GetProjectionMatrix() const { return m_ProjectionMatrix; };
+	// tan(fov / 2), vertical
+	float GetFovRatio() const { return m_FovRatio; };
+	float GetNearPlane() const { return m_NearPlane; };
+	float GetFarPlane() const { return m_FarPlane; };
 
 private:
 	// Camera Settings
@@ -58,6 +63,7 @@ private:
 	Vector3 m_Right{ Vector3::UnitX };
 
 	// Matrices
+	RigidTransform m_CameraToWorld{};
 	Matrix m_InvViewMatrix{};
 	Matrix m_ViewMatrix{};
 	Matrix m_ProjectionMatrix{};
@@ -0,0 +1,300 @@
+#include "pch.h"
+
+#include "ColorRGB.h"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+
+#if DAE_COLOR_SIMD
+#include <immintrin.h>
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		// Linear [0, 1] quantized to 4096 steps, enough that the 8-bit sRGB value is off by at most 1 from the exact curve
+		constexpr int SRGB_TABLE_SIZE{ 4096 };
+
+		const std::array<uint8_t, SRGB_TABLE_SIZE>& GetSRGBTable()
+		{
+			static const std::array<uint8_t, SRGB_TABLE_SIZE> table = []
+			{
+				std::array<uint8_t, SRGB_TABLE_SIZE> result{};
+				for(int i{ 0 }; i < SRGB_TABLE_SIZE; ++i)
+				{
+					const float linear{ static_cast<float>(i) / (SRGB_TABLE_SIZE - 1) };
+					const float encoded{ linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.f / 2.4f) - 0.055f };
+					result[i] = static_cast<uint8_t>(encoded * 255.f + 0.5f);
+				}
+				return result;
+			}();
+			return table;
+		}
+
+		// NaN goes to 0 like the SSE max then min, so the sRGB table index stays in range and both paths agree
+		inline float SaturateColor(float v)
+		{
+			return !(v > 0.f) ? 0.f : std::min(v, 1.f);
+		}
+
+		inline uint32_t PackRGBA8Scalar(float r, float g, float b, bool sRGB)
+		{
+			r = SaturateColor(r);
+			g = SaturateColor(g);
+			b = SaturateColor(b);
+
+			uint32_t r8, g8, b8;
+			if(sRGB)
+			{
+				const auto& table = GetSRGBTable();
+				r8 = table[static_cast<int>(r * (SRGB_TABLE_SIZE - 1) + 0.5f)];
+				g8 = table[static_cast<int>(g * (SRGB_TABLE_SIZE - 1) + 0.5f)];
+				b8 = table[static_cast<int>(b * (SRGB_TABLE_SIZE - 1) + 0.5f)];
+			}
+			else
+			{
+				r8 = static_cast<uint32_t>(r * 255.f + 0.5f);
+				g8 = static_cast<uint32_t>(g * 255.f + 0.5f);
+				b8 = static_cast<uint32_t>(b * 255.f + 0.5f);
+			}
+			return r8 | (g8 << 8) | (b8 << 16) | 0xFF000000;
+		}
+
+#if DAE_COLOR_SIMD
+		inline __m128 Saturate4(__m128 v)
+		{
+			return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+		}
+
+		// Saturated value to an integer in [0, scale], rounding half up
+		inline __m128i Quantize4(__m128 v, float scale)
+		{
+			return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(Saturate4(v), _mm_set1_ps(scale)), _mm_set1_ps(0.5f)));
+		}
+
+		inline __m128i LookupSRGB4(__m128i indices, const std::array<uint8_t, SRGB_TABLE_SIZE>& table)
+		{
+			alignas(16) int32_t idx[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(idx), indices);
+			return _mm_setr_epi32(table[idx[0]], table[idx[1]], table[idx[2]], table[idx[3]]);
+		}
+
+		// Applies op to 4 colors at a time, returns the first index it did not process
+		template<typename Op>
+		inline size_t ForEachPacket(size_t count, Op op)
+		{
+			size_t i{ 0 };
+			for(; i + 4 <= count; i += 4)
+			{
+				op(i);
+			}
+			return i;
+		}
+#endif
+	}
+
+#pragma region Batch Operations
+	void ColorRGB::Add(ConstColorPlanes c1, ConstColorPlanes c2, ColorPlanes out)
+	{
+		assert(c2.size() >= c1.size() && out.size() >= c1.size());
+
+		size_t i{ 0 };
+#if DAE_COLOR_SIMD
+		i = ForEachPacket(c1.size(), [&](size_t j)
+		{
+			_mm_storeu_ps(&out.r[j], _mm_add_ps(_mm_loadu_ps(&c1.r[j]), _mm_loadu_ps(&c2.r[j])));
+			_mm_storeu_ps(&out.g[j], _mm_add_ps(_mm_loadu_ps(&c1.g[j]), _mm_loadu_ps(&c2.g[j])));
+			_mm_storeu_ps(&out.b[j], _mm_add_ps(_mm_loadu_ps(&c1.b[j]), _mm_loadu_ps(&c2.b[j])));
+		});
+#endif
+		for(; i < c1.size(); ++i)
+		{
+			out.r[i] = c1.r[i] + c2.r[i];
+			out.g[i] = c1.g[i] + c2.g[i];
+			out.b[i] = c1.b[i] + c2.b[i];
+		}
+	}
+
+	void ColorRGB::Multiply(ConstColorPlanes c1, ConstColorPlanes c2, ColorPlanes out)
+	{
+		assert(c2.size() >= c1.size() && out.size() >= c1.size());
+
+		size_t i{ 0 };
+#if DAE_COLOR_SIMD
+		i = ForEachPacket(c1.size(), [&](size_t j)
+		{
+			_mm_storeu_ps(&out.r[j], _mm_mul_ps(_mm_loadu_ps(&c1.r[j]), _mm_loadu_ps(&c2.r[j])));
+			_mm_storeu_ps(&out.g[j], _mm_mul_ps(_mm_loadu_ps(&c1.g[j]), _mm_loadu_ps(&c2.g[j])));
+			_mm_storeu_ps(&out.b[j], _mm_mul_ps(_mm_loadu_ps(&c1.b[j]), _mm_loadu_ps(&c2.b[j])));
+		});
+#endif
+		for(; i < c1.size(); ++i)
+		{
+			out.r[i] = c1.r[i] * c2.r[i];
+			out.g[i] = c1.g[i] * c2.g[i];
+			out.b[i] = c1.b[i] * c2.b[i];
+		}
+	}
+
+	void ColorRGB::Multiply(ConstColorPlanes c, float s, ColorPlanes out)
+	{
+		assert(out.size() >= c.size());
+
+		size_t i{ 0 };
+#if DAE_COLOR_SIMD
+		const __m128 scale = _mm_set1_ps(s);
+		i = ForEachPacket(c.size(), [&](size_t j)
+		{
+			_mm_storeu_ps(&out.r[j], _mm_mul_ps(_mm_loadu_ps(&c.r[j]), scale));
+			_mm_storeu_ps(&out.g[j], _mm_mul_ps(_mm_loadu_ps(&c.g[j]), scale));
+			_mm_storeu_ps(&out.b[j], _mm_mul_ps(_mm_loadu_ps(&c.b[j]), scale));
+		});
+#endif
+		for(; i < c.size(); ++i)
+		{
+			out.r[i] = c.r[i] * s;
+			out.g[i] = c.g[i] * s;
+			out.b[i] = c.b[i] * s;
+		}
+	}
+
+	void ColorRGB::Lerp(ConstColorPlanes c1, ConstColorPlanes c2, float factor, ColorPlanes out)
+	{
+		assert(c2.size() >= c1.size() && out.size() >= c1.size());
+
+		size_t i{ 0 };
+#if DAE_COLOR_SIMD
+		// Same operation order as Lerpf so both paths give the same bits
+		const __m128 f = _mm_set1_ps(factor);
+		const __m128 oneMinusF = _mm_set1_ps(1 - factor);
+		const auto lerp = [&](const float* a, const float* b)
+		{
+			return _mm_add_ps(_mm_mul_ps(oneMinusF, _mm_loadu_ps(a)), _mm_mul_ps(f, _mm_loadu_ps(b)));
+		};
+		i = ForEachPacket(c1.size(), [&](size_t j)
+		{
+			_mm_storeu_ps(&out.r[j], lerp(&c1.r[j], &c2.r[j]));
+			_mm_storeu_ps(&out.g[j], lerp(&c1.g[j], &c2.g[j]));
+			_mm_storeu_ps(&out.b[j], lerp(&c1.b[j], &c2.b[j]));
+		});
+#endif
+		for(; i < c1.size(); ++i)
+		{
+			out.r[i] = Lerpf(c1.r[i], c2.r[i], factor);
+			out.g[i] = Lerpf(c1.g[i], c2.g[i], factor);
+			out.b[i] = Lerpf(c1.b[i], c2.b[i], factor);
+		}
+	}
+
+	void ColorRGB::MaxToOne(ColorPlanes colors)
+	{
+		size_t i{ 0 };
+#if DAE_COLOR_SIMD
+		const __m128 one = _mm_set1_ps(1.f);
+		i = ForEachPacket(colors.size(), [&](size_t j)
+		{
+			const __m128 r = _mm_loadu_ps(&colors.r[j]);
+			const __m128 g = _mm_loadu_ps(&colors.g[j]);
+			const __m128 b = _mm_loadu_ps(&colors.b[j]);
+			const __m128 scale = _mm_max_ps(_mm_max_ps(r, _mm_max_ps(g, b)), one);
+			_mm_storeu_ps(&colors.r[j], _mm_div_ps(r, scale));
+			_mm_storeu_ps(&colors.g[j], _mm_div_ps(g, scale));
+			_mm_storeu_ps(&colors.b[j], _mm_div_ps(b, scale));
+		});
+#endif
+		for(; i < colors.size(); ++i)
+		{
+			ColorRGB c{ colors.r[i], colors.g[i], colors.b[i] };
+			c.MaxToOne();
+			colors.r[i] = c.r;
+			colors.g[i] = c.g;
+			colors.b[i] = c.b;
+		}
+	}
+
+	void ColorRGB::Saturate(ColorPlanes colors)
+	{
+		size_t i{ 0 };
+#if DAE_COLOR_SIMD
+		i = ForEachPacket(colors.size(), [&](size_t j)
+		{
+			_mm_storeu_ps(&colors.r[j], Saturate4(_mm_loadu_ps(&colors.r[j])));
+			_mm_storeu_ps(&colors.g[j], Saturate4(_mm_loadu_ps(&colors.g[j])));
+			_mm_storeu_ps(&colors.b[j], Saturate4(_mm_loadu_ps(&colors.b[j])));
+		});
+#endif
+		for(; i < colors.size(); ++i)
+		{
+			colors.r[i] = SaturateColor(colors.r[i]);
+			colors.g[i] = SaturateColor(colors.g[i]);
+			colors.b[i] = SaturateColor(colors.b[i]);
+		}
+	}
+
+	void ColorRGB::PackRGBA8(ConstColorPlanes colors, std::span<uint32_t> out, bool sRGB)
+	{
+		assert(out.size() >= colors.size());
+
+		size_t i{ 0 };
+#if DAE_COLOR_SIMD
+		const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+		const auto pack = [&](size_t j, __m128i r, __m128i g, __m128i b)
+		{
+			const __m128i rgba = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), alpha));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&out[j]), rgba);
+		};
+
+		if(sRGB)
+		{
+			const auto& table = GetSRGBTable();
+			constexpr float scale{ SRGB_TABLE_SIZE - 1 };
+			i = ForEachPacket(colors.size(), [&](size_t j)
+			{
+				pack(j,
+					LookupSRGB4(Quantize4(_mm_loadu_ps(&colors.r[j]), scale), table),
+					LookupSRGB4(Quantize4(_mm_loadu_ps(&colors.g[j]), scale), table),
+					LookupSRGB4(Quantize4(_mm_loadu_ps(&colors.b[j]), scale), table));
+			});
+		}
+		else
+		{
+			i = ForEachPacket(colors.size(), [&](size_t j)
+			{
+				pack(j,
+					Quantize4(_mm_loadu_ps(&colors.r[j]), 255.f),
+					Quantize4(_mm_loadu_ps(&colors.g[j]), 255.f),
+					Quantize4(_mm_loadu_ps(&colors.b[j]), 255.f));
+			});
+		}
+#endif
+		for(; i < colors.size(); ++i)
+		{
+			out[i] = PackRGBA8Scalar(colors.r[i], colors.g[i], colors.b[i], sRGB);
+		}
+	}
+
+	void ColorRGB::ToPlanes(std::span<const ColorRGB> colors, ColorPlanes out)
+	{
+		assert(out.size() >= colors.size());
+
+		for(size_t i{ 0 }; i < colors.size(); ++i)
+		{
+			out.r[i] = colors[i].r;
+			out.g[i] = colors[i].g;
+			out.b[i] = colors[i].b;
+		}
+	}
+
+	void ColorRGB::FromPlanes(ConstColorPlanes colors, std::span<ColorRGB> out)
+	{
+		assert(out.size() >= colors.size());
+
+		for(size_t i{ 0 }; i < colors.size(); ++i)
+		{
+			out[i] = { colors.r[i], colors.g[i], colors.b[i] };
+		}
+	}
+#pragma endregion
+}
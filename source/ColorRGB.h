@@ -1,28 +1,88 @@
 #pragma once
+#include <algorithm>
+#include <span>
+#include <cstdint>
 #include "MathHelpers.h"
 
+// SIMD backend for the ColorRGB batch kernels, define DAE_COLOR_NO_SIMD to force the scalar fallback
+#if !defined(DAE_COLOR_NO_SIMD) && (defined(_M_X64) || defined(__SSE2__))
+#define DAE_COLOR_SIMD 1
+#else
+#define DAE_COLOR_SIMD 0
+#endif
+
 namespace dae
 {
+	struct ColorRGB;
+
+	// Planar (SoA) colors, one float plane per channel, all planes the same size
+	struct ColorPlanes
+	{
+		std::span<float> r{};
+		std::span<float> g{};
+		std::span<float> b{};
+
+		constexpr size_t size() const { return r.size(); }
+	};
+
+	struct ConstColorPlanes
+	{
+		std::span<const float> r{};
+		std::span<const float> g{};
+		std::span<const float> b{};
+
+		constexpr ConstColorPlanes() = default;
+		constexpr ConstColorPlanes(std::span<const float> _r, std::span<const float> _g, std::span<const float> _b) : r(_r), g(_g), b(_b) {}
+		constexpr ConstColorPlanes(const ColorPlanes& p) : r(p.r), g(p.g), b(p.b) {}
+
+		constexpr size_t size() const { return r.size(); }
+	};
+
 	struct ColorRGB
 	{
 		float r{};
 		float g{};
 		float b{};
 
-		void MaxToOne()
+		// Branchless, dividing by 1 leaves the color as is
+		constexpr void MaxToOne()
+		{
+			const float scale = std::max(std::max(r, std::max(g, b)), 1.f);
+			*this /= scale;
+		}
+
+		constexpr void Saturate()
 		{
-			const float maxValue = std::max(r, std::max(g, b));
-			if (maxValue > 1.f)
-				*this /= maxValue;
+			r = dae::Saturate(r);
+			g = dae::Saturate(g);
+			b = dae::Saturate(b);
 		}
 
-		static ColorRGB Lerp(const ColorRGB& c1, const ColorRGB& c2, float factor)
+		static constexpr ColorRGB Lerp(const ColorRGB& c1, const ColorRGB& c2, float factor)
 		{
 			return { Lerpf(c1.r, c2.r, factor), Lerpf(c1.g, c2.g, factor), Lerpf(c1.b, c2.b, factor) };
 		}
 
+#pragma region Batch Operations
+		// Planar batch kernels, out may alias an input. Sizes of out must be at least the input size.
+		static void Add(ConstColorPlanes c1, ConstColorPlanes c2, ColorPlanes out);
+		static void Multiply(ConstColorPlanes c1, ConstColorPlanes c2, ColorPlanes out);
+		static void Multiply(ConstColorPlanes c, float s, ColorPlanes out);
+		static void Lerp(ConstColorPlanes c1, ConstColorPlanes c2, float factor, ColorPlanes out);
+		static void MaxToOne(ColorPlanes colors);
+		// NaN saturates to 0
+		static void Saturate(ColorPlanes colors);
+
+		// Saturates (NaN to 0) and packs to R8G8B8A8 (r in the lowest byte, alpha 255), optionally sRGB encoded
+		static void PackRGBA8(ConstColorPlanes colors, std::span<uint32_t> out, bool sRGB = false);
+
+		// Conversions between interleaved and planar colors
+		static void ToPlanes(std::span<const ColorRGB> colors, ColorPlanes out);
+		static void FromPlanes(ConstColorPlanes colors, std::span<ColorRGB> out);
+#pragma endregion
+
 		#pragma region ColorRGB (Member) Operators
-		const ColorRGB& operator+=(const ColorRGB& c)
+		constexpr const ColorRGB& operator+=(const ColorRGB& c)
 		{
 			r += c.r;
 			g += c.g;
@@ -31,12 +91,12 @@ namespace dae
 			return *this;
 		}
 
-		ColorRGB operator+(const ColorRGB& c) const
+		constexpr ColorRGB operator+(const ColorRGB& c) const
 		{
 			return { r + c.r, g + c.g, b + c.b };
 		}
 
-		const ColorRGB& operator-=(const ColorRGB& c)
+		constexpr const ColorRGB& operator-=(const ColorRGB& c)
 		{
 			r -= c.r;
 			g -= c.g;
@@ -45,12 +105,12 @@ namespace dae
 			return *this;
 		}
 
-		ColorRGB operator-(const ColorRGB& c) const
+		constexpr ColorRGB operator-(const ColorRGB& c) const
 		{
 			return { r - c.r, g - c.g, b - c.b };
 		}
 
-		const ColorRGB& operator*=(const ColorRGB& c)
+		constexpr const ColorRGB& operator*=(const ColorRGB& c)
 		{
 			r *= c.r;
 			g *= c.g;
@@ -59,12 +119,12 @@ namespace dae
 			return *this;
 		}
 
-		ColorRGB operator*(const ColorRGB& c) const
+		constexpr ColorRGB operator*(const ColorRGB& c) const
 		{
 			return { r * c.r, g * c.g, b * c.b };
 		}
 
-		const ColorRGB& operator/=(const ColorRGB& c)
+		constexpr const ColorRGB& operator/=(const ColorRGB& c)
 		{
 			r /= c.r;
 			g /= c.g;
@@ -73,7 +133,7 @@ namespace dae
 			return *this;
 		}
 
-		const ColorRGB& operator*=(float s)
+		constexpr const ColorRGB& operator*=(float s)
 		{
 			r *= s;
 			g *= s;
@@ -82,12 +142,12 @@ namespace dae
 			return *this;
 		}
 
-		ColorRGB operator*(float s) const
+		constexpr ColorRGB operator*(float s) const
 		{
 			return { r * s, g * s,b * s };
 		}
 
-		const ColorRGB& operator/=(float s)
+		constexpr const ColorRGB& operator/=(float s)
 		{
 			r /= s;
 			g /= s;
@@ -96,7 +156,7 @@ namespace dae
 			return *this;
 		}
 
-		ColorRGB operator/(float s) const
+		constexpr ColorRGB operator/(float s) const
 		{
 			return { r / s, g / s,b / s };
 		}
@@ -104,21 +164,21 @@ namespace dae
 	};
 
 	//ColorRGB (Global) Operators
-	inline ColorRGB operator*(float s, const ColorRGB& c)
+	constexpr ColorRGB operator*(float s, const ColorRGB& c)
 	{
 		return c * s;
 	}
 
 	namespace colors
 	{
-		static ColorRGB Red{ 1,0,0 };
-		static ColorRGB Blue{ 0,0,1 };
-		static ColorRGB Green{ 0,1,0 };
-		static ColorRGB Yellow{ 1,1,0 };
-		static ColorRGB Cyan{ 0,1,1 };
-		static ColorRGB Magenta{ 1,0,1 };
-		static ColorRGB White{ 1,1,1 };
-		static ColorRGB Black{ 0,0,0 };
-		static ColorRGB Gray{ 0.5f,0.5f,0.5f };
+		inline constexpr ColorRGB Red{ 1,0,0 };
+		inline constexpr ColorRGB Blue{ 0,0,1 };
+		inline constexpr ColorRGB Green{ 0,1,0 };
+		inline constexpr ColorRGB Yellow{ 1,1,0 };
+		inline constexpr ColorRGB Cyan{ 0,1,1 };
+		inline constexpr ColorRGB Magenta{ 1,0,1 };
+		inline constexpr ColorRGB White{ 1,1,1 };
+		inline constexpr ColorRGB Black{ 0,0,0 };
+		inline constexpr ColorRGB Gray{ 0.5f,0.5f,0.5f };
 	}
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "pch.h"
+
+#include "D3D11RenderContext.h"
+
+using namespace dae;
+
+D3D11RenderContext::D3D11RenderContext(ID3D11DeviceContext* pDeviceContext):
+	m_pDeviceContext{ pDeviceContext }
+{
+}
+
+void D3D11RenderContext::SetPrimitiveTopology(uint32_t topology)
+{
+	m_pDeviceContext->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(topology));
+}
+
+void D3D11RenderContext::SetInputLayout(void* pInputLayout)
+{
+	m_pDeviceContext->IASetInputLayout(static_cast<ID3D11InputLayout*>(pInputLayout));
+}
+
+void D3D11RenderContext::SetVertexBuffer(uint32_t slot, void* pBuffer, uint32_t stride, uint32_t offset)
+{
+	ID3D11Buffer* pVertexBuffer{ static_cast<ID3D11Buffer*>(pBuffer) };
+	m_pDeviceContext->IASetVertexBuffers(slot, 1, &pVertexBuffer, &stride, &offset);
+}
+
+void D3D11RenderContext::SetIndexBuffer(void* pBuffer, uint32_t format, uint32_t offset)
+{
+	m_pDeviceContext->IASetIndexBuffer(static_cast<ID3D11Buffer*>(pBuffer), static_cast<DXGI_FORMAT>(format), offset);
+}
+
+void D3D11RenderContext::SetRasterizerState(void* pState)
+{
+	m_pDeviceContext->RSSetState(static_cast<ID3D11RasterizerState*>(pState));
+}
+
+void D3D11RenderContext::SetBlendState(void* pState)
+{
+	m_pDeviceContext->OMSetBlendState(static_cast<ID3D11BlendState*>(pState), nullptr, 0xFFFFFFFF);
+}
+
+void D3D11RenderContext::SetDepthStencilState(void* pState, uint32_t stencilRef)
+{
+	m_pDeviceContext->OMSetDepthStencilState(static_cast<ID3D11DepthStencilState*>(pState), stencilRef);
+}
+
+void D3D11RenderContext::SetRenderTarget(void* pRenderTargetView, void* pDepthStencilView)
+{
+	ID3D11RenderTargetView* pView{ static_cast<ID3D11RenderTargetView*>(pRenderTargetView) };
+	m_pDeviceContext->OMSetRenderTargets(1, &pView, static_cast<ID3D11DepthStencilView*>(pDepthStencilView));
+}
+
+void D3D11RenderContext::SetSampler(ShaderStage stage, uint32_t slot, void* pSampler)
+{
+	ID3D11SamplerState* pState{ static_cast<ID3D11SamplerState*>(pSampler) };
+	if(stage == ShaderStage::Vertex)
+		m_pDeviceContext->VSSetSamplers(slot, 1, &pState);
+	else
+		m_pDeviceContext->PSSetSamplers(slot, 1, &pState);
+}
+
+void D3D11RenderContext::SetShaderResource(ShaderStage stage, uint32_t slot, void* pView)
+{
+	ID3D11ShaderResourceView* pResourceView{ static_cast<ID3D11ShaderResourceView*>(pView) };
+	if(stage == ShaderStage::Vertex)
+		m_pDeviceContext->VSSetShaderResources(slot, 1, &pResourceView);
+	else
+		m_pDeviceContext->PSSetShaderResources(slot, 1, &pResourceView);
+}
+
+void D3D11RenderContext::ApplyPass(void* pPass)
+{
+	static_cast<ID3DX11EffectPass*>(pPass)->Apply(0, m_pDeviceContext);
+}
+
+void D3D11RenderContext::DrawIndexed(uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex)
+{
+	m_pDeviceContext->DrawIndexed(indexCount, firstIndex, baseVertex);
+}
+
+void D3D11RenderContext::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance)
+{
+	m_pDeviceContext->DrawIndexedInstanced(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+}
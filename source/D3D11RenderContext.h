@@ -0,0 +1,30 @@
+#pragma once
+#include "RenderContext.h"
+
+// Forwards every call to the device context, the opaque pointers are cast back to their D3D11 interfaces
+class D3D11RenderContext final : public dae::RenderContext
+{
+public:
+	explicit D3D11RenderContext(ID3D11DeviceContext* pDeviceContext);
+
+	void SetPrimitiveTopology(uint32_t topology) override;
+	void SetInputLayout(void* pInputLayout) override;
+	void SetVertexBuffer(uint32_t slot, void* pBuffer, uint32_t stride, uint32_t offset) override;
+	void SetIndexBuffer(void* pBuffer, uint32_t format, uint32_t offset) override;
+
+	void SetRasterizerState(void* pState) override;
+	void SetBlendState(void* pState) override;
+	void SetDepthStencilState(void* pState, uint32_t stencilRef) override;
+	void SetRenderTarget(void* pRenderTargetView, void* pDepthStencilView) override;
+
+	void SetSampler(dae::ShaderStage stage, uint32_t slot, void* pSampler) override;
+	void SetShaderResource(dae::ShaderStage stage, uint32_t slot, void* pView) override;
+
+	void ApplyPass(void* pPass) override;
+
+	void DrawIndexed(uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex) override;
+	void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) override;
+
+private:
+	ID3D11DeviceContext* m_pDeviceContext;
+};
@@ -11,6 +11,23 @@ Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
 		std::wcout << L"Technique not valid\n";
 	}
 
+	// Optional, meshes fall back to full vertices without it
+	m_pPackedTechnique = m_pEffect->GetTechniqueByName("PackedTechnique");
+	if(!m_pPackedTechnique->IsValid())
+		m_pPackedTechnique = nullptr;
+
+	// Optional as well, without them the effect can not draw instanced
+	m_pInstancedTechnique = m_pEffect->GetTechniqueByName("InstancedTechnique");
+	if(!m_pInstancedTechnique->IsValid())
+		m_pInstancedTechnique = nullptr;
+	m_pPackedInstancedTechnique = m_pEffect->GetTechniqueByName("PackedInstancedTechnique");
+	if(!m_pPackedInstancedTechnique->IsValid())
+		m_pPackedInstancedTechnique = nullptr;
+	m_pViewProjVariable = m_pEffect->GetVariableByName("gViewProj")->AsMatrix();
+
+	m_pPositionScaleVariable = m_pEffect->GetVariableByName("gPositionScale")->AsVector();
+	m_pPositionOffsetVariable = m_pEffect->GetVariableByName("gPositionOffset")->AsVector();
+
 	m_pMatWorldViewProjVariable = m_pEffect->GetVariableByName("gWorldViewProj")->AsMatrix();
 	if(!m_pMatWorldViewProjVariable->IsValid())
 	{
@@ -84,6 +101,7 @@ Effect::~Effect()
 	SafeRelease(m_pLinearSampler);
 	SafeRelease(m_pPointSampler);
 
+	SafeRelease(m_pPackedTechnique);
 	SafeRelease(m_pTechnique);
 	SafeRelease(m_pEffect);
 }
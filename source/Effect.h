@@ -20,21 +20,41 @@ public:
 
 	ID3DX11Effect* GetEffect() const { return m_pEffect; };
 	ID3DX11EffectTechnique* GetTechnique() const { return m_pTechnique; };
+	// Technique for PackedVertex input, nullptr when the effect has none
+	ID3DX11EffectTechnique* GetPackedTechnique() const { return m_pPackedTechnique; };
+	// Techniques taking the world matrix from a per instance stream, nullptr when the effect has none
+	ID3DX11EffectTechnique* GetInstancedTechnique() const { return m_pInstancedTechnique; };
+	ID3DX11EffectTechnique* GetPackedInstancedTechnique() const { return m_pPackedInstancedTechnique; };
+	ID3DX11EffectMatrixVariable* GetViewProjVariable() const { return m_pViewProjVariable; };
 	ID3DX11EffectMatrixVariable* GetWorldViewProjVariable() const { return m_pMatWorldViewProjVariable; };
 
 	ID3DX11EffectMatrixVariable* GetViewInverseMatrixVariable() const { return m_pEffectViewInverseMatrixVariable; };
 	ID3DX11EffectMatrixVariable* GetWorldMatrixVariable() const { return m_pEffectWorldMatrixVariable; };
 
+	// Dequantization of packed positions
+	ID3DX11EffectVectorVariable* GetPositionScaleVariable() const { return m_pPositionScaleVariable; };
+	ID3DX11EffectVectorVariable* GetPositionOffsetVariable() const { return m_pPositionOffsetVariable; };
+
 	void SetSamplerFilter(SamplerFilter filter);
 
+	// Blended over the opaque meshes, the render queue draws these last and back to front
+	virtual bool IsTransparent() const { return false; }
+
 protected:
 	ID3DX11Effect* m_pEffect;
 	ID3DX11EffectTechnique* m_pTechnique;
+	ID3DX11EffectTechnique* m_pPackedTechnique;
+	ID3DX11EffectTechnique* m_pInstancedTechnique;
+	ID3DX11EffectTechnique* m_pPackedInstancedTechnique;
+	ID3DX11EffectMatrixVariable* m_pViewProjVariable;
 
 	ID3DX11EffectMatrixVariable* m_pMatWorldViewProjVariable;
 	ID3DX11EffectMatrixVariable* m_pEffectWorldMatrixVariable;
 	ID3DX11EffectMatrixVariable* m_pEffectViewInverseMatrixVariable;
 
+	ID3DX11EffectVectorVariable* m_pPositionScaleVariable;
+	ID3DX11EffectVectorVariable* m_pPositionOffsetVariable;
+
 
 	// Store the different filter modes for the sampler
 	ID3D11SamplerState* m_pPointSampler;
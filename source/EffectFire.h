@@ -34,6 +34,8 @@ public:
 
 	void SetDiffuseMap(Texture* pTexture);
 
+	bool IsTransparent() const override { return true; }
+
 private:
 	ID3DX11EffectMatrixVariable* m_pMatWorldViewProjVariable;
 
@@ -0,0 +1,199 @@
+#include "pch.h"
+
+#include "Frustum.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+#if DAE_FRUSTUM_SIMD
+#include <immintrin.h>
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		// Distance of the box or sphere, whichever is tighter along the plane normal
+		inline bool IsOutside(const Vector4& plane, float centerX, float centerY, float centerZ, float extentX, float extentY, float extentZ, float radius)
+		{
+			const float distance{ plane.x * centerX + plane.y * centerY + plane.z * centerZ + plane.w };
+			const float boxRadius{ std::abs(plane.x) * extentX + std::abs(plane.y) * extentY + std::abs(plane.z) * extentZ };
+			return distance < -std::min(boxRadius, radius);
+		}
+
+#if DAE_FRUSTUM_SIMD
+		// Register width traits so the test runs 4 (SSE) or 8 (AVX) objects at a time
+		struct Lanes4
+		{
+			using Reg = __m128;
+			static constexpr size_t Width{ 4 };
+
+			static Reg Set1(float v) { return _mm_set1_ps(v); }
+			static Reg Zero() { return _mm_setzero_ps(); }
+			static Reg Load(const float* p) { return _mm_loadu_ps(p); }
+			static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+			static Reg Or(Reg a, Reg b) { return _mm_or_ps(a, b); }
+			static Reg Negate(Reg a) { return _mm_sub_ps(_mm_setzero_ps(), a); }
+			static Reg Less(Reg a, Reg b) { return _mm_cmplt_ps(a, b); }
+			static int MoveMask(Reg a) { return _mm_movemask_ps(a); }
+		};
+
+#if defined(__AVX__)
+		struct Lanes8
+		{
+			using Reg = __m256;
+			static constexpr size_t Width{ 8 };
+
+			static Reg Set1(float v) { return _mm256_set1_ps(v); }
+			static Reg Zero() { return _mm256_setzero_ps(); }
+			static Reg Load(const float* p) { return _mm256_loadu_ps(p); }
+			static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+			static Reg Or(Reg a, Reg b) { return _mm256_or_ps(a, b); }
+			static Reg Negate(Reg a) { return _mm256_sub_ps(_mm256_setzero_ps(), a); }
+			static Reg Less(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static int MoveMask(Reg a) { return _mm256_movemask_ps(a); }
+		};
+		using CullLanes = Lanes8;
+#else
+		using CullLanes = Lanes4;
+#endif
+
+		// Same math as IsOutside, returns the index of the first object it did not test
+		template<typename L>
+		size_t CullPackets(const Frustum& frustum, const BoundsSoA& bounds, std::span<uint8_t> visible, size_t& culled)
+		{
+			using Reg = typename L::Reg;
+
+			// Every plane component splatted once per batch
+			Reg planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+			for(size_t p{ 0 }; p < 6; ++p)
+			{
+				const Vector4& plane{ frustum.planes[p] };
+				planeX[p] = L::Set1(plane.x);
+				planeY[p] = L::Set1(plane.y);
+				planeZ[p] = L::Set1(plane.z);
+				planeW[p] = L::Set1(plane.w);
+				absX[p] = L::Set1(std::abs(plane.x));
+				absY[p] = L::Set1(std::abs(plane.y));
+				absZ[p] = L::Set1(std::abs(plane.z));
+			}
+
+			const size_t packetEnd{ bounds.GetCount() / L::Width * L::Width };
+			for(size_t i{ 0 }; i < packetEnd; i += L::Width)
+			{
+				const Reg centerX{ L::Load(&bounds.centerX[i]) };
+				const Reg centerY{ L::Load(&bounds.centerY[i]) };
+				const Reg centerZ{ L::Load(&bounds.centerZ[i]) };
+				const Reg extentX{ L::Load(&bounds.extentX[i]) };
+				const Reg extentY{ L::Load(&bounds.extentY[i]) };
+				const Reg extentZ{ L::Load(&bounds.extentZ[i]) };
+				const Reg radius{ L::Load(&bounds.radius[i]) };
+
+				Reg outside{ L::Zero() };
+				for(size_t p{ 0 }; p < 6; ++p)
+				{
+					const Reg distance{ L::Add(L::Add(L::Add(L::Mul(planeX[p], centerX), L::Mul(planeY[p], centerY)), L::Mul(planeZ[p], centerZ)), planeW[p]) };
+					const Reg boxRadius{ L::Add(L::Add(L::Mul(absX[p], extentX), L::Mul(absY[p], extentY)), L::Mul(absZ[p], extentZ)) };
+					outside = L::Or(outside, L::Less(distance, L::Negate(L::Min(boxRadius, radius))));
+				}
+
+				const int outsideMask{ L::MoveMask(outside) };
+				for(size_t lane{ 0 }; lane < L::Width; ++lane)
+					visible[i + lane] = static_cast<uint8_t>(((outsideMask >> lane) & 1) ^ 1);
+				culled += static_cast<size_t>(std::popcount(static_cast<unsigned>(outsideMask)));
+			}
+			return packetEnd;
+		}
+#endif
+	}
+
+	Frustum Frustum::FromViewProjection(const Matrix& viewProjection)
+	{
+		const auto getColumn = [&](int column)
+		{
+			return Vector4{ viewProjection[0][column], viewProjection[1][column], viewProjection[2][column], viewProjection[3][column] };
+		};
+		const Vector4 x{ getColumn(0) };
+		const Vector4 y{ getColumn(1) };
+		const Vector4 z{ getColumn(2) };
+		const Vector4 w{ getColumn(3) };
+
+		Frustum frustum{ { w + x, w - x, w + y, w - y, z, w - z } };
+		for(Vector4& plane : frustum.planes)
+		{
+			const float length{ Vector3{ plane.x, plane.y, plane.z }.Magnitude() };
+			if(length > 0.f)
+				plane = plane * (1.f / length);
+		}
+		return frustum;
+	}
+
+	bool Frustum::IsVisible(const Vector3& center, const Vector3& extents, float radius) const
+	{
+		return std::none_of(planes.begin(), planes.end(), [&](const Vector4& plane)
+		{
+			return IsOutside(plane, center.x, center.y, center.z, extents.x, extents.y, extents.z, radius);
+		});
+	}
+
+	void BoundsSoA::Resize(size_t count)
+	{
+		centerX.resize(count);
+		centerY.resize(count);
+		centerZ.resize(count);
+		extentX.resize(count);
+		extentY.resize(count);
+		extentZ.resize(count);
+		radius.resize(count);
+	}
+
+	void BoundsSoA::Set(size_t index, const Affine3x4& worldTransform, const Vector3& boundsMin, const Vector3& boundsMax, float boundsRadius)
+	{
+		const Vector3 center{ worldTransform.TransformPoint((boundsMin + boundsMax) * 0.5f) };
+		const Vector3 halfSize{ (boundsMax - boundsMin) * 0.5f };
+
+		// The box around the rotated box, every world axis gets the absolute contributions of the three object axes
+		const Vector3& axisX{ worldTransform.axisX };
+		const Vector3& axisY{ worldTransform.axisY };
+		const Vector3& axisZ{ worldTransform.axisZ };
+		centerX[index] = center.x;
+		centerY[index] = center.y;
+		centerZ[index] = center.z;
+		extentX[index] = std::abs(axisX.x) * halfSize.x + std::abs(axisY.x) * halfSize.y + std::abs(axisZ.x) * halfSize.z;
+		extentY[index] = std::abs(axisX.y) * halfSize.x + std::abs(axisY.y) * halfSize.y + std::abs(axisZ.y) * halfSize.z;
+		extentZ[index] = std::abs(axisX.z) * halfSize.x + std::abs(axisY.z) * halfSize.y + std::abs(axisZ.z) * halfSize.z;
+
+		const float scaleSquared{ std::max({ axisX.SqrMagnitude(), axisY.SqrMagnitude(), axisZ.SqrMagnitude() }) };
+		radius[index] = boundsRadius * std::sqrt(scaleSquared);
+	}
+
+	namespace Utils
+	{
+		CullStats CullBounds(const Frustum& frustum, const BoundsSoA& bounds, std::span<uint8_t> visible)
+		{
+			assert(visible.size() >= bounds.GetCount());
+
+			CullStats stats{};
+			stats.tested = bounds.GetCount();
+
+			size_t first{ 0 };
+#if DAE_FRUSTUM_SIMD
+			first = CullPackets<CullLanes>(frustum, bounds, visible, stats.culled);
+#endif
+			for(size_t i{ first }; i < bounds.GetCount(); ++i)
+			{
+				const bool isVisible{ frustum.IsVisible({ bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i] },
+					{ bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i] }, bounds.radius[i]) };
+				visible[i] = static_cast<uint8_t>(isVisible);
+				stats.culled += !isVisible;
+			}
+			return stats;
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Affine3x4.h"
+#include "Matrix.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+// SIMD backend for the batch visibility test, define DAE_FRUSTUM_NO_SIMD to force the scalar fallback
+#if !defined(DAE_FRUSTUM_NO_SIMD) && (defined(_M_X64) || defined(__SSE2__))
+#define DAE_FRUSTUM_SIMD 1
+#else
+#define DAE_FRUSTUM_SIMD 0
+#endif
+
+namespace dae
+{
+	struct Frustum
+	{
+		// Normalized, pointing inwards (x y z w: inside when dot(xyz, p) + w >= 0): left, right, bottom, top, near, far
+		std::array<Vector4, 6> planes{};
+
+		// Row vector matrices and D3D clip space (0 <= z <= w), the planes end up in the space the matrix transforms from
+		static Frustum FromViewProjection(const Matrix& viewProjection);
+
+		// Box around center with the given half extents, and a sphere around the same center. Outside when either is.
+		bool IsVisible(const Vector3& center, const Vector3& extents, float radius) const;
+	};
+
+	// World space bounds of many objects as structure of arrays, the batch test runs several objects per register
+	struct BoundsSoA
+	{
+		std::vector<float> centerX{};
+		std::vector<float> centerY{};
+		std::vector<float> centerZ{};
+		std::vector<float> extentX{};
+		std::vector<float> extentY{};
+		std::vector<float> extentZ{};
+		std::vector<float> radius{};
+
+		size_t GetCount() const { return centerX.size(); }
+		void Resize(size_t count);
+		// Object space box and the radius of the sphere around its center, moved into world space
+		void Set(size_t index, const Affine3x4& worldTransform, const Vector3& boundsMin, const Vector3& boundsMax, float boundsRadius);
+	};
+
+	struct CullStats
+	{
+		size_t tested{};
+		size_t culled{};
+	};
+
+	namespace Utils
+	{
+		// Writes 1 to visible for every object inside or crossing the frustum, 0 for the others
+		CullStats CullBounds(const Frustum& frustum, const BoundsSoA& bounds, std::span<uint8_t> visible);
+	}
+}
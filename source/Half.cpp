@@ -0,0 +1,57 @@
+#include "pch.h"
+
+#include "Half.h"
+
+#if DAE_HALF_F16C
+#include <immintrin.h>
+#endif
+
+namespace dae {
+	void Half::Convert(std::span<const float> in, std::span<Half> out)
+	{
+		assert(out.size() >= in.size());
+
+		size_t i{ 0 };
+#if DAE_HALF_F16C
+		for(; i + 8 <= in.size(); i += 8)
+		{
+			const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(&in[i]), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i]), h);
+		}
+		if(i + 4 <= in.size())
+		{
+			const __m128i h = _mm_cvtps_ph(_mm_loadu_ps(&in[i]), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(&out[i]), h);
+			i += 4;
+		}
+#endif
+		for(; i < in.size(); ++i)
+		{
+			out[i] = Half{ in[i] };
+		}
+	}
+
+	void Half::Convert(std::span<const Half> in, std::span<float> out)
+	{
+		assert(out.size() >= in.size());
+
+		size_t i{ 0 };
+#if DAE_HALF_F16C
+		for(; i + 8 <= in.size(); i += 8)
+		{
+			const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&in[i]));
+			_mm256_storeu_ps(&out[i], _mm256_cvtph_ps(h));
+		}
+		if(i + 4 <= in.size())
+		{
+			const __m128i h = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&in[i]));
+			_mm_storeu_ps(&out[i], _mm_cvtph_ps(h));
+			i += 4;
+		}
+#endif
+		for(; i < in.size(); ++i)
+		{
+			out[i] = in[i].ToFloat();
+		}
+	}
+}
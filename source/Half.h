@@ -0,0 +1,190 @@
+#pragma once
+#include <span>
+#include <bit>
+#include <cstdint>
+#include <cassert>
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "ColorRGB.h"
+
+// F16C backend for the bulk conversions, every AVX2 cpu has F16C.
+// Define DAE_HALF_NO_F16C to force the scalar fallback, which gives the same bits.
+#if !defined(DAE_HALF_NO_F16C) && (defined(__F16C__) || defined(__AVX2__))
+#define DAE_HALF_F16C 1
+#else
+#define DAE_HALF_F16C 0
+#endif
+
+namespace dae
+{
+	// IEEE 754 binary16, storage only. Convert to float to do math on it.
+	struct Half
+	{
+		uint16_t bits{};
+
+		constexpr Half() = default;
+		explicit constexpr Half(float f) : bits{ FloatToBits(f) } {}
+
+		static constexpr Half FromBits(uint16_t b)
+		{
+			Half h{};
+			h.bits = b;
+			return h;
+		}
+
+		constexpr float ToFloat() const
+		{
+			return BitsToFloat(bits);
+		}
+
+		// Round to nearest even, overflow goes to infinity, NaNs stay NaN (quieted).
+		// Same results as the F16C instructions.
+		static constexpr uint16_t FloatToBits(float f)
+		{
+			uint32_t u{ std::bit_cast<uint32_t>(f) };
+			const uint16_t sign{ static_cast<uint16_t>((u >> 16) & 0x8000) };
+			u &= 0x7FFFFFFF;
+
+			// NaN
+			if(u > 0x7F800000)
+				return static_cast<uint16_t>(sign | 0x7E00 | ((u >> 13) & 0x3FF));
+
+			// 65520 and up rounds to infinity
+			if(u >= 0x477FF000)
+				return static_cast<uint16_t>(sign | 0x7C00);
+
+			// Below the smallest normal half (2^-14), result is subnormal or zero
+			if(u < 0x38800000)
+			{
+				// 2^-25 and below rounds to zero
+				if(u <= 0x33000000)
+					return sign;
+
+				const uint32_t mantissa{ (u & 0x7FFFFF) | 0x800000 };
+				const uint32_t shift{ 126 - (u >> 23) };
+				uint32_t result{ mantissa >> shift };
+				const uint32_t remainder{ mantissa & ((1u << shift) - 1) };
+				const uint32_t halfway{ 1u << (shift - 1) };
+				if(remainder > halfway || (remainder == halfway && (result & 1)))
+					++result;
+
+				return static_cast<uint16_t>(sign | result);
+			}
+
+			// Normal, rebias the exponent from 127 to 15. A mantissa carry rolls into the exponent.
+			uint32_t result{ (u >> 13) - (112 << 10) };
+			const uint32_t remainder{ u & 0x1FFF };
+			if(remainder > 0x1000 || (remainder == 0x1000 && (result & 1)))
+				++result;
+
+			return static_cast<uint16_t>(sign | result);
+		}
+
+		// Exact, every half is representable as a float
+		static constexpr float BitsToFloat(uint16_t h)
+		{
+			const uint32_t sign{ static_cast<uint32_t>(h & 0x8000) << 16 };
+			uint32_t exponent{ static_cast<uint32_t>(h >> 10) & 0x1F };
+			uint32_t mantissa{ static_cast<uint32_t>(h) & 0x3FF };
+
+			// Infinity or NaN
+			if(exponent == 0x1F)
+				return std::bit_cast<float>(sign | 0x7F800000 | (mantissa ? (0x400000 | (mantissa << 13)) : 0));
+
+			if(exponent == 0)
+			{
+				if(mantissa == 0)
+					return std::bit_cast<float>(sign);
+
+				// Subnormal half, normalize it
+				exponent = 113;
+				while((mantissa & 0x400) == 0)
+				{
+					mantissa <<= 1;
+					--exponent;
+				}
+				return std::bit_cast<float>(sign | (exponent << 23) | ((mantissa & 0x3FF) << 13));
+			}
+
+			return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+		}
+
+		// Bulk conversions, out must be at least as large as in
+		static void Convert(std::span<const float> in, std::span<Half> out);
+		static void Convert(std::span<const Half> in, std::span<float> out);
+	};
+
+	struct Half2
+	{
+		Half x{};
+		Half y{};
+
+		constexpr Half2() = default;
+		constexpr Half2(Half _x, Half _y) : x(_x), y(_y) {}
+		explicit constexpr Half2(const Vector2& v) : x(v.x), y(v.y) {}
+
+		constexpr Vector2 ToVector2() const
+		{
+			return { x.ToFloat(), y.ToFloat() };
+		}
+
+		static void Convert(std::span<const Vector2> in, std::span<Half2> out)
+		{
+			assert(out.size() >= in.size());
+			Half::Convert(std::span{ reinterpret_cast<const float*>(in.data()), in.size() * 2 }, std::span{ reinterpret_cast<Half*>(out.data()), in.size() * 2 });
+		}
+
+		static void Convert(std::span<const Half2> in, std::span<Vector2> out)
+		{
+			assert(out.size() >= in.size());
+			Half::Convert(std::span{ reinterpret_cast<const Half*>(in.data()), in.size() * 2 }, std::span{ reinterpret_cast<float*>(out.data()), in.size() * 2 });
+		}
+	};
+
+	struct Half4
+	{
+		Half x{};
+		Half y{};
+		Half z{};
+		Half w{};
+
+		constexpr Half4() = default;
+		constexpr Half4(Half _x, Half _y, Half _z, Half _w) : x(_x), y(_y), z(_z), w(_w) {}
+		explicit constexpr Half4(const Vector4& v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
+		// Normals and directions, padded to 8 bytes
+		explicit constexpr Half4(const Vector3& v, float _w = 0.f) : x(v.x), y(v.y), z(v.z), w(_w) {}
+		explicit constexpr Half4(const ColorRGB& c, float a = 1.f) : x(c.r), y(c.g), z(c.b), w(a) {}
+
+		constexpr Vector4 ToVector4() const
+		{
+			return { x.ToFloat(), y.ToFloat(), z.ToFloat(), w.ToFloat() };
+		}
+
+		constexpr Vector3 ToVector3() const
+		{
+			return { x.ToFloat(), y.ToFloat(), z.ToFloat() };
+		}
+
+		constexpr ColorRGB ToColorRGB() const
+		{
+			return { x.ToFloat(), y.ToFloat(), z.ToFloat() };
+		}
+
+		static void Convert(std::span<const Vector4> in, std::span<Half4> out)
+		{
+			assert(out.size() >= in.size());
+			Half::Convert(std::span{ reinterpret_cast<const float*>(in.data()), in.size() * 4 }, std::span{ reinterpret_cast<Half*>(out.data()), in.size() * 4 });
+		}
+
+		static void Convert(std::span<const Half4> in, std::span<Vector4> out)
+		{
+			assert(out.size() >= in.size());
+			Half::Convert(std::span{ reinterpret_cast<const Half*>(in.data()), in.size() * 4 }, std::span{ reinterpret_cast<float*>(out.data()), in.size() * 4 });
+		}
+	};
+
+	static_assert(sizeof(Half) == 2);
+	static_assert(sizeof(Half2) == 4);
+	static_assert(sizeof(Half4) == 8);
+}
@@ -0,0 +1,75 @@
+#include "pch.h"
+
+#include "IndexFormat.h"
+
+#include <cassert>
+
+namespace dae
+{
+	namespace Utils
+	{
+		void ConvertTo16BitIndices(std::span<const uint32_t> indices, std::span<uint16_t> out)
+		{
+			assert(out.size() >= indices.size());
+			for(size_t i{ 0 }; i < indices.size(); ++i)
+			{
+				assert(indices[i] <= UINT16_MAX);
+				out[i] = static_cast<uint16_t>(indices[i]);
+			}
+		}
+
+		SplitMesh16 SplitFor16BitIndices(std::span<const uint32_t> indices, size_t vertexCount, size_t maxVertices)
+		{
+			assert(maxVertices >= 3 && maxVertices <= MAX_16BIT_VERTICES);
+
+			constexpr uint32_t NONE{ UINT32_MAX };
+			SplitMesh16 split{};
+			split.indices.reserve(indices.size());
+
+			// Local index of every source vertex in the current submesh, stamped with the submesh so it never has to be cleared
+			std::vector<uint32_t> localIndices(vertexCount, NONE);
+			std::vector<uint32_t> localStamps(vertexCount, NONE);
+			Submesh16 submesh{};
+
+			const auto finishSubmesh = [&]
+			{
+				if(submesh.indexCount > 0)
+					split.submeshes.push_back(submesh);
+
+				submesh = {};
+				submesh.firstIndex = static_cast<uint32_t>(split.indices.size());
+				submesh.baseVertex = static_cast<uint32_t>(split.vertexRemap.size());
+			};
+
+			for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+			{
+				// Distinct vertices the triangle would add
+				const uint32_t* pTriangle{ indices.data() + i };
+				const uint32_t stamp{ static_cast<uint32_t>(split.submeshes.size()) };
+				const uint32_t newVertices{ static_cast<uint32_t>(localStamps[pTriangle[0]] != stamp)
+					+ static_cast<uint32_t>(pTriangle[1] != pTriangle[0] && localStamps[pTriangle[1]] != stamp)
+					+ static_cast<uint32_t>(pTriangle[2] != pTriangle[0] && pTriangle[2] != pTriangle[1] && localStamps[pTriangle[2]] != stamp) };
+
+				if(submesh.vertexCount + newVertices > maxVertices)
+					finishSubmesh();
+
+				const uint32_t currentStamp{ static_cast<uint32_t>(split.submeshes.size()) };
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					const uint32_t index{ pTriangle[corner] };
+					if(localStamps[index] != currentStamp)
+					{
+						localStamps[index] = currentStamp;
+						localIndices[index] = submesh.vertexCount++;
+						split.vertexRemap.push_back(index);
+					}
+					split.indices.push_back(static_cast<uint16_t>(localIndices[index]));
+				}
+				submesh.indexCount += 3;
+			}
+			finishSubmesh();
+
+			return split;
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dae
+{
+	// Part of a mesh drawn with 16 bit indices relative to baseVertex
+	struct Submesh16
+	{
+		uint32_t firstIndex{};
+		uint32_t indexCount{};
+		uint32_t baseVertex{};
+		uint32_t vertexCount{};
+	};
+
+	struct SplitMesh16
+	{
+		// Source vertex of every output vertex, submeshes duplicate the vertices they share
+		std::vector<uint32_t> vertexRemap{};
+		std::vector<uint16_t> indices{};
+		std::vector<Submesh16> submeshes{};
+	};
+
+	namespace Utils
+	{
+		constexpr size_t MAX_16BIT_VERTICES{ size_t{ UINT16_MAX } + 1 };
+
+		constexpr bool FitsIn16BitIndices(size_t vertexCount)
+		{
+			return vertexCount <= MAX_16BIT_VERTICES;
+		}
+
+		// Every index has to fit, out must be at least as large as indices
+		void ConvertTo16BitIndices(std::span<const uint32_t> indices, std::span<uint16_t> out);
+
+		// Cuts the triangles in order into submeshes of at most maxVertices distinct vertices each.
+		// Works best on cache optimized indices, neighbouring triangles then share most of their vertices.
+		SplitMesh16 SplitFor16BitIndices(std::span<const uint32_t> indices, size_t vertexCount, size_t maxVertices = MAX_16BIT_VERTICES);
+	}
+}
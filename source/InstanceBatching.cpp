@@ -0,0 +1,79 @@
+#include "pch.h"
+
+#include "InstanceBatching.h"
+
+#include <algorithm>
+
+namespace dae
+{
+	InstanceData InstanceData::Create(const Affine3x4& worldTransform, const Vector4& parameters)
+	{
+		const Vector3& axisX{ worldTransform.axisX };
+		const Vector3& axisY{ worldTransform.axisY };
+		const Vector3& axisZ{ worldTransform.axisZ };
+		const Vector3& translation{ worldTransform.translation };
+		return InstanceData{
+			{
+				Vector4{ axisX.x, axisY.x, axisZ.x, translation.x },
+				Vector4{ axisX.y, axisY.y, axisZ.y, translation.y },
+				Vector4{ axisX.z, axisY.z, axisZ.z, translation.z }
+			},
+			parameters };
+	}
+
+	void InstanceBatcher::Clear()
+	{
+		m_Keys.clear();
+		m_Instances.clear();
+		m_Batches.clear();
+	}
+
+	void InstanceBatcher::Add(uint32_t key, const Affine3x4& worldTransform, const Vector4& parameters)
+	{
+		m_Keys.push_back(key);
+		m_Instances.push_back(InstanceData::Create(worldTransform, parameters));
+	}
+
+	void InstanceBatcher::Build()
+	{
+		m_Batches.clear();
+		if(m_Keys.empty())
+			return;
+
+		// Usually submitted key by key already, then there is nothing to move
+		if(std::is_sorted(m_Keys.begin(), m_Keys.end()))
+		{
+			uint32_t first{ 0 };
+			for(uint32_t i{ 1 }; i <= m_Keys.size(); ++i)
+			{
+				if(i == m_Keys.size() || m_Keys[i] != m_Keys[first])
+				{
+					m_Batches.push_back({ m_Keys[first], first, i - first });
+					first = i;
+				}
+			}
+			return;
+		}
+
+		// Start of every key in the packed array
+		const uint32_t keyCount{ *std::max_element(m_Keys.begin(), m_Keys.end()) + 1 };
+		m_Offsets.assign(keyCount + 1, 0);
+		for(const uint32_t key : m_Keys)
+			++m_Offsets[key + 1];
+		for(uint32_t key{ 0 }; key < keyCount; ++key)
+		{
+			if(m_Offsets[key + 1] > 0)
+				m_Batches.push_back({ key, m_Offsets[key], m_Offsets[key + 1] });
+			m_Offsets[key + 1] += m_Offsets[key];
+		}
+
+		m_SortBuffer.resize(m_Instances.size());
+		for(size_t i{ 0 }; i < m_Instances.size(); ++i)
+			m_SortBuffer[m_Offsets[m_Keys[i]]++] = m_Instances[i];
+		m_Instances.swap(m_SortBuffer);
+
+		// The keys match the packed order again
+		for(const InstanceBatch& batch : m_Batches)
+			std::fill_n(m_Keys.begin() + batch.firstInstance, batch.instanceCount, batch.key);
+	}
+}
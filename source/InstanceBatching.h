@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Affine3x4.h"
+#include "Vector4.h"
+
+namespace dae
+{
+	// One instance in the per instance vertex stream (slot 1), matches VS_INSTANCE in the effects. 64 bytes.
+	struct InstanceData
+	{
+		// Row vector world matrix as columns, x y z of the axes and the translation in w: world.c = dot(float4(p, 1), column c)
+		Vector4 worldColumns[3]{};
+		// rgb tints the diffuse map, a is free
+		Vector4 parameters{ 1.f, 1.f, 1.f, 0.f };
+
+		static InstanceData Create(const Affine3x4& worldTransform, const Vector4& parameters);
+	};
+	static_assert(sizeof(InstanceData) == 64, "InstanceData is the vertex stride of the instance buffer");
+
+	// One DrawIndexedInstanced, a run of the packed instances that share a key
+	struct InstanceBatch
+	{
+		// Mesh and level of detail, everything that has to match to share a draw
+		uint32_t key{};
+		uint32_t firstInstance{};
+		uint32_t instanceCount{};
+
+		static constexpr uint32_t MakeKey(uint32_t mesh, uint32_t lod) { return mesh << 8 | lod; }
+		uint32_t GetMesh() const { return key >> 8; }
+		uint32_t GetLod() const { return key & 0xFF; }
+	};
+
+	// Collects the visible instances every frame and packs them key by key, so every mesh draws all of its copies at a level at once
+	class InstanceBatcher final
+	{
+	public:
+		InstanceBatcher() = default;
+
+		~InstanceBatcher() = default;
+		InstanceBatcher(const InstanceBatcher&) = delete;
+		InstanceBatcher(InstanceBatcher&&) noexcept = delete;
+		InstanceBatcher& operator=(const InstanceBatcher&) = delete;
+		InstanceBatcher& operator=(InstanceBatcher&&) noexcept = delete;
+
+		void Clear();
+		// key from InstanceBatch::MakeKey, the counting sort in Build wants small ones
+		void Add(uint32_t key, const Affine3x4& worldTransform, const Vector4& parameters = { 1.f, 1.f, 1.f, 0.f });
+
+		// Groups the instances by key with a counting sort, keeping their order inside a key, and makes one batch per key
+		void Build();
+
+		size_t GetInstanceCount() const { return m_Instances.size(); }
+		// Valid after Build, uploaded to the instance buffer as is
+		std::span<const InstanceData> GetInstanceData() const { return m_Instances; }
+		std::span<const InstanceBatch> GetBatches() const { return m_Batches; }
+
+	private:
+		std::vector<uint32_t> m_Keys{};
+		std::vector<InstanceData> m_Instances{};
+		std::vector<InstanceBatch> m_Batches{};
+
+		// Kept between frames so Build does not allocate
+		std::vector<InstanceData> m_SortBuffer{};
+		std::vector<uint32_t> m_Offsets{};
+	};
+}
@@ -0,0 +1,78 @@
+#include "pch.h"
+
+#include "InstancedRenderer.h"
+#include "Mesh.h"
+
+#include <cassert>
+#include <cstring>
+
+using namespace dae;
+
+InstancedRenderer::InstancedRenderer(ID3D11Device* pDevice, uint32_t capacity):
+	m_pDevice{ pDevice },
+	m_pInstanceBuffer{ nullptr },
+	m_Capacity{ 0 }
+{
+	CreateInstanceBuffer(std::max(capacity, 1u));
+}
+
+InstancedRenderer::~InstancedRenderer()
+{
+	SafeRelease(m_pInstanceBuffer);
+}
+
+void InstancedRenderer::CreateInstanceBuffer(uint32_t capacity)
+{
+	SafeRelease(m_pInstanceBuffer);
+	m_pInstanceBuffer = nullptr;
+	m_Capacity = 0;
+
+	// Rewritten every frame
+	D3D11_BUFFER_DESC bufferDesc{};
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth = static_cast<uint32_t>(sizeof(InstanceData)) * capacity;
+	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = 0;
+
+	const HRESULT result = m_pDevice->CreateBuffer(&bufferDesc, nullptr, &m_pInstanceBuffer);
+	if(FAILED(result))
+	{
+		assert(false);
+		return;
+	}
+	m_Capacity = capacity;
+}
+
+void InstancedRenderer::Upload(ID3D11DeviceContext* pDeviceContext, const InstanceBatcher& batcher)
+{
+	const std::span<const InstanceData> instances{ batcher.GetInstanceData() };
+	if(instances.empty())
+		return;
+
+	if(instances.size() > m_Capacity)
+		CreateInstanceBuffer(std::max(static_cast<uint32_t>(instances.size()), m_Capacity * 2));
+	if(!m_pInstanceBuffer)
+		return;
+
+	D3D11_MAPPED_SUBRESOURCE mapped{};
+	if(FAILED(pDeviceContext->Map(m_pInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+		return;
+	std::memcpy(mapped.pData, instances.data(), instances.size_bytes());
+	pDeviceContext->Unmap(m_pInstanceBuffer, 0);
+}
+
+void InstancedRenderer::Render(StateTrackingContext& context, const InstanceBatcher& batcher, std::span<Mesh* const> meshes,
+	const Matrix& viewProjection, const Matrix& viewInverse) const
+{
+	if(!m_pInstanceBuffer || batcher.GetInstanceCount() > m_Capacity)
+		return;
+
+	for(const InstanceBatch& batch : batcher.GetBatches())
+	{
+		assert(batch.GetMesh() < meshes.size());
+		Mesh* pMesh{ meshes[batch.GetMesh()] };
+		if(pMesh->CanRenderInstanced())
+			pMesh->RenderInstanced(context, m_pInstanceBuffer, batch.GetLod(), batch.firstInstance, batch.instanceCount, viewProjection, viewInverse);
+	}
+}
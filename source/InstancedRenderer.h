@@ -0,0 +1,33 @@
+#pragma once
+#include <span>
+#include "InstanceBatching.h"
+#include "StateTrackingContext.h"
+
+class Mesh;
+
+// Draws the batches of an InstanceBatcher with one DrawIndexedInstanced each, all instances live in one dynamic vertex buffer
+class InstancedRenderer final
+{
+public:
+	InstancedRenderer(ID3D11Device* pDevice, uint32_t capacity = 1024);
+
+	~InstancedRenderer();
+	InstancedRenderer(const InstancedRenderer&) = delete;
+	InstancedRenderer(InstancedRenderer&&) noexcept = delete;
+	InstancedRenderer& operator=(const InstancedRenderer&) = delete;
+	InstancedRenderer& operator=(InstancedRenderer&&) noexcept = delete;
+
+	// Copies the packed instances into the instance buffer, which grows when they do not fit
+	void Upload(ID3D11DeviceContext* pDeviceContext, const dae::InstanceBatcher& batcher);
+
+	// Batch keys hold the index into meshes and the level of detail, meshes without an instanced technique are skipped
+	void Render(dae::StateTrackingContext& context, const dae::InstanceBatcher& batcher, std::span<Mesh* const> meshes,
+		const dae::Matrix& viewProjection, const dae::Matrix& viewInverse) const;
+
+private:
+	ID3D11Device* m_pDevice;
+	ID3D11Buffer* m_pInstanceBuffer;
+	uint32_t m_Capacity;
+
+	void CreateInstanceBuffer(uint32_t capacity);
+};
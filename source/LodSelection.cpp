@@ -0,0 +1,56 @@
+#include "pch.h"
+
+#include "LodSelection.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dae
+{
+	void LodInstance::SetWorldTransform(const Affine3x4& worldTransform)
+	{
+		const float scaleSquared{ std::max({ worldTransform.axisX.SqrMagnitude(), worldTransform.axisY.SqrMagnitude(), worldTransform.axisZ.SqrMagnitude() }) };
+		scale = std::sqrt(scaleSquared);
+		center = worldTransform.TransformPoint(pChain->boundsCenter);
+		radius = pChain->boundsRadius * scale;
+	}
+
+	namespace Utils
+	{
+		LodStats SelectLods(std::span<LodInstance> instances, const Vector3& cameraPosition, float projectionScale, const LodSettings& settings)
+		{
+			const float coarsenThreshold{ settings.pixelThreshold * (1.f - settings.hysteresis) };
+
+			LodStats stats{};
+			stats.instances = instances.size();
+			for(LodInstance& instance : instances)
+			{
+				const LodChain& chain{ *instance.pChain };
+				const uint32_t lodCount{ static_cast<uint32_t>(chain.errors.size()) };
+
+				// Pixels per object space unit of error, from the nearest the mesh can get to the camera
+				const float distance{ (instance.center - cameraPosition).Magnitude() - instance.radius };
+				uint32_t lod{ 0 };
+				if(distance > 0.f && lodCount > 1)
+				{
+					const float pixelsPerError{ instance.scale * projectionScale / distance };
+					for(uint32_t level{ lodCount - 1 }; level > 0; --level)
+					{
+						const float threshold{ level > instance.lod ? coarsenThreshold : settings.pixelThreshold };
+						if(chain.errors[level] * pixelsPerError <= threshold)
+						{
+							lod = level;
+							break;
+						}
+					}
+				}
+
+				stats.changed += lod != instance.lod;
+				instance.lod = lod;
+				stats.fullTriangles += chain.triangleCounts[0];
+				stats.drawnTriangles += chain.triangleCounts[lod];
+			}
+			return stats;
+		}
+	}
+}
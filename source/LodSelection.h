@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Affine3x4.h"
+#include "Vector3.h"
+
+namespace dae
+{
+	// Levels of detail of one mesh, finest first, at least the full mesh
+	struct LodChain
+	{
+		// Object space geometric error, 0 for the full mesh
+		std::vector<float> errors{};
+		std::vector<uint32_t> triangleCounts{};
+		// Object space bounding sphere
+		Vector3 boundsCenter{};
+		float boundsRadius{};
+	};
+
+	// One drawn copy of a mesh, the chain has to outlive it
+	struct LodInstance
+	{
+		const LodChain* pChain{};
+		// World space bounding sphere and the largest scale of the world transform
+		Vector3 center{};
+		float radius{};
+		float scale{ 1.f };
+		// Picked by SelectLods, also the level the hysteresis compares against
+		uint32_t lod{};
+
+		void SetWorldTransform(const Affine3x4& worldTransform);
+	};
+
+	struct LodSettings
+	{
+		// Largest error on screen, in pixels
+		float pixelThreshold{ 1.f };
+		// Going coarser needs the error below pixelThreshold * (1 - hysteresis), going finer happens at pixelThreshold.
+		// The band between them keeps instances near a switch distance from popping back and forth.
+		float hysteresis{ 0.25f };
+	};
+
+	struct LodStats
+	{
+		size_t instances{};
+		// Instances that switched level this pass
+		size_t changed{};
+		size_t fullTriangles{};
+		size_t drawnTriangles{};
+
+		size_t GetTrianglesSaved() const { return fullTriangles - drawnTriangles; }
+	};
+
+	namespace Utils
+	{
+		// Pixels one world unit covers at distance 1, with fovRatio = tan(fov / 2) of the vertical field of view
+		constexpr float GetProjectionScale(float fovRatio, float viewportHeight)
+		{
+			return viewportHeight / (2.f * fovRatio);
+		}
+
+		// Projects every level's error from the nearest point of the instance's bounding sphere and picks the coarsest
+		// one under the threshold. Instances the camera is inside of get the full mesh.
+		LodStats SelectLods(std::span<LodInstance> instances, const Vector3& cameraPosition, float projectionScale, const LodSettings& settings = {});
+	}
+}
@@ -0,0 +1,158 @@
+#include "pch.h"
+
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dae
+{
+	MappedFile::MappedFile(const std::string& filename)
+	{
+		Open(filename);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if(this != &other)
+		{
+			Close();
+			m_pData = std::exchange(other.m_pData, nullptr);
+			m_Size = std::exchange(other.m_Size, 0);
+			m_IsEmpty = std::exchange(other.m_IsEmpty, false);
+#ifdef _WIN32
+			m_FileHandle = std::exchange(other.m_FileHandle, nullptr);
+			m_MappingHandle = std::exchange(other.m_MappingHandle, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::string& filename)
+	{
+		Close();
+
+		HANDLE file{ CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+		if(file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size{};
+		if(!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		if(size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			m_IsEmpty = true;
+			return true;
+		}
+
+		HANDLE mapping{ CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+		if(mapping == nullptr)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		const void* pView{ MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) };
+		if(pView == nullptr)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		m_FileHandle = file;
+		m_MappingHandle = mapping;
+		m_pData = static_cast<const char*>(pView);
+		m_Size = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if(m_pData)
+			UnmapViewOfFile(m_pData);
+		if(m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+		if(m_FileHandle)
+			CloseHandle(m_FileHandle);
+
+		m_pData = nullptr;
+		m_Size = 0;
+		m_IsEmpty = false;
+		m_FileHandle = nullptr;
+		m_MappingHandle = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::string& filename)
+	{
+		Close();
+
+		const int file{ open(filename.c_str(), O_RDONLY) };
+		if(file < 0)
+			return false;
+
+		struct stat info{};
+		if(fstat(file, &info) != 0)
+		{
+			close(file);
+			return false;
+		}
+
+		if(info.st_size == 0)
+		{
+			close(file);
+			m_IsEmpty = true;
+			return true;
+		}
+
+		void* pView{ mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0) };
+		// The mapping keeps its own reference to the file
+		close(file);
+		if(pView == MAP_FAILED)
+			return false;
+
+		madvise(pView, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+		m_pData = static_cast<const char*>(pView);
+		m_Size = static_cast<size_t>(info.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if(m_pData)
+			munmap(const_cast<char*>(m_pData), m_Size);
+
+		m_pData = nullptr;
+		m_Size = 0;
+		m_IsEmpty = false;
+	}
+#endif
+}
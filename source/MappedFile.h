@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace dae
+{
+	// Read only memory mapping of a whole file, unmapped when destroyed
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& filename);
+
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		bool Open(const std::string& filename);
+		void Close();
+
+		bool IsOpen() const { return m_pData != nullptr || m_IsEmpty; }
+		const char* GetData() const { return m_pData; }
+		size_t GetSize() const { return m_Size; }
+		std::string_view GetText() const { return { m_pData, m_Size }; }
+
+	private:
+		const char* m_pData{};
+		size_t m_Size{};
+		// Empty files can't be mapped but are still valid
+		bool m_IsEmpty{};
+
+#ifdef _WIN32
+		void* m_FileHandle{};
+		void* m_MappingHandle{};
+#endif
+	};
+}
@@ -4,4 +4,8 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix.h"
+#include "Affine3x4.h"
+#include "RigidTransform.h"
+#include "Quaternion.h"
+#include "Half.h"
 #include "MathHelpers.h"
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include <cmath>
+#include <cfloat>
+#include <type_traits>
 
 namespace dae
 {
@@ -21,29 +23,34 @@ namespace dae
 	constexpr auto TO_RADIANS(PI / 180.0f);
 
 	/* --- HELPER FUNCTIONS --- */
-	inline float Square(float a)
+	constexpr float Square(float a)
 	{
 		return a * a;
 	}
 
-	inline float Lerpf(float a, float b, float factor)
+	constexpr float Lerpf(float a, float b, float factor)
 	{
 		return ((1 - factor) * a) + (factor * b);
 	}
 
-	inline bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
+	constexpr float Abs(float a)
 	{
-		return abs(a - b) < epsilon;
+		return a < 0.f ? -a : a;
 	}
 
-	inline int Clamp(const int v, int min, int max)
+	constexpr bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
+	{
+		return Abs(a - b) < epsilon;
+	}
+
+	constexpr int Clamp(const int v, int min, int max)
 	{
 		if(v < min) return min;
 		if(v > max) return max;
 		return v;
 	}
 
-	inline float Clamp(const float v, float min, float max)
+	constexpr float Clamp(const float v, float min, float max)
 	{
 		if(v < min) return min;
 		if(v > max) return max;
@@ -63,10 +70,110 @@ namespace dae
 		return lowerBound + fmod(input - lowerBound, range);
 	}
 
-	inline float Saturate(const float v)
+	constexpr float Saturate(const float v)
 	{
 		if(v < 0.f) return 0.f;
 		if(v > 1.f) return 1.f;
 		return v;
 	}
+
+	/* --- CONSTEXPR TRIGONOMETRY --- */
+	// std::sin / std::cos are not constexpr, these are used when a transform gets folded at compile time.
+	// Range reduced to [-PI/2, PI/2] and evaluated with a Taylor series in double, error < 1e-9 before rounding to float.
+	constexpr double ConstexprSin(double x)
+	{
+		constexpr double pi{ 3.14159265358979323846 };
+
+		// Reduce to [-PI, PI]
+		const double turns{ x / (2.0 * pi) };
+		const long long wholeTurns{ static_cast<long long>(turns < 0.0 ? turns - 0.5 : turns + 0.5) };
+		x -= static_cast<double>(wholeTurns) * 2.0 * pi;
+
+		// Reduce to [-PI/2, PI/2] using sin(PI - x) == sin(x)
+		if(x > pi / 2.0) x = pi - x;
+		else if(x < -pi / 2.0) x = -pi - x;
+
+		// x - x^3/3! + x^5/5! - ... up to x^15
+		const double x2{ x * x };
+		double term{ x };
+		double result{ x };
+		for(int n{ 1 }; n <= 7; ++n)
+		{
+			term *= -x2 / static_cast<double>((2 * n) * (2 * n + 1));
+			result += term;
+		}
+		return result;
+	}
+
+	constexpr float ConstexprSin(float angle)
+	{
+		return static_cast<float>(ConstexprSin(static_cast<double>(angle)));
+	}
+
+	constexpr float ConstexprCos(float angle)
+	{
+		return static_cast<float>(ConstexprSin(static_cast<double>(angle) + 1.57079632679489661923));
+	}
+
+	// std::sin / std::cos at runtime, the constexpr series when evaluated at compile time
+	constexpr float Sin(float angle)
+	{
+		if(std::is_constant_evaluated())
+			return ConstexprSin(angle);
+		return std::sin(angle);
+	}
+
+	constexpr float Cos(float angle)
+	{
+		if(std::is_constant_evaluated())
+			return ConstexprCos(angle);
+		return std::cos(angle);
+	}
+
+	/* --- FUSED SINE / COSINE --- */
+	enum class TrigMode
+	{
+		Precise,	// std::sin / std::cos
+		Fast		// Minimax polynomial, max abs error ~4e-7 against std::sin / std::cos for |angle| < 10
+	};
+
+	// 11-degree sine / 10-degree cosine minimax polynomials on [-PI/2, PI/2], one shared range reduction.
+	// The reduction is done in float, so the error grows with |angle| (about 6e-5 at 1e3 rad, 8e-4 at 1e4 rad).
+	constexpr void SinCosFast(float angle, float& sine, float& cosine)
+	{
+		// Map to y in [-PI, PI]
+		float quotient{ angle * (1.f / PI_2) };
+		quotient = static_cast<float>(static_cast<int>(quotient >= 0.f ? quotient + 0.5f : quotient - 0.5f));
+		float y{ angle - PI_2 * quotient };
+
+		// Map to [-PI/2, PI/2] with sin(y) unchanged, cosine flips sign
+		float sign{ 1.f };
+		if(y > PI_DIV_2)
+		{
+			y = PI - y;
+			sign = -1.f;
+		}
+		else if(y < -PI_DIV_2)
+		{
+			y = -PI - y;
+			sign = -1.f;
+		}
+
+		const float y2{ y * y };
+		sine = (((((-2.3889859e-08f * y2 + 2.7525562e-06f) * y2 - 0.00019840874f) * y2 + 0.0083333310f) * y2 - 0.16666667f) * y2 + 1.f) * y;
+		cosine = sign * (((((-2.6051615e-07f * y2 + 2.4760495e-05f) * y2 - 0.0013888378f) * y2 + 0.041666638f) * y2 - 0.5f) * y2 + 1.f);
+	}
+
+	constexpr void SinCos(float angle, float& sine, float& cosine, TrigMode mode = TrigMode::Precise)
+	{
+		if(mode == TrigMode::Fast)
+		{
+			SinCosFast(angle, sine, cosine);
+			return;
+		}
+
+		// Both calls side by side so the compiler can merge them into one sincos
+		sine = Sin(angle);
+		cosine = Cos(angle);
+	}
 }
\ No newline at end of file
@@ -7,288 +7,610 @@
 #include "MathHelpers.h"
 #include <cmath>
 
+#if DAE_MATRIX_SIMD
+#include <immintrin.h>
+#endif
+
 namespace dae
 {
-	Matrix::Matrix(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& t):
-		Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+#if DAE_MATRIX_SIMD
+	namespace
 	{
-	}
+		inline __m128 LoadRow(const Vector4& v)
+		{
+			return _mm_load_ps(&v.x);
+		}
 
-	Matrix::Matrix(const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis, const Vector4& t)
-	{
-		data[0] = xAxis;
-		data[1] = yAxis;
-		data[2] = zAxis;
-		data[3] = t;
-	}
+		inline void StoreRow(Vector4& v, __m128 r)
+		{
+			_mm_store_ps(&v.x, r);
+		}
 
-	Matrix::Matrix(const Matrix& m)
-	{
-		data[0] = m[0];
-		data[1] = m[1];
-		data[2] = m[2];
-		data[3] = m[3];
-	}
+		inline __m128 MulAdd(__m128 a, __m128 b, __m128 c)
+		{
+#if defined(__FMA__) || defined(__AVX2__)
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
 
-	Vector3 Matrix::TransformVector(const Vector3& v) const
-	{
-		return TransformVector(v.x, v.y, v.z);
-	}
+		template<int lane>
+		inline __m128 Splat(__m128 v)
+		{
+			return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane));
+		}
 
-	Vector3 Matrix::TransformVector(float x, float y, float z) const
-	{
-		return Vector3{
-			data[0].x * x + data[1].x * y + data[2].x * z,
-			data[0].y * x + data[1].y * y + data[2].y * z,
-			data[0].z * x + data[1].z * y + data[2].z * z
-		};
-	}
+		// Row vector times matrix: x * m0 + y * m1 + z * m2 + w * m3 (no transposed copy needed)
+		inline __m128 RowTimesMatrix(__m128 row, __m128 m0, __m128 m1, __m128 m2, __m128 m3)
+		{
+			__m128 result = _mm_mul_ps(Splat<0>(row), m0);
+			result = MulAdd(Splat<1>(row), m1, result);
+			result = MulAdd(Splat<2>(row), m2, result);
+			return MulAdd(Splat<3>(row), m3, result);
+		}
 
-	Vector3 Matrix::TransformPoint(const Vector3& p) const
-	{
-		return TransformPoint(p.x, p.y, p.z);
-	}
+		// Cross product on the xyz lanes, w lane is garbage
+		inline __m128 Cross3(__m128 a, __m128 b)
+		{
+			const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+			return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+		}
 
-	Vector3 Matrix::TransformPoint(float x, float y, float z) const
-	{
-		return Vector3{
-			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
-			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
-			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+		// Dot product on the xyz lanes, summed in the same order as Vector3::Dot
+		inline float Dot3(__m128 a, __m128 b)
+		{
+			const __m128 p = _mm_mul_ps(a, b);
+			return _mm_cvtss_f32(p) + _mm_cvtss_f32(Splat<1>(p)) + _mm_cvtss_f32(Splat<2>(p));
+		}
+
+		// Register width traits so the SoA kernels can run 4 (SSE) or 8 (AVX) lanes wide
+		struct Lanes4
+		{
+			using Reg = __m128;
+			static constexpr size_t Width{ 4 };
+
+			static Reg Set1(float v) { return _mm_set1_ps(v); }
+			static Reg Load(const float* p) { return _mm_loadu_ps(p); }
+			static void Store(float* p, Reg r) { _mm_storeu_ps(p, r); }
+			static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+			static Reg MulAdd(Reg a, Reg b, Reg c) { return dae::MulAdd(a, b, c); }
 		};
-	}
 
-	Vector4 Matrix::TransformPoint(const Vector4& p) const
-	{
-		return TransformPoint(p.x, p.y, p.z, p.w);
-	}
+#if defined(__AVX__)
+		struct Lanes8
+		{
+			using Reg = __m256;
+			static constexpr size_t Width{ 8 };
+
+			static Reg Set1(float v) { return _mm256_set1_ps(v); }
+			static Reg Load(const float* p) { return _mm256_loadu_ps(p); }
+			static void Store(float* p, Reg r) { _mm256_storeu_ps(p, r); }
+			static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+			static Reg MulAdd(Reg a, Reg b, Reg c)
+			{
+#if defined(__FMA__) || defined(__AVX2__)
+				return _mm256_fmadd_ps(a, b, c);
+#else
+				return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+			}
+		};
+#endif
 
-	Vector4 Matrix::TransformPoint(float x, float y, float z, float w) const
-	{
-		return Vector4{
-			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
-			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
-			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
-			data[0].w * x + data[1].w * y + data[2].w * z + data[3].w
+		// Every matrix element splatted over a full register, built once per batch
+		template<typename L>
+		struct SplatMatrix
+		{
+			typename L::Reg m[4][4];
+
+			explicit SplatMatrix(const Vector4* rows)
+			{
+				for(int r{ 0 }; r < 4; ++r)
+				{
+					for(int c{ 0 }; c < 4; ++c)
+					{
+						m[r][c] = L::Set1(rows[r][c]);
+					}
+				}
+			}
 		};
-	}
 
-	const Matrix& Matrix::Transpose()
-	{
-		Matrix result{};
-		for(int r{ 0 }; r < 4; ++r)
+		// Transforms one packet of SoA points (or vectors), same summation order as the scalar code
+		template<typename L, bool isPoint>
+		inline void TransformPacket(const SplatMatrix<L>& s, typename L::Reg x, typename L::Reg y, typename L::Reg z,
+			typename L::Reg& outX, typename L::Reg& outY, typename L::Reg& outZ, typename L::Reg* pOutW)
 		{
-			for(int c{ 0 }; c < 4; ++c)
+			outX = L::MulAdd(z, s.m[2][0], L::MulAdd(y, s.m[1][0], L::Mul(x, s.m[0][0])));
+			outY = L::MulAdd(z, s.m[2][1], L::MulAdd(y, s.m[1][1], L::Mul(x, s.m[0][1])));
+			outZ = L::MulAdd(z, s.m[2][2], L::MulAdd(y, s.m[1][2], L::Mul(x, s.m[0][2])));
+
+			if constexpr(isPoint)
 			{
-				result[r][c] = data[c][r];
+				outX = L::Add(outX, s.m[3][0]);
+				outY = L::Add(outY, s.m[3][1]);
+				outZ = L::Add(outZ, s.m[3][2]);
+				*pOutW = L::Add(L::MulAdd(z, s.m[2][3], L::MulAdd(y, s.m[1][3], L::Mul(x, s.m[0][3]))), s.m[3][3]);
 			}
 		}
 
-		data[0] = result[0];
-		data[1] = result[1];
-		data[2] = result[2];
-		data[3] = result[3];
+		// Runs the SoA kernel over as many full packets as fit, returns the first index it did not process
+		template<typename L, bool isPoint>
+		size_t TransformSoA(const Vector4* rows, size_t first, size_t count,
+			const float* xs, const float* ys, const float* zs,
+			float* outXs, float* outYs, float* outZs, float* outWs, bool perspectiveDivide)
+		{
+			const SplatMatrix<L> s{ rows };
 
-		return *this;
-	}
+			size_t i{ first };
+			for(; i + L::Width <= count; i += L::Width)
+			{
+				typename L::Reg x, y, z, w;
+				TransformPacket<L, isPoint>(s, L::Load(xs + i), L::Load(ys + i), L::Load(zs + i), x, y, z, &w);
+
+				if constexpr(isPoint)
+				{
+					L::Store(outWs + i, w);
+					if(perspectiveDivide)
+					{
+						x = L::Div(x, w);
+						y = L::Div(y, w);
+						z = L::Div(z, w);
+					}
+				}
+
+				L::Store(outXs + i, x);
+				L::Store(outYs + i, y);
+				L::Store(outZs + i, z);
+			}
 
-	const Matrix& Matrix::Inverse()
-	{
-		//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
-		const Vector3& a = data[0];
-		const Vector3& b = data[1];
-		const Vector3& c = data[2];
-		const Vector3& d = data[3];
-
-		const float x = data[0][3];
-		const float y = data[1][3];
-		const float z = data[2][3];
-		const float w = data[3][3];
-
-		Vector3 s = Vector3::Cross(a, b);
-		Vector3 t = Vector3::Cross(c, d);
-		Vector3 u = a * y - b * x;
-		Vector3 v = c * w - d * z;
-
-		const float det = Vector3::Dot(s, v) + Vector3::Dot(t, u);
-		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
-		const float invDet = 1.f / det;
+			return i;
+		}
+
+		// 4 packed Vector3's (12 floats) to SoA registers and back
+		inline void Deinterleave3(const float* p, __m128& x, __m128& y, __m128& z)
+		{
+			const __m128 a = _mm_loadu_ps(p);		// x0 y0 z0 x1
+			const __m128 b = _mm_loadu_ps(p + 4);	// y1 z1 x2 y2
+			const __m128 c = _mm_loadu_ps(p + 8);	// z2 x3 y3 z3
+
+			x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+			y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		}
+
+		inline void Interleave3(float* p, __m128 x, __m128 y, __m128 z)
+		{
+			const __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+			_mm_storeu_ps(p, a);
+			_mm_storeu_ps(p + 4, b);
+			_mm_storeu_ps(p + 8, c);
+		}
 
-		s *= invDet; t *= invDet; u *= invDet; v *= invDet;
+#if defined(__AVX2__)
+		// 8 packed Vector3's (24 floats) to SoA registers. Every component sits at a different lane in each of the
+		// three loads, so two blends gather it into one register and one permute puts it in point order.
+		inline void Deinterleave3(const float* p, __m256& x, __m256& y, __m256& z)
+		{
+			const __m256 a = _mm256_loadu_ps(p);		// x0 y0 z0 x1 y1 z1 x2 y2
+			const __m256 b = _mm256_loadu_ps(p + 8);	// z2 x3 y3 z3 x4 y4 z4 x5
+			const __m256 c = _mm256_loadu_ps(p + 16);	// y5 z5 x6 y6 z6 x7 y7 z7
 
-		const Vector3 r0 = Vector3::Cross(b, v) + t * y;
-		const Vector3 r1 = Vector3::Cross(v, a) - t * x;
-		const Vector3 r2 = Vector3::Cross(d, u) + s * w;
-		//Vector3 r3 = Vector3::Cross(u, c) - s * z;
+			x = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24), _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+			y = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49), _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+			z = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92), _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+		}
+#endif
 
-		data[0] = Vector4{ r0.x, r1.x, r2.x, 0.f };
-		data[1] = Vector4{ r0.y, r1.y, r2.y, 0.f };
-		data[2] = Vector4{ r0.z, r1.z, r2.z, 0.f };
-		data[3] = { -Vector3::Dot(b, t),Vector3::Dot(a, t),-Vector3::Dot(d, s),Vector3::Dot(c, s) };
+		// Transforms packed Vector3 points into Vector4's, 8 at a time with AVX2 and 4 with SSE.
+		// Returns the first index it did not process.
+		size_t TransformAoS3To4(const Vector4* rows, const Vector3* pIn, Vector4* pOut, size_t count, bool perspectiveDivide)
+		{
+			size_t i{ 0 };
+#if defined(__AVX2__)
+			const SplatMatrix<Lanes8> s8{ rows };
+			for(; i + 8 <= count; i += 8)
+			{
+				__m256 x, y, z, w;
+				Deinterleave3(&pIn[i].x, x, y, z);
+				TransformPacket<Lanes8, true>(s8, x, y, z, x, y, z, &w);
+				if(perspectiveDivide)
+				{
+					x = _mm256_div_ps(x, w);
+					y = _mm256_div_ps(y, w);
+					z = _mm256_div_ps(z, w);
+				}
+
+				// 4x4 transpose inside both 128 bit halves, the low half holds points 0-3 and the high half 4-7
+				const __m256 xy01 = _mm256_unpacklo_ps(x, y);
+				const __m256 xy23 = _mm256_unpackhi_ps(x, y);
+				const __m256 zw01 = _mm256_unpacklo_ps(z, w);
+				const __m256 zw23 = _mm256_unpackhi_ps(z, w);
+				const __m256 p0 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(1, 0, 1, 0));
+				const __m256 p1 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(3, 2, 3, 2));
+				const __m256 p2 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+				const __m256 p3 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+				_mm_storeu_ps(&pOut[i].x, _mm256_castps256_ps128(p0));
+				_mm_storeu_ps(&pOut[i + 1].x, _mm256_castps256_ps128(p1));
+				_mm_storeu_ps(&pOut[i + 2].x, _mm256_castps256_ps128(p2));
+				_mm_storeu_ps(&pOut[i + 3].x, _mm256_castps256_ps128(p3));
+				_mm_storeu_ps(&pOut[i + 4].x, _mm256_extractf128_ps(p0, 1));
+				_mm_storeu_ps(&pOut[i + 5].x, _mm256_extractf128_ps(p1, 1));
+				_mm_storeu_ps(&pOut[i + 6].x, _mm256_extractf128_ps(p2, 1));
+				_mm_storeu_ps(&pOut[i + 7].x, _mm256_extractf128_ps(p3, 1));
+			}
+#endif
+			const SplatMatrix<Lanes4> s{ rows };
+			for(; i + 4 <= count; i += 4)
+			{
+				__m128 x, y, z, w;
+				Deinterleave3(&pIn[i].x, x, y, z);
+				TransformPacket<Lanes4, true>(s, x, y, z, x, y, z, &w);
+				if(perspectiveDivide)
+				{
+					// Divide xyz, keep w so it can still be used for perspective correct interpolation
+					x = _mm_div_ps(x, w);
+					y = _mm_div_ps(y, w);
+					z = _mm_div_ps(z, w);
+				}
+
+				// SoA lanes to one Vector4 per point
+				_MM_TRANSPOSE4_PS(x, y, z, w);
+				_mm_storeu_ps(&pOut[i].x, x);
+				_mm_storeu_ps(&pOut[i + 1].x, y);
+				_mm_storeu_ps(&pOut[i + 2].x, z);
+				_mm_storeu_ps(&pOut[i + 3].x, w);
+			}
+
+			return i;
+		}
+
+		// SinCosFast on 4 angles at once, same reduction and polynomials as the scalar version
+		inline void SinCosFast4(__m128 angle, __m128& sine, __m128& cosine)
+		{
+			const __m128 signMask = _mm_set1_ps(-0.f);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 pi = _mm_set1_ps(PI);
+			const __m128 piDiv2 = _mm_set1_ps(PI_DIV_2);
+
+			// Map to y in [-PI, PI], rounding half away from zero
+			__m128 quotient = _mm_mul_ps(angle, _mm_set1_ps(1.f / PI_2));
+			quotient = _mm_add_ps(quotient, _mm_or_ps(half, _mm_and_ps(quotient, signMask)));
+			quotient = _mm_cvtepi32_ps(_mm_cvttps_epi32(quotient));
+			__m128 y = _mm_sub_ps(angle, _mm_mul_ps(_mm_set1_ps(PI_2), quotient));
+
+			// Map to [-PI/2, PI/2], y = +-PI - y where |y| > PI/2
+			const __m128 ySign = _mm_and_ps(y, signMask);
+			const __m128 fold = _mm_cmpgt_ps(_mm_andnot_ps(signMask, y), piDiv2);
+			const __m128 folded = _mm_sub_ps(_mm_or_ps(pi, ySign), y);
+			y = _mm_or_ps(_mm_and_ps(fold, folded), _mm_andnot_ps(fold, y));
+			const __m128 cosSign = _mm_and_ps(fold, signMask);
+
+			const __m128 y2 = _mm_mul_ps(y, y);
+
+			__m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-2.3889859e-08f), y2), _mm_set1_ps(2.7525562e-06f));
+			s = _mm_sub_ps(_mm_mul_ps(s, y2), _mm_set1_ps(0.00019840874f));
+			s = _mm_add_ps(_mm_mul_ps(s, y2), _mm_set1_ps(0.0083333310f));
+			s = _mm_sub_ps(_mm_mul_ps(s, y2), _mm_set1_ps(0.16666667f));
+			s = _mm_add_ps(_mm_mul_ps(s, y2), _mm_set1_ps(1.f));
+			sine = _mm_mul_ps(s, y);
+
+			__m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-2.6051615e-07f), y2), _mm_set1_ps(2.4760495e-05f));
+			c = _mm_sub_ps(_mm_mul_ps(c, y2), _mm_set1_ps(0.0013888378f));
+			c = _mm_add_ps(_mm_mul_ps(c, y2), _mm_set1_ps(0.041666638f));
+			c = _mm_sub_ps(_mm_mul_ps(c, y2), _mm_set1_ps(0.5f));
+			c = _mm_add_ps(_mm_mul_ps(c, y2), _mm_set1_ps(1.f));
+			cosine = _mm_xor_ps(c, cosSign);
+		}
+
+		// Transforms packed Vector3's 4 at a time, returns the first index it did not process
+		template<bool isPoint>
+		size_t TransformAoS3(const Vector4* rows, const Vector3* pIn, Vector3* pOut, size_t count)
+		{
+			static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be tightly packed");
+			const SplatMatrix<Lanes4> s{ rows };
 
-		return *this;
+			size_t i{ 0 };
+			for(; i + 4 <= count; i += 4)
+			{
+				__m128 x, y, z, w;
+				Deinterleave3(&pIn[i].x, x, y, z);
+				TransformPacket<Lanes4, isPoint>(s, x, y, z, x, y, z, &w);
+				Interleave3(&pOut[i].x, x, y, z);
+			}
+
+			return i;
+		}
 	}
+#endif
 
-	Matrix Matrix::Transpose(const Matrix& m)
+#if DAE_MATRIX_SIMD
+#pragma region SIMD
+	Vector3 Matrix::TransformPointSIMD(float x, float y, float z) const
 	{
-		Matrix out{ m };
-		out.Transpose();
+		const __m128 result = RowTimesMatrix(_mm_set_ps(1.f, z, y, x), LoadRow(data[0]), LoadRow(data[1]), LoadRow(data[2]), LoadRow(data[3]));
 
-		return out;
+		alignas(16) Vector4 out;
+		StoreRow(out, result);
+		return Vector3{ out.x, out.y, out.z };
 	}
 
-	Matrix Matrix::Inverse(const Matrix& m)
+	Vector4 Matrix::TransformPoint4SIMD(float x, float y, float z) const
 	{
-		Matrix out{ m };
-		out.Inverse();
+		const __m128 result = RowTimesMatrix(_mm_set_ps(1.f, z, y, x), LoadRow(data[0]), LoadRow(data[1]), LoadRow(data[2]), LoadRow(data[3]));
 
+		alignas(16) Vector4 out;
+		StoreRow(out, result);
 		return out;
 	}
 
-	Matrix Matrix::CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up)
+	void Matrix::TransposeSIMD()
 	{
-		const Vector3 right = Vector3::Cross(Vector3::UnitY, forward).Normalized();
-		return {
-			Vector4(right, 0),
-			Vector4(up, 0),
-			Vector4(forward, 0),
-			Vector4(origin, 1)
-		};
+		__m128 r0 = LoadRow(data[0]);
+		__m128 r1 = LoadRow(data[1]);
+		__m128 r2 = LoadRow(data[2]);
+		__m128 r3 = LoadRow(data[3]);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		StoreRow(data[0], r0);
+		StoreRow(data[1], r1);
+		StoreRow(data[2], r2);
+		StoreRow(data[3], r3);
 	}
 
-	Matrix Matrix::CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf)
+	void Matrix::InverseSIMD()
 	{
-		return {
-			{ 1.0f / (aspect * fov),	0.0f,		0.0f,					0.0f },
-			{ 0.0f,						1.0f / fov,	0.0f,					0.0f },
-			{ 0.0f,						0.0f,		zf / (zf - zn),			1.0f },
-			{ 0.0f,						0.0f,		-(zf * zn) / (zf - zn),	0.0f }
-		};
-	}
+		//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
+		const __m128 a = LoadRow(data[0]);
+		const __m128 b = LoadRow(data[1]);
+		const __m128 c = LoadRow(data[2]);
+		const __m128 d = LoadRow(data[3]);
+
+		const __m128 x = Splat<3>(a);
+		const __m128 y = Splat<3>(b);
+		const __m128 z = Splat<3>(c);
+		const __m128 w = Splat<3>(d);
+
+		__m128 s = Cross3(a, b);
+		__m128 t = Cross3(c, d);
+		__m128 u = _mm_sub_ps(_mm_mul_ps(a, y), _mm_mul_ps(b, x));
+		__m128 v = _mm_sub_ps(_mm_mul_ps(c, w), _mm_mul_ps(d, z));
+
+		const float det = Dot3(s, v) + Dot3(t, u);
+		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+		const __m128 invDet = _mm_set1_ps(1.f / det);
 
-	Vector3 Matrix::GetAxisX() const
-	{
-		return data[0];
-	}
+		s = _mm_mul_ps(s, invDet); t = _mm_mul_ps(t, invDet); u = _mm_mul_ps(u, invDet); v = _mm_mul_ps(v, invDet);
 
-	Vector3 Matrix::GetAxisY() const
-	{
-		return data[1];
-	}
+		__m128 r0 = _mm_add_ps(Cross3(b, v), _mm_mul_ps(t, y));
+		__m128 r1 = _mm_sub_ps(Cross3(v, a), _mm_mul_ps(t, x));
+		__m128 r2 = _mm_add_ps(Cross3(d, u), _mm_mul_ps(s, w));
+		__m128 r3 = _mm_sub_ps(Cross3(u, c), _mm_mul_ps(s, z));
 
-	Vector3 Matrix::GetAxisZ() const
-	{
-		return data[2];
-	}
+		// Put the translation part in the w lanes, so one transpose yields the final rows
+		alignas(16) const float translation[4]{ -Dot3(b, t), Dot3(a, t), -Dot3(d, s), Dot3(c, s) };
+		const __m128 wMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+		r0 = _mm_or_ps(_mm_andnot_ps(wMask, r0), _mm_and_ps(wMask, _mm_set1_ps(translation[0])));
+		r1 = _mm_or_ps(_mm_andnot_ps(wMask, r1), _mm_and_ps(wMask, _mm_set1_ps(translation[1])));
+		r2 = _mm_or_ps(_mm_andnot_ps(wMask, r2), _mm_and_ps(wMask, _mm_set1_ps(translation[2])));
+		r3 = _mm_or_ps(_mm_andnot_ps(wMask, r3), _mm_and_ps(wMask, _mm_set1_ps(translation[3])));
 
-	Vector3 Matrix::GetTranslation() const
-	{
-		return data[3];
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		StoreRow(data[0], r0);
+		StoreRow(data[1], r1);
+		StoreRow(data[2], r2);
+		StoreRow(data[3], r3);
 	}
 
-	Matrix Matrix::CreateTranslation(float x, float y, float z)
+	Matrix Matrix::MultiplySIMD(const Matrix& m1, const Matrix& m2)
 	{
-		return CreateTranslation({ x, y, z });
-	}
+		Matrix result{};
+		const __m128 b0 = LoadRow(m2.data[0]);
+		const __m128 b1 = LoadRow(m2.data[1]);
+		const __m128 b2 = LoadRow(m2.data[2]);
+		const __m128 b3 = LoadRow(m2.data[3]);
 
-	Matrix Matrix::CreateTranslation(const Vector3& t)
-	{
-		return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
-	}
+		for(int r{ 0 }; r < 4; ++r)
+		{
+			StoreRow(result.data[r], RowTimesMatrix(LoadRow(m1.data[r]), b0, b1, b2, b3));
+		}
 
-	Matrix Matrix::CreateRotationX(float pitch)
-	{
-		return {
-			{1, 0, 0, 0},
-			{0, cos(pitch), -sin(pitch), 0},
-			{0, sin(pitch), cos(pitch), 0},
-			{0, 0, 0, 1}
-		};
+		return result;
 	}
+#pragma endregion
+#endif
 
-	Matrix Matrix::CreateRotationY(float yaw)
+	void Matrix::CreateRotations(std::span<const Vector3> eulerAngles, std::span<Matrix> rotationsOut, TrigMode mode)
 	{
-		return {
-			{cos(yaw), 0, -sin(yaw), 0},
-			{0, 1, 0, 0},
-			{sin(yaw), 0, cos(yaw), 0},
-			{0, 0, 0, 1}
-		};
+		assert(rotationsOut.size() >= eulerAngles.size());
+
+		size_t i{ 0 };
+#if DAE_MATRIX_SIMD
+		if(mode == TrigMode::Fast)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			for(; i + 4 <= eulerAngles.size(); i += 4)
+			{
+				__m128 pitch, yaw, roll;
+				Deinterleave3(&eulerAngles[i].x, pitch, yaw, roll);
+
+				__m128 sp, cp, sy, cy, sr, cr;
+				SinCosFast4(pitch, sp, cp);
+				SinCosFast4(yaw, sy, cy);
+				SinCosFast4(roll, sr, cr);
+
+				// Same terms as CreateRotation, one lane per matrix
+				const __m128 spsy = _mm_mul_ps(sp, sy);
+				const __m128 cpsy = _mm_mul_ps(cp, sy);
+
+				__m128 row0[4]{ _mm_mul_ps(cy, cr), _mm_mul_ps(cy, sr), _mm_xor_ps(sy, _mm_set1_ps(-0.f)), zero };
+				__m128 row1[4]{
+					_mm_sub_ps(_mm_xor_ps(_mm_mul_ps(spsy, cr), _mm_set1_ps(-0.f)), _mm_mul_ps(cp, sr)),
+					_mm_add_ps(_mm_xor_ps(_mm_mul_ps(spsy, sr), _mm_set1_ps(-0.f)), _mm_mul_ps(cp, cr)),
+					_mm_xor_ps(_mm_mul_ps(sp, cy), _mm_set1_ps(-0.f)),
+					zero
+				};
+				__m128 row2[4]{
+					_mm_sub_ps(_mm_mul_ps(cpsy, cr), _mm_mul_ps(sp, sr)),
+					_mm_add_ps(_mm_mul_ps(cpsy, sr), _mm_mul_ps(sp, cr)),
+					_mm_mul_ps(cp, cy),
+					zero
+				};
+
+				// SoA lanes to one row per matrix
+				_MM_TRANSPOSE4_PS(row0[0], row0[1], row0[2], row0[3]);
+				_MM_TRANSPOSE4_PS(row1[0], row1[1], row1[2], row1[3]);
+				_MM_TRANSPOSE4_PS(row2[0], row2[1], row2[2], row2[3]);
+
+				for(size_t lane{ 0 }; lane < 4; ++lane)
+				{
+					Matrix& out = rotationsOut[i + lane];
+					StoreRow(out.data[0], row0[lane]);
+					StoreRow(out.data[1], row1[lane]);
+					StoreRow(out.data[2], row2[lane]);
+					out.data[3] = { 0, 0, 0, 1 };
+				}
+			}
+		}
+#endif
+		for(; i < eulerAngles.size(); ++i)
+		{
+			rotationsOut[i] = CreateRotation(eulerAngles[i], mode);
+		}
 	}
 
-	Matrix Matrix::CreateRotationZ(float roll)
+	Matrix Matrix::CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up)
 	{
+		const Vector3 right = Vector3::Cross(Vector3::UnitY, forward).Normalized();
 		return {
-			{cos(roll), sin(roll), 0, 0},
-			{-sin(roll), cos(roll), 0, 0},
-			{0, 0, 1, 0},
-			{0, 0, 0, 1}
+			Vector4(right, 0),
+			Vector4(up, 0),
+			Vector4(forward, 0),
+			Vector4(origin, 1)
 		};
 	}
 
-	Matrix Matrix::CreateRotation(float pitch, float yaw, float roll)
+#pragma region Batch Transforms
+	void Matrix::TransformPoints(std::span<const Vector3> points, std::span<Vector3> pointsOut) const
 	{
-		return CreateRotation({ pitch, yaw, roll });
-	}
+		assert(pointsOut.size() >= points.size());
 
-	Matrix Matrix::CreateRotation(const Vector3& r)
-	{
-		return CreateRotationX(r[0]) * CreateRotationY(r[1]) * CreateRotationZ(r[2]);
+		size_t i{ 0 };
+#if DAE_MATRIX_SIMD
+		i = TransformAoS3<true>(data, points.data(), pointsOut.data(), points.size());
+#endif
+		for(; i < points.size(); ++i)
+		{
+			pointsOut[i] = TransformPoint(points[i]);
+		}
 	}
 
-	Matrix Matrix::CreateScale(float sx, float sy, float sz)
+	void Matrix::TransformPoints(std::span<const Vector3> points, std::span<Vector4> pointsOut, bool perspectiveDivide) const
 	{
-		return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
-	}
+		assert(pointsOut.size() >= points.size());
 
-	Matrix Matrix::CreateScale(const Vector3& s)
-	{
-		return CreateScale(s[0], s[1], s[2]);
+		size_t i{ 0 };
+#if DAE_MATRIX_SIMD
+		i = TransformAoS3To4(data, points.data(), pointsOut.data(), points.size(), perspectiveDivide);
+#endif
+		for(; i < points.size(); ++i)
+		{
+			const Vector3& p = points[i];
+			Vector4 result{
+				data[0].x * p.x + data[1].x * p.y + data[2].x * p.z + data[3].x,
+				data[0].y * p.x + data[1].y * p.y + data[2].y * p.z + data[3].y,
+				data[0].z * p.x + data[1].z * p.y + data[2].z * p.z + data[3].z,
+				data[0].w * p.x + data[1].w * p.y + data[2].w * p.z + data[3].w
+			};
+			if(perspectiveDivide)
+			{
+				result.x /= result.w;
+				result.y /= result.w;
+				result.z /= result.w;
+			}
+			pointsOut[i] = result;
+		}
 	}
 
-#pragma region Operator Overloads
-	Vector4& Matrix::operator[](int index)
+	void Matrix::TransformVectors(std::span<const Vector3> vectors, std::span<Vector3> vectorsOut) const
 	{
-		assert(index <= 3 && index >= 0);
-		return data[index];
-	}
+		assert(vectorsOut.size() >= vectors.size());
 
-	Vector4 Matrix::operator[](int index) const
-	{
-		assert(index <= 3 && index >= 0);
-		return data[index];
+		size_t i{ 0 };
+#if DAE_MATRIX_SIMD
+		i = TransformAoS3<false>(data, vectors.data(), vectorsOut.data(), vectors.size());
+#endif
+		for(; i < vectors.size(); ++i)
+		{
+			vectorsOut[i] = TransformVector(vectors[i]);
+		}
 	}
 
-	Matrix Matrix::operator*(const Matrix& m) const
+	void Matrix::TransformPoints(std::span<const float> xs, std::span<const float> ys, std::span<const float> zs,
+		std::span<float> outXs, std::span<float> outYs, std::span<float> outZs, std::span<float> outWs, bool perspectiveDivide) const
 	{
-		Matrix result{};
-		Matrix m_transposed = Transpose(m);
+		const size_t count{ xs.size() };
+		assert(ys.size() == count && zs.size() == count);
+		assert(outXs.size() >= count && outYs.size() >= count && outZs.size() >= count && outWs.size() >= count);
 
-		for(int r{ 0 }; r < 4; ++r)
+		size_t i{ 0 };
+#if DAE_MATRIX_SIMD
+#if defined(__AVX__)
+		i = TransformSoA<Lanes8, true>(data, i, count, xs.data(), ys.data(), zs.data(), outXs.data(), outYs.data(), outZs.data(), outWs.data(), perspectiveDivide);
+#endif
+		i = TransformSoA<Lanes4, true>(data, i, count, xs.data(), ys.data(), zs.data(), outXs.data(), outYs.data(), outZs.data(), outWs.data(), perspectiveDivide);
+#endif
+		for(; i < count; ++i)
 		{
-			for(int c{ 0 }; c < 4; ++c)
+			const float x{ xs[i] }, y{ ys[i] }, z{ zs[i] };
+			float outX{ data[0].x * x + data[1].x * y + data[2].x * z + data[3].x };
+			float outY{ data[0].y * x + data[1].y * y + data[2].y * z + data[3].y };
+			float outZ{ data[0].z * x + data[1].z * y + data[2].z * z + data[3].z };
+			const float outW{ data[0].w * x + data[1].w * y + data[2].w * z + data[3].w };
+
+			if(perspectiveDivide)
 			{
-				result[r][c] = Vector4::Dot(data[r], m_transposed[c]);
+				outX /= outW;
+				outY /= outW;
+				outZ /= outW;
 			}
-		}
 
-		return result;
+			outXs[i] = outX;
+			outYs[i] = outY;
+			outZs[i] = outZ;
+			outWs[i] = outW;
+		}
 	}
 
-	const Matrix& Matrix::operator*=(const Matrix& m)
+	void Matrix::TransformVectors(std::span<const float> xs, std::span<const float> ys, std::span<const float> zs,
+		std::span<float> outXs, std::span<float> outYs, std::span<float> outZs) const
 	{
-		Matrix copy{ *this };
-		Matrix m_transposed = Transpose(m);
+		const size_t count{ xs.size() };
+		assert(ys.size() == count && zs.size() == count);
+		assert(outXs.size() >= count && outYs.size() >= count && outZs.size() >= count);
 
-		for(int r{ 0 }; r < 4; ++r)
+		size_t i{ 0 };
+#if DAE_MATRIX_SIMD
+#if defined(__AVX__)
+		i = TransformSoA<Lanes8, false>(data, i, count, xs.data(), ys.data(), zs.data(), outXs.data(), outYs.data(), outZs.data(), nullptr, false);
+#endif
+		i = TransformSoA<Lanes4, false>(data, i, count, xs.data(), ys.data(), zs.data(), outXs.data(), outYs.data(), outZs.data(), nullptr, false);
+#endif
+		for(; i < count; ++i)
 		{
-			for(int c{ 0 }; c < 4; ++c)
-			{
-				data[r][c] = Vector4::Dot(copy[r], m_transposed[c]);
-			}
+			const Vector3 v{ TransformVector(xs[i], ys[i], zs[i]) };
+			outXs[i] = v.x;
+			outYs[i] = v.y;
+			outZs[i] = v.z;
 		}
-
-		return *this;
 	}
 #pragma endregion
-}
\ No newline at end of file
+}
@@ -1,65 +1,93 @@
 #pragma once
+#include <span>
+#include <type_traits>
+#include <cassert>
 #include "Vector3.h"
 #include "Vector4.h"
+#include "MathHelpers.h"
+
+// SIMD backend for multiply, inverse, transpose and TransformPoint.
+// x64 always has SSE2, define DAE_MATRIX_NO_SIMD to force the scalar fallback.
+// Everything is constexpr, constant evaluation always takes the scalar path.
+#if !defined(DAE_MATRIX_NO_SIMD) && (defined(_M_X64) || defined(__SSE2__))
+#define DAE_MATRIX_SIMD 1
+#else
+#define DAE_MATRIX_SIMD 0
+#endif
 
 namespace dae {
 	struct Matrix
 	{
-		Matrix() = default;
-		Matrix(
+		constexpr Matrix() = default;
+		constexpr Matrix(
 			const Vector3& xAxis,
 			const Vector3& yAxis,
 			const Vector3& zAxis,
 			const Vector3& t);
 
-		Matrix(
+		constexpr Matrix(
 			const Vector4& xAxis,
 			const Vector4& yAxis,
 			const Vector4& zAxis,
 			const Vector4& t);
 
-		Matrix(const Matrix& m);
+		constexpr Matrix(const Matrix& m) = default;
+		constexpr Matrix& operator=(const Matrix& m) = default;
+
+		constexpr Vector3 TransformVector(const Vector3& v) const;
+		constexpr Vector3 TransformVector(float x, float y, float z) const;
+		constexpr Vector3 TransformPoint(const Vector3& p) const;
+		constexpr Vector3 TransformPoint(float x, float y, float z) const;
+
+		constexpr Vector4 TransformPoint(const Vector4& p) const;
+		constexpr Vector4 TransformPoint(float x, float y, float z, float w) const;
 
-		Vector3 TransformVector(const Vector3& v) const;
-		Vector3 TransformVector(float x, float y, float z) const;
-		Vector3 TransformPoint(const Vector3& p) const;
-		Vector3 TransformPoint(float x, float y, float z) const;
+		// Batch transforms, every output span must be at least as big as the input
+		void TransformPoints(std::span<const Vector3> points, std::span<Vector3> pointsOut) const;
+		void TransformPoints(std::span<const Vector3> points, std::span<Vector4> pointsOut, bool perspectiveDivide = false) const;
+		void TransformVectors(std::span<const Vector3> vectors, std::span<Vector3> vectorsOut) const;
 
-		Vector4 TransformPoint(const Vector4& p) const;
-		Vector4 TransformPoint(float x, float y, float z, float w) const;
+		// SoA batch transforms, outW receives the homogeneous w (before the optional divide)
+		void TransformPoints(std::span<const float> xs, std::span<const float> ys, std::span<const float> zs,
+			std::span<float> outXs, std::span<float> outYs, std::span<float> outZs, std::span<float> outWs, bool perspectiveDivide = false) const;
+		void TransformVectors(std::span<const float> xs, std::span<const float> ys, std::span<const float> zs,
+			std::span<float> outXs, std::span<float> outYs, std::span<float> outZs) const;
 
-		const Matrix& Transpose();
-		const Matrix& Inverse();
+		constexpr const Matrix& Transpose();
+		constexpr const Matrix& Inverse();
 
-		Vector3 GetAxisX() const;
-		Vector3 GetAxisY() const;
-		Vector3 GetAxisZ() const;
-		Vector3 GetTranslation() const;
+		constexpr Vector3 GetAxisX() const;
+		constexpr Vector3 GetAxisY() const;
+		constexpr Vector3 GetAxisZ() const;
+		constexpr Vector3 GetTranslation() const;
 
-		static Matrix CreateTranslation(float x, float y, float z);
-		static Matrix CreateTranslation(const Vector3& t);
-		static Matrix CreateRotationX(float pitch);
-		static Matrix CreateRotationY(float yaw);
-		static Matrix CreateRotationZ(float roll);
-		static Matrix CreateRotation(float pitch, float yaw, float roll);
-		static Matrix CreateRotation(const Vector3& r);
-		static Matrix CreateScale(float sx, float sy, float sz);
-		static Matrix CreateScale(const Vector3& s);
-		static Matrix Transpose(const Matrix& m);
-		static Matrix Inverse(const Matrix& m);
+		static constexpr Matrix CreateTranslation(float x, float y, float z);
+		static constexpr Matrix CreateTranslation(const Vector3& t);
+		static constexpr Matrix CreateRotationX(float pitch);
+		static constexpr Matrix CreateRotationY(float yaw);
+		static constexpr Matrix CreateRotationZ(float roll);
+		// Same result as CreateRotationX(pitch) * CreateRotationY(yaw) * CreateRotationZ(roll), built directly
+		static constexpr Matrix CreateRotation(float pitch, float yaw, float roll, TrigMode mode = TrigMode::Precise);
+		static constexpr Matrix CreateRotation(const Vector3& r, TrigMode mode = TrigMode::Precise);
+		// Builds one rotation per {pitch, yaw, roll}, 4 at a time with SIMD in Fast mode
+		static void CreateRotations(std::span<const Vector3> eulerAngles, std::span<Matrix> rotationsOut, TrigMode mode = TrigMode::Fast);
+		static constexpr Matrix CreateScale(float sx, float sy, float sz);
+		static constexpr Matrix CreateScale(const Vector3& s);
+		static constexpr Matrix Transpose(const Matrix& m);
+		static constexpr Matrix Inverse(const Matrix& m);
 
 		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up);
-		static Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
+		static constexpr Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
 
-		Vector4& operator[](int index);
-		Vector4 operator[](int index) const;
-		Matrix operator*(const Matrix& m) const;
-		const Matrix& operator*=(const Matrix& m);
+		constexpr Vector4& operator[](int index);
+		constexpr const Vector4& operator[](int index) const;
+		constexpr Matrix operator*(const Matrix& m) const;
+		constexpr const Matrix& operator*=(const Matrix& m);
 
 	private:
 
-		//Row-Major Matrix
-		Vector4 data[4]
+		//Row-Major Matrix, 16 byte aligned so every row can be loaded as one SIMD register
+		alignas(16) Vector4 data[4]
 		{
 			{1,0,0,0}, //xAxis
 			{0,1,0,0}, //yAxis
@@ -71,5 +99,310 @@ namespace dae {
 		// v1x v1y v1z v1w
 		// v2x v2y v2z v2w
 		// v3x v3y v3z v3w
+
+#if DAE_MATRIX_SIMD
+		// Runtime SIMD paths (Matrix.cpp)
+		Vector3 TransformPointSIMD(float x, float y, float z) const;
+		Vector4 TransformPoint4SIMD(float x, float y, float z) const;
+		void TransposeSIMD();
+		void InverseSIMD();
+		static Matrix MultiplySIMD(const Matrix& m1, const Matrix& m2);
+#endif
 	};
-}
\ No newline at end of file
+
+	constexpr Matrix::Matrix(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& t):
+		Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+	{
+	}
+
+	constexpr Matrix::Matrix(const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis, const Vector4& t):
+		data{ xAxis, yAxis, zAxis, t }
+	{
+	}
+
+	constexpr Vector3 Matrix::TransformVector(const Vector3& v) const
+	{
+		return TransformVector(v.x, v.y, v.z);
+	}
+
+	constexpr Vector3 Matrix::TransformVector(float x, float y, float z) const
+	{
+		return Vector3{
+			data[0].x * x + data[1].x * y + data[2].x * z,
+			data[0].y * x + data[1].y * y + data[2].y * z,
+			data[0].z * x + data[1].z * y + data[2].z * z
+		};
+	}
+
+	constexpr Vector3 Matrix::TransformPoint(const Vector3& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z);
+	}
+
+	constexpr Vector3 Matrix::TransformPoint(float x, float y, float z) const
+	{
+#if DAE_MATRIX_SIMD
+		if(!std::is_constant_evaluated())
+			return TransformPointSIMD(x, y, z);
+#endif
+		return Vector3{
+			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+		};
+	}
+
+	constexpr Vector4 Matrix::TransformPoint(const Vector4& p) const
+	{
+		return TransformPoint(p.x, p.y, p.z, p.w);
+	}
+
+	constexpr Vector4 Matrix::TransformPoint(float x, float y, float z, float w) const
+	{
+		// Note: w is treated as 1, the translation row is always added
+		(void)w;
+#if DAE_MATRIX_SIMD
+		if(!std::is_constant_evaluated())
+			return TransformPoint4SIMD(x, y, z);
+#endif
+		return Vector4{
+			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+			data[0].w * x + data[1].w * y + data[2].w * z + data[3].w
+		};
+	}
+
+	constexpr const Matrix& Matrix::Transpose()
+	{
+#if DAE_MATRIX_SIMD
+		if(!std::is_constant_evaluated())
+		{
+			TransposeSIMD();
+			return *this;
+		}
+#endif
+		Matrix result{};
+		for(int r{ 0 }; r < 4; ++r)
+		{
+			for(int c{ 0 }; c < 4; ++c)
+			{
+				result[r][c] = data[c][r];
+			}
+		}
+
+		data[0] = result[0];
+		data[1] = result[1];
+		data[2] = result[2];
+		data[3] = result[3];
+
+		return *this;
+	}
+
+	constexpr const Matrix& Matrix::Inverse()
+	{
+#if DAE_MATRIX_SIMD
+		if(!std::is_constant_evaluated())
+		{
+			InverseSIMD();
+			return *this;
+		}
+#endif
+		//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
+		const Vector3 a = data[0];
+		const Vector3 b = data[1];
+		const Vector3 c = data[2];
+		const Vector3 d = data[3];
+
+		const float x = data[0][3];
+		const float y = data[1][3];
+		const float z = data[2][3];
+		const float w = data[3][3];
+
+		Vector3 s = Vector3::Cross(a, b);
+		Vector3 t = Vector3::Cross(c, d);
+		Vector3 u = a * y - b * x;
+		Vector3 v = c * w - d * z;
+
+		const float det = Vector3::Dot(s, v) + Vector3::Dot(t, u);
+		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+		const float invDet = 1.f / det;
+
+		s *= invDet; t *= invDet; u *= invDet; v *= invDet;
+
+		const Vector3 r0 = Vector3::Cross(b, v) + t * y;
+		const Vector3 r1 = Vector3::Cross(v, a) - t * x;
+		const Vector3 r2 = Vector3::Cross(d, u) + s * w;
+		const Vector3 r3 = Vector3::Cross(u, c) - s * z;
+
+		data[0] = Vector4{ r0.x, r1.x, r2.x, r3.x };
+		data[1] = Vector4{ r0.y, r1.y, r2.y, r3.y };
+		data[2] = Vector4{ r0.z, r1.z, r2.z, r3.z };
+		data[3] = Vector4{ -Vector3::Dot(b, t), Vector3::Dot(a, t), -Vector3::Dot(d, s), Vector3::Dot(c, s) };
+
+		return *this;
+	}
+
+	constexpr Matrix Matrix::Transpose(const Matrix& m)
+	{
+		Matrix out{ m };
+		out.Transpose();
+
+		return out;
+	}
+
+	constexpr Matrix Matrix::Inverse(const Matrix& m)
+	{
+		Matrix out{ m };
+		out.Inverse();
+
+		return out;
+	}
+
+	constexpr Matrix Matrix::CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf)
+	{
+		return {
+			{ 1.0f / (aspect * fov),	0.0f,		0.0f,					0.0f },
+			{ 0.0f,						1.0f / fov,	0.0f,					0.0f },
+			{ 0.0f,						0.0f,		zf / (zf - zn),			1.0f },
+			{ 0.0f,						0.0f,		-(zf * zn) / (zf - zn),	0.0f }
+		};
+	}
+
+	constexpr Vector3 Matrix::GetAxisX() const
+	{
+		return data[0];
+	}
+
+	constexpr Vector3 Matrix::GetAxisY() const
+	{
+		return data[1];
+	}
+
+	constexpr Vector3 Matrix::GetAxisZ() const
+	{
+		return data[2];
+	}
+
+	constexpr Vector3 Matrix::GetTranslation() const
+	{
+		return data[3];
+	}
+
+	constexpr Matrix Matrix::CreateTranslation(float x, float y, float z)
+	{
+		return CreateTranslation({ x, y, z });
+	}
+
+	constexpr Matrix Matrix::CreateTranslation(const Vector3& t)
+	{
+		return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+	}
+
+	constexpr Matrix Matrix::CreateRotationX(float pitch)
+	{
+		float s{}, c{};
+		SinCos(pitch, s, c);
+		return {
+			{1, 0, 0, 0},
+			{0, c, -s, 0},
+			{0, s, c, 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	constexpr Matrix Matrix::CreateRotationY(float yaw)
+	{
+		float s{}, c{};
+		SinCos(yaw, s, c);
+		return {
+			{c, 0, -s, 0},
+			{0, 1, 0, 0},
+			{s, 0, c, 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	constexpr Matrix Matrix::CreateRotationZ(float roll)
+	{
+		float s{}, c{};
+		SinCos(roll, s, c);
+		return {
+			{c, s, 0, 0},
+			{-s, c, 0, 0},
+			{0, 0, 1, 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	constexpr Matrix Matrix::CreateRotation(float pitch, float yaw, float roll, TrigMode mode)
+	{
+		float sp{}, cp{}, sy{}, cy{}, sr{}, cr{};
+		SinCos(pitch, sp, cp, mode);
+		SinCos(yaw, sy, cy, mode);
+		SinCos(roll, sr, cr, mode);
+
+		// Rx * Ry * Rz multiplied out
+		return {
+			{ cy * cr,						cy * sr,						-sy,		0 },
+			{ -sp * sy * cr - cp * sr,		-sp * sy * sr + cp * cr,		-sp * cy,	0 },
+			{ cp * sy * cr - sp * sr,		cp * sy * sr + sp * cr,			cp * cy,	0 },
+			{ 0,							0,								0,			1 }
+		};
+	}
+
+	constexpr Matrix Matrix::CreateRotation(const Vector3& r, TrigMode mode)
+	{
+		return CreateRotation(r.x, r.y, r.z, mode);
+	}
+
+	constexpr Matrix Matrix::CreateScale(float sx, float sy, float sz)
+	{
+		return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
+	}
+
+	constexpr Matrix Matrix::CreateScale(const Vector3& s)
+	{
+		return CreateScale(s[0], s[1], s[2]);
+	}
+
+#pragma region Operator Overloads
+	constexpr Vector4& Matrix::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	constexpr const Vector4& Matrix::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	constexpr Matrix Matrix::operator*(const Matrix& m) const
+	{
+#if DAE_MATRIX_SIMD
+		if(!std::is_constant_evaluated())
+			return MultiplySIMD(*this, m);
+#endif
+		Matrix result{};
+		Matrix m_transposed = Transpose(m);
+
+		for(int r{ 0 }; r < 4; ++r)
+		{
+			for(int c{ 0 }; c < 4; ++c)
+			{
+				result[r][c] = Vector4::Dot(data[r], m_transposed[c]);
+			}
+		}
+
+		return result;
+	}
+
+	constexpr const Matrix& Matrix::operator*=(const Matrix& m)
+	{
+		*this = *this * m;
+		return *this;
+	}
+#pragma endregion
+}
@@ -2,46 +2,94 @@
 #include "Mesh.h"
 #include "EffectVehicle.h"
 #include <cassert>
+#include <cmath>
 
-Mesh::Mesh(ID3D11Device* pDevice, Effect* pEffect, const std::vector<Vertex>& vertices, const std::vector<uint32_t> indices)
+namespace
 {
-	// Create an instance of the effect class
-	m_pEffect = pEffect;
-	//m_pEffect = new Effect(pDevice, L"Resources/PosCol3D.fx");
-	m_pTechnique = m_pEffect->GetTechnique();
+	// Vertex
+	constexpr D3D11_INPUT_ELEMENT_DESC VERTEX_LAYOUT[]
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TANGENT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },	// W IS THE BITANGENT SIGN
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	};
+
+	// PackedVertex, decoded by VS_Packed
+	constexpr D3D11_INPUT_ELEMENT_DESC PACKED_VERTEX_LAYOUT[]
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },	// W IS THE BITANGENT SIGN
+		{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },			// OCTAHEDRAL
+		{ "TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },			// OCTAHEDRAL
+		{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	};
+
+	// InstanceData in slot 1, read by VS_INSTANCE
+	constexpr D3D11_INPUT_ELEMENT_DESC INSTANCE_LAYOUT[]
+	{
+		{ "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCEPARAMETERS", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+	};
 
+	std::span<const D3D11_INPUT_ELEMENT_DESC> GetInputLayout(VertexFormat format)
+	{
+		if(format == VertexFormat::Packed)
+			return PACKED_VERTEX_LAYOUT;
+		return VERTEX_LAYOUT;
+	}
+}
+
+Mesh::Mesh(ID3D11Device* pDevice, Effect* pEffect, const MeshCache& meshCache, VertexFormat format)
+{
+	Initialize(pDevice, pEffect, format, { meshCache.GetVertices(), meshCache.GetPackedVertices(), meshCache.GetPositionQuantization(),
+		meshCache.GetIndices(), meshCache.GetIndices16(), meshCache.GetSubmeshes16(), meshCache.GetSubmeshes() });
+}
+
+Mesh::Mesh(ID3D11Device* pDevice, Effect* pEffect, std::span<const Vertex> vertices, std::span<const uint32_t> indices, VertexFormat format,
+	std::span<const SubmeshRange> lods)
+{
+	// Only has to live until CreateBuffer copied it
+	std::vector<uint16_t> indices16{};
+	if(Utils::FitsIn16BitIndices(vertices.size()))
+	{
+		indices16.resize(indices.size());
+		Utils::ConvertTo16BitIndices(indices, indices16);
+	}
+	Initialize(pDevice, pEffect, format, { vertices, {}, {}, indices, indices16, {}, lods });
+}
 
-	// Create vertex layout
-	static constexpr uint32_t numElements{ 4 };
-	D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
+void Mesh::Initialize(ID3D11Device* pDevice, Effect* pEffect, VertexFormat format, BufferData data)
+{
+	const std::span<const Vertex> vertices{ data.vertices };
+	const std::span<const uint32_t> indices{ data.indices };
+	std::span<const SubmeshRange> lods{ data.lods };
 
-	vertexDesc[0].SemanticName = "POSITION";						// VERT POSITION
-	vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;				// VECTOR 3
-	vertexDesc[0].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT; // AUTO ALIGN WITH LAST BYTE
-	vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	// Create an instance of the effect class
+	m_pEffect = pEffect;
+	//m_pEffect = new Effect(pDevice, L"Resources/PosCol3D.fx");
 
-	vertexDesc[1].SemanticName = "NORMAL";							// NORMAL
-	vertexDesc[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;				// VECTOR 3
-	vertexDesc[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT; // AUTO ALIGN WITH LAST BYTE
-	vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	// The packed format needs the effect to decode it
+	m_VertexFormat = format == VertexFormat::Packed && m_pEffect->GetPackedTechnique() ? VertexFormat::Packed : VertexFormat::Full;
+	m_pTechnique = m_VertexFormat == VertexFormat::Packed ? m_pEffect->GetPackedTechnique() : m_pEffect->GetTechnique();
 
-	vertexDesc[2].SemanticName = "TANGENT";							// TANGENT
-	vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;				// VECTOR 3
-	vertexDesc[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT; // AUTO ALIGN WITH LAST BYTE
-	vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 
-	vertexDesc[3].SemanticName = "TEXCOORD";						// UV
-	vertexDesc[3].Format = DXGI_FORMAT_R32G32_FLOAT;				// VECTOR 2
-	vertexDesc[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT; // AUTO ALIGN WITH LAST BYTE
-	vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	D3DX11_TECHNIQUE_DESC techDesc{};
+	m_pTechnique->GetDesc(&techDesc);
+	for(UINT p{ 0 }; p < techDesc.Passes; ++p)
+	{
+		m_Passes.push_back(m_pTechnique->GetPassByIndex(p));
+	}
 
 	// Create input layout
 	D3DX11_PASS_DESC passDesc{};
-	m_pTechnique->GetPassByIndex(0)->GetDesc(&passDesc);
+	m_Passes[0]->GetDesc(&passDesc);
 
+	const std::span<const D3D11_INPUT_ELEMENT_DESC> vertexDesc{ GetInputLayout(m_VertexFormat) };
 	HRESULT result = pDevice->CreateInputLayout(
-		vertexDesc,
-		numElements,
+		vertexDesc.data(),
+		static_cast<UINT>(vertexDesc.size()),
 		passDesc.pIAInputSignature,
 		passDesc.IAInputSignatureSize,
 		&m_pInputLayout
@@ -50,19 +98,107 @@ Mesh::Mesh(ID3D11Device* pDevice, Effect* pEffect, const std::vector<Vertex>& ve
 	if(FAILED(result))
 		assert(false);
 
+	// Instanced variant of the technique, the vertex layout plus the instance stream
+	ID3DX11EffectTechnique* pInstancedTechnique{ m_VertexFormat == VertexFormat::Packed ? m_pEffect->GetPackedInstancedTechnique() : m_pEffect->GetInstancedTechnique() };
+	m_pInstancedInputLayout = nullptr;
+	if(pInstancedTechnique)
+	{
+		pInstancedTechnique->GetDesc(&techDesc);
+		for(UINT p{ 0 }; p < techDesc.Passes; ++p)
+		{
+			m_InstancedPasses.push_back(pInstancedTechnique->GetPassByIndex(p));
+		}
+
+		std::vector<D3D11_INPUT_ELEMENT_DESC> instancedDesc{ vertexDesc.begin(), vertexDesc.end() };
+		instancedDesc.insert(instancedDesc.end(), std::begin(INSTANCE_LAYOUT), std::end(INSTANCE_LAYOUT));
+		m_InstancedPasses[0]->GetDesc(&passDesc);
+		result = pDevice->CreateInputLayout(instancedDesc.data(), static_cast<UINT>(instancedDesc.size()), passDesc.pIAInputSignature, passDesc.IAInputSignatureSize,
+			&m_pInstancedInputLayout);
+		if(FAILED(result))
+			assert(false);
+	}
 
 
+	// Every level of detail draws its own range of the one index buffer
+	const SubmeshRange wholeMesh{ 0, static_cast<uint32_t>(indices.size()) };
+	if(lods.empty())
+		lods = { &wholeMesh, 1 };
+
+	m_Lod = 0;
+	for(const SubmeshRange& lod : lods)
+	{
+		m_LodChain.errors.push_back(lod.lodError);
+		m_LodChain.triangleCounts.push_back(lod.indexCount / 3);
+	}
+
+	// Object space box, and the sphere around its center that holds every vertex
+	m_BoundsMin = m_BoundsMax = vertices.empty() ? Vector3::Zero : vertices.front().position;
+	for(const Vertex& vertex : vertices)
+	{
+		m_BoundsMin = Vector3::Min(m_BoundsMin, vertex.position);
+		m_BoundsMax = Vector3::Max(m_BoundsMax, vertex.position);
+	}
+	const Vector3 boundsCenter{ (m_BoundsMin + m_BoundsMax) * 0.5f };
+	float radiusSquared{ 0.f };
+	for(const Vertex& vertex : vertices)
+		radiusSquared = std::max(radiusSquared, (vertex.position - boundsCenter).SqrMagnitude());
+	m_BoundsRadius = std::sqrt(radiusSquared);
+	m_LodChain.boundsCenter = boundsCenter;
+	m_LodChain.boundsRadius = m_BoundsRadius;
+
+	const auto addLod = [this](std::span<const Submesh16> submeshes)
+	{
+		m_Lods.push_back(Lod{ static_cast<uint32_t>(m_Submeshes.size()), static_cast<uint32_t>(submeshes.size()) });
+		m_Submeshes.insert(m_Submeshes.end(), submeshes.begin(), submeshes.end());
+	};
+
+	// One draw per level, or the split submeshes, which are stored level after level inside their level's index range
+	const std::span<const Submesh16> submeshes16{ data.submeshes16 };
+	size_t nextSubmesh{ 0 };
+	for(const SubmeshRange& lod : lods)
+	{
+		if(submeshes16.empty())
+		{
+			addLod({ { Submesh16{ lod.firstIndex, lod.indexCount, 0, static_cast<uint32_t>(vertices.size()) } } });
+			continue;
+		}
+
+		const size_t firstSubmesh{ nextSubmesh };
+		while(nextSubmesh < submeshes16.size() && submeshes16[nextSubmesh].firstIndex >= lod.firstIndex
+			&& submeshes16[nextSubmesh].firstIndex + submeshes16[nextSubmesh].indexCount <= lod.firstIndex + lod.indexCount)
+			++nextSubmesh;
+		addLod(submeshes16.subspan(firstSubmesh, nextSubmesh - firstSubmesh));
+	}
+
+	assert(data.indices16.empty() || data.indices16.size() == indices.size());
+	const std::span<const uint16_t> indices16{ data.indices16 };
+	m_IndexFormat = indices16.empty() && !indices.empty() ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+
+	// Packed vertices the cache did not have are encoded here
+	std::vector<PackedVertex> packedVertices{};
+	if(m_VertexFormat == VertexFormat::Packed)
+	{
+		m_PositionQuantization = data.positionQuantization;
+		if(data.packedVertices.size() != vertices.size())
+		{
+			m_PositionQuantization = Utils::GetPositionQuantization(vertices);
+			packedVertices.resize(vertices.size());
+			Utils::PackVertices(vertices, m_PositionQuantization, packedVertices);
+			data.packedVertices = packedVertices;
+		}
+	}
+	m_VertexStride = m_VertexFormat == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
 
 	// Create vertex buffer
 	D3D11_BUFFER_DESC bufferDesc{};
 	bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-	bufferDesc.ByteWidth = sizeof(Vertex) * static_cast<uint32_t>(vertices.size());  // Warning, sizeof not matching pwp, pos3 or pos4?
+	bufferDesc.ByteWidth = m_VertexStride * static_cast<uint32_t>(vertices.size());
 	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	bufferDesc.CPUAccessFlags = 0;
 	bufferDesc.MiscFlags = 0;
 
 	D3D11_SUBRESOURCE_DATA initData{};
-	initData.pSysMem = vertices.data();
+	initData.pSysMem = m_VertexFormat == VertexFormat::Packed ? static_cast<const void*>(data.packedVertices.data()) : static_cast<const void*>(vertices.data());
 
 	result = pDevice->CreateBuffer(&bufferDesc, &initData, &m_pVertexBuffer);
 	if(FAILED(result))
@@ -70,13 +206,13 @@ Mesh::Mesh(ID3D11Device* pDevice, Effect* pEffect, const std::vector<Vertex>& ve
 
 
 	// Create index buffer
-	m_NumIndices = static_cast<uint32_t>(indices.size());
+	m_NumIndices = static_cast<uint32_t>(m_IndexFormat == DXGI_FORMAT_R16_UINT ? indices16.size() : indices.size());
 	bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-	bufferDesc.ByteWidth = sizeof(uint32_t) * m_NumIndices;
+	bufferDesc.ByteWidth = (m_IndexFormat == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(uint32_t)) * m_NumIndices;
 	bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	bufferDesc.CPUAccessFlags = 0;
 	bufferDesc.MiscFlags = 0;
-	initData.pSysMem = indices.data();
+	initData.pSysMem = m_IndexFormat == DXGI_FORMAT_R16_UINT ? static_cast<const void*>(indices16.data()) : static_cast<const void*>(indices.data());
 
 	result = pDevice->CreateBuffer(&bufferDesc, &initData, &m_pIndexBuffer);
 	if(FAILED(result))
@@ -89,23 +225,22 @@ Mesh::~Mesh()
 	m_pVertexBuffer->Release();
 	m_pIndexBuffer->Release();
 	m_pInputLayout->Release();
+	SafeRelease(m_pInstancedInputLayout);
 }
 
-void Mesh::Render(ID3D11DeviceContext* pDeviceContext, Matrix worldViewProjMatrix, Matrix viewInverseMatrix)
+void Mesh::Render(StateTrackingContext& context, Matrix worldViewProjMatrix, Matrix viewInverseMatrix)
 {
 	// 1. Set Primitive Topolgy
-	pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	context.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	// 2. Set Input Layout
-	pDeviceContext->IASetInputLayout(m_pInputLayout);
+	context.SetInputLayout(m_pInputLayout);
 
 	// 3. Set Vertex buffer
-	constexpr UINT stride = sizeof(Vertex);
-	constexpr UINT offset = 0;
-	pDeviceContext->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &stride, &offset);
+	context.SetVertexBuffer(0, m_pVertexBuffer, m_VertexStride, 0);
 
 	// 4. Set IndexBuffer
-	pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	context.SetIndexBuffer(m_pIndexBuffer, m_IndexFormat, 0);
 
 	// 5. Draw
 	// We reinterpret the pointer, not the object itself?
@@ -113,12 +248,49 @@ void Mesh::Render(ID3D11DeviceContext* pDeviceContext, Matrix worldViewProjMatri
 	Matrix worldMatrix(GetWorldMatrix());
 	m_pEffect->GetWorldMatrixVariable()->SetMatrix(reinterpret_cast<float*>(&worldMatrix));
 	m_pEffect->GetViewInverseMatrixVariable()->SetMatrix(reinterpret_cast<float*>(&viewInverseMatrix));
+	if(m_VertexFormat == VertexFormat::Packed)
+	{
+		m_pEffect->GetPositionScaleVariable()->SetRawValue(&m_PositionQuantization.scale, 0, sizeof(Vector3));
+		m_pEffect->GetPositionOffsetVariable()->SetRawValue(&m_PositionQuantization.offset, 0, sizeof(Vector3));
+	}
 
-	D3DX11_TECHNIQUE_DESC techDesc{};
-	m_pTechnique->GetDesc(&techDesc);
-	for(UINT p{ 0 }; p < techDesc.Passes; ++p)
+	// The matrices above have to be uploaded, even when the pass is still applied from the previous draw
+	context.InvalidatePass();
+	for(ID3DX11EffectPass* pPass : m_Passes)
+	{
+		context.ApplyPass(pPass);
+		const Lod& lod{ m_Lods[m_Lod] };
+		for(const Submesh16& submesh : std::span{ m_Submeshes }.subspan(lod.firstSubmesh, lod.submeshCount))
+			context.DrawIndexed(submesh.indexCount, submesh.firstIndex, static_cast<int32_t>(submesh.baseVertex));
+	}
+}
+
+void Mesh::RenderInstanced(StateTrackingContext& context, ID3D11Buffer* pInstanceBuffer, uint32_t lod, uint32_t firstInstance, uint32_t instanceCount,
+	Matrix viewProjMatrix, Matrix viewInverseMatrix)
+{
+	assert(CanRenderInstanced());
+
+	context.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	context.SetInputLayout(m_pInstancedInputLayout);
+	context.SetVertexBuffer(0, m_pVertexBuffer, m_VertexStride, 0);
+	context.SetVertexBuffer(1, pInstanceBuffer, sizeof(InstanceData), 0);
+	context.SetIndexBuffer(m_pIndexBuffer, m_IndexFormat, 0);
+
+	// The world matrices come from the instance stream
+	m_pEffect->GetViewProjVariable()->SetMatrix(reinterpret_cast<float*>(&viewProjMatrix));
+	m_pEffect->GetViewInverseMatrixVariable()->SetMatrix(reinterpret_cast<float*>(&viewInverseMatrix));
+	if(m_VertexFormat == VertexFormat::Packed)
+	{
+		m_pEffect->GetPositionScaleVariable()->SetRawValue(&m_PositionQuantization.scale, 0, sizeof(Vector3));
+		m_pEffect->GetPositionOffsetVariable()->SetRawValue(&m_PositionQuantization.offset, 0, sizeof(Vector3));
+	}
+
+	context.InvalidatePass();
+	const Lod& drawnLod{ m_Lods[std::min(lod, GetLodCount() - 1)] };
+	for(ID3DX11EffectPass* pPass : m_InstancedPasses)
 	{
-		m_pTechnique->GetPassByIndex(p)->Apply(0, pDeviceContext);
-		pDeviceContext->DrawIndexed(m_NumIndices, 0, 0);
+		context.ApplyPass(pPass);
+		for(const Submesh16& submesh : std::span{ m_Submeshes }.subspan(drawnLod.firstSubmesh, drawnLod.submeshCount))
+			context.DrawIndexedInstanced(submesh.indexCount, instanceCount, submesh.firstIndex, static_cast<int32_t>(submesh.baseVertex), firstInstance);
 	}
 }
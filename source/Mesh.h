@@ -1,34 +1,34 @@
 #pragma once
 #include "MathHelpers.h"
+#include <span>
 #include <vector>
 #include "EffectVehicle.h"
+#include "IndexFormat.h"
+#include "InstanceBatching.h"
+#include "LodSelection.h"
+#include "MeshCache.h"
+#include "Meshlet.h"
+#include "PackedVertex.h"
+#include "StateTrackingContext.h"
+#include "Vertex.h"
 
 using namespace dae;
 
 class Texture;
 
-struct Vertex
-{
-	Vector3 position{};
-	Vector3 normal{};
-	Vector3 tangent{};
-	Vector2 uv{};
-};
-
-struct Vertex_Out
-{
-	Vector4 position{};
-	Vector4 worldPosition{};
-	Vector3 normal{};
-	Vector3 tangent{};
-	Vector2 uv{};
-};
-
 
 class Mesh final
 {
 public:
-	Mesh(ID3D11Device* pDevice, Effect* pEffect, const std::vector<Vertex>& vertices, const std::vector<uint32_t> indices);
+	// The vertex and index buffers are filled straight from the mapping, in the vertex format asked for and the index format
+	// the import chose. The cache has to stay open until the constructor returns. Effects without a PackedTechnique get the full format.
+	Mesh(ID3D11Device* pDevice, Effect* pEffect, const MeshCache& meshCache, VertexFormat format = VertexFormat::Full);
+
+	// Without a cache, the fallback: packed vertices are encoded here, and the indices are converted to 16 bit when every
+	// vertex fits. Bigger meshes stay 32 bit, MeshCache::Load is the one that can split them.
+	// lods are index ranges of the levels of detail, finest first (MeshCache::GetSubmeshes), empty draws every index.
+	Mesh(ID3D11Device* pDevice, Effect* pEffect, std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+		VertexFormat format = VertexFormat::Full, std::span<const SubmeshRange> lods = {});
 
 	~Mesh();
 	Mesh(const Mesh&) = delete;
@@ -36,27 +36,95 @@ public:
 	Mesh(Mesh&&) = delete;
 	Mesh& operator=(Mesh&&) = delete;
 
-	void Render(ID3D11DeviceContext* pDeviceContext, Matrix worldViewProjMatrix, Matrix viewInverseMatrix);
+	// Goes through the state tracking context, so bindings the previous draw left behind are not set again
+	void Render(StateTrackingContext& context, Matrix worldViewProjMatrix, Matrix viewInverseMatrix);
+
+	// Only when the effect has an instanced technique for the vertex format
+	bool CanRenderInstanced() const { return m_pInstancedInputLayout != nullptr; }
+	// instanceCount copies at the given level, their InstanceData starts at firstInstance in pInstanceBuffer
+	void RenderInstanced(StateTrackingContext& context, ID3D11Buffer* pInstanceBuffer, uint32_t lod, uint32_t firstInstance, uint32_t instanceCount,
+		Matrix viewProjMatrix, Matrix viewInverseMatrix);
 
 	Effect* GetEffect() const { return m_pEffect; }
+	VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+	DXGI_FORMAT GetIndexFormat() const { return m_IndexFormat; }
+
+	// Level of detail Render draws, 0 is the full mesh
+	uint32_t GetLodCount() const { return static_cast<uint32_t>(m_Lods.size()); }
+	uint32_t GetLod() const { return m_Lod; }
+	void SetLod(uint32_t lod) { m_Lod = std::min(lod, GetLodCount() - 1); }
+	// Errors, triangle counts and bounds for SelectLods
+	const LodChain& GetLodChain() const { return m_LodChain; }
+
+	// Meshlets of the full level (MeshCache::CopyMeshletMesh), culled for stats in Renderer::Update. Empty when there are none.
+	const MeshletMesh& GetMeshletMesh() const { return m_MeshletMesh; }
+	void SetMeshletMesh(MeshletMesh meshletMesh) { m_MeshletMesh = std::move(meshletMesh); }
+
+	// Object space box and the radius of the sphere around its center
+	const Vector3& GetBoundsMin() const { return m_BoundsMin; }
+	const Vector3& GetBoundsMax() const { return m_BoundsMax; }
+	float GetBoundsRadius() const { return m_BoundsRadius; }
 
-	Matrix GetWorldMatrix() const { return m_WorldMatrix; };
-	void SetWorldMatrix(const Matrix& worldMatrix) { m_WorldMatrix = worldMatrix; };
+	Matrix GetWorldMatrix() const { return m_WorldTransform.ToMatrix(); };
+	const Affine3x4& GetWorldTransform() const { return m_WorldTransform; };
+	void SetWorldTransform(const Affine3x4& worldTransform) { m_WorldTransform = worldTransform; };
 
 
 private:
+	// What the buffers are made from, only read while they are made
+	struct BufferData
+	{
+		std::span<const Vertex> vertices;
+		// Empty when they still have to be encoded
+		std::span<const PackedVertex> packedVertices;
+		PositionQuantization positionQuantization;
+		std::span<const uint32_t> indices;
+		// Uploaded instead of indices when there are any (MeshCacheContent::indices16)
+		std::span<const uint16_t> indices16;
+		// Empty for one draw per level
+		std::span<const Submesh16> submeshes16;
+		std::span<const SubmeshRange> lods;
+	};
+	void Initialize(ID3D11Device* pDevice, Effect* pEffect, VertexFormat format, BufferData data);
+
 	Effect* m_pEffect;
 
 	ID3DX11EffectTechnique* m_pTechnique;
+	// Looked up once instead of every draw
+	std::vector<ID3DX11EffectPass*> m_Passes;
 
 	ID3D11InputLayout* m_pInputLayout;
+	// Vertex layout plus the instance stream, nullptr without an instanced technique
+	ID3D11InputLayout* m_pInstancedInputLayout;
+	std::vector<ID3DX11EffectPass*> m_InstancedPasses;
 
 	ID3D11Buffer* m_pVertexBuffer;
 	ID3D11Buffer* m_pIndexBuffer;
 
-	uint32_t m_NumIndices;
+	VertexFormat m_VertexFormat;
+	uint32_t m_VertexStride;
+	PositionQuantization m_PositionQuantization;
 
-	Matrix m_WorldMatrix;
+	uint32_t m_NumIndices;
+	DXGI_FORMAT m_IndexFormat;
+	// One draw each, a single one per level unless the mesh was split
+	std::vector<Submesh16> m_Submeshes;
+
+	struct Lod
+	{
+		uint32_t firstSubmesh;
+		uint32_t submeshCount;
+	};
+	std::vector<Lod> m_Lods;
+	uint32_t m_Lod;
+	LodChain m_LodChain;
+	MeshletMesh m_MeshletMesh;
+
+	Vector3 m_BoundsMin;
+	Vector3 m_BoundsMax;
+	float m_BoundsRadius;
+
+	Affine3x4 m_WorldTransform;
 
 
 };
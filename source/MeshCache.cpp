@@ -0,0 +1,486 @@
+#include "pch.h"
+
+#include "MeshCache.h"
+#include "MeshSimplifier.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr char MAGIC[4]{ 'D', 'M', 'S', 'H' };
+		// Every array starts on this, mappings are page aligned so the spans are aligned too
+		constexpr uint64_t ARRAY_ALIGNMENT{ 16 };
+
+		// Little endian, written as is
+		struct MeshCacheHeader
+		{
+			char magic[4]{};
+			uint32_t version{};
+			uint32_t vertexSize{};
+			uint32_t indexSize{};
+
+			// Import options the cache was made with
+			uint64_t optionsKey{};
+			// Source OBJ when the cache was made
+			uint64_t sourceSize{};
+			int64_t sourceWriteTime{};
+			uint64_t sourceHash{};
+
+			uint64_t vertexCount{};
+			uint64_t indexCount{};
+			uint64_t submeshCount{};
+			uint64_t vertexOffset{};
+			uint64_t indexOffset{};
+			uint64_t submeshOffset{};
+
+			uint64_t meshletCount{};
+			uint64_t meshletVertexCount{};
+			uint64_t meshletTriangleCount{};
+			uint64_t meshletOffset{};
+			uint64_t meshletBoundsOffset{};
+			uint64_t meshletVertexOffset{};
+			uint64_t meshletTriangleOffset{};
+
+			uint64_t packedVertexCount{};
+			uint64_t packedVertexOffset{};
+
+			uint64_t index16Count{};
+			uint64_t submesh16Count{};
+			uint64_t index16Offset{};
+			uint64_t submesh16Offset{};
+
+			Vector3 boundsMin{};
+			Vector3 boundsMax{};
+			PositionQuantization positionQuantization{};
+		};
+		static_assert(std::is_trivially_copyable_v<MeshCacheHeader>);
+		static_assert(std::is_trivially_copyable_v<Vertex>);
+		static_assert(std::is_trivially_copyable_v<SubmeshRange>);
+		static_assert(std::is_trivially_copyable_v<Meshlet> && std::is_trivially_copyable_v<MeshletBounds>);
+		static_assert(std::is_trivially_copyable_v<PackedVertex>);
+		static_assert(std::is_trivially_copyable_v<Submesh16>);
+
+		constexpr uint64_t AlignUp(uint64_t value)
+		{
+			return (value + ARRAY_ALIGNMENT - 1) & ~(ARRAY_ALIGNMENT - 1);
+		}
+
+		// threadCount is left out, the output does not depend on it. The LOD ratios go in as 24 bits of their hash.
+		uint64_t GetOptionsKey(const Utils::ObjImportOptions& options, std::span<const float> lodRatios, bool splitFor16BitIndices)
+		{
+			const uint64_t lodKey{ lodRatios.empty() ? 0
+				: MeshCache::HashContent({ reinterpret_cast<const char*>(lodRatios.data()), lodRatios.size_bytes() }) & 0xFFFFFF };
+			return static_cast<uint64_t>(options.flipAxisAndWinding)
+				| static_cast<uint64_t>(options.weldVertices) << 1
+				| static_cast<uint64_t>(options.optimizeVertexCache) << 2
+				| static_cast<uint64_t>(splitFor16BitIndices) << 3
+				| lodKey << 8
+				| static_cast<uint64_t>(std::bit_cast<uint32_t>(options.weldEpsilon)) << 32;
+		}
+
+		bool GetSourceInfo(const std::string& path, uint64_t& size, int64_t& writeTime)
+		{
+			std::error_code error{};
+			size = std::filesystem::file_size(path, error);
+			if(error)
+				return false;
+
+			const std::filesystem::file_time_type time{ std::filesystem::last_write_time(path, error) };
+			if(error)
+				return false;
+
+			writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+			return true;
+		}
+
+		// Header of a mapped cache, nullptr when it is not one this build can read
+		const MeshCacheHeader* GetHeader(const MappedFile& file)
+		{
+			if(file.GetSize() < sizeof(MeshCacheHeader))
+				return nullptr;
+
+			const MeshCacheHeader* pHeader{ reinterpret_cast<const MeshCacheHeader*>(file.GetData()) };
+			if(std::memcmp(pHeader->magic, MAGIC, sizeof(MAGIC)) != 0 || pHeader->version != MeshCache::VERSION
+				|| pHeader->vertexSize != sizeof(Vertex) || pHeader->indexSize != sizeof(uint32_t))
+				return nullptr;
+
+			// Arrays have to be aligned and inside the file
+			const auto isInside = [&](uint64_t offset, uint64_t count, uint64_t elementSize)
+			{
+				return offset % ARRAY_ALIGNMENT == 0 && offset <= file.GetSize() && count <= (file.GetSize() - offset) / elementSize;
+			};
+			if(!isInside(pHeader->vertexOffset, pHeader->vertexCount, sizeof(Vertex))
+				|| !isInside(pHeader->indexOffset, pHeader->indexCount, sizeof(uint32_t))
+				|| !isInside(pHeader->submeshOffset, pHeader->submeshCount, sizeof(SubmeshRange))
+				|| !isInside(pHeader->meshletOffset, pHeader->meshletCount, sizeof(Meshlet))
+				|| !isInside(pHeader->meshletBoundsOffset, pHeader->meshletCount, sizeof(MeshletBounds))
+				|| !isInside(pHeader->meshletVertexOffset, pHeader->meshletVertexCount, sizeof(uint32_t))
+				|| !isInside(pHeader->meshletTriangleOffset, pHeader->meshletTriangleCount, sizeof(uint8_t))
+				|| !isInside(pHeader->packedVertexOffset, pHeader->packedVertexCount, sizeof(PackedVertex))
+				|| !isInside(pHeader->index16Offset, pHeader->index16Count, sizeof(uint16_t))
+				|| !isInside(pHeader->submesh16Offset, pHeader->submesh16Count, sizeof(Submesh16)))
+				return nullptr;
+
+			return pHeader;
+		}
+
+		void ExpandBounds(const Vector3& point, Vector3& boundsMin, Vector3& boundsMax)
+		{
+			boundsMin = Vector3::Min(boundsMin, point);
+			boundsMax = Vector3::Max(boundsMax, point);
+		}
+
+		// Range with the bounds of the vertices it uses
+		SubmeshRange MakeSubmesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t firstIndex, uint32_t indexCount, float lodError = 0.f)
+		{
+			SubmeshRange submesh{ firstIndex, indexCount };
+			submesh.lodError = lodError;
+			const std::span<const uint32_t> rangeIndices{ indices.subspan(firstIndex, indexCount) };
+			if(rangeIndices.empty())
+				return submesh;
+
+			submesh.boundsMin = submesh.boundsMax = vertices[rangeIndices.front()].position;
+			for(const uint32_t index : rangeIndices)
+				ExpandBounds(vertices[index].position, submesh.boundsMin, submesh.boundsMax);
+			return submesh;
+		}
+
+		// One range over every index
+		SubmeshRange MakeWholeMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+		{
+			return MakeSubmesh(vertices, indices, 0, static_cast<uint32_t>(indices.size()));
+		}
+
+		// 16 bit indices of every level, at the same positions as the 32 bit ones. Vertices that do not fit are split per
+		// level when asked, so a level never draws submeshes of another; the vertices and 32 bit indices become the split ones.
+		void Make16BitIndices(MeshCacheContent& content, bool splitFor16BitIndices)
+		{
+			std::vector<Vertex>& vertices{ content.vertices };
+			std::vector<uint32_t>& indices{ content.indices };
+			if(Utils::FitsIn16BitIndices(vertices.size()))
+			{
+				content.indices16.resize(indices.size());
+				Utils::ConvertTo16BitIndices(indices, content.indices16);
+				return;
+			}
+			if(!splitFor16BitIndices)
+				return;
+
+			content.indices16.resize(indices.size());
+			std::vector<uint32_t> vertexRemap{};
+			for(const SubmeshRange& level : content.submeshes)
+			{
+				SplitMesh16 split{ Utils::SplitFor16BitIndices(std::span{ indices }.subspan(level.firstIndex, level.indexCount), vertices.size()) };
+				for(Submesh16& submesh : split.submeshes)
+				{
+					submesh.firstIndex += level.firstIndex;
+					submesh.baseVertex += static_cast<uint32_t>(vertexRemap.size());
+					for(uint32_t i{ submesh.firstIndex }; i < submesh.firstIndex + submesh.indexCount; ++i)
+					{
+						content.indices16[i] = split.indices[i - level.firstIndex];
+						indices[i] = submesh.baseVertex + content.indices16[i];
+					}
+				}
+				vertexRemap.insert(vertexRemap.end(), split.vertexRemap.begin(), split.vertexRemap.end());
+				content.submeshes16.insert(content.submeshes16.end(), split.submeshes.begin(), split.submeshes.end());
+			}
+
+			std::vector<Vertex> splitVertices(vertexRemap.size());
+			for(size_t i{ 0 }; i < vertexRemap.size(); ++i)
+				splitVertices[i] = vertices[vertexRemap[i]];
+			vertices = std::move(splitVertices);
+		}
+
+		template<typename T>
+		std::span<const T> GetArray(const char* pData, uint64_t offset, uint64_t count)
+		{
+			return { reinterpret_cast<const T*>(pData + offset), static_cast<size_t>(count) };
+		}
+
+		bool WritePadding(std::ofstream& file)
+		{
+			static constexpr char zeros[ARRAY_ALIGNMENT]{};
+			const uint64_t position{ static_cast<uint64_t>(file.tellp()) };
+			file.write(zeros, static_cast<std::streamsize>(AlignUp(position) - position));
+			return file.good();
+		}
+	}
+
+	bool MeshCache::Load(const std::string& objPath, const Utils::ObjImportOptions& options, std::span<const float> lodRatios, bool splitFor16BitIndices)
+	{
+		return Load(objPath, GetCachePath(objPath), options, lodRatios, splitFor16BitIndices);
+	}
+
+	bool MeshCache::Load(const std::string& objPath, const std::string& cachePath, const Utils::ObjImportOptions& options, std::span<const float> lodRatios,
+		bool splitFor16BitIndices)
+	{
+		Close();
+		m_WasRebuilt = false;
+		m_ImportStats = {};
+
+		const uint64_t optionsKey{ GetOptionsKey(options, lodRatios, splitFor16BitIndices) };
+		uint64_t sourceSize{};
+		int64_t sourceWriteTime{};
+		const bool hasSource{ GetSourceInfo(objPath, sourceSize, sourceWriteTime) };
+
+		if(Open(cachePath))
+		{
+			// Without the OBJ (shipped build) any valid cache will do
+			if(!hasSource)
+				return true;
+
+			const MeshCacheHeader header{ *GetHeader(m_File) };
+			if(header.optionsKey == optionsKey && header.sourceSize == sourceSize)
+			{
+				if(header.sourceWriteTime == sourceWriteTime)
+					return true;
+
+				// Touched, but maybe not changed (checkout, copy). Only the hash decides.
+				const MappedFile source{ objPath };
+				if(source.IsOpen() && HashContent(source.GetText()) == header.sourceHash)
+				{
+					// Store the new write time so the next load skips the hash, the mapping has to go first
+					Close();
+					std::fstream file{ cachePath, std::ios::in | std::ios::out | std::ios::binary };
+					file.seekp(offsetof(MeshCacheHeader, sourceWriteTime));
+					file.write(reinterpret_cast<const char*>(&sourceWriteTime), sizeof(sourceWriteTime));
+					file.close();
+					return Open(cachePath);
+				}
+			}
+			Close();
+		}
+
+		if(!hasSource)
+			return false;
+
+		const MappedFile source{ objPath };
+		if(!source.IsOpen())
+			return false;
+
+		MeshCacheContent content{};
+		std::vector<Vertex>& vertices{ content.vertices };
+		std::vector<uint32_t>& indices{ content.indices };
+		if(!Utils::ParseOBJText(source.GetText(), vertices, indices, options, &m_ImportStats))
+			return false;
+
+		// The levels share the vertices, their indices go after the full mesh
+		if(!lodRatios.empty())
+		{
+			for(const LodLevel& level : Utils::GenerateLods(vertices, indices, lodRatios, options.threadCount))
+				content.submeshes.push_back(MakeSubmesh(vertices, indices, level.firstIndex, level.indexCount, level.error));
+		}
+		else
+		{
+			content.submeshes.push_back(MakeWholeMesh(vertices, indices));
+		}
+		Make16BitIndices(content, splitFor16BitIndices);
+
+		// The meshlets only cover the full mesh, they are built after a split so they index the vertices that are stored
+		const SubmeshRange& fullDetail{ content.submeshes.front() };
+		content.meshletMesh = Utils::BuildMeshlets(vertices, std::span{ indices }.subspan(fullDetail.firstIndex, fullDetail.indexCount));
+
+		// Encoded once here instead of every time a Mesh is made
+		content.positionQuantization = Utils::GetPositionQuantization(vertices);
+		content.packedVertices.resize(vertices.size());
+		Utils::PackVertices(vertices, content.positionQuantization, content.packedVertices);
+
+		m_WasRebuilt = true;
+		if(Write(cachePath, content, sourceSize, sourceWriteTime, HashContent(source.GetText()), optionsKey) && Open(cachePath))
+			return true;
+
+		// Still usable, just not zero copy
+		m_Imported = std::move(content);
+		m_Vertices = m_Imported.vertices;
+		m_Indices = m_Imported.indices;
+		m_Indices16 = m_Imported.indices16;
+		m_Submeshes16 = m_Imported.submeshes16;
+		m_Submeshes = m_Imported.submeshes;
+		m_Meshlets = m_Imported.meshletMesh.meshlets;
+		m_MeshletBounds = m_Imported.meshletMesh.bounds;
+		m_MeshletVertices = m_Imported.meshletMesh.vertices;
+		m_MeshletTriangles = m_Imported.meshletMesh.triangles;
+		m_PackedVertices = m_Imported.packedVertices;
+		m_PositionQuantization = m_Imported.positionQuantization;
+		// The levels use a subset of the full mesh's vertices
+		m_BoundsMin = m_Imported.submeshes.front().boundsMin;
+		m_BoundsMax = m_Imported.submeshes.front().boundsMax;
+		return true;
+	}
+
+	bool MeshCache::Open(const std::string& cachePath)
+	{
+		Close();
+		if(!m_File.Open(cachePath))
+			return false;
+
+		const MeshCacheHeader* pHeader{ GetHeader(m_File) };
+		if(!pHeader)
+		{
+			Close();
+			return false;
+		}
+
+		const char* pData{ m_File.GetData() };
+		m_Vertices = GetArray<Vertex>(pData, pHeader->vertexOffset, pHeader->vertexCount);
+		m_Indices = GetArray<uint32_t>(pData, pHeader->indexOffset, pHeader->indexCount);
+		m_Indices16 = GetArray<uint16_t>(pData, pHeader->index16Offset, pHeader->index16Count);
+		m_Submeshes16 = GetArray<Submesh16>(pData, pHeader->submesh16Offset, pHeader->submesh16Count);
+		m_Submeshes = GetArray<SubmeshRange>(pData, pHeader->submeshOffset, pHeader->submeshCount);
+		m_Meshlets = GetArray<Meshlet>(pData, pHeader->meshletOffset, pHeader->meshletCount);
+		m_MeshletBounds = GetArray<MeshletBounds>(pData, pHeader->meshletBoundsOffset, pHeader->meshletCount);
+		m_MeshletVertices = GetArray<uint32_t>(pData, pHeader->meshletVertexOffset, pHeader->meshletVertexCount);
+		m_MeshletTriangles = GetArray<uint8_t>(pData, pHeader->meshletTriangleOffset, pHeader->meshletTriangleCount);
+		m_PackedVertices = GetArray<PackedVertex>(pData, pHeader->packedVertexOffset, pHeader->packedVertexCount);
+		m_PositionQuantization = pHeader->positionQuantization;
+		m_BoundsMin = pHeader->boundsMin;
+		m_BoundsMax = pHeader->boundsMax;
+		return true;
+	}
+
+	void MeshCache::Close()
+	{
+		m_File.Close();
+		m_Imported = {};
+		m_Vertices = {};
+		m_Indices = {};
+		m_Indices16 = {};
+		m_Submeshes16 = {};
+		m_Submeshes = {};
+		m_Meshlets = {};
+		m_MeshletBounds = {};
+		m_MeshletVertices = {};
+		m_MeshletTriangles = {};
+		m_PackedVertices = {};
+		m_PositionQuantization = {};
+		m_BoundsMin = {};
+		m_BoundsMax = {};
+	}
+
+	MeshletMesh MeshCache::CopyMeshletMesh() const
+	{
+		return { { m_Meshlets.begin(), m_Meshlets.end() }, { m_MeshletBounds.begin(), m_MeshletBounds.end() },
+			{ m_MeshletVertices.begin(), m_MeshletVertices.end() }, { m_MeshletTriangles.begin(), m_MeshletTriangles.end() } };
+	}
+
+	std::string MeshCache::GetCachePath(const std::string& objPath)
+	{
+		return std::filesystem::path{ objPath }.replace_extension(".dmesh").string();
+	}
+
+	bool MeshCache::Write(const std::string& cachePath, const MeshCacheContent& content, uint64_t sourceSize, int64_t sourceWriteTime, uint64_t sourceHash, uint64_t optionsKey)
+	{
+		const std::span<const Vertex> vertices{ content.vertices };
+		const std::span<const uint32_t> indices{ content.indices };
+		std::span<const SubmeshRange> submeshes{ content.submeshes };
+		const MeshletMesh& meshletMesh{ content.meshletMesh };
+		const SubmeshRange wholeMesh{ MakeWholeMesh(vertices, indices) };
+		if(submeshes.empty())
+			submeshes = { &wholeMesh, 1 };
+
+		MeshCacheHeader header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.vertexSize = sizeof(Vertex);
+		header.indexSize = sizeof(uint32_t);
+		header.optionsKey = optionsKey;
+		header.sourceSize = sourceSize;
+		header.sourceWriteTime = sourceWriteTime;
+		header.sourceHash = sourceHash;
+		header.vertexCount = vertices.size();
+		header.indexCount = indices.size();
+		header.submeshCount = submeshes.size();
+		header.vertexOffset = AlignUp(sizeof(MeshCacheHeader));
+		header.indexOffset = AlignUp(header.vertexOffset + vertices.size_bytes());
+		header.submeshOffset = AlignUp(header.indexOffset + indices.size_bytes());
+		header.meshletCount = meshletMesh.meshlets.size();
+		header.meshletVertexCount = meshletMesh.vertices.size();
+		header.meshletTriangleCount = meshletMesh.triangles.size();
+		header.meshletOffset = AlignUp(header.submeshOffset + submeshes.size_bytes());
+		header.meshletBoundsOffset = AlignUp(header.meshletOffset + meshletMesh.meshlets.size() * sizeof(Meshlet));
+		header.meshletVertexOffset = AlignUp(header.meshletBoundsOffset + meshletMesh.bounds.size() * sizeof(MeshletBounds));
+		header.meshletTriangleOffset = AlignUp(header.meshletVertexOffset + meshletMesh.vertices.size() * sizeof(uint32_t));
+		header.packedVertexCount = content.packedVertices.size();
+		header.packedVertexOffset = AlignUp(header.meshletTriangleOffset + meshletMesh.triangles.size());
+		header.positionQuantization = content.positionQuantization;
+		header.index16Count = content.indices16.size();
+		header.submesh16Count = content.submeshes16.size();
+		header.index16Offset = AlignUp(header.packedVertexOffset + content.packedVertices.size() * sizeof(PackedVertex));
+		header.submesh16Offset = AlignUp(header.index16Offset + content.indices16.size() * sizeof(uint16_t));
+		if(!vertices.empty())
+		{
+			header.boundsMin = header.boundsMax = vertices.front().position;
+			for(const Vertex& vertex : vertices)
+				ExpandBounds(vertex.position, header.boundsMin, header.boundsMax);
+		}
+
+		// Written next to it and moved over, a crash never leaves a half written cache behind
+		const std::string tempPath{ cachePath + ".tmp" };
+		{
+			std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			WritePadding(file);
+			file.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size_bytes()));
+			WritePadding(file);
+			file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size_bytes()));
+			WritePadding(file);
+			file.write(reinterpret_cast<const char*>(submeshes.data()), static_cast<std::streamsize>(submeshes.size_bytes()));
+			const auto writeArray = [&](const auto& array)
+			{
+				WritePadding(file);
+				file.write(reinterpret_cast<const char*>(array.data()), static_cast<std::streamsize>(array.size() * sizeof(array[0])));
+			};
+			writeArray(meshletMesh.meshlets);
+			writeArray(meshletMesh.bounds);
+			writeArray(meshletMesh.vertices);
+			writeArray(meshletMesh.triangles);
+			writeArray(content.packedVertices);
+			writeArray(content.indices16);
+			writeArray(content.submeshes16);
+			if(!file.good())
+			{
+				file.close();
+				std::filesystem::remove(tempPath);
+				return false;
+			}
+		}
+
+		std::error_code error{};
+		std::filesystem::rename(tempPath, cachePath, error);
+		return !error;
+	}
+
+	uint64_t MeshCache::HashContent(std::string_view content)
+	{
+		uint64_t hash{ 0x9E3779B97F4A7C15ull ^ content.size() };
+		const auto mix = [&](uint64_t word)
+		{
+			hash = std::rotl(hash ^ (word * 0xC2B2AE3D27D4EB4Full), 31) * 0x85EBCA77C2B2AE63ull;
+		};
+
+		size_t i{ 0 };
+		for(; i + 8 <= content.size(); i += 8)
+		{
+			uint64_t word{};
+			std::memcpy(&word, content.data() + i, 8);
+			mix(word);
+		}
+		if(i < content.size())
+		{
+			uint64_t word{};
+			std::memcpy(&word, content.data() + i, content.size() - i);
+			mix(word);
+		}
+
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+}
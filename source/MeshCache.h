@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "IndexFormat.h"
+#include "MappedFile.h"
+#include "Meshlet.h"
+#include "ObjParser.h"
+#include "PackedVertex.h"
+#include "Vertex.h"
+
+namespace dae
+{
+	// Index range of one part of the mesh with its object space bounds
+	struct SubmeshRange
+	{
+		uint32_t firstIndex{};
+		uint32_t indexCount{};
+		Vector3 boundsMin{};
+		Vector3 boundsMax{};
+		// Geometric error of the level of detail the range draws, 0 for the full mesh
+		float lodError{};
+	};
+
+	// What an import makes and a cache stores
+	struct MeshCacheContent
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		// The same indices as 16 bit, index for index, empty when the mesh stays 32 bit. Split meshes hold their
+		// submeshes' local indices here and list the submeshes level after level, unsplit ones have none.
+		std::vector<uint16_t> indices16{};
+		std::vector<Submesh16> submeshes16{};
+		// Empty for one range over the whole mesh
+		std::vector<SubmeshRange> submeshes{};
+		MeshletMesh meshletMesh{};
+		// The vertices encoded for VertexFormat::Packed, ready for the vertex buffer
+		std::vector<PackedVertex> packedVertices{};
+		PositionQuantization positionQuantization{};
+	};
+
+	// Binary mesh container (.dmesh) with the processed vertices and indices, read straight from a file mapping.
+	// Layout: MeshCacheHeader, then the vertex, index, submesh, meshlet, packed vertex and 16 bit index arrays, each 16 byte aligned.
+	class MeshCache final
+	{
+	public:
+		static constexpr uint32_t VERSION{ 7 };
+
+		MeshCache() = default;
+
+		~MeshCache() = default;
+		MeshCache(const MeshCache&) = delete;
+		MeshCache(MeshCache&&) noexcept = delete;
+		MeshCache& operator=(const MeshCache&) = delete;
+		MeshCache& operator=(MeshCache&&) noexcept = delete;
+
+		// Maps the cache of the OBJ, first (re)building it when it is missing, from another version, import options
+		// or LOD ratios, or when the OBJ changed: a different size or write time makes it compare the content hash.
+		// Every LOD ratio appends a simplified copy of the indices (MeshSimplifier.h), the submeshes are then the levels, finest first.
+		// The index format is chosen here as well: 16 bit when every vertex fits, otherwise 32 bit, or 16 bit submeshes when
+		// splitFor16BitIndices is set (IndexFormat.h). A split gives every level its own copies of the vertices it uses and
+		// rewrites the 32 bit indices to match, so the CPU side sees the same mesh the GPU draws.
+		// The meshlets (Meshlet.h) are built from the full mesh with the default sizes, the packed vertices (PackedVertex.h)
+		// are encoded here too so a Mesh can upload any of the formats from the mapping.
+		bool Load(const std::string& objPath, const std::string& cachePath, const Utils::ObjImportOptions& options = {}, std::span<const float> lodRatios = {},
+			bool splitFor16BitIndices = false);
+		bool Load(const std::string& objPath, const Utils::ObjImportOptions& options = {}, std::span<const float> lodRatios = {},
+			bool splitFor16BitIndices = false);
+
+		// Maps a cache without looking at its source
+		bool Open(const std::string& cachePath);
+		void Close();
+
+		// Points into the mapping (or the imported arrays when the cache could not be written), valid until closed
+		std::span<const Vertex> GetVertices() const { return m_Vertices; }
+		std::span<const uint32_t> GetIndices() const { return m_Indices; }
+		std::span<const uint16_t> GetIndices16() const { return m_Indices16; }
+		std::span<const Submesh16> GetSubmeshes16() const { return m_Submeshes16; }
+		std::span<const SubmeshRange> GetSubmeshes() const { return m_Submeshes; }
+		std::span<const Meshlet> GetMeshlets() const { return m_Meshlets; }
+		std::span<const MeshletBounds> GetMeshletBounds() const { return m_MeshletBounds; }
+		std::span<const uint32_t> GetMeshletVertices() const { return m_MeshletVertices; }
+		std::span<const uint8_t> GetMeshletTriangles() const { return m_MeshletTriangles; }
+		std::span<const PackedVertex> GetPackedVertices() const { return m_PackedVertices; }
+		const PositionQuantization& GetPositionQuantization() const { return m_PositionQuantization; }
+		// Copy of the meshlet arrays that outlives the cache
+		MeshletMesh CopyMeshletMesh() const;
+		const Vector3& GetBoundsMin() const { return m_BoundsMin; }
+		const Vector3& GetBoundsMax() const { return m_BoundsMax; }
+
+		// True when the last Load had to import the OBJ, the import stats are only filled in then
+		bool WasRebuilt() const { return m_WasRebuilt; }
+		const Utils::ObjImportStats& GetImportStats() const { return m_ImportStats; }
+
+		// name.obj -> name.dmesh
+		static std::string GetCachePath(const std::string& objPath);
+
+		// Writes a cache, the meshlets, packed vertices and 16 bit indices may be empty for none
+		static bool Write(const std::string& cachePath, const MeshCacheContent& content, uint64_t sourceSize, int64_t sourceWriteTime, uint64_t sourceHash, uint64_t optionsKey);
+
+		// 64 bit hash of a whole file, used to spot a changed source
+		static uint64_t HashContent(std::string_view content);
+
+	private:
+		MappedFile m_File{};
+		std::span<const Vertex> m_Vertices{};
+		std::span<const uint32_t> m_Indices{};
+		std::span<const uint16_t> m_Indices16{};
+		std::span<const Submesh16> m_Submeshes16{};
+		std::span<const SubmeshRange> m_Submeshes{};
+		std::span<const Meshlet> m_Meshlets{};
+		std::span<const MeshletBounds> m_MeshletBounds{};
+		std::span<const uint32_t> m_MeshletVertices{};
+		std::span<const uint8_t> m_MeshletTriangles{};
+		std::span<const PackedVertex> m_PackedVertices{};
+		PositionQuantization m_PositionQuantization{};
+		Vector3 m_BoundsMin{};
+		Vector3 m_BoundsMax{};
+
+		// Only used when the cache could not be written, a read only install for example
+		MeshCacheContent m_Imported{};
+
+		bool m_WasRebuilt{};
+		Utils::ObjImportStats m_ImportStats{};
+	};
+}
@@ -0,0 +1,657 @@
+#include "pch.h"
+
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+#include "VertexCache.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <tuple>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t NONE{ UINT32_MAX };
+
+		// Border edges keep the silhouette of open meshes, they get a lot more weight than the surface
+		constexpr float BORDER_EDGE_WEIGHT{ 10.f };
+		constexpr float SEAM_EDGE_WEIGHT{ 1.f };
+		// Many of the cheapest collapses get blocked by a neighbour collapsing first,
+		// so a pass accepts a bit more error than the collapse that would reach the goal
+		constexpr float PASS_ERROR_BOUND{ 1.5f };
+		// A collapse may turn the normal of a neighbouring triangle by at most about 75 degrees. Allowing up to 90
+		// lets two collapses in a row fold a triangle over.
+		constexpr float MAX_NORMAL_TURN_COS{ 0.25f };
+
+#pragma region Topology
+		enum class VertexKind : uint8_t
+		{
+			// Closed surface around it, collapses in any direction
+			Manifold,
+			// On one open edge loop, collapses along it
+			Border,
+			// Two vertices on one position split by a uv/normal seam, both collapse along the seam together
+			Seam,
+			// Corners, more than two vertices on one position and broken topology
+			Locked
+		};
+		constexpr size_t KIND_COUNT{ 4 };
+
+		// Whether a vertex of the first kind may collapse onto one of the second kind
+		constexpr bool CAN_COLLAPSE[KIND_COUNT][KIND_COUNT]
+		{
+			{ true, true, true, true },
+			{ false, true, false, true },
+			{ false, false, true, true },
+			{ false, false, false, false }
+		};
+		// Whether an edge between the kinds also shows up reversed, seams count on positions
+		constexpr bool HAS_OPPOSITE[KIND_COUNT][KIND_COUNT]
+		{
+			{ true, true, true, true },
+			{ true, false, true, false },
+			{ true, true, true, true },
+			{ true, false, true, false }
+		};
+
+		constexpr size_t ToIndex(VertexKind kind)
+		{
+			return static_cast<size_t>(kind);
+		}
+
+		// Triangles around every vertex as the two corners that follow it
+		struct EdgeAdjacency
+		{
+			struct Edge
+			{
+				uint32_t next{};
+				uint32_t prev{};
+			};
+
+			// Edges of vertex v are [offsets[v], offsets[v + 1])
+			std::vector<uint32_t> offsets{};
+			std::vector<Edge> edges{};
+
+			std::span<const Edge> GetEdges(uint32_t vertex) const
+			{
+				return { edges.data() + offsets[vertex], edges.data() + offsets[vertex + 1] };
+			}
+
+			bool HasEdge(uint32_t from, uint32_t to) const
+			{
+				for(const Edge& edge : GetEdges(from))
+				{
+					if(edge.next == to)
+						return true;
+				}
+				return false;
+			}
+		};
+
+		// pRemap builds it on positions instead of vertices
+		void BuildAdjacency(EdgeAdjacency& adjacency, std::span<const uint32_t> indices, size_t vertexCount, const uint32_t* pRemap)
+		{
+			const auto getVertex = [pRemap](uint32_t index)
+			{
+				return pRemap ? pRemap[index] : index;
+			};
+
+			adjacency.offsets.assign(vertexCount + 1, 0);
+			for(const uint32_t index : indices)
+				++adjacency.offsets[getVertex(index) + 1];
+			std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+			adjacency.edges.resize(indices.size());
+			std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+			for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+			{
+				const uint32_t a{ getVertex(indices[i]) };
+				const uint32_t b{ getVertex(indices[i + 1]) };
+				const uint32_t c{ getVertex(indices[i + 2]) };
+				adjacency.edges[fill[a]++] = { b, c };
+				adjacency.edges[fill[b]++] = { c, a };
+				adjacency.edges[fill[c]++] = { a, b };
+			}
+		}
+
+		// wedge cycles through the vertices on a position, in index order
+		std::vector<uint32_t> BuildWedges(const std::vector<uint32_t>& remap)
+		{
+			std::vector<uint32_t> wedge(remap.size());
+			std::vector<uint32_t> last(remap.size(), NONE);
+			for(uint32_t vertex{ 0 }; vertex < static_cast<uint32_t>(remap.size()); ++vertex)
+			{
+				const uint32_t first{ remap[vertex] };
+				wedge[vertex] = first;
+				if(last[first] != NONE)
+					wedge[last[first]] = vertex;
+				last[first] = vertex;
+			}
+			return wedge;
+		}
+
+		// loop is the vertex the open edge leaving a vertex goes to, loopback where the open edge arriving comes from.
+		// Both are NONE without an open edge and the vertex itself with more than one.
+		void ClassifyVertices(std::vector<VertexKind>& kinds, std::vector<uint32_t>& loop, std::vector<uint32_t>& loopback,
+			const EdgeAdjacency& adjacency, const std::vector<uint32_t>& remap, const std::vector<uint32_t>& wedge)
+		{
+			const uint32_t vertexCount{ static_cast<uint32_t>(remap.size()) };
+			loop.assign(vertexCount, NONE);
+			loopback.assign(vertexCount, NONE);
+
+			for(uint32_t vertex{ 0 }; vertex < vertexCount; ++vertex)
+			{
+				for(const EdgeAdjacency::Edge& edge : adjacency.GetEdges(vertex))
+				{
+					const uint32_t target{ edge.next };
+					if(adjacency.HasEdge(target, vertex))
+						continue;
+
+					loopback[target] = loopback[target] == NONE ? vertex : target;
+					loop[vertex] = loop[vertex] == NONE ? target : vertex;
+				}
+			}
+
+			const auto isSingleOpenEdge = [](uint32_t open, uint32_t vertex)
+			{
+				return open != NONE && open != vertex;
+			};
+
+			kinds.resize(vertexCount);
+			for(uint32_t vertex{ 0 }; vertex < vertexCount; ++vertex)
+			{
+				// Every vertex on a position gets the kind of the first one
+				if(remap[vertex] != vertex)
+				{
+					kinds[vertex] = kinds[remap[vertex]];
+					continue;
+				}
+
+				if(wedge[vertex] == vertex)
+				{
+					if(loop[vertex] == NONE && loopback[vertex] == NONE)
+						kinds[vertex] = VertexKind::Manifold;
+					else if(isSingleOpenEdge(loop[vertex], vertex) && isSingleOpenEdge(loopback[vertex], vertex))
+						kinds[vertex] = VertexKind::Border;
+					else
+						kinds[vertex] = VertexKind::Locked;
+				}
+				else if(wedge[wedge[vertex]] == vertex)
+				{
+					// A seam has one open edge each way on both vertices and they have to meet on the same positions
+					const uint32_t other{ wedge[vertex] };
+					const bool isOpen{ isSingleOpenEdge(loop[vertex], vertex) && isSingleOpenEdge(loopback[vertex], vertex)
+						&& isSingleOpenEdge(loop[other], other) && isSingleOpenEdge(loopback[other], other) };
+					const bool isSeam{ isOpen
+						&& remap[loopback[vertex]] == remap[loop[other]] && remap[loop[vertex]] == remap[loopback[other]]
+						&& remap[loopback[vertex]] != remap[loop[vertex]] };
+					kinds[vertex] = isSeam ? VertexKind::Seam : VertexKind::Locked;
+				}
+				else
+				{
+					kinds[vertex] = VertexKind::Locked;
+				}
+			}
+		}
+
+		bool IsOnEdgeLoop(VertexKind kind)
+		{
+			return kind == VertexKind::Border || kind == VertexKind::Seam;
+		}
+
+		// The loop targets of collapsed vertices move along, when the loop edge itself collapsed backwards it skips ahead
+		void RemapEdgeLoop(std::vector<uint32_t>& loop, const std::vector<uint32_t>& collapseRemap)
+		{
+			for(uint32_t vertex{ 0 }; vertex < static_cast<uint32_t>(loop.size()); ++vertex)
+			{
+				if(loop[vertex] == NONE)
+					continue;
+
+				const uint32_t target{ loop[vertex] };
+				const uint32_t collapsed{ collapseRemap[target] };
+				loop[vertex] = collapsed == vertex ? loop[target] : collapsed;
+			}
+		}
+#pragma endregion
+
+#pragma region Quadrics
+		// Weighted sum of squared plane distances, symmetric matrix A, vector b and constant c
+		struct Quadric
+		{
+			float a00{}, a11{}, a22{};
+			float a10{}, a20{}, a21{};
+			float b0{}, b1{}, b2{};
+			float c{};
+			float weight{};
+
+			static Quadric FromPlane(const Vector3& normal, float distance, float weight)
+			{
+				const float wx{ normal.x * weight };
+				const float wy{ normal.y * weight };
+				const float wz{ normal.z * weight };
+				return Quadric{
+					wx * normal.x, wy * normal.y, wz * normal.z,
+					wy * normal.x, wz * normal.x, wz * normal.y,
+					wx * distance, wy * distance, wz * distance,
+					distance * distance * weight,
+					weight };
+			}
+
+			Quadric& operator+=(const Quadric& quadric)
+			{
+				a00 += quadric.a00; a11 += quadric.a11; a22 += quadric.a22;
+				a10 += quadric.a10; a20 += quadric.a20; a21 += quadric.a21;
+				b0 += quadric.b0; b1 += quadric.b1; b2 += quadric.b2;
+				c += quadric.c;
+				weight += quadric.weight;
+				return *this;
+			}
+
+			// Mean squared distance of the point to the planes
+			float GetError(const Vector3& p) const
+			{
+				const float squared{ a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+					+ 2.f * (a10 * p.x * p.y + a20 * p.x * p.z + a21 * p.y * p.z) };
+				const float error{ squared + 2.f * (b0 * p.x + b1 * p.y + b2 * p.z) + c };
+				return weight > 0.f ? std::abs(error) / weight : 0.f;
+			}
+		};
+
+		// Triangle planes weighted by area, summed per position
+		void FillFaceQuadrics(std::vector<Quadric>& quadrics, std::span<const uint32_t> indices, const std::vector<Vector3>& positions, const std::vector<uint32_t>& remap)
+		{
+			for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+			{
+				const Vector3& p0{ positions[indices[i]] };
+				Vector3 normal{ Vector3::Cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0) };
+				const float area{ normal.Magnitude() };
+				if(area <= 0.f)
+					continue;
+
+				normal /= area;
+				const Quadric quadric{ Quadric::FromPlane(normal, -Vector3::Dot(normal, p0), area) };
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+					quadrics[remap[indices[i + corner]]] += quadric;
+			}
+		}
+
+		// Planes through open edges perpendicular to their triangle keep borders and seams from sliding
+		void FillEdgeQuadrics(std::vector<Quadric>& quadrics, std::span<const uint32_t> indices, const std::vector<Vector3>& positions,
+			const std::vector<uint32_t>& remap, const std::vector<VertexKind>& kinds, const std::vector<uint32_t>& loop, const std::vector<uint32_t>& loopback)
+		{
+			for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+			{
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					const uint32_t i0{ indices[i + corner] };
+					const uint32_t i1{ indices[i + (corner + 1) % 3] };
+					const uint32_t i2{ indices[i + (corner + 2) % 3] };
+					const VertexKind k0{ kinds[i0] };
+					const VertexKind k1{ kinds[i1] };
+
+					// Also taken when only one end is on the loop, otherwise the loop's last edge before a corner has no error
+					if(!IsOnEdgeLoop(k0) && !IsOnEdgeLoop(k1))
+						continue;
+					if((IsOnEdgeLoop(k0) && loop[i0] != i1) || (IsOnEdgeLoop(k1) && loopback[i1] != i0))
+						continue;
+					// Seam edges show up once on both sides
+					if(HAS_OPPOSITE[ToIndex(k0)][ToIndex(k1)] && remap[i1] > remap[i0])
+						continue;
+
+					const Vector3& p0{ positions[i0] };
+					Vector3 edge{ positions[i1] - p0 };
+					const float length{ edge.Magnitude() };
+					if(length <= 0.f)
+						continue;
+					edge /= length;
+
+					const Vector3 toOpposite{ positions[i2] - p0 };
+					Vector3 normal{ toOpposite - edge * Vector3::Dot(toOpposite, edge) };
+					const float normalLength{ normal.Magnitude() };
+					if(normalLength <= 0.f)
+						continue;
+					normal /= normalLength;
+
+					const float weight{ k0 == VertexKind::Border || k1 == VertexKind::Border ? BORDER_EDGE_WEIGHT : SEAM_EDGE_WEIGHT };
+					const Quadric quadric{ Quadric::FromPlane(normal, -Vector3::Dot(normal, p0), length * length * weight) };
+					quadrics[remap[i0]] += quadric;
+					quadrics[remap[i1]] += quadric;
+				}
+			}
+		}
+#pragma endregion
+
+#pragma region Collapses
+		struct Collapse
+		{
+			uint32_t from{};
+			uint32_t to{};
+			float error{};
+			// Both directions are allowed, ranking picks the cheaper one
+			bool isBidirectional{};
+		};
+
+		void PickEdgeCollapses(std::vector<Collapse>& collapses, std::span<const uint32_t> indices, const std::vector<uint32_t>& remap,
+			const std::vector<VertexKind>& kinds, const std::vector<uint32_t>& loop)
+		{
+			collapses.clear();
+			for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+			{
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					const uint32_t i0{ indices[i + corner] };
+					const uint32_t i1{ indices[i + (corner + 1) % 3] };
+					if(remap[i0] == remap[i1])
+						continue;
+
+					const size_t k0{ ToIndex(kinds[i0]) };
+					const size_t k1{ ToIndex(kinds[i1]) };
+					if(!CAN_COLLAPSE[k0][k1] && !CAN_COLLAPSE[k1][k0])
+						continue;
+					// Edges with an opposite half edge are only taken once
+					if(HAS_OPPOSITE[k0][k1] && remap[i1] > remap[i0])
+						continue;
+					// Two loop vertices that are not neighbours on the loop, collapsing would pinch two loops together
+					if(k0 == k1 && IsOnEdgeLoop(kinds[i0]) && loop[i0] != i1)
+						continue;
+
+					if(CAN_COLLAPSE[k0][k1] && CAN_COLLAPSE[k1][k0])
+						collapses.push_back({ i0, i1, 0.f, true });
+					else if(CAN_COLLAPSE[k0][k1])
+						collapses.push_back({ i0, i1, 0.f, false });
+					else
+						collapses.push_back({ i1, i0, 0.f, false });
+				}
+			}
+		}
+
+		void RankEdgeCollapses(std::vector<Collapse>& collapses, const std::vector<Vector3>& positions, const std::vector<Quadric>& quadrics, const std::vector<uint32_t>& remap)
+		{
+			for(Collapse& collapse : collapses)
+			{
+				const float forward{ quadrics[remap[collapse.from]].GetError(positions[collapse.to]) };
+				if(!collapse.isBidirectional)
+				{
+					collapse.error = forward;
+					continue;
+				}
+
+				const float backward{ quadrics[remap[collapse.to]].GetError(positions[collapse.from]) };
+				if(backward < forward)
+					std::swap(collapse.from, collapse.to);
+				collapse.error = std::min(forward, backward);
+			}
+		}
+
+		bool IsTriangleFlipped(const Vector3& a, const Vector3& b, const Vector3& from, const Vector3& to)
+		{
+			const Vector3 edge{ b - a };
+			const Vector3 normalFrom{ Vector3::Cross(edge, from - a) };
+			const Vector3 normalTo{ Vector3::Cross(edge, to - a) };
+			return Vector3::Dot(normalFrom, normalTo) <= MAX_NORMAL_TURN_COS * std::sqrt(normalFrom.SqrMagnitude() * normalTo.SqrMagnitude());
+		}
+
+		// adjacency is on positions, r0 and r1 are positions
+		bool HasTriangleFlips(const EdgeAdjacency& adjacency, const std::vector<Vector3>& positions, const std::vector<uint32_t>& collapseRemap,
+			const std::vector<uint32_t>& remap, uint32_t r0, uint32_t r1)
+		{
+			for(const EdgeAdjacency::Edge& edge : adjacency.GetEdges(r0))
+			{
+				const uint32_t a{ remap[collapseRemap[edge.next]] };
+				const uint32_t b{ remap[collapseRemap[edge.prev]] };
+
+				// Triangles this collapse or an earlier one in the pass removes
+				if(a == r1 || b == r1 || a == b)
+					continue;
+
+				if(IsTriangleFlipped(positions[a], positions[b], positions[r0], positions[r1]))
+					return true;
+			}
+			return false;
+		}
+
+		struct CollapseState
+		{
+			std::vector<uint32_t> collapseRemap{};
+			// Positions touched this pass, on positions
+			std::vector<uint8_t> isLocked{};
+			std::vector<uint32_t> order{};
+		};
+
+		// Returns the number of edges collapsed, collapseRemap holds where every vertex went
+		size_t PerformEdgeCollapses(CollapseState& state, std::vector<Quadric>& quadrics, const std::vector<Collapse>& collapses, size_t triangleCollapseGoal,
+			const std::vector<uint32_t>& remap, const std::vector<uint32_t>& wedge, const std::vector<VertexKind>& kinds,
+			const std::vector<uint32_t>& loop, const std::vector<uint32_t>& loopback, const std::vector<Vector3>& positions, const EdgeAdjacency& adjacency, float& maxError)
+		{
+			std::vector<uint32_t>& order{ state.order };
+			order.resize(collapses.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+			{
+				return collapses[a].error < collapses[b].error || (collapses[a].error == collapses[b].error && a < b);
+			});
+
+			std::iota(state.collapseRemap.begin(), state.collapseRemap.end(), 0);
+			std::fill(state.isLocked.begin(), state.isLocked.end(), uint8_t{ 0 });
+
+			// Most collapses remove two triangles
+			const size_t edgeCollapseGoal{ std::max<size_t>(triangleCollapseGoal / 2, 1) };
+			const float errorLimit{ collapses[order[std::min(edgeCollapseGoal, order.size()) - 1]].error * PASS_ERROR_BOUND };
+
+			size_t edgeCollapses{ 0 };
+			size_t triangleCollapses{ 0 };
+			for(const uint32_t index : order)
+			{
+				const Collapse& collapse{ collapses[index] };
+				if(collapse.error > errorLimit || triangleCollapses >= triangleCollapseGoal)
+					break;
+
+				const uint32_t i0{ collapse.from };
+				const uint32_t i1{ collapse.to };
+				const uint32_t r0{ remap[i0] };
+				const uint32_t r1{ remap[i1] };
+				if(state.isLocked[r0] || state.isLocked[r1])
+					continue;
+				if(HasTriangleFlips(adjacency, positions, state.collapseRemap, remap, r0, r1))
+					continue;
+
+				if(kinds[i0] == VertexKind::Seam)
+				{
+					// The other side of the seam follows along its own loop
+					const uint32_t s0{ wedge[i0] };
+					const uint32_t s1{ loop[i0] == i1 ? loopback[s0] : loop[s0] };
+					if(s1 == NONE || remap[s1] != r1)
+						continue;
+
+					state.collapseRemap[i0] = i1;
+					state.collapseRemap[s0] = s1;
+				}
+				else
+				{
+					uint32_t vertex{ i0 };
+					do
+					{
+						state.collapseRemap[vertex] = i1;
+						vertex = wedge[vertex];
+					} while(vertex != i0);
+				}
+
+				state.isLocked[r0] = 1;
+				state.isLocked[r1] = 1;
+				quadrics[r1] += quadrics[r0];
+
+				triangleCollapses += kinds[i0] == VertexKind::Border ? 1 : 2;
+				++edgeCollapses;
+				maxError = std::max(maxError, collapse.error);
+			}
+			return edgeCollapses;
+		}
+#pragma endregion
+	}
+
+	namespace Utils
+	{
+		std::vector<uint32_t> SimplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t targetIndexCount, float* pError)
+		{
+			assert(indices.size() % 3 == 0);
+
+			std::vector<uint32_t> result(indices.begin(), indices.end());
+			float maxError{ 0.f };
+			if(pError)
+				*pError = 0.f;
+			if(result.size() <= targetIndexCount || vertices.empty())
+				return result;
+
+			// Errors are measured on the mesh scaled into a unit cube, float quadrics lose too much on large coordinates
+			Vector3 minimum{ vertices[0].position };
+			Vector3 maximum{ vertices[0].position };
+			for(const Vertex& vertex : vertices)
+			{
+				minimum = Vector3::Min(minimum, vertex.position);
+				maximum = Vector3::Max(maximum, vertex.position);
+			}
+			const Vector3 size{ maximum - minimum };
+			const float extent{ std::max({ size.x, size.y, size.z }) };
+			const float scale{ extent > 0.f ? 1.f / extent : 0.f };
+
+			const size_t vertexCount{ vertices.size() };
+			std::vector<Vector3> positions(vertexCount);
+			for(size_t i{ 0 }; i < vertexCount; ++i)
+				positions[i] = (vertices[i].position - minimum) * scale;
+
+			const std::vector<uint32_t> remap{ GeneratePositionRemap(vertices) };
+			const std::vector<uint32_t> wedge{ BuildWedges(remap) };
+
+			EdgeAdjacency adjacency{};
+			BuildAdjacency(adjacency, result, vertexCount, nullptr);
+
+			std::vector<VertexKind> kinds{};
+			std::vector<uint32_t> loop{};
+			std::vector<uint32_t> loopback{};
+			ClassifyVertices(kinds, loop, loopback, adjacency, remap, wedge);
+
+			std::vector<Quadric> quadrics(vertexCount);
+			FillFaceQuadrics(quadrics, result, positions, remap);
+			FillEdgeQuadrics(quadrics, result, positions, remap, kinds, loop, loopback);
+
+			std::vector<Collapse> collapses{};
+			CollapseState state{};
+			state.collapseRemap.resize(vertexCount);
+			state.isLocked.resize(vertexCount);
+
+			// Every pass collapses a batch of independent cheap edges, so the ranking only gets redone per pass
+			while(result.size() > targetIndexCount)
+			{
+				BuildAdjacency(adjacency, result, vertexCount, remap.data());
+
+				PickEdgeCollapses(collapses, result, remap, kinds, loop);
+				if(collapses.empty())
+					break;
+				RankEdgeCollapses(collapses, positions, quadrics, remap);
+
+				const size_t triangleCollapseGoal{ (result.size() - targetIndexCount + 2) / 3 };
+				if(PerformEdgeCollapses(state, quadrics, collapses, triangleCollapseGoal, remap, wedge, kinds, loop, loopback, positions, adjacency, maxError) == 0)
+					break;
+
+				RemapEdgeLoop(loop, state.collapseRemap);
+				RemapEdgeLoop(loopback, state.collapseRemap);
+
+				// Triangles that lost a corner to the collapses drop out
+				size_t writeIndex{ 0 };
+				for(size_t i{ 0 }; i + 2 < result.size(); i += 3)
+				{
+					const uint32_t a{ state.collapseRemap[result[i]] };
+					const uint32_t b{ state.collapseRemap[result[i + 1]] };
+					const uint32_t c{ state.collapseRemap[result[i + 2]] };
+					if(remap[a] == remap[b] || remap[a] == remap[c] || remap[b] == remap[c])
+						continue;
+
+					result[writeIndex++] = a;
+					result[writeIndex++] = b;
+					result[writeIndex++] = c;
+				}
+				result.resize(writeIndex);
+			}
+
+			if(pError)
+				*pError = std::sqrt(maxError) * extent;
+			return result;
+		}
+
+		std::vector<uint32_t> GeneratePositionRemap(std::span<const Vertex> vertices)
+		{
+			// Bit patterns, the importer writes the same floats for every vertex it builds from one position
+			const auto getKey = [&](uint32_t index)
+			{
+				const Vector3& position{ vertices[index].position };
+				return std::tuple{ std::bit_cast<uint32_t>(position.x), std::bit_cast<uint32_t>(position.y), std::bit_cast<uint32_t>(position.z) };
+			};
+
+			// Sorted by position, then by index so the first vertex of a position comes first
+			std::vector<uint32_t> order(vertices.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return std::tuple{ getKey(a), a } < std::tuple{ getKey(b), b }; });
+
+			std::vector<uint32_t> remap(vertices.size());
+			for(size_t first{ 0 }; first < order.size();)
+			{
+				size_t last{ first + 1 };
+				while(last < order.size() && getKey(order[last]) == getKey(order[first]))
+					++last;
+
+				for(size_t i{ first }; i < last; ++i)
+					remap[order[i]] = order[first];
+				first = last;
+			}
+			return remap;
+		}
+
+		std::vector<LodLevel> GenerateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices, std::span<const float> ratios, uint32_t threadCount)
+		{
+			std::vector<LodLevel> levels{ LodLevel{ 0, static_cast<uint32_t>(indices.size()), 0.f } };
+			if(ratios.empty())
+				return levels;
+
+			if(threadCount == 0)
+				threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+			// Every level is simplified from the full mesh so the levels do not depend on each other
+			const size_t triangleCount{ indices.size() / 3 };
+			std::vector<std::vector<uint32_t>> lodIndices(ratios.size());
+			std::vector<float> errors(ratios.size());
+			const auto simplify = [&](size_t level)
+			{
+				const float ratio{ std::clamp(ratios[level], 0.f, 1.f) };
+				const size_t targetIndexCount{ static_cast<size_t>(static_cast<float>(triangleCount) * ratio) * 3 };
+				lodIndices[level] = SimplifyMesh(vertices, indices, targetIndexCount, &errors[level]);
+				OptimizeVertexCache(lodIndices[level], vertices.size());
+			};
+
+			if(threadCount > 1 && ratios.size() > 1)
+			{
+				ThreadPool::GetShared().ParallelFor(ratios.size(), simplify);
+			}
+			else
+			{
+				for(size_t level{ 0 }; level < ratios.size(); ++level)
+					simplify(level);
+			}
+
+			for(size_t level{ 0 }; level < ratios.size(); ++level)
+			{
+				const float maxIndexCount{ static_cast<float>(levels.back().indexCount) * MAX_LOD_TRIANGLE_FRACTION };
+				if(lodIndices[level].empty() || static_cast<float>(lodIndices[level].size()) > maxIndexCount)
+					continue;
+
+				levels.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lodIndices[level].size()), errors[level] });
+				indices.insert(indices.end(), lodIndices[level].begin(), lodIndices[level].end());
+			}
+			return levels;
+		}
+	}
+}
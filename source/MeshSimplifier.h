@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Vertex.h"
+
+namespace dae
+{
+	// Index range of one detail level, all levels share the vertex buffer
+	struct LodLevel
+	{
+		uint32_t firstIndex{};
+		uint32_t indexCount{};
+		// Object space distance the level may be off from the full mesh, 0 for the full mesh
+		float error{};
+	};
+
+	namespace Utils
+	{
+		// Quadric error metric edge collapse. Vertices only collapse onto other existing vertices, so the result indexes
+		// the same vertex array. UV/normal seams (one position, two vertices) and open borders only collapse along
+		// themselves, positions with more than two vertices and broken topology are locked. Collapses that flip a
+		// triangle are skipped, so the target may not be reached.
+		// pError gets the geometric error in object units, the root of the worst mean squared plane distance.
+		std::vector<uint32_t> SimplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t targetIndexCount, float* pError = nullptr);
+
+		// The first vertex on the same position for every vertex, uv and normal seams split one position into several vertices
+		std::vector<uint32_t> GeneratePositionRemap(std::span<const Vertex> vertices);
+
+		// A level has to keep at most this much of the triangles of the level before it. When the simplifier gets stuck
+		// short of a ratio the next ratios land on about the same count, those near copies only add error.
+		constexpr float MAX_LOD_TRIANGLE_FRACTION{ 0.75f };
+
+		// Appends one simplified, cache optimized copy of indices for every ratio (of the triangle count, finest first)
+		// and returns the levels, level 0 is the input. Ratios that come out empty or do not get below MAX_LOD_TRIANGLE_FRACTION of the
+		// previous level are dropped, so there can be fewer levels than ratios.
+		// The levels are simplified in parallel (0 uses every hardware thread).
+		std::vector<LodLevel> GenerateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices, std::span<const float> ratios, uint32_t threadCount = 0);
+	}
+}
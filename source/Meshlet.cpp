@@ -0,0 +1,292 @@
+#include "pch.h"
+
+#include "Meshlet.h"
+#include "Frustum.h"
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t NONE{ UINT32_MAX };
+		// Below this the normals spread over almost a half sphere and the cone would never cull anything
+		constexpr float MIN_CONE_DOT{ 0.1f };
+		// Weight of facing away from the meshlet's average normal against one extra vertex
+		constexpr float NORMAL_SCORE_WEIGHT{ 0.5f };
+		// A meshlet that ran out of connected triangles continues on an unused one within this many times its radius.
+		// Only the triangles from the first unused one on are searched, in index order cache optimized ones are close by.
+		constexpr float JOIN_RADIUS_SCALE{ 2.f };
+		constexpr size_t JOIN_SEARCH_TRIANGLES{ 1024 };
+
+		Vector3 GetTriangleNormal(std::span<const Vertex> vertices, const uint32_t* pTriangle)
+		{
+			const Vector3& p0{ vertices[pTriangle[0]].position };
+			const Vector3 normal{ Vector3::Cross(vertices[pTriangle[1]].position - p0, vertices[pTriangle[2]].position - p0) };
+			const float length{ normal.Magnitude() };
+			return length > 0.f ? normal / length : Vector3::Zero;
+		}
+
+		MeshletBounds ComputeBounds(std::span<const Vertex> vertices, const MeshletMesh& meshletMesh, const Meshlet& meshlet, std::span<const Vector3> triangleNormals)
+		{
+			MeshletBounds bounds{};
+			const std::span<const uint32_t> meshletVertices{ meshletMesh.vertices.data() + meshlet.vertexOffset, meshlet.vertexCount };
+
+			// Box center, close enough to the smallest sphere for a few dozen vertices
+			Vector3 boundsMin{ vertices[meshletVertices.front()].position };
+			Vector3 boundsMax{ boundsMin };
+			for(const uint32_t vertex : meshletVertices)
+			{
+				boundsMin = Vector3::Min(boundsMin, vertices[vertex].position);
+				boundsMax = Vector3::Max(boundsMax, vertices[vertex].position);
+			}
+			bounds.center = (boundsMin + boundsMax) * 0.5f;
+			for(const uint32_t vertex : meshletVertices)
+				bounds.radius = std::max(bounds.radius, (vertices[vertex].position - bounds.center).Magnitude());
+
+			Vector3 axis{};
+			for(const Vector3& normal : triangleNormals)
+				axis += normal;
+			const float axisLength{ axis.Magnitude() };
+			if(axisLength <= 0.f)
+				return bounds;
+			axis /= axisLength;
+
+			float minDot{ 1.f };
+			for(const Vector3& normal : triangleNormals)
+				minDot = std::min(minDot, Vector3::Dot(normal, axis));
+			if(minDot <= MIN_CONE_DOT)
+				return bounds;
+
+			bounds.coneAxis = axis;
+			bounds.coneCutoff = std::sqrt(1.f - minDot * minDot);
+			return bounds;
+		}
+	}
+
+	namespace Utils
+	{
+		MeshletMesh BuildMeshlets(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t maxVertices, size_t maxTriangles, float minNormalDot,
+			size_t minConeTriangles)
+		{
+			assert(maxVertices >= 3 && maxVertices <= 256 && maxTriangles >= 1);
+
+			const size_t triangleCount{ indices.size() / 3 };
+			MeshletMesh meshletMesh{};
+			if(triangleCount == 0)
+				return meshletMesh;
+
+			// Triangles around every position, meshlets grow across uv and normal seams too
+			const std::vector<uint32_t> remap{ GeneratePositionRemap(vertices) };
+			std::vector<uint32_t> offsets(vertices.size() + 1, 0);
+			for(const uint32_t index : indices)
+				++offsets[remap[index] + 1];
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+			std::vector<uint32_t> positionTriangles(indices.size());
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for(size_t i{ 0 }; i < triangleCount * 3; ++i)
+				positionTriangles[fill[remap[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+
+			std::vector<Vector3> normals(triangleCount);
+			std::vector<Vector3> centroids(triangleCount);
+			for(size_t triangle{ 0 }; triangle < triangleCount; ++triangle)
+			{
+				const uint32_t* pTriangle{ &indices[triangle * 3] };
+				normals[triangle] = GetTriangleNormal(vertices, pTriangle);
+				centroids[triangle] = (vertices[pTriangle[0]].position + vertices[pTriangle[1]].position + vertices[pTriangle[2]].position) / 3.f;
+			}
+
+			std::vector<uint8_t> isUsed(triangleCount, 0);
+			// Index in the current meshlet, NONE when the vertex is not in it
+			std::vector<uint32_t> localIndices(vertices.size(), NONE);
+
+			Meshlet meshlet{};
+			Vector3 normalSum{};
+			Vector3 centroidSum{};
+			Vector3 meshletMin{};
+			Vector3 meshletMax{};
+			std::vector<Vector3> meshletNormals{};
+
+			const auto getNewVertexCount = [&](uint32_t triangle)
+			{
+				const uint32_t* pTriangle{ &indices[triangle * 3] };
+				return static_cast<uint32_t>(localIndices[pTriangle[0]] == NONE)
+					+ static_cast<uint32_t>(localIndices[pTriangle[1]] == NONE && pTriangle[1] != pTriangle[0])
+					+ static_cast<uint32_t>(localIndices[pTriangle[2]] == NONE && pTriangle[2] != pTriangle[0] && pTriangle[2] != pTriangle[1]);
+			};
+
+			const auto finishMeshlet = [&]
+			{
+				if(meshlet.triangleCount == 0)
+					return;
+
+				for(uint32_t i{ 0 }; i < meshlet.vertexCount; ++i)
+					localIndices[meshletMesh.vertices[meshlet.vertexOffset + i]] = NONE;
+
+				meshletMesh.bounds.push_back(ComputeBounds(vertices, meshletMesh, meshlet, meshletNormals));
+				meshletMesh.meshlets.push_back(meshlet);
+
+				meshlet = {};
+				meshlet.vertexOffset = static_cast<uint32_t>(meshletMesh.vertices.size());
+				meshlet.triangleOffset = static_cast<uint32_t>(meshletMesh.triangles.size() / 3);
+				normalSum = {};
+				centroidSum = {};
+				meshletNormals.clear();
+			};
+
+			size_t nextSeed{ 0 };
+			const auto skipUsedSeeds = [&]
+			{
+				while(nextSeed < triangleCount && isUsed[nextSeed])
+					++nextSeed;
+			};
+
+			while(true)
+			{
+				// The normals only count once the meshlet has its minimum size, before that it just grows
+				const bool isConeShaping{ meshlet.triangleCount >= minConeTriangles };
+				const float normalSumLength{ normalSum.Magnitude() };
+				const Vector3 averageNormal{ normalSumLength > 0.f ? normalSum / normalSumLength : Vector3::Zero };
+
+				// Best unused triangle around the meshlet's vertices that still fits
+				uint32_t best{ NONE };
+				float bestScore{ FLT_MAX };
+				bool hasNeighbours{ false };
+				for(uint32_t i{ 0 }; i < meshlet.vertexCount; ++i)
+				{
+					const uint32_t position{ remap[meshletMesh.vertices[meshlet.vertexOffset + i]] };
+					for(uint32_t t{ offsets[position] }; t < offsets[position + 1]; ++t)
+					{
+						const uint32_t triangle{ positionTriangles[t] };
+						if(isUsed[triangle])
+							continue;
+
+						hasNeighbours = true;
+						const uint32_t newVertexCount{ getNewVertexCount(triangle) };
+						if(meshlet.vertexCount + newVertexCount > maxVertices)
+							continue;
+
+						const float normalDot{ Vector3::Dot(normals[triangle], averageNormal) };
+						if(isConeShaping && normalDot < minNormalDot)
+							continue;
+
+						const float score{ static_cast<float>(newVertexCount) + (isConeShaping ? (1.f - normalDot) * NORMAL_SCORE_WEIGHT : 0.f) };
+						if(score < bestScore || (score == bestScore && triangle < best))
+						{
+							best = triangle;
+							bestScore = score;
+						}
+					}
+				}
+
+				// The part the meshlet grew over is used up but there is room left: continue on the closest unused
+				// triangle. Small separate parts (bolts, trims) would otherwise each get a meshlet of their own.
+				if(best == NONE && !hasNeighbours && meshlet.triangleCount > 0 && meshlet.vertexCount + 3 <= maxVertices)
+				{
+					const Vector3 center{ centroidSum / static_cast<float>(meshlet.triangleCount) };
+					float bestSqrDistance{ FLT_MAX };
+					skipUsedSeeds();
+					for(uint32_t triangle{ static_cast<uint32_t>(nextSeed) }; triangle < std::min(triangleCount, nextSeed + JOIN_SEARCH_TRIANGLES); ++triangle)
+					{
+						if(isUsed[triangle] || (isConeShaping && Vector3::Dot(normals[triangle], averageNormal) < minNormalDot))
+							continue;
+
+						const float sqrDistance{ (centroids[triangle] - center).SqrMagnitude() };
+						if(sqrDistance < bestSqrDistance)
+						{
+							best = triangle;
+							bestSqrDistance = sqrDistance;
+						}
+					}
+					const float joinRadius{ (meshletMax - meshletMin).Magnitude() * 0.5f * JOIN_RADIUS_SCALE };
+					if(bestSqrDistance > joinRadius * joinRadius)
+						best = NONE;
+				}
+
+				// Nothing fits, start the next meshlet from the first unused triangle
+				if(best == NONE)
+				{
+					finishMeshlet();
+					skipUsedSeeds();
+					if(nextSeed == triangleCount)
+						break;
+					best = static_cast<uint32_t>(nextSeed);
+				}
+
+				isUsed[best] = 1;
+				if(meshlet.triangleCount == 0)
+					meshletMin = meshletMax = vertices[indices[best * 3]].position;
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					const uint32_t vertex{ indices[best * 3 + corner] };
+					if(localIndices[vertex] == NONE)
+					{
+						localIndices[vertex] = meshlet.vertexCount++;
+						meshletMesh.vertices.push_back(vertex);
+						meshletMin = Vector3::Min(meshletMin, vertices[vertex].position);
+						meshletMax = Vector3::Max(meshletMax, vertices[vertex].position);
+					}
+					meshletMesh.triangles.push_back(static_cast<uint8_t>(localIndices[vertex]));
+				}
+				++meshlet.triangleCount;
+				normalSum += normals[best];
+				centroidSum += centroids[best];
+				meshletNormals.push_back(normals[best]);
+
+				if(meshlet.triangleCount == maxTriangles)
+					finishMeshlet();
+			}
+			return meshletMesh;
+		}
+
+		std::vector<uint32_t> GetMeshletIndices(const MeshletMesh& meshletMesh)
+		{
+			std::vector<uint32_t> indices(meshletMesh.triangles.size());
+			for(const Meshlet& meshlet : meshletMesh.meshlets)
+			{
+				for(uint32_t i{ meshlet.triangleOffset * 3 }; i < (meshlet.triangleOffset + meshlet.triangleCount) * 3; ++i)
+					indices[i] = meshletMesh.vertices[meshlet.vertexOffset + meshletMesh.triangles[i]];
+			}
+			return indices;
+		}
+
+		MeshletCullStats CullMeshlets(const MeshletMesh& meshletMesh, const Matrix& worldViewProjection, const Vector3& cameraPosition,
+			std::vector<uint32_t>& visibleMeshlets, bool cullBackfaces)
+		{
+			// Planes in object space, straight from the world view projection
+			const Frustum frustum{ Frustum::FromViewProjection(worldViewProjection) };
+
+			MeshletCullStats stats{};
+			stats.meshlets = meshletMesh.meshlets.size();
+			for(uint32_t index{ 0 }; index < static_cast<uint32_t>(meshletMesh.meshlets.size()); ++index)
+			{
+				const MeshletBounds& bounds{ meshletMesh.bounds[index] };
+				const uint32_t triangleCount{ meshletMesh.meshlets[index].triangleCount };
+				stats.triangles += triangleCount;
+
+				if(!frustum.IsVisible(bounds.center, { bounds.radius, bounds.radius, bounds.radius }, bounds.radius))
+				{
+					++stats.frustumCulledMeshlets;
+					stats.culledTriangles += triangleCount;
+					continue;
+				}
+
+				const Vector3 toCenter{ bounds.center - cameraPosition };
+				if(cullBackfaces && Vector3::Dot(toCenter, bounds.coneAxis) >= bounds.coneCutoff * toCenter.Magnitude() + bounds.radius)
+				{
+					++stats.backfaceCulledMeshlets;
+					stats.culledTriangles += triangleCount;
+					continue;
+				}
+
+				visibleMeshlets.push_back(index);
+			}
+			return stats;
+		}
+	}
+}
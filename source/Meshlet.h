@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Matrix.h"
+#include "Vertex.h"
+
+namespace dae
+{
+	// A few neighbouring triangles that are culled as a whole
+	struct Meshlet
+	{
+		// Into MeshletMesh::vertices and MeshletMesh::triangles (counted in triangles)
+		uint32_t vertexOffset{};
+		uint32_t triangleOffset{};
+		uint32_t vertexCount{};
+		uint32_t triangleCount{};
+	};
+
+	struct MeshletBounds
+	{
+		Vector3 center{};
+		float radius{};
+		// Every triangle normal is within the cone around the axis. Seen from a point p every triangle faces away when
+		// dot(center - p, coneAxis) >= coneCutoff * |center - p| + radius. A cutoff of 1 never passes.
+		Vector3 coneAxis{};
+		float coneCutoff{ 1.f };
+	};
+
+	struct MeshletMesh
+	{
+		std::vector<Meshlet> meshlets{};
+		std::vector<MeshletBounds> bounds{};
+		// Mesh vertex of every meshlet vertex
+		std::vector<uint32_t> vertices{};
+		// Three indices into the meshlet's vertices per triangle
+		std::vector<uint8_t> triangles{};
+	};
+
+	struct MeshletCullStats
+	{
+		size_t meshlets{};
+		size_t triangles{};
+		size_t frustumCulledMeshlets{};
+		size_t backfaceCulledMeshlets{};
+		size_t culledTriangles{};
+
+		void Add(const MeshletCullStats& stats)
+		{
+			meshlets += stats.meshlets;
+			triangles += stats.triangles;
+			frustumCulledMeshlets += stats.frustumCulledMeshlets;
+			backfaceCulledMeshlets += stats.backfaceCulledMeshlets;
+			culledTriangles += stats.culledTriangles;
+		}
+
+		float GetCulledTriangleRatio() const
+		{
+			return triangles > 0 ? static_cast<float>(culledTriangles) / static_cast<float>(triangles) : 0.f;
+		}
+	};
+
+	namespace Utils
+	{
+		// Sizes that fill a mesh shader thread group and keep local indices in a byte
+		constexpr size_t MAX_MESHLET_VERTICES{ 64 };
+		constexpr size_t MAX_MESHLET_TRIANGLES{ 124 };
+
+		// Below this many triangles a meshlet grows without looking at its normals. On the vehicle (minNormalDot 0.3), 32 gives
+		// 306 meshlets of 38 triangles but back face culls only about 2% of the triangles from the renderer's distance, 0 culls
+		// 14-18% with 844 meshlets of 14. 8 keeps most of that: 6-8% culled, 542 meshlets of 21 triangles.
+		constexpr size_t MIN_MESHLET_CONE_TRIANGLES{ 8 };
+
+		// Grows every meshlet from a seed triangle over shared positions, preferring triangles that add no vertices.
+		// When the connected triangles run out it continues on the closest unused one nearby, so small separate parts
+		// share meshlets. From minConeTriangles on it also prefers triangles facing the same way as the meshlet so far,
+		// and leaves triangles facing further than minNormalDot from its average normal for another meshlet.
+		// The minimum keeps the meshlets filled, minConeTriangles 0 with a high minNormalDot gives small meshlets with
+		// narrow cones that back face cull more often. Works best on cache optimized indices.
+		MeshletMesh BuildMeshlets(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t maxVertices = MAX_MESHLET_VERTICES,
+			size_t maxTriangles = MAX_MESHLET_TRIANGLES, float minNormalDot = 0.3f, size_t minConeTriangles = MIN_MESHLET_CONE_TRIANGLES);
+
+		// The meshlet triangles as mesh indices, meshlet m is the range [3 * triangleOffset, 3 * (triangleOffset + triangleCount))
+		std::vector<uint32_t> GetMeshletIndices(const MeshletMesh& meshletMesh);
+
+		// Appends the meshlets that may be visible to visibleMeshlets. worldViewProjection is the world matrix times the
+		// Camera view and projection, cameraPosition is in object space. Two sided materials turn the backface test off.
+		MeshletCullStats CullMeshlets(const MeshletMesh& meshletMesh, const Matrix& worldViewProjection, const Vector3& cameraPosition,
+			std::vector<uint32_t>& visibleMeshlets, bool cullBackfaces = true);
+	}
+}
@@ -0,0 +1,764 @@
+#include "pch.h"
+
+#include "ObjParser.h"
+#include "MathHelpers.h"
+#include "TangentSpace.h"
+#include "ThreadPool.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define DAE_OBJ_SIMD 1
+#include <immintrin.h>
+#else
+#define DAE_OBJ_SIMD 0
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		// Next '\n' in [p, end), or end
+		const char* FindNewline(const char* p, const char* end)
+		{
+#if DAE_OBJ_SIMD
+			const __m128i newline = _mm_set1_epi8('\n');
+			while(end - p >= 16)
+			{
+				const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const uint32_t mask{ static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline))) };
+				if(mask != 0)
+					return p + std::countr_zero(mask);
+				p += 16;
+			}
+#endif
+			while(p < end && *p != '\n')
+				++p;
+			return p;
+		}
+
+		// Calls lineFunction(begin, end) for every line, without the line break
+		template<typename LineFunction>
+		bool ForEachLine(std::string_view text, LineFunction lineFunction)
+		{
+			const char* p{ text.data() };
+			const char* const end{ text.data() + text.size() };
+			while(p < end)
+			{
+				const char* lineEnd{ FindNewline(p, end) };
+				const char* next{ lineEnd < end ? lineEnd + 1 : end };
+				if(lineEnd > p && lineEnd[-1] == '\r')
+					--lineEnd;
+
+				if(!lineFunction(p, lineEnd))
+					return false;
+
+				p = next;
+			}
+			return true;
+		}
+
+		inline const char* SkipSpaces(const char* p, const char* end)
+		{
+			while(p < end && (*p == ' ' || *p == '\t'))
+				++p;
+			return p;
+		}
+
+		enum class LineType
+		{
+			Other,
+			Position,
+			TexCoord,
+			Normal,
+			Face
+		};
+
+		// Classifies the line and moves begin past the keyword
+		LineType GetLineType(const char*& begin, const char* end)
+		{
+			const char* p{ SkipSpaces(begin, end) };
+			const auto isSeparator = [&](const char* c) { return c >= end || *c == ' ' || *c == '\t'; };
+
+			LineType type{ LineType::Other };
+			if(p < end && p[0] == 'v')
+			{
+				if(isSeparator(p + 1))
+				{
+					type = LineType::Position;
+					p += 1;
+				}
+				else if(p[1] == 't' && isSeparator(p + 2))
+				{
+					type = LineType::TexCoord;
+					p += 2;
+				}
+				else if(p[1] == 'n' && isSeparator(p + 2))
+				{
+					type = LineType::Normal;
+					p += 2;
+				}
+			}
+			else if(p < end && p[0] == 'f' && isSeparator(p + 1))
+			{
+				type = LineType::Face;
+				p += 1;
+			}
+
+			begin = p;
+			return type;
+		}
+
+		bool ParseFloat(const char*& p, const char* end, float& value)
+		{
+			p = SkipSpaces(p, end);
+			if(p < end && *p == '+')
+				++p;
+
+			const std::from_chars_result result{ std::from_chars(p, end, value) };
+			if(result.ec != std::errc{})
+				return false;
+
+			p = result.ptr;
+			return true;
+		}
+
+		bool ParseInt(const char*& p, const char* end, int64_t& value)
+		{
+			const std::from_chars_result result{ std::from_chars(p, end, value) };
+			if(result.ec != std::errc{})
+				return false;
+
+			p = result.ptr;
+			return true;
+		}
+
+		// 1-based, negative indices count back from the last element
+		bool ResolveIndex(int64_t index, size_t count, size_t& resolved)
+		{
+			if(index > 0 && static_cast<size_t>(index) <= count)
+			{
+				resolved = static_cast<size_t>(index - 1);
+				return true;
+			}
+			if(index < 0 && static_cast<size_t>(-index) <= count)
+			{
+				resolved = count - static_cast<size_t>(-index);
+				return true;
+			}
+			return false;
+		}
+
+		bool ParseVector3(const char*& p, const char* end, Vector3& vector)
+		{
+			return ParseFloat(p, end, vector.x) && ParseFloat(p, end, vector.y) && ParseFloat(p, end, vector.z);
+		}
+
+		// v is flipped, OBJ has it pointing up
+		bool ParseTexCoord(const char*& p, const char* end, Vector2& uv)
+		{
+			float u, v;
+			if(!ParseFloat(p, end, u) || !ParseFloat(p, end, v))
+				return false;
+
+			uv = Vector2(u, 1 - v);
+			return true;
+		}
+
+		// Resolved attribute indices of one face corner, NO_INDEX for a missing uv or normal
+		struct FaceCorner
+		{
+			uint32_t position{};
+			uint32_t uv{ NO_INDEX };
+			uint32_t normal{ NO_INDEX };
+
+			static constexpr uint32_t NO_INDEX{ UINT32_MAX };
+
+			bool operator==(const FaceCorner&) const = default;
+		};
+
+		// position[/[uv][/normal]]
+		bool ParseFaceCorner(const char*& p, const char* end, size_t positionCount, size_t uvCount, size_t normalCount, FaceCorner& corner)
+		{
+			int64_t index{};
+			size_t resolved{};
+
+			if(!ParseInt(p, end, index) || !ResolveIndex(index, positionCount, resolved))
+				return false;
+			corner.position = static_cast<uint32_t>(resolved);
+
+			if(p < end && *p == '/')
+			{
+				++p;
+				if(p < end && *p != '/')
+				{
+					// Optional texture coordinate
+					if(!ParseInt(p, end, index) || !ResolveIndex(index, uvCount, resolved))
+						return false;
+					corner.uv = static_cast<uint32_t>(resolved);
+				}
+
+				if(p < end && *p == '/')
+				{
+					++p;
+
+					// Optional vertex normal
+					if(!ParseInt(p, end, index) || !ResolveIndex(index, normalCount, resolved))
+						return false;
+					corner.normal = static_cast<uint32_t>(resolved);
+				}
+			}
+			return true;
+		}
+
+		Vertex MakeVertex(const FaceCorner& corner, const std::vector<Vector3>& positions, const std::vector<Vector2>& UVs, const std::vector<Vector3>& normals)
+		{
+			Vertex vertex{};
+			vertex.position = positions[corner.position];
+			if(corner.uv != FaceCorner::NO_INDEX)
+				vertex.uv = UVs[corner.uv];
+			if(corner.normal != FaceCorner::NO_INDEX)
+				vertex.normal = normals[corner.normal];
+			return vertex;
+		}
+
+		// Fan triangulation: (first, previous, current) for every corner after the second
+		std::array<uint32_t, 3> GetFanTriangle(uint32_t first, uint32_t previous, uint32_t current, bool flipWinding)
+		{
+			if(flipWinding)
+				return { first, current, previous };
+			return { first, previous, current };
+		}
+
+		// Open addressing (linear probing) map from a face corner to the vertex made for it
+		class CornerWeldTable final
+		{
+		public:
+			explicit CornerWeldTable(size_t expectedCorners)
+			{
+				// Most corners share their triple with a neighbour, the corner count is a safe upper bound
+				Rehash(std::bit_ceil(std::max<size_t>(expectedCorners * 2, 64)));
+			}
+
+			// Vertex already made for this corner, or newVertex after remembering it
+			uint32_t FindOrInsert(const FaceCorner& corner, uint32_t newVertex)
+			{
+				if((m_Count + 1) * 2 > m_Vertices.size())
+					Rehash(m_Vertices.size() * 2);
+
+				size_t slot{ Hash(corner) & m_Mask };
+				while(m_Vertices[slot] != EMPTY)
+				{
+					if(m_Corners[slot] == corner)
+						return m_Vertices[slot];
+					slot = (slot + 1) & m_Mask;
+				}
+
+				m_Corners[slot] = corner;
+				m_Vertices[slot] = newVertex;
+				++m_Count;
+				return newVertex;
+			}
+
+		private:
+			static constexpr uint32_t EMPTY{ UINT32_MAX };
+
+			std::vector<FaceCorner> m_Corners{};
+			std::vector<uint32_t> m_Vertices{};
+			size_t m_Mask{};
+			size_t m_Count{};
+
+			static size_t Hash(const FaceCorner& corner)
+			{
+				uint64_t h{ corner.position * 0x9E3779B97F4A7C15ull };
+				h ^= (corner.uv + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+				h ^= (corner.normal + 0x165667B19E3779F9ull) * 0x85EBCA77C2B2AE63ull;
+				return static_cast<size_t>(h ^ (h >> 29));
+			}
+
+			void Rehash(size_t capacity)
+			{
+				std::vector<FaceCorner> corners(capacity);
+				std::vector<uint32_t> vertices(capacity, EMPTY);
+				m_Corners.swap(corners);
+				m_Vertices.swap(vertices);
+				m_Mask = capacity - 1;
+				m_Count = 0;
+
+				for(size_t i{ 0 }; i < vertices.size(); ++i)
+				{
+					if(vertices[i] != EMPTY)
+						FindOrInsert(corners[i], vertices[i]);
+				}
+			}
+		};
+
+#pragma region Sequential
+		bool ParseSequential(std::string_view text, const Utils::ObjImportOptions& options, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, size_t& cornerCount)
+		{
+			// Counting pass so nothing reallocates while parsing
+			size_t positionCount{}, texCoordCount{}, normalCount{}, faceCount{};
+			ForEachLine(text, [&](const char* begin, const char* end)
+			{
+				switch(GetLineType(begin, end))
+				{
+				case LineType::Position: ++positionCount; break;
+				case LineType::TexCoord: ++texCoordCount; break;
+				case LineType::Normal: ++normalCount; break;
+				case LineType::Face: ++faceCount; break;
+				default: break;
+				}
+				return true;
+			});
+
+			std::vector<Vector3> positions{};
+			std::vector<Vector3> normals{};
+			std::vector<Vector2> UVs{};
+			positions.reserve(positionCount);
+			normals.reserve(normalCount);
+			UVs.reserve(texCoordCount);
+			// Exact for triangle meshes, polygons grow past it. Welding only makes fewer vertices.
+			vertices.reserve(faceCount * 3);
+			indices.reserve(faceCount * 3);
+
+			std::optional<CornerWeldTable> weldTable{};
+			if(options.weldVertices)
+				weldTable.emplace(faceCount * 3);
+
+			return ForEachLine(text, [&](const char* p, const char* end)
+			{
+				switch(GetLineType(p, end))
+				{
+				case LineType::Position:
+					return ParseVector3(p, end, positions.emplace_back());
+				case LineType::TexCoord:
+					return ParseTexCoord(p, end, UVs.emplace_back());
+				case LineType::Normal:
+					return ParseVector3(p, end, normals.emplace_back());
+				case LineType::Face:
+				{
+					uint32_t first{}, previous{};
+					int corner{ 0 };
+					for(p = SkipSpaces(p, end); p < end; p = SkipSpaces(p, end), ++corner)
+					{
+						FaceCorner faceCorner{};
+						if(!ParseFaceCorner(p, end, positions.size(), UVs.size(), normals.size(), faceCorner))
+							return false;
+						++cornerCount;
+
+						// Corners with the same position/uv/normal triple share one vertex
+						const uint32_t newIndex{ static_cast<uint32_t>(vertices.size()) };
+						const uint32_t index{ weldTable ? weldTable->FindOrInsert(faceCorner, newIndex) : newIndex };
+						if(index == newIndex)
+							vertices.push_back(MakeVertex(faceCorner, positions, UVs, normals));
+
+						if(corner == 0)
+							first = index;
+						else if(corner >= 2)
+						{
+							const std::array<uint32_t, 3> triangle{ GetFanTriangle(first, previous, index, options.flipAxisAndWinding) };
+							indices.insert(indices.end(), triangle.begin(), triangle.end());
+						}
+						previous = index;
+					}
+					return corner >= 3;
+				}
+				default:
+					return true;
+				}
+			});
+		}
+#pragma endregion
+
+#pragma region Parallel
+		// Below this a chunk is not worth a task
+		constexpr size_t MIN_CHUNK_SIZE{ 1 << 20 };
+		// A few chunks per thread, faces are slower to parse than attributes
+		constexpr size_t CHUNKS_PER_THREAD{ 4 };
+
+		// Whole lines of the file, parsed on their own and merged in file order
+		struct ObjChunk
+		{
+			std::string_view text{};
+
+			size_t positionCount{}, texCoordCount{}, normalCount{}, faceCount{};
+			// Attributes in the chunks before this one
+			size_t positionOffset{}, texCoordOffset{}, normalOffset{};
+
+			// Corner count of every face
+			std::vector<uint32_t> faceSizes{};
+			// Local vertex of every face corner
+			std::vector<uint32_t> cornerVertices{};
+			// Face corner of every local vertex, in order of first use
+			std::vector<FaceCorner> vertexCorners{};
+			size_t triangleCount{};
+			bool isParsed{};
+
+			// Local vertex to vertex in the merged mesh, only used when welding
+			std::vector<uint32_t> mergedVertices{};
+			// Merged vertices that first appear in this chunk are [firstNewVertex, endNewVertex)
+			size_t firstNewVertex{}, endNewVertex{};
+			size_t indexOffset{};
+		};
+
+		std::vector<ObjChunk> SplitIntoChunks(std::string_view text, size_t chunkCount)
+		{
+			std::vector<ObjChunk> chunks{};
+			chunks.reserve(chunkCount);
+
+			const char* begin{ text.data() };
+			const char* const end{ text.data() + text.size() };
+			for(size_t i{ 1 }; i <= chunkCount && begin < end; ++i)
+			{
+				// Move the split past the next line break
+				const char* split{ i == chunkCount ? end : std::max(begin, text.data() + text.size() * i / chunkCount) };
+				split = FindNewline(split, end);
+				split = split < end ? split + 1 : end;
+
+				chunks.emplace_back().text = std::string_view{ begin, static_cast<size_t>(split - begin) };
+				begin = split;
+			}
+			return chunks;
+		}
+
+		void CountChunkLines(ObjChunk& chunk)
+		{
+			ForEachLine(chunk.text, [&](const char* begin, const char* end)
+			{
+				switch(GetLineType(begin, end))
+				{
+				case LineType::Position: ++chunk.positionCount; break;
+				case LineType::TexCoord: ++chunk.texCoordCount; break;
+				case LineType::Normal: ++chunk.normalCount; break;
+				case LineType::Face: ++chunk.faceCount; break;
+				default: break;
+				}
+				return true;
+			});
+		}
+
+		// Attributes go straight to their place in the shared arrays, faces are indexed against the attributes
+		// read so far in the whole file, like the sequential parse does
+		void ParseChunk(ObjChunk& chunk, bool weldVertices, std::vector<Vector3>& positions, std::vector<Vector2>& UVs, std::vector<Vector3>& normals)
+		{
+			size_t positionCount{ chunk.positionOffset }, texCoordCount{ chunk.texCoordOffset }, normalCount{ chunk.normalOffset };
+
+			chunk.faceSizes.reserve(chunk.faceCount);
+			chunk.cornerVertices.reserve(chunk.faceCount * 3);
+			chunk.vertexCorners.reserve(chunk.faceCount * 3);
+
+			std::optional<CornerWeldTable> weldTable{};
+			if(weldVertices)
+				weldTable.emplace(chunk.faceCount * 3);
+
+			chunk.isParsed = ForEachLine(chunk.text, [&](const char* p, const char* end)
+			{
+				switch(GetLineType(p, end))
+				{
+				case LineType::Position:
+					return ParseVector3(p, end, positions[positionCount++]);
+				case LineType::TexCoord:
+					return ParseTexCoord(p, end, UVs[texCoordCount++]);
+				case LineType::Normal:
+					return ParseVector3(p, end, normals[normalCount++]);
+				case LineType::Face:
+				{
+					uint32_t corner{ 0 };
+					for(p = SkipSpaces(p, end); p < end; p = SkipSpaces(p, end), ++corner)
+					{
+						FaceCorner faceCorner{};
+						if(!ParseFaceCorner(p, end, positionCount, texCoordCount, normalCount, faceCorner))
+							return false;
+
+						const uint32_t newIndex{ static_cast<uint32_t>(chunk.vertexCorners.size()) };
+						const uint32_t index{ weldTable ? weldTable->FindOrInsert(faceCorner, newIndex) : newIndex };
+						if(index == newIndex)
+							chunk.vertexCorners.push_back(faceCorner);
+						chunk.cornerVertices.push_back(index);
+					}
+					if(corner < 3)
+						return false;
+
+					chunk.faceSizes.push_back(corner);
+					chunk.triangleCount += corner - 2;
+					return true;
+				}
+				default:
+					return true;
+				}
+			});
+		}
+
+		void WriteChunkMesh(const ObjChunk& chunk, bool weldVertices, bool flipWinding, const std::vector<Vector3>& positions, const std::vector<Vector2>& UVs, const std::vector<Vector3>& normals, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			const auto getMergedVertex = [&](uint32_t localVertex)
+			{
+				return weldVertices ? chunk.mergedVertices[localVertex] : static_cast<uint32_t>(chunk.firstNewVertex + localVertex);
+			};
+
+			for(uint32_t localVertex{ 0 }; localVertex < chunk.vertexCorners.size(); ++localVertex)
+			{
+				// Vertices shared with an earlier chunk are written by that chunk
+				const uint32_t mergedVertex{ getMergedVertex(localVertex) };
+				if(mergedVertex >= chunk.firstNewVertex && mergedVertex < chunk.endNewVertex)
+					vertices[mergedVertex] = MakeVertex(chunk.vertexCorners[localVertex], positions, UVs, normals);
+			}
+
+			uint32_t* pIndex{ indices.data() + chunk.indexOffset };
+			const uint32_t* pCorner{ chunk.cornerVertices.data() };
+			for(const uint32_t faceSize : chunk.faceSizes)
+			{
+				const uint32_t first{ getMergedVertex(pCorner[0]) };
+				uint32_t previous{ getMergedVertex(pCorner[1]) };
+				for(uint32_t corner{ 2 }; corner < faceSize; ++corner)
+				{
+					const uint32_t current{ getMergedVertex(pCorner[corner]) };
+					const std::array<uint32_t, 3> triangle{ GetFanTriangle(first, previous, current, flipWinding) };
+					pIndex = std::copy(triangle.begin(), triangle.end(), pIndex);
+					previous = current;
+				}
+				pCorner += faceSize;
+			}
+		}
+
+		// Same output as ParseSequential, bit for bit
+		bool ParseParallel(std::string_view text, const Utils::ObjImportOptions& options, ThreadPool& pool, size_t chunkCount, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, size_t& cornerCount)
+		{
+			std::vector<ObjChunk> chunks{ SplitIntoChunks(text, chunkCount) };
+			pool.ParallelFor(chunks.size(), [&](size_t i) { CountChunkLines(chunks[i]); });
+
+			// Prefix sums give every chunk its place in the attribute arrays
+			size_t positionCount{}, texCoordCount{}, normalCount{};
+			for(ObjChunk& chunk : chunks)
+			{
+				chunk.positionOffset = positionCount;
+				chunk.texCoordOffset = texCoordCount;
+				chunk.normalOffset = normalCount;
+				positionCount += chunk.positionCount;
+				texCoordCount += chunk.texCoordCount;
+				normalCount += chunk.normalCount;
+			}
+
+			std::vector<Vector3> positions(positionCount);
+			std::vector<Vector2> UVs(texCoordCount);
+			std::vector<Vector3> normals(normalCount);
+			pool.ParallelFor(chunks.size(), [&](size_t i) { ParseChunk(chunks[i], options.weldVertices, positions, UVs, normals); });
+
+			if(std::any_of(chunks.begin(), chunks.end(), [](const ObjChunk& chunk) { return !chunk.isParsed; }))
+				return false;
+
+			// Merged in file order, so vertices are numbered by first use just like the sequential parse.
+			// Only the chunk local vertices go through the shared weld table.
+			size_t vertexCount{}, indexCount{};
+			std::optional<CornerWeldTable> weldTable{};
+			if(options.weldVertices)
+			{
+				size_t localVertexCount{};
+				for(const ObjChunk& chunk : chunks)
+					localVertexCount += chunk.vertexCorners.size();
+				weldTable.emplace(localVertexCount);
+			}
+
+			for(ObjChunk& chunk : chunks)
+			{
+				chunk.firstNewVertex = vertexCount;
+				if(weldTable)
+				{
+					chunk.mergedVertices.resize(chunk.vertexCorners.size());
+					for(size_t i{ 0 }; i < chunk.vertexCorners.size(); ++i)
+					{
+						chunk.mergedVertices[i] = weldTable->FindOrInsert(chunk.vertexCorners[i], static_cast<uint32_t>(vertexCount));
+						if(chunk.mergedVertices[i] == vertexCount)
+							++vertexCount;
+					}
+				}
+				else
+				{
+					vertexCount += chunk.vertexCorners.size();
+				}
+				chunk.endNewVertex = vertexCount;
+
+				chunk.indexOffset = indexCount;
+				indexCount += chunk.triangleCount * 3;
+				cornerCount += chunk.cornerVertices.size();
+			}
+
+			vertices.resize(vertexCount);
+			indices.resize(indexCount);
+			pool.ParallelFor(chunks.size(), [&](size_t i)
+			{
+				WriteChunkMesh(chunks[i], options.weldVertices, options.flipAxisAndWinding, positions, UVs, normals, vertices, indices);
+			});
+			return true;
+		}
+#pragma endregion
+
+		// Optional z flip, then the tangent frames in the final space
+		void FinishVertices(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, bool flipAxisAndWinding, uint32_t threadCount)
+		{
+			if(flipAxisAndWinding)
+			{
+				for(Vertex& vertex : vertices)
+				{
+					vertex.position.z *= -1.f;
+					vertex.normal.z *= -1.f;
+				}
+			}
+
+			Utils::GenerateTangents(vertices, indices, threadCount);
+		}
+	}
+
+	namespace Utils
+	{
+		bool ParseOBJText(std::string_view text, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding)
+		{
+			ObjImportOptions options{};
+			options.flipAxisAndWinding = flipAxisAndWinding;
+			return ParseOBJText(text, vertices, indices, options);
+		}
+
+		bool ParseOBJText(std::string_view text, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const ObjImportOptions& options, ObjImportStats* pStats)
+		{
+			vertices.clear();
+			indices.clear();
+
+			const uint32_t threadCount{ options.threadCount != 0 ? options.threadCount : std::max(std::thread::hardware_concurrency(), 1u) };
+			const size_t chunkCount{ threadCount > 1 ? std::min(text.size() / MIN_CHUNK_SIZE, threadCount * CHUNKS_PER_THREAD) : 1 };
+
+			size_t cornerCount{};
+			const bool parsed{ chunkCount > 1
+				? ParseParallel(text, options, ThreadPool::GetShared(), chunkCount, vertices, indices, cornerCount)
+				: ParseSequential(text, options, vertices, indices, cornerCount) };
+
+			if(!parsed)
+			{
+				vertices.clear();
+				indices.clear();
+				return false;
+			}
+
+			const size_t indexWeldedCount{ vertices.size() };
+			if(options.weldEpsilon > 0.f)
+				WeldVertices(vertices, indices, options.weldEpsilon);
+
+			// After welding so every shared vertex accumulates the tangents of all its triangles
+			FinishVertices(vertices, indices, options.flipAxisAndWinding, threadCount);
+
+			const VertexCacheStats cacheBefore{ pStats ? AnalyzeVertexCache(indices, vertices.size()) : VertexCacheStats{} };
+			if(options.optimizeVertexCache)
+			{
+				OptimizeVertexCache(indices, vertices.size());
+				OptimizeVertexFetch(vertices, indices);
+			}
+
+			if(pStats)
+			{
+				pStats->faceCorners = cornerCount;
+				pStats->indexWeldedVertices = indexWeldedCount;
+				pStats->vertices = vertices.size();
+				pStats->triangles = indices.size() / 3;
+				pStats->cacheBefore = cacheBefore;
+				pStats->cacheAfter = options.optimizeVertexCache ? AnalyzeVertexCache(indices, vertices.size()) : cacheBefore;
+			}
+			return true;
+		}
+
+		size_t WeldVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon)
+		{
+			assert(epsilon > 0.f);
+
+			// Uniform grid with epsilon sized cells, a match can only be in the 27 cells around a vertex
+			const float cellScale{ 1.f / epsilon };
+			const auto getCell = [&](float v) { return static_cast<int64_t>(std::floor(v * cellScale)); };
+			const auto getCellKey = [](int64_t x, int64_t y, int64_t z)
+			{
+				return static_cast<uint64_t>(x & 0x1FFFFF) | (static_cast<uint64_t>(y & 0x1FFFFF) << 21) | (static_cast<uint64_t>(z & 0x1FFFFF) << 42);
+			};
+			const auto isClose = [&](const Vertex& a, const Vertex& b)
+			{
+				return Abs(a.position.x - b.position.x) <= epsilon && Abs(a.position.y - b.position.y) <= epsilon && Abs(a.position.z - b.position.z) <= epsilon
+					&& Abs(a.normal.x - b.normal.x) <= epsilon && Abs(a.normal.y - b.normal.y) <= epsilon && Abs(a.normal.z - b.normal.z) <= epsilon
+					&& Abs(a.uv.x - b.uv.x) <= epsilon && Abs(a.uv.y - b.uv.y) <= epsilon;
+			};
+
+			constexpr uint32_t NONE{ UINT32_MAX };
+			// First kept vertex per cell, the rest of the cell is chained through nextInCell
+			std::unordered_map<uint64_t, uint32_t> cellHeads{};
+			cellHeads.reserve(vertices.size());
+			std::vector<uint32_t> nextInCell{};
+			nextInCell.reserve(vertices.size());
+
+			std::vector<uint32_t> remap(vertices.size());
+			size_t keptCount{};
+			for(size_t i{ 0 }; i < vertices.size(); ++i)
+			{
+				const Vertex& vertex{ vertices[i] };
+				const int64_t cellX{ getCell(vertex.position.x) };
+				const int64_t cellY{ getCell(vertex.position.y) };
+				const int64_t cellZ{ getCell(vertex.position.z) };
+
+				uint32_t match{ NONE };
+				for(int64_t z{ cellZ - 1 }; z <= cellZ + 1 && match == NONE; ++z)
+				{
+					for(int64_t y{ cellY - 1 }; y <= cellY + 1 && match == NONE; ++y)
+					{
+						for(int64_t x{ cellX - 1 }; x <= cellX + 1 && match == NONE; ++x)
+						{
+							const auto it = cellHeads.find(getCellKey(x, y, z));
+							for(uint32_t kept{ it != cellHeads.end() ? it->second : NONE }; kept != NONE; kept = nextInCell[kept])
+							{
+								if(isClose(vertices[kept], vertex))
+								{
+									match = kept;
+									break;
+								}
+							}
+						}
+					}
+				}
+
+				if(match != NONE)
+				{
+					remap[i] = match;
+					continue;
+				}
+
+				// Keep it, compacting in place (kept indices are always <= i)
+				const uint32_t keptIndex{ static_cast<uint32_t>(keptCount++) };
+				vertices[keptIndex] = vertex;
+				remap[i] = keptIndex;
+
+				uint32_t& head = cellHeads.try_emplace(getCellKey(cellX, cellY, cellZ), NONE).first->second;
+				nextInCell.push_back(head);
+				head = keptIndex;
+			}
+
+			vertices.resize(keptCount);
+
+			// Triangles that collapsed onto an edge or a point are dropped
+			size_t indexCount{};
+			for(size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+			{
+				const uint32_t index0{ remap[indices[i]] };
+				const uint32_t index1{ remap[indices[i + 1]] };
+				const uint32_t index2{ remap[indices[i + 2]] };
+				if(index0 == index1 || index1 == index2 || index0 == index2)
+					continue;
+
+				indices[indexCount++] = index0;
+				indices[indexCount++] = index1;
+				indices[indexCount++] = index2;
+			}
+			indices.resize(indexCount);
+
+			return keptCount;
+		}
+	}
+}
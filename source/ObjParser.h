@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Vertex.h"
+#include "VertexCache.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		struct ObjImportOptions
+		{
+			bool flipAxisAndWinding{ true };
+			// Face corners with the same position/uv/normal indices share one vertex
+			bool weldVertices{ true };
+			// When > 0, also merges vertices whose position, normal and uv are all within this distance
+			float weldEpsilon{ 0.f };
+			// Threads for parsing and the tangent pass, 0 uses every hardware thread and 1 stays on the calling thread.
+			// Small files are always parsed on the calling thread. The output does not depend on this.
+			uint32_t threadCount{ 0 };
+			// Reorders the triangles for the post transform cache and then the vertices by first use
+			bool optimizeVertexCache{ true };
+		};
+
+		struct ObjImportStats
+		{
+			// Vertex count without any welding, one per face corner
+			size_t faceCorners{};
+			// After welding on the index triples
+			size_t indexWeldedVertices{};
+			// After the optional epsilon weld
+			size_t vertices{};
+			size_t triangles{};
+			// Simulated 16 entry FIFO cache on the imported order and on the final one
+			VertexCacheStats cacheBefore{};
+			VertexCacheStats cacheAfter{};
+
+			// Face corners per output vertex, 1 means nothing was welded
+			float GetVertexReductionRatio() const
+			{
+				return vertices > 0 ? static_cast<float>(faceCorners) / static_cast<float>(vertices) : 1.f;
+			}
+		};
+
+		// Parses OBJ text that is already in memory (positions, UVs, normals and faces, everything else is skipped).
+		// Polygons are fan triangulated. Flips z and the winding when asked, then generates the tangent frames on
+		// the (welded) vertices with GenerateTangents and optimizes the triangle and vertex order when asked.
+		// Big files are split into chunks of whole lines that are parsed in parallel and merged in file order.
+		// Returns false on a malformed number or an out of range face index.
+		bool ParseOBJText(std::string_view text, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const ObjImportOptions& options, ObjImportStats* pStats = nullptr);
+		bool ParseOBJText(std::string_view text, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true);
+
+		// Merges vertices whose position, normal and uv are all within epsilon and drops the triangles that collapse.
+		// Returns the new vertex count.
+		size_t WeldVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon);
+	}
+}
@@ -0,0 +1,405 @@
+#include "pch.h"
+
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+#if DAE_OCCLUSION_SIMD
+#include <immintrin.h>
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		// Unit of work for the rasterizer threads, a bin owns its subtiles so the threads never share a write
+		constexpr uint32_t BIN_WIDTH{ 64 };
+		constexpr uint32_t BIN_HEIGHT{ 32 };
+		// Subtiles per side of a coarse depth cell
+		constexpr uint32_t COARSE_SUBTILES{ 4 };
+		constexpr uint32_t FULL_MASK{ UINT32_MAX };
+		// Triangles with a vertex closer than this (clip w) are left out instead of clipped
+		constexpr float MIN_W{ 1e-5f };
+
+		uint32_t RoundUp(uint32_t value, uint32_t multiple)
+		{
+			return (std::max(value, 1u) + multiple - 1) / multiple * multiple;
+		}
+	}
+
+	OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height, uint32_t threadCount)
+		: m_Width{ RoundUp(width, BIN_WIDTH) }
+		, m_Height{ RoundUp(height, BIN_HEIGHT) }
+		, m_SubtilesX{ m_Width / SUBTILE_WIDTH }
+		, m_SubtilesY{ m_Height / SUBTILE_HEIGHT }
+		, m_BinsX{ m_Width / BIN_WIDTH }
+		, m_BinsY{ m_Height / BIN_HEIGHT }
+		, m_ThreadCount{ threadCount == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : threadCount }
+	{
+		const size_t subtileCount{ size_t{ m_SubtilesX } * m_SubtilesY };
+		m_ZMax0.resize(subtileCount);
+		m_ZMax1.resize(subtileCount);
+		m_Masks.resize(subtileCount);
+		m_CoarseZMax.resize(subtileCount / (COARSE_SUBTILES * COARSE_SUBTILES));
+		m_BinTriangles.resize(size_t{ m_BinsX } * m_BinsY);
+		Clear();
+	}
+
+	void OcclusionCuller::Clear()
+	{
+		std::fill(m_ZMax0.begin(), m_ZMax0.end(), 1.f);
+		std::fill(m_ZMax1.begin(), m_ZMax1.end(), 0.f);
+		std::fill(m_Masks.begin(), m_Masks.end(), 0u);
+		std::fill(m_CoarseZMax.begin(), m_CoarseZMax.end(), 1.f);
+		m_Occluders.clear();
+	}
+
+	void OcclusionCuller::AddOccluder(std::span<const Vector3> positions, std::span<const uint32_t> indices, const Matrix& worldViewProjection)
+	{
+		m_Occluders.push_back({ positions, indices, worldViewProjection });
+	}
+
+	size_t OcclusionCuller::RenderOccluders()
+	{
+		m_Triangles.clear();
+		for(std::vector<uint32_t>& binTriangles : m_BinTriangles)
+			binTriangles.clear();
+
+		ThreadPool& pool{ ThreadPool::GetShared() };
+		for(const Occluder& occluder : m_Occluders)
+		{
+			m_ClipPositions.resize(occluder.positions.size());
+			const auto transform = [&](size_t begin, size_t end, size_t)
+			{
+				occluder.worldViewProjection.TransformPoints(occluder.positions.subspan(begin, end - begin),
+					std::span<Vector4>{ m_ClipPositions }.subspan(begin, end - begin));
+			};
+			if(m_ThreadCount > 1)
+				pool.ParallelForRanges(m_ClipPositions.size(), pool.GetThreadCount(), transform);
+			else
+				transform(0, m_ClipPositions.size(), 0);
+
+			for(size_t i{ 0 }; i + 2 < occluder.indices.size(); i += 3)
+			{
+				assert(occluder.indices[i] < m_ClipPositions.size() && occluder.indices[i + 1] < m_ClipPositions.size() && occluder.indices[i + 2] < m_ClipPositions.size());
+				SetupTriangle(m_ClipPositions[occluder.indices[i]], m_ClipPositions[occluder.indices[i + 1]], m_ClipPositions[occluder.indices[i + 2]]);
+			}
+		}
+		m_Occluders.clear();
+
+		const auto rasterizeBin = [this](size_t bin) { RasterizeBin(static_cast<uint32_t>(bin)); };
+		if(m_ThreadCount > 1)
+			pool.ParallelFor(m_BinTriangles.size(), rasterizeBin);
+		else
+		{
+			for(size_t bin{ 0 }; bin < m_BinTriangles.size(); ++bin)
+				rasterizeBin(bin);
+		}
+		return m_Triangles.size();
+	}
+
+	void OcclusionCuller::SetupTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2)
+	{
+		if(v0.w < MIN_W || v1.w < MIN_W || v2.w < MIN_W)
+			return;
+
+		// Pixel coordinates, y down
+		const auto toScreen = [this](const Vector4& v)
+		{
+			const float invW{ 1.f / v.w };
+			return Vector3{ (v.x * invW * 0.5f + 0.5f) * static_cast<float>(m_Width), (0.5f - v.y * invW * 0.5f) * static_cast<float>(m_Height), v.z * invW };
+		};
+		const Vector3 screen[3]{ toScreen(v0), toScreen(v1), toScreen(v2) };
+
+		ScreenTriangle triangle{};
+		triangle.zMin = std::min({ screen[0].z, screen[1].z, screen[2].z });
+		triangle.zMax = std::min(std::max({ screen[0].z, screen[1].z, screen[2].z }), 1.f);
+		// Pixels in front of the near plane are clipped away on the gpu, they must not occlude anything
+		if(triangle.zMin < 0.f || triangle.zMin >= 1.f)
+			return;
+
+		const float minX{ std::min({ screen[0].x, screen[1].x, screen[2].x }) };
+		const float minY{ std::min({ screen[0].y, screen[1].y, screen[2].y }) };
+		const float maxX{ std::max({ screen[0].x, screen[1].x, screen[2].x }) };
+		const float maxY{ std::max({ screen[0].y, screen[1].y, screen[2].y }) };
+		if(maxX < 0.f || maxY < 0.f || minX >= static_cast<float>(m_Width) || minY >= static_cast<float>(m_Height))
+			return;
+
+		const Vector3 edge1{ screen[1] - screen[0] };
+		const Vector3 edge2{ screen[2] - screen[0] };
+		const float area{ edge1.x * edge2.y - edge2.x * edge1.y };
+		if(!(std::abs(area) > 0.f) || !std::isfinite(area))
+			return;
+
+		// Edge functions scaled so the inside is positive for either winding, occluders are drawn two sided
+		const float sign{ area > 0.f ? 1.f : -1.f };
+		for(int i{ 0 }; i < 3; ++i)
+		{
+			const Vector3& from{ screen[i] };
+			const Vector3& to{ screen[(i + 1) % 3] };
+			triangle.edgeA[i] = (from.y - to.y) * sign;
+			triangle.edgeB[i] = (to.x - from.x) * sign;
+			triangle.edgeC[i] = (from.x * to.y - to.x * from.y) * sign;
+		}
+
+		const float invArea{ 1.f / area };
+		triangle.depthA = (edge1.z * edge2.y - edge1.y * edge2.z) * invArea;
+		triangle.depthB = (edge1.x * edge2.z - edge1.z * edge2.x) * invArea;
+		triangle.depthC = screen[0].z - triangle.depthA * screen[0].x - triangle.depthB * screen[0].y;
+
+		triangle.minX = static_cast<int>(std::max(minX, 0.f));
+		triangle.minY = static_cast<int>(std::max(minY, 0.f));
+		triangle.maxX = static_cast<int>(std::min(maxX, static_cast<float>(m_Width - 1)));
+		triangle.maxY = static_cast<int>(std::min(maxY, static_cast<float>(m_Height - 1)));
+
+		const uint32_t index{ static_cast<uint32_t>(m_Triangles.size()) };
+		m_Triangles.push_back(triangle);
+
+		const uint32_t binMinX{ static_cast<uint32_t>(triangle.minX) / BIN_WIDTH };
+		const uint32_t binMinY{ static_cast<uint32_t>(triangle.minY) / BIN_HEIGHT };
+		const uint32_t binMaxX{ static_cast<uint32_t>(triangle.maxX) / BIN_WIDTH };
+		const uint32_t binMaxY{ static_cast<uint32_t>(triangle.maxY) / BIN_HEIGHT };
+		for(uint32_t binY{ binMinY }; binY <= binMaxY; ++binY)
+		{
+			for(uint32_t binX{ binMinX }; binX <= binMaxX; ++binX)
+				m_BinTriangles[binY * m_BinsX + binX].push_back(index);
+		}
+	}
+
+	void OcclusionCuller::RasterizeBin(uint32_t bin)
+	{
+		const uint32_t binX{ bin % m_BinsX };
+		const uint32_t binY{ bin / m_BinsX };
+		constexpr uint32_t BIN_SUBTILES_X{ BIN_WIDTH / SUBTILE_WIDTH };
+		constexpr uint32_t BIN_SUBTILES_Y{ BIN_HEIGHT / SUBTILE_HEIGHT };
+		const uint32_t binSubtileX{ binX * BIN_SUBTILES_X };
+		const uint32_t binSubtileY{ binY * BIN_SUBTILES_Y };
+
+		for(const uint32_t index : m_BinTriangles[bin])
+		{
+			const ScreenTriangle& triangle{ m_Triangles[index] };
+			RasterizeTriangle(triangle,
+				std::max(static_cast<uint32_t>(triangle.minX) / SUBTILE_WIDTH, binSubtileX),
+				std::max(static_cast<uint32_t>(triangle.minY) / SUBTILE_HEIGHT, binSubtileY),
+				std::min(static_cast<uint32_t>(triangle.maxX) / SUBTILE_WIDTH, binSubtileX + BIN_SUBTILES_X - 1),
+				std::min(static_cast<uint32_t>(triangle.maxY) / SUBTILE_HEIGHT, binSubtileY + BIN_SUBTILES_Y - 1));
+		}
+
+		// Coarse cells of this bin
+		const uint32_t coarseX{ m_SubtilesX / COARSE_SUBTILES };
+		for(uint32_t cellY{ binSubtileY / COARSE_SUBTILES }; cellY < (binSubtileY + BIN_SUBTILES_Y) / COARSE_SUBTILES; ++cellY)
+		{
+			for(uint32_t cellX{ binSubtileX / COARSE_SUBTILES }; cellX < (binSubtileX + BIN_SUBTILES_X) / COARSE_SUBTILES; ++cellX)
+			{
+				float zMax{ 0.f };
+				for(uint32_t y{ cellY * COARSE_SUBTILES }; y < (cellY + 1) * COARSE_SUBTILES; ++y)
+				{
+					for(uint32_t x{ cellX * COARSE_SUBTILES }; x < (cellX + 1) * COARSE_SUBTILES; ++x)
+						zMax = std::max(zMax, m_ZMax0[y * m_SubtilesX + x]);
+				}
+				m_CoarseZMax[cellY * coarseX + cellX] = zMax;
+			}
+		}
+	}
+
+	void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& triangle, uint32_t subtileMinX, uint32_t subtileMinY, uint32_t subtileMaxX, uint32_t subtileMaxY)
+	{
+#if DAE_OCCLUSION_SIMD
+		// Edge values of 4 neighbouring pixels, the second half of a subtile row adds 4 steps
+		__m128 edgeStep[3], edgeStep4[3];
+		for(int e{ 0 }; e < 3; ++e)
+		{
+			edgeStep[e] = _mm_mul_ps(_mm_set1_ps(triangle.edgeA[e]), _mm_setr_ps(0.f, 1.f, 2.f, 3.f));
+			edgeStep4[e] = _mm_set1_ps(triangle.edgeA[e] * 4.f);
+		}
+#endif
+
+		for(uint32_t subtileY{ subtileMinY }; subtileY <= subtileMaxY; ++subtileY)
+		{
+			for(uint32_t subtileX{ subtileMinX }; subtileX <= subtileMaxX; ++subtileX)
+			{
+				const uint32_t subtile{ subtileY * m_SubtilesX + subtileX };
+				if(triangle.zMin >= m_ZMax0[subtile])
+					continue;
+
+				// Pixel centers
+				const float x{ static_cast<float>(subtileX * SUBTILE_WIDTH) + 0.5f };
+				const float y{ static_cast<float>(subtileY * SUBTILE_HEIGHT) + 0.5f };
+
+				uint32_t coverage{ 0 };
+				for(uint32_t row{ 0 }; row < SUBTILE_HEIGHT; ++row)
+				{
+					const float rowY{ y + static_cast<float>(row) };
+#if DAE_OCCLUSION_SIMD
+					__m128 inside0{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+					__m128 inside1{ inside0 };
+					for(int e{ 0 }; e < 3; ++e)
+					{
+						const __m128 edge0{ _mm_add_ps(_mm_set1_ps(triangle.edgeA[e] * x + triangle.edgeB[e] * rowY + triangle.edgeC[e]), edgeStep[e]) };
+						const __m128 edge1{ _mm_add_ps(edge0, edgeStep4[e]) };
+						inside0 = _mm_and_ps(inside0, _mm_cmpge_ps(edge0, _mm_setzero_ps()));
+						inside1 = _mm_and_ps(inside1, _mm_cmpge_ps(edge1, _mm_setzero_ps()));
+					}
+					const uint32_t rowMask{ static_cast<uint32_t>(_mm_movemask_ps(inside0)) | static_cast<uint32_t>(_mm_movemask_ps(inside1)) << 4 };
+#else
+					uint32_t rowMask{ 0 };
+					for(uint32_t column{ 0 }; column < SUBTILE_WIDTH; ++column)
+					{
+						const float pixelX{ x + static_cast<float>(column) };
+						bool isInside{ true };
+						for(int e{ 0 }; e < 3; ++e)
+							isInside &= triangle.edgeA[e] * pixelX + triangle.edgeB[e] * rowY + triangle.edgeC[e] >= 0.f;
+						rowMask |= static_cast<uint32_t>(isInside) << column;
+					}
+#endif
+					coverage |= rowMask << (row * SUBTILE_WIDTH);
+				}
+				if(coverage == 0)
+					continue;
+
+				// Farthest point of the depth plane over the pixel centers of the subtile
+				const float farX{ triangle.depthA > 0.f ? x + static_cast<float>(SUBTILE_WIDTH - 1) : x };
+				const float farY{ triangle.depthB > 0.f ? y + static_cast<float>(SUBTILE_HEIGHT - 1) : y };
+				const float zMax{ std::min(triangle.depthA * farX + triangle.depthB * farY + triangle.depthC, triangle.zMax) };
+				UpdateSubtile(subtile, coverage, zMax);
+			}
+		}
+	}
+
+	void OcclusionCuller::UpdateSubtile(uint32_t subtile, uint32_t coverage, float zMax)
+	{
+		float& zMax0{ m_ZMax0[subtile] };
+		float& zMax1{ m_ZMax1[subtile] };
+		uint32_t& mask{ m_Masks[subtile] };
+
+		// Covered pixels were already in front of the reference layer
+		zMax = std::min(zMax, zMax0);
+
+		// Start a new working layer when the triangle is much closer than the current one
+		if(zMax1 - zMax > zMax0 - zMax1)
+		{
+			zMax1 = 0.f;
+			mask = 0;
+		}
+
+		zMax1 = std::max(zMax1, zMax);
+		mask |= coverage;
+
+		// A full working layer becomes the reference
+		if(mask == FULL_MASK)
+		{
+			zMax0 = zMax1;
+			zMax1 = 0.f;
+			mask = 0;
+		}
+	}
+
+	bool OcclusionCuller::IsVisible(const Vector3& boundsMin, const Vector3& boundsMax, const Matrix& viewProjection) const
+	{
+		float minX{ FLT_MAX }, minY{ FLT_MAX }, maxX{ -FLT_MAX }, maxY{ -FLT_MAX }, zMin{ FLT_MAX };
+		for(int corner{ 0 }; corner < 8; ++corner)
+		{
+			const Vector4 clip{ viewProjection.TransformPoint((corner & 1) ? boundsMax.x : boundsMin.x,
+				(corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z, 1.f) };
+			if(clip.w < MIN_W)
+				return true;
+
+			const float invW{ 1.f / clip.w };
+			const float x{ (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(m_Width) };
+			const float y{ (0.5f - clip.y * invW * 0.5f) * static_cast<float>(m_Height) };
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+			zMin = std::min(zMin, clip.z * invW);
+		}
+
+		// Off screen is up to the frustum test, crossing the near plane can not be tested
+		if(zMin <= 0.f || maxX < 0.f || maxY < 0.f || minX >= static_cast<float>(m_Width) || minY >= static_cast<float>(m_Height))
+			return true;
+
+		const uint32_t subtileMinX{ static_cast<uint32_t>(std::max(minX, 0.f)) / SUBTILE_WIDTH };
+		const uint32_t subtileMinY{ static_cast<uint32_t>(std::max(minY, 0.f)) / SUBTILE_HEIGHT };
+		const uint32_t subtileMaxX{ static_cast<uint32_t>(std::min(maxX, static_cast<float>(m_Width - 1))) / SUBTILE_WIDTH };
+		const uint32_t subtileMaxY{ static_cast<uint32_t>(std::min(maxY, static_cast<float>(m_Height - 1))) / SUBTILE_HEIGHT };
+
+		// Coarse cells first, only cells with something farther than the box get their subtiles checked
+		const uint32_t coarseX{ m_SubtilesX / COARSE_SUBTILES };
+		for(uint32_t cellY{ subtileMinY / COARSE_SUBTILES }; cellY <= subtileMaxY / COARSE_SUBTILES; ++cellY)
+		{
+			for(uint32_t cellX{ subtileMinX / COARSE_SUBTILES }; cellX <= subtileMaxX / COARSE_SUBTILES; ++cellX)
+			{
+				if(m_CoarseZMax[cellY * coarseX + cellX] < zMin)
+					continue;
+
+				const uint32_t firstY{ std::max(cellY * COARSE_SUBTILES, subtileMinY) };
+				const uint32_t lastY{ std::min((cellY + 1) * COARSE_SUBTILES - 1, subtileMaxY) };
+				const uint32_t firstX{ std::max(cellX * COARSE_SUBTILES, subtileMinX) };
+				const uint32_t lastX{ std::min((cellX + 1) * COARSE_SUBTILES - 1, subtileMaxX) };
+				for(uint32_t y{ firstY }; y <= lastY; ++y)
+				{
+					for(uint32_t x{ firstX }; x <= lastX; ++x)
+					{
+						if(m_ZMax0[y * m_SubtilesX + x] >= zMin)
+							return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	CullStats OcclusionCuller::TestBounds(const BoundsSoA& bounds, const Matrix& viewProjection, std::span<uint8_t> visible) const
+	{
+		assert(visible.size() >= bounds.GetCount());
+
+		CullStats stats{};
+		for(size_t i{ 0 }; i < bounds.GetCount(); ++i)
+		{
+			if(!visible[i])
+				continue;
+
+			const Vector3 center{ bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i] };
+			const Vector3 extents{ bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i] };
+			++stats.tested;
+			if(!IsVisible(center - extents, center + extents, viewProjection))
+			{
+				visible[i] = 0;
+				++stats.culled;
+			}
+		}
+		return stats;
+	}
+
+	bool OcclusionCuller::WriteDepthImage(const std::string& path) const
+	{
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		if(!file)
+			return false;
+
+		// Stretch the written depths over the gray range, post projection depth bunches up close to 1
+		float zNear{ 1.f };
+		for(const float z : m_ZMax0)
+			zNear = std::min(zNear, z);
+		const float scale{ zNear < 1.f ? 1.f / (1.f - zNear) : 0.f };
+
+		file << "P5\n" << m_Width << ' ' << m_Height << "\n255\n";
+		std::vector<uint8_t> row(m_Width);
+		for(uint32_t y{ 0 }; y < m_Height; ++y)
+		{
+			for(uint32_t x{ 0 }; x < m_Width; ++x)
+			{
+				const float z{ m_ZMax0[(y / SUBTILE_HEIGHT) * m_SubtilesX + x / SUBTILE_WIDTH] };
+				row[x] = z < 1.f ? static_cast<uint8_t>(64.f + 191.f * (1.f - (z - zNear) * scale)) : 0;
+			}
+			file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+		}
+		return static_cast<bool>(file);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "Frustum.h"
+#include "Matrix.h"
+#include "Vector3.h"
+
+// SIMD backend for the occluder rasterizer, define DAE_OCCLUSION_NO_SIMD to force the scalar fallback
+#if !defined(DAE_OCCLUSION_NO_SIMD) && (defined(_M_X64) || defined(__SSE2__))
+#define DAE_OCCLUSION_SIMD 1
+#else
+#define DAE_OCCLUSION_SIMD 0
+#endif
+
+namespace dae
+{
+	// Software occlusion culling in the style of masked occlusion culling. Occluder triangles are rasterized into a
+	// low resolution buffer of 8x4 pixel subtiles. Every subtile keeps a reference depth that all of its pixels are
+	// in front of, and a working layer (coverage mask + depth) that replaces the reference once it covers the subtile.
+	// A coarse level with the farthest depth of every 4x4 subtiles lets occluded objects out early.
+	// Depth is the D3D clip z / w, 0 at the near plane and 1 at the far plane.
+	class OcclusionCuller final
+	{
+	public:
+		static constexpr uint32_t SUBTILE_WIDTH{ 8 };
+		static constexpr uint32_t SUBTILE_HEIGHT{ 4 };
+
+		// The size is rounded up to whole bins of 64x32 pixels, 0 threads uses every hardware thread
+		OcclusionCuller(uint32_t width = 256, uint32_t height = 128, uint32_t threadCount = 0);
+
+		~OcclusionCuller() = default;
+		OcclusionCuller(const OcclusionCuller&) = delete;
+		OcclusionCuller(OcclusionCuller&&) noexcept = delete;
+		OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+		OcclusionCuller& operator=(OcclusionCuller&&) noexcept = delete;
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+
+		// Empties the occluder list and the depth buffer
+		void Clear();
+
+		// The arrays are read in RenderOccluders and have to live until then. Triangles crossing the near plane are left out.
+		void AddOccluder(std::span<const Vector3> positions, std::span<const uint32_t> indices, const Matrix& worldViewProjection);
+
+		// Transforms and bins the occluder triangles, then rasterizes every bin on its own thread.
+		// Returns the number of triangles that reached the screen.
+		size_t RenderOccluders();
+
+		// World space box against the depth buffer. Boxes crossing the near plane are always visible.
+		bool IsVisible(const Vector3& boundsMin, const Vector3& boundsMax, const Matrix& viewProjection) const;
+
+		// Tests the objects that are still visible (frustum culling first) and clears the occluded ones
+		CullStats TestBounds(const BoundsSoA& bounds, const Matrix& viewProjection, std::span<uint8_t> visible) const;
+
+		// Reference depth of every pixel as a binary PGM, near is white and the far plane black
+		bool WriteDepthImage(const std::string& path) const;
+
+	private:
+		struct Occluder
+		{
+			std::span<const Vector3> positions;
+			std::span<const uint32_t> indices;
+			Matrix worldViewProjection;
+		};
+
+		// Screen space triangle, edge functions are positive inside
+		struct ScreenTriangle
+		{
+			float edgeA[3];
+			float edgeB[3];
+			float edgeC[3];
+			// Depth plane z = a x + b y + c
+			float depthA;
+			float depthB;
+			float depthC;
+			float zMin;
+			float zMax;
+			int minX;
+			int minY;
+			int maxX;
+			int maxY;
+		};
+
+		uint32_t m_Width;
+		uint32_t m_Height;
+		uint32_t m_SubtilesX;
+		uint32_t m_SubtilesY;
+		uint32_t m_BinsX;
+		uint32_t m_BinsY;
+		uint32_t m_ThreadCount;
+
+		// One entry per subtile
+		std::vector<float> m_ZMax0{};
+		std::vector<float> m_ZMax1{};
+		std::vector<uint32_t> m_Masks{};
+		// Farthest reference depth of every 4x4 subtiles
+		std::vector<float> m_CoarseZMax{};
+
+		std::vector<Occluder> m_Occluders{};
+		std::vector<ScreenTriangle> m_Triangles{};
+		// Triangles overlapping every bin, in submission order
+		std::vector<std::vector<uint32_t>> m_BinTriangles{};
+		std::vector<Vector4> m_ClipPositions{};
+
+		void SetupTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2);
+		void RasterizeBin(uint32_t bin);
+		void RasterizeTriangle(const ScreenTriangle& triangle, uint32_t subtileMinX, uint32_t subtileMinY, uint32_t subtileMaxX, uint32_t subtileMaxY);
+		void UpdateSubtile(uint32_t subtile, uint32_t coverage, float zMax);
+		void BuildCoarseLevel();
+	};
+}
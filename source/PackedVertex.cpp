@@ -0,0 +1,165 @@
+#include "pch.h"
+
+#include "PackedVertex.h"
+#include "MathHelpers.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr float UNORM16_MAX{ 65535.f };
+		constexpr float SNORM16_MAX{ 32767.f };
+
+		uint16_t ToUnorm16(float v)
+		{
+			return static_cast<uint16_t>(std::lround(Clamp(v, 0.f, 1.f) * UNORM16_MAX));
+		}
+
+		// Same as the input assembler, -32768 and -32767 are both -1
+		float FromSnorm16(int16_t v)
+		{
+			return std::max(static_cast<float>(v) / SNORM16_MAX, -1.f);
+		}
+
+		// atan2 instead of acos of the dot, which in float cannot resolve less than about 0.02 degrees
+		float GetAngleDegrees(const Vector3& v1, const Vector3& v2)
+		{
+			return std::atan2(Vector3::Cross(v1, v2).Magnitude(), Vector3::Dot(v1, v2)) * TO_DEGREES;
+		}
+
+		// Rounding both coordinates to nearest is not always the closest direction, the four snorm neighbours are tried
+		void PackDirection(const Vector3& direction, int16_t out[2])
+		{
+			const Vector2 encoded{ Utils::EncodeOctahedral(direction) };
+			const float x{ std::floor(Clamp(encoded.x, -1.f, 1.f) * SNORM16_MAX) };
+			const float y{ std::floor(Clamp(encoded.y, -1.f, 1.f) * SNORM16_MAX) };
+
+			float bestDot{ -2.f };
+			for(int i{ 0 }; i < 4; ++i)
+			{
+				const int16_t candidate[2]{
+					static_cast<int16_t>(Clamp(x + static_cast<float>(i & 1), -SNORM16_MAX, SNORM16_MAX)),
+					static_cast<int16_t>(Clamp(y + static_cast<float>(i >> 1), -SNORM16_MAX, SNORM16_MAX))
+				};
+				const float dot{ Vector3::Dot(direction, Utils::DecodeOctahedral({ FromSnorm16(candidate[0]), FromSnorm16(candidate[1]) })) };
+				if(dot > bestDot)
+				{
+					bestDot = dot;
+					out[0] = candidate[0];
+					out[1] = candidate[1];
+				}
+			}
+		}
+	}
+
+	namespace Utils
+	{
+		Vector2 EncodeOctahedral(const Vector3& direction)
+		{
+			const float sum{ Abs(direction.x) + Abs(direction.y) + Abs(direction.z) };
+			if(sum == 0.f)
+				return { 0.f, 0.f };
+
+			const Vector3 octahedron{ direction / sum };
+			if(octahedron.z >= 0.f)
+				return { octahedron.x, octahedron.y };
+
+			// The lower half folds over the diagonals
+			return {
+				(1.f - Abs(octahedron.y)) * (octahedron.x >= 0.f ? 1.f : -1.f),
+				(1.f - Abs(octahedron.x)) * (octahedron.y >= 0.f ? 1.f : -1.f)
+			};
+		}
+
+		Vector3 DecodeOctahedral(const Vector2& encoded)
+		{
+			Vector3 direction{ encoded.x, encoded.y, 1.f - Abs(encoded.x) - Abs(encoded.y) };
+			const float fold{ Clamp(-direction.z, 0.f, 1.f) };
+			direction.x += direction.x >= 0.f ? -fold : fold;
+			direction.y += direction.y >= 0.f ? -fold : fold;
+			return direction.Normalized();
+		}
+
+		PositionQuantization GetPositionQuantization(std::span<const Vertex> vertices)
+		{
+			if(vertices.empty())
+				return {};
+
+			Vector3 boundsMin{ vertices.front().position };
+			Vector3 boundsMax{ boundsMin };
+			for(const Vertex& vertex : vertices)
+			{
+				boundsMin = Vector3::Min(boundsMin, vertex.position);
+				boundsMax = Vector3::Max(boundsMax, vertex.position);
+			}
+			return { boundsMax - boundsMin, boundsMin };
+		}
+
+		void PackVertices(std::span<const Vertex> vertices, const PositionQuantization& quantization, std::span<PackedVertex> out)
+		{
+			assert(out.size() >= vertices.size());
+
+			// A flat axis has scale 0, everything on it is at the offset
+			const auto inverse = [](float scale) { return scale > 0.f ? 1.f / scale : 0.f; };
+			const Vector3 inverseScale{ inverse(quantization.scale.x), inverse(quantization.scale.y), inverse(quantization.scale.z) };
+
+			for(size_t i{ 0 }; i < vertices.size(); ++i)
+			{
+				const Vertex& vertex{ vertices[i] };
+				PackedVertex& packed{ out[i] };
+
+				const Vector3 position{ vertex.position - quantization.offset };
+				packed.position[0] = ToUnorm16(position.x * inverseScale.x);
+				packed.position[1] = ToUnorm16(position.y * inverseScale.y);
+				packed.position[2] = ToUnorm16(position.z * inverseScale.z);
+				packed.position[3] = vertex.tangent.w < 0.f ? 0 : UINT16_MAX;
+
+				PackDirection(vertex.normal, packed.normal);
+				PackDirection(vertex.tangent.GetXYZ(), packed.tangent);
+				packed.uv = Half2{ vertex.uv };
+			}
+		}
+
+		Vertex UnpackVertex(const PackedVertex& packed, const PositionQuantization& quantization)
+		{
+			const auto fromUnorm = [](uint16_t v) { return static_cast<float>(v) / UNORM16_MAX; };
+
+			Vertex vertex{};
+			vertex.position = {
+				fromUnorm(packed.position[0]) * quantization.scale.x + quantization.offset.x,
+				fromUnorm(packed.position[1]) * quantization.scale.y + quantization.offset.y,
+				fromUnorm(packed.position[2]) * quantization.scale.z + quantization.offset.z
+			};
+			vertex.normal = DecodeOctahedral({ FromSnorm16(packed.normal[0]), FromSnorm16(packed.normal[1]) });
+			vertex.tangent = Vector4{ DecodeOctahedral({ FromSnorm16(packed.tangent[0]), FromSnorm16(packed.tangent[1]) }), fromUnorm(packed.position[3]) * 2.f - 1.f };
+			vertex.uv = packed.uv.ToVector2();
+			return vertex;
+		}
+
+		PackingError MeasurePackingError(std::span<const Vertex> vertices, std::span<const PackedVertex> packed, const PositionQuantization& quantization)
+		{
+			assert(packed.size() >= vertices.size());
+
+			PackingError error{};
+			for(size_t i{ 0 }; i < vertices.size(); ++i)
+			{
+				const Vertex& source{ vertices[i] };
+				const Vertex unpacked{ UnpackVertex(packed[i], quantization) };
+
+				error.maxPosition = std::max(error.maxPosition, (unpacked.position - source.position).Magnitude());
+				error.maxNormalAngle = std::max(error.maxNormalAngle, GetAngleDegrees(source.normal, unpacked.normal));
+				error.maxTangentAngle = std::max(error.maxTangentAngle, GetAngleDegrees(source.tangent.GetXYZ(), unpacked.tangent.GetXYZ()));
+				error.maxUV = std::max(error.maxUV, std::max(Abs(unpacked.uv.x - source.uv.x), Abs(unpacked.uv.y - source.uv.y)));
+				if((source.tangent.w < 0.f) != (unpacked.tangent.w < 0.f))
+					++error.flippedSigns;
+			}
+
+			const float diagonal{ quantization.scale.Magnitude() };
+			error.maxRelativePosition = diagonal > 0.f ? error.maxPosition / diagonal : 0.f;
+			return error;
+		}
+	}
+}
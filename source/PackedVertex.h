@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "Half.h"
+#include "Vertex.h"
+
+namespace dae
+{
+	enum class VertexFormat
+	{
+		// Vertex as is, 48 bytes
+		Full,
+		// PackedVertex, 20 bytes
+		Packed
+	};
+
+	// Matches the packed input layout in Mesh and VS_Packed in the effects
+	struct PackedVertex
+	{
+		// UNORM inside the mesh bounds, w is the bitangent sign (0 is -1, 65535 is +1)
+		uint16_t position[4]{};
+		// Octahedral, SNORM
+		int16_t normal[2]{};
+		int16_t tangent[2]{};
+		Half2 uv{};
+	};
+	static_assert(sizeof(PackedVertex) == 20);
+
+	// position = unorm * scale + offset, per mesh
+	struct PositionQuantization
+	{
+		Vector3 scale{ 1.f, 1.f, 1.f };
+		Vector3 offset{};
+	};
+
+	// Worst case loss of a packed mesh against its source vertices
+	struct PackingError
+	{
+		// World units, and relative to the diagonal of the bounds
+		float maxPosition{};
+		float maxRelativePosition{};
+		// Degrees
+		float maxNormalAngle{};
+		float maxTangentAngle{};
+		float maxUV{};
+		size_t flippedSigns{};
+	};
+
+	namespace Utils
+	{
+		// Unit vector to the [-1, 1] square and back. The decode is the one the shaders use.
+		Vector2 EncodeOctahedral(const Vector3& direction);
+		Vector3 DecodeOctahedral(const Vector2& encoded);
+
+		PositionQuantization GetPositionQuantization(std::span<const Vertex> vertices);
+
+		// out must be at least as large as vertices
+		void PackVertices(std::span<const Vertex> vertices, const PositionQuantization& quantization, std::span<PackedVertex> out);
+		// What the input assembler and VS_Packed make of it
+		Vertex UnpackVertex(const PackedVertex& vertex, const PositionQuantization& quantization);
+
+		PackingError MeasurePackingError(std::span<const Vertex> vertices, std::span<const PackedVertex> packed, const PositionQuantization& quantization);
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "Vector3.h"
+#include "MathHelpers.h"
+
+namespace dae
+{
+	// Unit quaternion rotation (right-hand rule around the axis, like Matrix::CreateRotationY/Z)
+	struct Quaternion
+	{
+		float x{};
+		float y{};
+		float z{};
+		float w{ 1.f };
+
+		constexpr Quaternion() = default;
+		constexpr Quaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+
+		static constexpr Quaternion CreateFromAxisAngle(const Vector3& axis, float angle)
+		{
+			const float halfAngle{ angle * 0.5f };
+			float s{}, c{};
+			SinCos(halfAngle, s, c);
+			return { axis.x * s, axis.y * s, axis.z * s, c };
+		}
+
+		constexpr Vector3 GetXYZ() const
+		{
+			return { x, y, z };
+		}
+
+		constexpr float SqrMagnitude() const
+		{
+			return x * x + y * y + z * z + w * w;
+		}
+
+		Quaternion Normalized() const
+		{
+			const float invLength{ 1.f / sqrtf(SqrMagnitude()) };
+			return { x * invLength, y * invLength, z * invLength, w * invLength };
+		}
+
+		constexpr Quaternion Conjugate() const
+		{
+			return { -x, -y, -z, w };
+		}
+
+		constexpr Vector3 Rotate(const Vector3& v) const
+		{
+			// v + w * t + q x t, with t = 2 * (q x v)
+			const Vector3 q{ x, y, z };
+			const Vector3 t{ Vector3::Cross(q, v) * 2.f };
+			return v + t * w + Vector3::Cross(q, t);
+		}
+
+		// Rotated unit axes, these are the rows of the matching rotation matrix
+		constexpr Vector3 GetAxisX() const
+		{
+			return { 1.f - 2.f * (y * y + z * z), 2.f * (x * y + w * z), 2.f * (x * z - w * y) };
+		}
+
+		constexpr Vector3 GetAxisY() const
+		{
+			return { 2.f * (x * y - w * z), 1.f - 2.f * (x * x + z * z), 2.f * (y * z + w * x) };
+		}
+
+		constexpr Vector3 GetAxisZ() const
+		{
+			return { 2.f * (x * z + w * y), 2.f * (y * z - w * x), 1.f - 2.f * (x * x + y * y) };
+		}
+
+		// Hamilton product, (q1 * q2) rotates by q2 first, then by q1
+		constexpr Quaternion operator*(const Quaternion& q) const
+		{
+			return {
+				w * q.x + x * q.w + y * q.z - z * q.y,
+				w * q.y - x * q.z + y * q.w + z * q.x,
+				w * q.z + x * q.y - y * q.x + z * q.w,
+				w * q.w - x * q.x - y * q.y - z * q.z
+			};
+		}
+	};
+}
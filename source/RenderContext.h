@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+
+namespace dae
+{
+	enum class ShaderStage : uint8_t
+	{
+		Vertex,
+		Pixel,
+		Count
+	};
+
+	// The device context calls the renderer makes per draw. Objects are the D3D11 interfaces as opaque pointers, so
+	// StateTrackingContext can filter the calls without DirectX (D3D11RenderContext forwards them to the device).
+	class RenderContext
+	{
+	public:
+		RenderContext() = default;
+		virtual ~RenderContext() = default;
+
+		RenderContext(const RenderContext&) = delete;
+		RenderContext(RenderContext&&) noexcept = delete;
+		RenderContext& operator=(const RenderContext&) = delete;
+		RenderContext& operator=(RenderContext&&) noexcept = delete;
+
+		// Input assembler, topology and index format are the D3D11 enum values
+		virtual void SetPrimitiveTopology(uint32_t topology) = 0;
+		virtual void SetInputLayout(void* pInputLayout) = 0;
+		virtual void SetVertexBuffer(uint32_t slot, void* pBuffer, uint32_t stride, uint32_t offset) = 0;
+		virtual void SetIndexBuffer(void* pBuffer, uint32_t format, uint32_t offset) = 0;
+
+		// Rasterizer and output merger
+		virtual void SetRasterizerState(void* pState) = 0;
+		virtual void SetBlendState(void* pState) = 0;
+		virtual void SetDepthStencilState(void* pState, uint32_t stencilRef) = 0;
+		virtual void SetRenderTarget(void* pRenderTargetView, void* pDepthStencilView) = 0;
+
+		virtual void SetSampler(ShaderStage stage, uint32_t slot, void* pSampler) = 0;
+		virtual void SetShaderResource(ShaderStage stage, uint32_t slot, void* pView) = 0;
+
+		// Effect pass, binds the shaders with their constants, states, samplers and resources itself
+		virtual void ApplyPass(void* pPass) = 0;
+
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex) = 0;
+		// Per instance data starts at firstInstance in every per instance vertex buffer
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) = 0;
+	};
+}
@@ -0,0 +1,86 @@
+#include "pch.h"
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint64_t DEPTH_MAX{ (uint64_t{ 1 } << RenderQueue::DEPTH_BITS) - 1 };
+		constexpr uint32_t PASS_SHIFT{ 62 };
+		constexpr uint32_t FREE_BITS{ 22 };
+
+		// Below this an insertion sort beats clearing and summing the histograms
+		constexpr size_t SMALL_QUEUE{ 64 };
+	}
+
+	uint64_t RenderQueue::MakeKey(RenderPass pass, uint16_t material, float depth, float nearPlane, float farPlane)
+	{
+		const float range{ farPlane - nearPlane };
+		float normalizedDepth{ range > 0.f ? (depth - nearPlane) / range : 0.f };
+		// Also catches NaN
+		if(!(normalizedDepth > 0.f))
+			normalizedDepth = 0.f;
+		const uint64_t quantizedDepth{ std::min(static_cast<uint64_t>(normalizedDepth * static_cast<float>(DEPTH_MAX)), DEPTH_MAX) };
+
+		const uint64_t key{ static_cast<uint64_t>(pass) << PASS_SHIFT };
+		if(pass == RenderPass::Transparent)
+			return key | (DEPTH_MAX - quantizedDepth) << (FREE_BITS + MATERIAL_BITS) | uint64_t{ material } << FREE_BITS;
+		return key | uint64_t{ material } << (FREE_BITS + DEPTH_BITS) | quantizedDepth << FREE_BITS;
+	}
+
+	void RenderQueue::Sort()
+	{
+		const size_t count{ m_Items.size() };
+		if(count <= SMALL_QUEUE)
+		{
+			for(size_t i{ 1 }; i < count; ++i)
+			{
+				const RenderItem item{ m_Items[i] };
+				size_t j{ i };
+				for(; j > 0 && m_Items[j - 1].key > item.key; --j)
+					m_Items[j] = m_Items[j - 1];
+				m_Items[j] = item;
+			}
+			return;
+		}
+
+		// Every digit's histogram in one read over the keys
+		std::array<std::array<uint32_t, 256>, 8> histograms{};
+		for(const RenderItem& item : m_Items)
+		{
+			for(size_t digit{ 0 }; digit < 8; ++digit)
+				++histograms[digit][(item.key >> (digit * 8)) & 0xFF];
+		}
+
+		m_SortBuffer.resize(count);
+		RenderItem* pSource{ m_Items.data() };
+		RenderItem* pDestination{ m_SortBuffer.data() };
+		for(size_t digit{ 0 }; digit < 8; ++digit)
+		{
+			const uint32_t shift{ static_cast<uint32_t>(digit * 8) };
+			std::array<uint32_t, 256>& offsets{ histograms[digit] };
+			// One bucket holds every key, the pass would not move anything
+			if(offsets[(pSource[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			uint32_t offset{ 0 };
+			for(uint32_t& bucket : offsets)
+			{
+				const uint32_t bucketCount{ bucket };
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for(size_t i{ 0 }; i < count; ++i)
+				pDestination[offsets[(pSource[i].key >> shift) & 0xFF]++] = pSource[i];
+			std::swap(pSource, pDestination);
+		}
+
+		if(pSource != m_Items.data())
+			m_Items.swap(m_SortBuffer);
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dae
+{
+	// Lower passes draw first
+	enum class RenderPass : uint8_t
+	{
+		Opaque,
+		Transparent
+	};
+
+	// drawIndex is up to the caller, Renderer uses the mesh index
+	struct RenderItem
+	{
+		uint64_t key{};
+		uint32_t drawIndex{};
+	};
+
+	// Draws sorted by a 64 bit key once per frame. Key layout, high bits first:
+	//   63-62  pass
+	//   opaque       61-46 material, 45-22 depth           grouped by material, front to back inside one
+	//   transparent  61-38 inverted depth, 37-22 material  back to front, the material only breaks ties
+	// The low 22 bits stay 0. The sort is stable, equal keys keep their submit order.
+	class RenderQueue final
+	{
+	public:
+		static constexpr uint32_t DEPTH_BITS{ 24 };
+		static constexpr uint32_t MATERIAL_BITS{ 16 };
+
+		RenderQueue() = default;
+
+		~RenderQueue() = default;
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue(RenderQueue&&) noexcept = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+		RenderQueue& operator=(RenderQueue&&) noexcept = delete;
+
+		// depth is the view space distance along the camera forward, quantized over [nearPlane, farPlane]
+		static uint64_t MakeKey(RenderPass pass, uint16_t material, float depth, float nearPlane, float farPlane);
+
+		void Clear() { m_Items.clear(); }
+		void Submit(uint64_t key, uint32_t drawIndex) { m_Items.push_back({ key, drawIndex }); }
+
+		// LSD radix sort on 8 bit digits, digits that are the same in every key are skipped
+		void Sort();
+
+		std::span<const RenderItem> GetItems() const { return m_Items; }
+
+	private:
+		std::vector<RenderItem> m_Items{};
+		// Ping pong buffer of the radix passes, kept so sorting does not allocate every frame
+		std::vector<RenderItem> m_SortBuffer{};
+	};
+}
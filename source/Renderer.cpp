@@ -4,6 +4,10 @@
 #include "Camera.h"
 #include "Texture.h"
 #include "Utils.h"
+#include "MeshCache.h"
+#include "MeshSimplifier.h"
+#include "D3D11RenderContext.h"
+#include "InstancedRenderer.h"
 
 
 Renderer::Renderer(SDL_Window* pWindow):
@@ -29,6 +33,10 @@ Renderer::Renderer(SDL_Window* pWindow):
 		std::cout << "DirectX initialization failed!\n";
 	}
 
+	m_pRenderContext = new D3D11RenderContext{ m_pDeviceContext };
+	m_pStateContext = new StateTrackingContext{ *m_pRenderContext };
+	m_pInstancedRenderer = new InstancedRenderer{ m_pDevice };
+
 
 	m_pVehicleMaterial = new EffectVehicle{ m_pDevice, L"Resources/PosCol3D.fx" };
 
@@ -47,11 +55,88 @@ Renderer::Renderer(SDL_Window* pWindow):
 	delete pVehicleSpecular;
 	delete pVehicleGloss;
 
-	std::vector<Vertex> vertices{};
-	std::vector<uint32_t> indices{};
+	// Mapped from the .dmesh next to the OBJ, which is only imported again when it changed.
+	// The vertex and index buffers are filled straight from the mapping, the vehicle's 16 bit indices included.
+	MeshCache meshCache{};
+	const auto loadMesh = [&](const std::string& objPath, std::span<const float> lodRatios)
+	{
+		if(!meshCache.Load(objPath, {}, lodRatios))
+		{
+			std::cout << objPath << ": could not be loaded\n";
+		}
+		else if(meshCache.WasRebuilt())
+		{
+			const Utils::ObjImportStats& stats{ meshCache.GetImportStats() };
+			std::cout << objPath << ": imported, " << stats.faceCorners << " face corners welded to " << stats.vertices
+				<< " vertices (" << stats.GetVertexReductionRatio() << "x reduction), ACMR " << stats.cacheBefore.GetACMR()
+				<< " -> " << stats.cacheAfter.GetACMR() << ", ATVR " << stats.cacheBefore.GetATVR() << " -> " << stats.cacheAfter.GetATVR() << '\n';
+			if(!meshCache.GetMeshlets().empty())
+			{
+				std::cout << "  " << meshCache.GetMeshlets().size() << " meshlets, " << static_cast<float>(meshCache.GetMeshletTriangles().size() / 3)
+					/ static_cast<float>(meshCache.GetMeshlets().size()) << " triangles each on average\n";
+			}
+			const std::span<const SubmeshRange> submeshes{ meshCache.GetSubmeshes() };
+			for(size_t lod{ 1 }; lod < submeshes.size(); ++lod)
+			{
+				std::cout << "  LOD" << lod << ": " << submeshes[lod].indexCount / 3 << " triangles ("
+					<< 100.f * static_cast<float>(submeshes[lod].indexCount) / static_cast<float>(submeshes[0].indexCount) << "%), error " << submeshes[lod].lodError << '\n';
+			}
+			// The simplifier got stuck before these ratios, they would have repeated the last level
+			if(submeshes.size() < lodRatios.size() + 1)
+			{
+				std::cout << "  " << lodRatios.size() + 1 - submeshes.size() << " of " << lodRatios.size()
+					<< " LOD ratios dropped, they do not get below " << Utils::MAX_LOD_TRIANGLE_FRACTION * 100.f << "% of the level before\n";
+			}
+		}
+	};
+
+	// Half the triangles every level. The seams lock the vehicle at about 29%, so an eighth would only repeat the quarter.
+	constexpr float VEHICLE_LOD_RATIOS[]{ 0.5f, 0.25f };
+	loadMesh("./Resources/vehicle.obj", VEHICLE_LOD_RATIOS);
+	Mesh* pMesh = m_MeshPtrs.emplace_back(new Mesh{ m_pDevice, m_pVehicleMaterial, meshCache, VertexFormat::Packed });
+	pMesh->SetMeshletMesh(meshCache.CopyMeshletMesh());
+	m_MeshTransforms.emplace_back();
+	m_LodInstances.push_back({ &pMesh->GetLodChain() });
+
+	// The vehicle is the only opaque mesh, so it is the occluder
+	Occluder& occluder{ m_Occluders.emplace_back() };
+	occluder.mesh = m_MeshPtrs.size() - 1;
+	for(const Vertex& vertex : meshCache.GetVertices())
+	{
+		occluder.positions.push_back(vertex.position);
+	}
+	if(!meshCache.GetSubmeshes().empty())
+	{
+		const SubmeshRange& fullDetail{ meshCache.GetSubmeshes()[0] };
+		const std::span<const uint32_t> indices{ meshCache.GetIndices().subspan(fullDetail.firstIndex, fullDetail.indexCount) };
+		occluder.indices.assign(indices.begin(), indices.end());
+	}
 
-	Utils::ParseOBJ("./Resources/vehicle.obj", vertices, indices);
-	Mesh* pMesh = m_MeshPtrs.emplace_back(new Mesh{ m_pDevice, m_pVehicleMaterial, vertices, indices });
+	// 32x32 copies at a tenth of the size on the ground below, static so their bounds are made once
+	constexpr uint32_t CROWD_SIDE{ 32 };
+	constexpr float CROWD_SPACING{ 6.f };
+	constexpr float CROWD_SCALE{ 0.1f };
+	m_CrowdMesh = m_MeshPtrs.size() - 1;
+	m_CrowdBounds.Resize(CROWD_SIDE * CROWD_SIDE);
+	m_IsCrowdVisible.resize(CROWD_SIDE * CROWD_SIDE);
+	for(uint32_t z{ 0 }; z < CROWD_SIDE; ++z)
+	{
+		for(uint32_t x{ 0 }; x < CROWD_SIDE; ++x)
+		{
+			// Cheap hash for a yaw and a tint per copy
+			const uint32_t hash{ (x * 73856093u ^ z * 19349663u) * 2654435761u };
+			const float yaw{ static_cast<float>(hash % 360) * TO_RADIANS };
+			const Quaternion rotation{ Quaternion::CreateFromAxisAngle(Vector3::UnitY, yaw) };
+			const Vector3 position{ (static_cast<float>(x) - CROWD_SIDE / 2) * CROWD_SPACING, -15.f, -20.f + static_cast<float>(z) * CROWD_SPACING };
+			const Affine3x4 worldTransform{ rotation.GetAxisX() * CROWD_SCALE, rotation.GetAxisY() * CROWD_SCALE, rotation.GetAxisZ() * CROWD_SCALE, position };
+
+			m_CrowdBounds.Set(m_CrowdTransforms.size(), worldTransform, pMesh->GetBoundsMin(), pMesh->GetBoundsMax(), pMesh->GetBoundsRadius());
+			m_CrowdTransforms.push_back(worldTransform);
+			m_CrowdParameters.push_back({ 0.5f + (hash >> 8 & 0xFF) / 510.f, 0.5f + (hash >> 16 & 0xFF) / 510.f, 0.5f + (hash >> 24) / 510.f, 0.f });
+			LodInstance& lodInstance{ m_CrowdLods.emplace_back(LodInstance{ &pMesh->GetLodChain() }) };
+			lodInstance.SetWorldTransform(worldTransform);
+		}
+	}
 
 	m_pFireMaterial = new EffectFire{ m_pDevice, L"Resources/ShaderTransparent.fx" };
 	Texture* pFireDiffuse = Texture::LoadFromFile(m_pDevice, "./Resources/fireFX_diffuse.png");
@@ -59,9 +144,20 @@ Renderer::Renderer(SDL_Window* pWindow):
 	delete pFireDiffuse;
 
 
-	Utils::ParseOBJ("./Resources/fireFX.obj", vertices, indices);
-	pMesh = m_MeshPtrs.emplace_back(new Mesh{ m_pDevice, m_pFireMaterial, vertices, indices });
+	loadMesh("./Resources/fireFX.obj", {});
+	pMesh = m_MeshPtrs.emplace_back(new Mesh{ m_pDevice, m_pFireMaterial, meshCache });
+	m_MeshTransforms.emplace_back();
+	m_LodInstances.push_back({ &pMesh->GetLodChain() });
 
+	// Render queue material ids in order of first use
+	std::vector<const Effect*> materialEffects{};
+	for(const Mesh* pMesh : m_MeshPtrs)
+	{
+		const auto it = std::find(materialEffects.begin(), materialEffects.end(), pMesh->GetEffect());
+		m_MeshMaterials.push_back(static_cast<uint16_t>(it - materialEffects.begin()));
+		if(it == materialEffects.end())
+			materialEffects.push_back(pMesh->GetEffect());
+	}
 }
 
 Renderer::~Renderer()
@@ -92,6 +188,9 @@ Renderer::~Renderer()
 		}
 	}
 
+	delete m_pInstancedRenderer;
+	delete m_pStateContext;
+	delete m_pRenderContext;
 	delete m_pCamera;
 }
 
@@ -99,13 +198,96 @@ void Renderer::Update(const Timer* pTimer)
 {
 	m_pCamera->Update(pTimer);
 
-	Matrix rotation = Matrix::CreateRotationY(PI_DIV_4 * pTimer->GetElapsed());
+	const Quaternion rotation = Quaternion::CreateFromAxisAngle(Vector3::UnitY, PI_DIV_4 * pTimer->GetElapsed());
+	for(Transform& transform : m_MeshTransforms)
+	{
+		transform.Rotate(rotation);
+	}
 
-	for(Mesh* pMesh : m_MeshPtrs)
+	// Only the dirty transforms get rebuilt, in one pass over the array
+	Transform::UpdateWorldTransforms(m_MeshTransforms);
+	for(size_t i{ 0 }; i < m_MeshPtrs.size(); ++i)
+	{
+		m_MeshPtrs[i]->SetWorldTransform(m_MeshTransforms[i].GetWorldTransform());
+		m_LodInstances[i].SetWorldTransform(m_MeshTransforms[i].GetWorldTransform());
+	}
+
+	// Frustum test over every mesh at once, Render skips the culled ones
+	m_MeshBounds.Resize(m_MeshPtrs.size());
+	m_IsMeshVisible.resize(m_MeshPtrs.size());
+	for(size_t i{ 0 }; i < m_MeshPtrs.size(); ++i)
+	{
+		const Mesh* pMesh{ m_MeshPtrs[i] };
+		m_MeshBounds.Set(i, m_MeshTransforms[i].GetWorldTransform(), pMesh->GetBoundsMin(), pMesh->GetBoundsMax(), pMesh->GetBoundsRadius());
+	}
+	const Matrix viewProjection{ m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() };
+	const Frustum frustum{ Frustum::FromViewProjection(viewProjection) };
+	m_CullStats = Utils::CullBounds(frustum, m_MeshBounds, m_IsMeshVisible);
+
+	// Visible occluders into the software depth buffer, then the meshes still left are tested against it
+	m_OcclusionCuller.Clear();
+	for(const Occluder& occluder : m_Occluders)
+	{
+		if(m_IsMeshVisible[occluder.mesh])
+			m_OcclusionCuller.AddOccluder(occluder.positions, occluder.indices, m_MeshPtrs[occluder.mesh]->GetWorldMatrix() * viewProjection);
+	}
+	m_OcclusionCuller.RenderOccluders();
+	m_OcclusionStats = m_OcclusionCuller.TestBounds(m_MeshBounds, viewProjection, m_IsMeshVisible);
+
+	// Every instance in one pass, then the meshes draw the picked levels
+	const float projectionScale{ Utils::GetProjectionScale(m_pCamera->GetFovRatio(), static_cast<float>(m_Height)) };
+	m_LodStats = Utils::SelectLods(m_LodInstances, m_pCamera->GetCameraToWorld().translation, projectionScale, m_LodSettings);
+	for(size_t i{ 0 }; i < m_MeshPtrs.size(); ++i)
 	{
-		pMesh->SetWorldMatrix(pMesh->GetWorldMatrix() * rotation);
+		m_MeshPtrs[i]->SetLod(m_LodInstances[i].lod);
+	}
+
+	// Meshlets of the visible meshes at full detail, against the camera in their object space
+	const RigidTransform& cameraToWorld{ m_pCamera->GetCameraToWorld() };
+	m_MeshletStats = {};
+	if(m_IsMeshletStatsEnabled)
+	{
+		for(size_t i{ 0 }; i < m_MeshPtrs.size(); ++i)
+		{
+			const Mesh* pMesh{ m_MeshPtrs[i] };
+			if(!m_IsMeshVisible[i] || pMesh->GetLod() != 0 || pMesh->GetMeshletMesh().meshlets.empty())
+				continue;
+
+			const Affine3x4& worldTransform{ pMesh->GetWorldTransform() };
+			const Vector3 cameraPosition{ worldTransform.Inverse().TransformPoint(cameraToWorld.translation) };
+			m_VisibleMeshlets.clear();
+			m_MeshletStats.Add(Utils::CullMeshlets(pMesh->GetMeshletMesh(), worldTransform * viewProjection, cameraPosition, m_VisibleMeshlets));
+		}
 	}
 
+	// Visible meshes by pass, material and view depth of the bounds center
+	m_RenderQueue.Clear();
+	for(size_t i{ 0 }; i < m_MeshPtrs.size(); ++i)
+	{
+		if(!m_IsMeshVisible[i])
+			continue;
+
+		const Vector3 center{ m_MeshBounds.centerX[i], m_MeshBounds.centerY[i], m_MeshBounds.centerZ[i] };
+		const float depth{ Vector3::Dot(center - cameraToWorld.translation, cameraToWorld.axisZ) };
+		const RenderPass pass{ m_MeshPtrs[i]->GetEffect()->IsTransparent() ? RenderPass::Transparent : RenderPass::Opaque };
+		m_RenderQueue.Submit(RenderQueue::MakeKey(pass, m_MeshMaterials[i], depth, m_pCamera->GetNearPlane(), m_pCamera->GetFarPlane()), static_cast<uint32_t>(i));
+	}
+	m_RenderQueue.Sort();
+
+	// Visible copies of the crowd, batched per level of detail
+	m_InstanceBatcher.Clear();
+	if(m_IsCrowdEnabled)
+	{
+		Utils::CullBounds(frustum, m_CrowdBounds, m_IsCrowdVisible);
+		m_OcclusionCuller.TestBounds(m_CrowdBounds, viewProjection, m_IsCrowdVisible);
+		Utils::SelectLods(m_CrowdLods, cameraToWorld.translation, projectionScale, m_LodSettings);
+		for(size_t i{ 0 }; i < m_CrowdTransforms.size(); ++i)
+		{
+			if(m_IsCrowdVisible[i])
+				m_InstanceBatcher.Add(InstanceBatch::MakeKey(static_cast<uint32_t>(m_CrowdMesh), m_CrowdLods[i].lod), m_CrowdTransforms[i], m_CrowdParameters[i]);
+		}
+	}
+	m_InstanceBatcher.Build();
 }
 
 
@@ -120,16 +302,45 @@ void Renderer::Render() const
 	m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
 
 	// 2. SET PIPELINE + INVOKE DRAWCALLS (= RENDER)
-	for(Mesh* pMesh : m_MeshPtrs)
+	m_pStateContext->BeginFrame();
+	m_pStateContext->SetRenderTarget(m_pRenderTargetView, m_pDepthStencilView);
+	const Matrix viewProjectionMatrix{ m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() };
+	const Matrix inverseViewMatrix{ m_pCamera->GetInverseViewMatrix() };
+	// The crowd is opaque, it goes before the queue's transparent meshes
+	m_pInstancedRenderer->Upload(m_pDeviceContext, m_InstanceBatcher);
+	m_pInstancedRenderer->Render(*m_pStateContext, m_InstanceBatcher, m_MeshPtrs, viewProjectionMatrix, inverseViewMatrix);
+
+	for(const RenderItem& item : m_RenderQueue.GetItems())
 	{
-		Matrix worldViewProjectionMatrix{ pMesh->GetWorldMatrix() * m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() };
-		pMesh->Render(m_pDeviceContext, worldViewProjectionMatrix, m_pCamera->GetInverseViewMatrix());
+		Mesh* pMesh{ m_MeshPtrs[item.drawIndex] };
+		const Matrix worldViewProjectionMatrix{ pMesh->GetWorldTransform() * viewProjectionMatrix };
+		pMesh->Render(*m_pStateContext, worldViewProjectionMatrix, inverseViewMatrix);
 	}
 
 	// SWAP THE BACKBUFFER / PRESENT
 	m_pSwapChain->Present(0, 0);
 }
 
+void Renderer::DumpOcclusionDepth(const std::string& path) const
+{
+	if(m_OcclusionCuller.WriteDepthImage(path))
+		std::cout << "Occlusion depth buffer written to " << path << '\n';
+	else
+		std::cout << path << ": could not be written\n";
+}
+
+void Renderer::ToggleInstancedCrowd()
+{
+	m_IsCrowdEnabled = !m_IsCrowdEnabled;
+	std::cout << "Instanced crowd: " << (m_IsCrowdEnabled ? "on" : "off") << '\n';
+}
+
+void Renderer::ToggleMeshletStats()
+{
+	m_IsMeshletStatsEnabled = !m_IsMeshletStatsEnabled;
+	std::cout << "Meshlet stats: " << (m_IsMeshletStatsEnabled ? "on" : "off") << '\n';
+}
+
 void Renderer::CycleEffectFilter()
 {
 	// Fancy thing to toggle / go through the filtermethods 1 by 1
@@ -2,6 +2,14 @@
 #include "Effect.h"
 #include "EffectVehicle.h"
 #include "EffectFire.h"
+#include "Frustum.h"
+#include "InstanceBatching.h"
+#include "LodSelection.h"
+#include "Meshlet.h"
+#include "OcclusionCuller.h"
+#include "RenderQueue.h"
+#include "StateTrackingContext.h"
+#include "Transform.h"
 
 using namespace dae;
 
@@ -10,6 +18,8 @@ struct SDL_Surface;
 class Mesh;
 
 class Camera;
+class D3D11RenderContext;
+class InstancedRenderer;
 class Texture;
 class Renderer final
 {
@@ -33,6 +43,27 @@ public:
 	void Render() const;
 
 	void CycleEffectFilter();
+	// Shows or hides the field of instanced vehicle copies
+	void ToggleInstancedCrowd();
+	// Turns the meshlet culling pass on or off, it only gathers stats until the meshlets are drawn one by one
+	void ToggleMeshletStats();
+	bool IsMeshletStatsEnabled() const { return m_IsMeshletStatsEnabled; }
+
+	// Result of the last LOD selection pass
+	const LodStats& GetLodStats() const { return m_LodStats; }
+	// Result of the last frustum culling pass
+	const CullStats& GetCullStats() const { return m_CullStats; }
+	// Result of the last occlusion culling pass, tested counts the meshes left after the frustum test
+	const CullStats& GetOcclusionStats() const { return m_OcclusionStats; }
+
+	// Result of the last meshlet culling pass over the meshes drawn at full detail, empty while it is off
+	const MeshletCullStats& GetMeshletStats() const { return m_MeshletStats; }
+
+	// Pipeline calls of the last frame, issued and dropped as redundant
+	const StateStats& GetStateStats() const { return m_pStateContext->GetStats(); }
+
+	// Writes the software occlusion depth buffer of the last frame as a PGM image
+	void DumpOcclusionDepth(const std::string& path) const;
 
 private:
 	SDL_Window* m_pWindow{};
@@ -56,7 +87,53 @@ private:
 	ID3D11Texture2D* m_pRenderTargetBuffer;
 	ID3D11RenderTargetView* m_pRenderTargetView;
 
+	// Draws go through the state tracking layer on top of the device context
+	D3D11RenderContext* m_pRenderContext;
+	StateTrackingContext* m_pStateContext;
+
 	std::vector<Mesh*> m_MeshPtrs;
+	std::vector<Transform> m_MeshTransforms; // One per mesh, same order as m_MeshPtrs
+	std::vector<LodInstance> m_LodInstances; // One per mesh, same order as m_MeshPtrs
+	LodSettings m_LodSettings{};
+	LodStats m_LodStats{};
+
+	// World space bounds of every mesh and whether it is in the camera frustum, same order as m_MeshPtrs
+	BoundsSoA m_MeshBounds{};
+	std::vector<uint8_t> m_IsMeshVisible{};
+	CullStats m_CullStats{};
+
+	// Object space copy of the full detail triangles of the meshes that hide others
+	struct Occluder
+	{
+		size_t mesh{};
+		std::vector<Vector3> positions{};
+		std::vector<uint32_t> indices{};
+	};
+	std::vector<Occluder> m_Occluders{};
+	// Same 4:3 aspect as the window
+	OcclusionCuller m_OcclusionCuller{ 256, 192 };
+	CullStats m_OcclusionStats{};
+
+	// The draws cover the whole level, so the meshlets left after the frustum and backface cone tests are only counted
+	bool m_IsMeshletStatsEnabled{ false };
+	std::vector<uint32_t> m_VisibleMeshlets{};
+	MeshletCullStats m_MeshletStats{};
+
+	// Material id of every mesh, one per distinct effect, same order as m_MeshPtrs
+	std::vector<uint16_t> m_MeshMaterials{};
+	// Visible meshes in draw order, filled in Update
+	RenderQueue m_RenderQueue{};
+
+	// Small copies of the vehicle, drawn instanced: one draw per level of detail instead of one per copy
+	size_t m_CrowdMesh{};
+	bool m_IsCrowdEnabled{ false };
+	std::vector<Affine3x4> m_CrowdTransforms{};
+	std::vector<Vector4> m_CrowdParameters{};
+	std::vector<LodInstance> m_CrowdLods{};
+	BoundsSoA m_CrowdBounds{};
+	std::vector<uint8_t> m_IsCrowdVisible{};
+	InstanceBatcher m_InstanceBatcher{};
+	InstancedRenderer* m_pInstancedRenderer;
 
 	Camera* m_pCamera;
 
@@ -16,9 +16,15 @@ float3 gAmbientColor : AmbientColor = float3(0.025f, 0.025f, 0.025f);
 
 float4x4 gWorldMatrix : WORLD;
 float4x4 gViewInverse : VIEWINVERSE;
+// Instanced techniques, the world matrix comes from the instance stream
+float4x4 gViewProj : ViewProjection;
 
 SamplerState gSampler; // Used to sample textures
 
+// Dequantization of packed positions, set per mesh
+float3 gPositionScale : PositionScale = float3(1.0f, 1.0f, 1.0f);
+float3 gPositionOffset : PositionOffset = float3(0.0f, 0.0f, 0.0f);
+
 
 const float PI = 3.1415926535897932384626433832795f;
 
@@ -52,17 +58,36 @@ struct VS_INPUT
 {
     float3 Position : POSITION;
     float3 Normal : NORMAL;
-    float3 Tangent : TANGENT;
+    float4 Tangent : TANGENT; // w is the bitangent sign
+    float2 TexCoord : TEXCOORD;
+};
+
+// PackedVertex, 20 bytes
+struct VS_PACKED_INPUT
+{
+    float4 Position : POSITION; // UNORM inside the mesh bounds, w is the bitangent sign mapped to 0..1
+    float2 Normal : NORMAL; // Octahedral
+    float2 Tangent : TANGENT; // Octahedral
     float2 TexCoord : TEXCOORD;
 };
 
+// InstanceData, 64 bytes per instance in vertex buffer slot 1
+struct VS_INSTANCE
+{
+    float4 WorldColumn0 : WORLD0; // x of the three axes, translation x in w
+    float4 WorldColumn1 : WORLD1;
+    float4 WorldColumn2 : WORLD2;
+    float4 Parameters : INSTANCEPARAMETERS; // rgb tints the diffuse map
+};
+
 struct VS_OUTPUT
 {
     float4 Position : SV_POSITION;
     float4 WorldPosition : COLOR; // Set to COLOR in slides because you cant reuse SV_POSITION;
     float3 Normal : NORMAL;
-    float3 Tangent : TANGENT;
+    float4 Tangent : TANGENT;
     float2 TexCoord : TEXCOORD;
+    float3 Tint : TINT;
 };
 
 // -----------------------------------------------------------------
@@ -77,14 +102,62 @@ VS_OUTPUT VS(VS_INPUT input)
     output.TexCoord = input.TexCoord;
     
     output.Normal = mul(normalize(input.Normal), (float3x3) gWorldMatrix);
-    output.Tangent = mul(normalize(input.Tangent), (float3x3) gWorldMatrix);
+    output.Tangent = float4(mul(normalize(input.Tangent.xyz), (float3x3) gWorldMatrix), input.Tangent.w);
     
     
     output.WorldPosition = mul(float4(input.Position, 1), gWorldMatrix);
+    output.Tint = float3(1.0f, 1.0f, 1.0f);
     
     return output;
 }
 
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    const float fold = saturate(-direction.z);
+    direction.xy += direction.xy >= 0.0f ? -fold : fold;
+    return normalize(direction);
+}
+
+VS_INPUT Unpack(VS_PACKED_INPUT input)
+{
+    VS_INPUT unpacked;
+    unpacked.Position = input.Position.xyz * gPositionScale + gPositionOffset;
+    unpacked.Normal = DecodeOctahedral(input.Normal);
+    unpacked.Tangent = float4(DecodeOctahedral(input.Tangent), input.Position.w * 2.0f - 1.0f);
+    unpacked.TexCoord = input.TexCoord;
+    return unpacked;
+}
+
+VS_OUTPUT VS_Packed(VS_PACKED_INPUT input)
+{
+    return VS(Unpack(input));
+}
+
+// Same as VS, with the instance's world matrix
+VS_OUTPUT VS_Instanced(VS_INPUT input, VS_INSTANCE instance)
+{
+    VS_OUTPUT output = (VS_OUTPUT) 0;
+
+    const float4 position = float4(input.Position, 1.0f);
+    output.WorldPosition = float4(dot(position, instance.WorldColumn0), dot(position, instance.WorldColumn1), dot(position, instance.WorldColumn2), 1.0f);
+    output.Position = mul(output.WorldPosition, gViewProj);
+    output.TexCoord = input.TexCoord;
+
+    const float3 normal = normalize(input.Normal);
+    const float3 tangent = normalize(input.Tangent.xyz);
+    output.Normal = float3(dot(normal, instance.WorldColumn0.xyz), dot(normal, instance.WorldColumn1.xyz), dot(normal, instance.WorldColumn2.xyz));
+    output.Tangent = float4(dot(tangent, instance.WorldColumn0.xyz), dot(tangent, instance.WorldColumn1.xyz), dot(tangent, instance.WorldColumn2.xyz), input.Tangent.w);
+    output.Tint = instance.Parameters.rgb;
+
+    return output;
+}
+
+VS_OUTPUT VS_PackedInstanced(VS_PACKED_INPUT input, VS_INSTANCE instance)
+{
+    return VS_Instanced(Unpack(input), instance);
+}
+
 // -----------------------------------------------------------------
 //  Pixel shader
 // -----------------------------------------------------------------
@@ -108,15 +181,15 @@ float4 PS(VS_OUTPUT input) : SV_TARGET
     float3 lightRadiance = gLightColor * gLightIntensity;
     
     // Get the texture samples using the sampler
-    float3 diffuseColor = gDiffuseMap.Sample(gSampler, input.TexCoord).rgb;
+    float3 diffuseColor = gDiffuseMap.Sample(gSampler, input.TexCoord).rgb * input.Tint;
     float3 normalSample = gNormalMap.Sample(gSampler, input.TexCoord).rgb;
     float3 specularColor = gSpecularMap.Sample(gSampler, input.TexCoord).rgb;
     float glossinessSample = gGlossinessMap.Sample(gSampler, input.TexCoord).r; // Only needs red since its a gray scale map
     
     
     // Calculate tangent space axis
-    const float3 binormal = normalize(cross(input.Normal, input.Tangent));
-    const float3x3 tangentSpaceAxis = float3x3(normalize(input.Tangent), binormal, normalize(input.Normal));
+    const float3 binormal = normalize(cross(input.Normal, input.Tangent.xyz)) * input.Tangent.w;
+    const float3x3 tangentSpaceAxis = float3x3(normalize(input.Tangent.xyz), binormal, normalize(input.Normal));
     
     // Calculate normal in tangent space
     //const float3 tangentNormal = float3(normalSample.r * 2.0f - 1.0f, normalSample.g * 2.0f - 1.0f, normalSample.b * 2.0f - 1.0f);
@@ -156,3 +229,42 @@ technique11 DefaultTechnique
         SetPixelShader(CompileShader(ps_5_0, PS()));
     }
 };
+
+technique11 PackedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Packed()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
+};
+
+technique11 InstancedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
+};
+
+technique11 PackedInstancedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_PackedInstanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
+};
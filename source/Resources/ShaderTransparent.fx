@@ -10,6 +10,10 @@ Texture2D gDiffuseMap : DiffuseMap;
 
 SamplerState gSampler; // Used to sample textures
 
+// Dequantization of packed positions, set per mesh
+float3 gPositionScale : PositionScale = float3(1.0f, 1.0f, 1.0f);
+float3 gPositionOffset : PositionOffset = float3(0.0f, 0.0f, 0.0f);
+
 
 RasterizerState gRasterizerState
 {
@@ -63,7 +67,16 @@ struct VS_INPUT
 {
     float3 Position : POSITION;
     float3 Normal : NORMAL;
-    float3 Tangent : TANGENT;
+    float4 Tangent : TANGENT;
+    float2 TexCoord : TEXCOORD;
+};
+
+// PackedVertex, 20 bytes
+struct VS_PACKED_INPUT
+{
+    float4 Position : POSITION; // UNORM inside the mesh bounds, w is the bitangent sign mapped to 0..1
+    float2 Normal : NORMAL; // Octahedral
+    float2 Tangent : TANGENT; // Octahedral
     float2 TexCoord : TEXCOORD;
 };
 
@@ -72,7 +85,7 @@ struct VS_OUTPUT
     float4 Position : SV_POSITION;
     float4 WorldPosition : COLOR; // Set to COLOR in slides because you cant reuse SV_POSITION;
     float3 Normal : NORMAL;
-    float3 Tangent : TANGENT;
+    float4 Tangent : TANGENT;
     float2 TexCoord : TEXCOORD;
 };
 
@@ -94,6 +107,24 @@ VS_OUTPUT VS(VS_INPUT input)
     return output;
 }
 
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    const float fold = saturate(-direction.z);
+    direction.xy += direction.xy >= 0.0f ? -fold : fold;
+    return normalize(direction);
+}
+
+VS_OUTPUT VS_Packed(VS_PACKED_INPUT input)
+{
+    VS_INPUT unpacked;
+    unpacked.Position = input.Position.xyz * gPositionScale + gPositionOffset;
+    unpacked.Normal = DecodeOctahedral(input.Normal);
+    unpacked.Tangent = float4(DecodeOctahedral(input.Tangent), input.Position.w * 2.0f - 1.0f);
+    unpacked.TexCoord = input.TexCoord;
+    return VS(unpacked);
+}
+
 // -----------------------------------------------------------------
 //  Pixel shader
 // -----------------------------------------------------------------
@@ -122,3 +153,16 @@ technique11 DefaultTechnique
         SetPixelShader(CompileShader(ps_5_0, PS()));
     }
 };
+
+technique11 PackedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Packed()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include "Affine3x4.h"
+
+namespace dae
+{
+	// Rotation + translation only, the axes are orthonormal.
+	// The inverse is a transpose of the rotation plus a rotated translation, never a general inverse.
+	struct RigidTransform
+	{
+		Vector3 axisX{ Vector3::UnitX };
+		Vector3 axisY{ Vector3::UnitY };
+		Vector3 axisZ{ Vector3::UnitZ };
+		Vector3 translation{ Vector3::Zero };
+
+		constexpr RigidTransform() = default;
+		constexpr RigidTransform(const Vector3& _axisX, const Vector3& _axisY, const Vector3& _axisZ, const Vector3& _translation):
+			axisX{ _axisX }, axisY{ _axisY }, axisZ{ _axisZ }, translation{ _translation }
+		{
+		}
+
+		constexpr Affine3x4 ToAffine() const
+		{
+			return { axisX, axisY, axisZ, translation };
+		}
+
+		constexpr Matrix ToMatrix() const
+		{
+			return { axisX, axisY, axisZ, translation };
+		}
+
+		constexpr Vector3 TransformVector(const Vector3& v) const
+		{
+			return axisX * v.x + axisY * v.y + axisZ * v.z;
+		}
+
+		constexpr Vector3 TransformPoint(const Vector3& p) const
+		{
+			return TransformVector(p) + translation;
+		}
+
+		constexpr RigidTransform Inverse() const
+		{
+			return {
+				Vector3{ axisX.x, axisY.x, axisZ.x },
+				Vector3{ axisX.y, axisY.y, axisZ.y },
+				Vector3{ axisX.z, axisY.z, axisZ.z },
+				-Vector3{ Vector3::Dot(translation, axisX), Vector3::Dot(translation, axisY), Vector3::Dot(translation, axisZ) }
+			};
+		}
+
+		// this first, then r
+		constexpr RigidTransform operator*(const RigidTransform& r) const
+		{
+			return {
+				r.TransformVector(axisX),
+				r.TransformVector(axisY),
+				r.TransformVector(axisZ),
+				r.TransformPoint(translation)
+			};
+		}
+
+		constexpr Affine3x4 operator*(const Affine3x4& a) const
+		{
+			return ToAffine() * a;
+		}
+
+		constexpr Matrix operator*(const Matrix& m) const
+		{
+			return ToAffine() * m;
+		}
+
+		// Same basis as Matrix::CreateLookAtLH, but keeps the result rigid
+		static RigidTransform CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up)
+		{
+			const Vector3 right = Vector3::Cross(Vector3::UnitY, forward).Normalized();
+			return { right, up, forward, origin };
+		}
+
+		static constexpr RigidTransform CreateTranslation(const Vector3& t)
+		{
+			return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+		}
+
+		static constexpr RigidTransform CreateRotationY(float yaw)
+		{
+			const Matrix rotation = Matrix::CreateRotationY(yaw);
+			return { rotation.GetAxisX(), rotation.GetAxisY(), rotation.GetAxisZ(), Vector3::Zero };
+		}
+	};
+
+	// Affine followed by rigid
+	constexpr Affine3x4 operator*(const Affine3x4& a, const RigidTransform& r)
+	{
+		return a * r.ToAffine();
+	}
+}
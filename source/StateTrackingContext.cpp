@@ -0,0 +1,171 @@
+#include "pch.h"
+
+#include "StateTrackingContext.h"
+
+#include <cassert>
+#include <numeric>
+
+namespace dae
+{
+	uint32_t StateStats::GetIssued() const
+	{
+		return std::accumulate(issued.begin(), issued.end(), 0u);
+	}
+
+	uint32_t StateStats::GetElided() const
+	{
+		return std::accumulate(elided.begin(), elided.end(), 0u);
+	}
+
+	StateTrackingContext::StateTrackingContext(RenderContext& context)
+		: m_Context{ context }
+	{
+	}
+
+	void StateTrackingContext::BeginFrame()
+	{
+		m_Stats = {};
+		Invalidate();
+	}
+
+	void StateTrackingContext::Invalidate()
+	{
+		m_Topology.isKnown = false;
+		m_InputLayout.isKnown = false;
+		for(Shadow<BufferBinding>& vertexBuffer : m_VertexBuffers)
+			vertexBuffer.isKnown = false;
+		m_IndexBuffer.isKnown = false;
+		m_RenderTarget.isKnown = false;
+		m_Pass.isKnown = false;
+		InvalidatePassState();
+	}
+
+	void StateTrackingContext::InvalidatePassState()
+	{
+		m_RasterizerState.isKnown = false;
+		m_BlendState.isKnown = false;
+		m_DepthStencilState.isKnown = false;
+		for(size_t stage{ 0 }; stage < STAGE_COUNT; ++stage)
+		{
+			for(Shadow<void*>& sampler : m_Samplers[stage])
+				sampler.isKnown = false;
+			for(Shadow<void*>& shaderResource : m_ShaderResources[stage])
+				shaderResource.isKnown = false;
+		}
+	}
+
+	template<typename T>
+	bool StateTrackingContext::Update(StateCall call, Shadow<T>& shadow, const T& value)
+	{
+		if(shadow.isKnown && shadow.value == value)
+		{
+			++m_Stats.elided[static_cast<size_t>(call)];
+			return false;
+		}
+
+		shadow.value = value;
+		shadow.isKnown = true;
+		++m_Stats.issued[static_cast<size_t>(call)];
+		return true;
+	}
+
+	void StateTrackingContext::SetPrimitiveTopology(uint32_t topology)
+	{
+		if(Update(StateCall::Topology, m_Topology, topology))
+			m_Context.SetPrimitiveTopology(topology);
+	}
+
+	void StateTrackingContext::SetInputLayout(void* pInputLayout)
+	{
+		if(Update(StateCall::InputLayout, m_InputLayout, pInputLayout))
+			m_Context.SetInputLayout(pInputLayout);
+	}
+
+	void StateTrackingContext::SetVertexBuffer(uint32_t slot, void* pBuffer, uint32_t stride, uint32_t offset)
+	{
+		assert(slot < MAX_VERTEX_BUFFERS);
+		if(Update(StateCall::VertexBuffer, m_VertexBuffers[slot], BufferBinding{ pBuffer, stride, offset }))
+			m_Context.SetVertexBuffer(slot, pBuffer, stride, offset);
+	}
+
+	void StateTrackingContext::SetIndexBuffer(void* pBuffer, uint32_t format, uint32_t offset)
+	{
+		if(Update(StateCall::IndexBuffer, m_IndexBuffer, BufferBinding{ pBuffer, format, offset }))
+			m_Context.SetIndexBuffer(pBuffer, format, offset);
+	}
+
+	void StateTrackingContext::SetRasterizerState(void* pState)
+	{
+		if(Update(StateCall::Rasterizer, m_RasterizerState, pState))
+		{
+			m_Context.SetRasterizerState(pState);
+			m_Pass.isKnown = false;
+		}
+	}
+
+	void StateTrackingContext::SetBlendState(void* pState)
+	{
+		if(Update(StateCall::Blend, m_BlendState, pState))
+		{
+			m_Context.SetBlendState(pState);
+			m_Pass.isKnown = false;
+		}
+	}
+
+	void StateTrackingContext::SetDepthStencilState(void* pState, uint32_t stencilRef)
+	{
+		if(Update(StateCall::DepthStencil, m_DepthStencilState, DepthStencilBinding{ pState, stencilRef }))
+		{
+			m_Context.SetDepthStencilState(pState, stencilRef);
+			m_Pass.isKnown = false;
+		}
+	}
+
+	void StateTrackingContext::SetRenderTarget(void* pRenderTargetView, void* pDepthStencilView)
+	{
+		if(Update(StateCall::RenderTarget, m_RenderTarget, RenderTargetBinding{ pRenderTargetView, pDepthStencilView }))
+			m_Context.SetRenderTarget(pRenderTargetView, pDepthStencilView);
+	}
+
+	void StateTrackingContext::SetSampler(ShaderStage stage, uint32_t slot, void* pSampler)
+	{
+		assert(stage < ShaderStage::Count && slot < MAX_SAMPLERS);
+		if(Update(StateCall::Sampler, m_Samplers[static_cast<size_t>(stage)][slot], pSampler))
+		{
+			m_Context.SetSampler(stage, slot, pSampler);
+			m_Pass.isKnown = false;
+		}
+	}
+
+	void StateTrackingContext::SetShaderResource(ShaderStage stage, uint32_t slot, void* pView)
+	{
+		assert(stage < ShaderStage::Count && slot < MAX_SHADER_RESOURCES);
+		if(Update(StateCall::ShaderResource, m_ShaderResources[static_cast<size_t>(stage)][slot], pView))
+		{
+			m_Context.SetShaderResource(stage, slot, pView);
+			m_Pass.isKnown = false;
+		}
+	}
+
+	void StateTrackingContext::ApplyPass(void* pPass)
+	{
+		if(!Update(StateCall::Pass, m_Pass, pPass))
+			return;
+
+		m_Context.ApplyPass(pPass);
+		InvalidatePassState();
+	}
+
+	void StateTrackingContext::DrawIndexed(uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex)
+	{
+		++m_Stats.draws;
+		m_Context.DrawIndexed(indexCount, firstIndex, baseVertex);
+	}
+
+	void StateTrackingContext::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance)
+	{
+		++m_Stats.draws;
+		m_Stats.instances += instanceCount;
+		m_Context.DrawIndexedInstanced(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+	}
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "RenderContext.h"
+
+namespace dae
+{
+	enum class StateCall : uint8_t
+	{
+		Topology,
+		InputLayout,
+		VertexBuffer,
+		IndexBuffer,
+		Rasterizer,
+		Blend,
+		DepthStencil,
+		RenderTarget,
+		Sampler,
+		ShaderResource,
+		Pass,
+		Count
+	};
+
+	struct StateStats
+	{
+		// Indexed by StateCall
+		std::array<uint32_t, static_cast<size_t>(StateCall::Count)> issued{};
+		std::array<uint32_t, static_cast<size_t>(StateCall::Count)> elided{};
+		uint32_t draws{};
+		// Drawn by the instanced draws among them
+		uint32_t instances{};
+
+		uint32_t GetIssued() const;
+		uint32_t GetElided() const;
+	};
+
+	// Shadows the bindings and only forwards the calls that change one, counting both per frame.
+	// Applying an effect pass binds states, samplers and resources behind the shadow's back, so those are unknown again after it,
+	// and changing one of them means the pass has to be applied again.
+	class StateTrackingContext final : public RenderContext
+	{
+	public:
+		static constexpr uint32_t MAX_VERTEX_BUFFERS{ 4 };
+		static constexpr uint32_t MAX_SAMPLERS{ 16 };
+		static constexpr uint32_t MAX_SHADER_RESOURCES{ 16 };
+
+		explicit StateTrackingContext(RenderContext& context);
+
+		// Zeroes the counters and forgets every binding, Present and direct device context use may have changed them
+		void BeginFrame();
+		// Forgets every binding, the next call of each kind goes through
+		void Invalidate();
+		// The effect variables changed, the next ApplyPass has to upload them even for the pass that is already applied
+		void InvalidatePass() { m_Pass.isKnown = false; }
+
+		const StateStats& GetStats() const { return m_Stats; }
+
+		void SetPrimitiveTopology(uint32_t topology) override;
+		void SetInputLayout(void* pInputLayout) override;
+		void SetVertexBuffer(uint32_t slot, void* pBuffer, uint32_t stride, uint32_t offset) override;
+		void SetIndexBuffer(void* pBuffer, uint32_t format, uint32_t offset) override;
+
+		void SetRasterizerState(void* pState) override;
+		void SetBlendState(void* pState) override;
+		void SetDepthStencilState(void* pState, uint32_t stencilRef) override;
+		void SetRenderTarget(void* pRenderTargetView, void* pDepthStencilView) override;
+
+		void SetSampler(ShaderStage stage, uint32_t slot, void* pSampler) override;
+		void SetShaderResource(ShaderStage stage, uint32_t slot, void* pView) override;
+
+		void ApplyPass(void* pPass) override;
+
+		void DrawIndexed(uint32_t indexCount, uint32_t firstIndex, int32_t baseVertex) override;
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance) override;
+
+	private:
+		template<typename T>
+		struct Shadow
+		{
+			T value{};
+			bool isKnown{ false };
+		};
+
+		struct BufferBinding
+		{
+			void* pBuffer{};
+			uint32_t strideOrFormat{};
+			uint32_t offset{};
+
+			bool operator==(const BufferBinding&) const = default;
+		};
+
+		struct DepthStencilBinding
+		{
+			void* pState{};
+			uint32_t stencilRef{};
+
+			bool operator==(const DepthStencilBinding&) const = default;
+		};
+
+		struct RenderTargetBinding
+		{
+			void* pRenderTargetView{};
+			void* pDepthStencilView{};
+
+			bool operator==(const RenderTargetBinding&) const = default;
+		};
+
+		static constexpr size_t STAGE_COUNT{ static_cast<size_t>(ShaderStage::Count) };
+
+		RenderContext& m_Context;
+		StateStats m_Stats{};
+
+		Shadow<uint32_t> m_Topology{};
+		Shadow<void*> m_InputLayout{};
+		std::array<Shadow<BufferBinding>, MAX_VERTEX_BUFFERS> m_VertexBuffers{};
+		Shadow<BufferBinding> m_IndexBuffer{};
+
+		Shadow<void*> m_RasterizerState{};
+		Shadow<void*> m_BlendState{};
+		Shadow<DepthStencilBinding> m_DepthStencilState{};
+		Shadow<RenderTargetBinding> m_RenderTarget{};
+
+		std::array<std::array<Shadow<void*>, MAX_SAMPLERS>, STAGE_COUNT> m_Samplers{};
+		std::array<std::array<Shadow<void*>, MAX_SHADER_RESOURCES>, STAGE_COUNT> m_ShaderResources{};
+
+		Shadow<void*> m_Pass{};
+
+		// Counts the call, true when it changes the binding and has to be forwarded
+		template<typename T>
+		bool Update(StateCall call, Shadow<T>& shadow, const T& value);
+		// Everything an effect pass binds
+		void InvalidatePassState();
+	};
+}
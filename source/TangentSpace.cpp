@@ -0,0 +1,228 @@
+#include "pch.h"
+
+#include "TangentSpace.h"
+#include "MathHelpers.h"
+#include "ThreadPool.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+// Compilers that contract a * b + c into fma (gcc by default) may do so differently at every inlined copy.
+// The per triangle and per vertex math is kept out of line so the sequential and parallel paths round the same.
+#if defined(_MSC_VER)
+#define DAE_TANGENT_NOINLINE __declspec(noinline)
+#else
+#define DAE_TANGENT_NOINLINE __attribute__((noinline))
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		// Below this the tangents are generated on the calling thread
+		constexpr size_t MIN_PARALLEL_TRIANGLES{ 1 << 16 };
+		// One bit per range in the range masks
+		constexpr size_t MAX_RANGES{ 32 };
+
+		// Angle weighted sums of one vertex
+		struct TangentSums
+		{
+			Vector3 tangent{};
+			Vector3 bitangent{};
+
+			TangentSums& operator+=(const TangentSums& sums)
+			{
+				tangent += sums.tangent;
+				bitangent += sums.bitangent;
+				return *this;
+			}
+		};
+
+		// Zero stays zero
+		Vector3 SafeNormalized(const Vector3& v)
+		{
+			const float sqrMagnitude{ v.SqrMagnitude() };
+			return sqrMagnitude > 0.f ? v * (1.f / std::sqrt(sqrMagnitude)) : Vector3{};
+		}
+
+		// Contribution of a triangle to each of its corners
+		DAE_TANGENT_NOINLINE std::array<TangentSums, 3> GetCornerTangents(std::span<const Vertex> vertices, const uint32_t* pTriangle)
+		{
+			std::array<TangentSums, 3> corners{};
+			const Vertex* pCorners[3]{ &vertices[pTriangle[0]], &vertices[pTriangle[1]], &vertices[pTriangle[2]] };
+
+			const Vector3 edge1{ pCorners[1]->position - pCorners[0]->position };
+			const Vector3 edge2{ pCorners[2]->position - pCorners[0]->position };
+			const Vector2 uvEdge1{ pCorners[1]->uv - pCorners[0]->uv };
+			const Vector2 uvEdge2{ pCorners[2]->uv - pCorners[0]->uv };
+
+			// No UV parametrization to follow, also catches NaN
+			const float uvArea{ Vector2::Cross(uvEdge1, uvEdge2) };
+			if(!(Abs(uvArea) > FLT_MIN))
+				return corners;
+
+			const float r{ 1.f / uvArea };
+			const Vector3 tangent{ (edge1 * uvEdge2.y - edge2 * uvEdge1.y) * r };
+			const Vector3 bitangent{ (edge2 * uvEdge1.x - edge1 * uvEdge2.x) * r };
+			const Vector3 faceNormal{ SafeNormalized(Vector3::Cross(edge1, edge2)) };
+
+			// Every edge direction is shared by the two corners it connects
+			const Vector3 directions[3]{ SafeNormalized(edge1), SafeNormalized(pCorners[2]->position - pCorners[1]->position), SafeNormalized(-edge2) };
+			for(int corner{ 0 }; corner < 3; ++corner)
+			{
+				// Angle between the outgoing edge and the reversed incoming edge
+				const float angle{ std::acos(Clamp(-Vector3::Dot(directions[corner], directions[(corner + 2) % 3]), -1.f, 1.f)) };
+
+				Vector3 normal{ SafeNormalized(pCorners[corner]->normal) };
+				if(normal.SqrMagnitude() == 0.f)
+					normal = faceNormal;
+
+				corners[corner].tangent = SafeNormalized(tangent - normal * Vector3::Dot(normal, tangent)) * angle;
+				corners[corner].bitangent = SafeNormalized(bitangent - normal * Vector3::Dot(normal, bitangent)) * angle;
+			}
+			return corners;
+		}
+
+		// pSums[0] belongs to firstVertex
+		void AccumulateRange(std::span<const Vertex> vertices, std::span<const uint32_t> indices, size_t begin, size_t end, TangentSums* pSums, uint32_t firstVertex)
+		{
+			for(size_t triangle{ begin }; triangle < end; ++triangle)
+			{
+				const uint32_t* pTriangle{ indices.data() + triangle * 3 };
+				const std::array<TangentSums, 3> corners{ GetCornerTangents(vertices, pTriangle) };
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+					pSums[pTriangle[corner] - firstVertex] += corners[corner];
+			}
+		}
+
+		// Gram-Schmidt against the normal and the handedness from the bitangent sum
+		DAE_TANGENT_NOINLINE void FinishRange(std::span<Vertex> vertices, std::span<const TangentSums> sums, size_t begin, size_t end)
+		{
+			for(size_t i{ begin }; i < end; ++i)
+			{
+				Vertex& vertex{ vertices[i] };
+				const Vector3 normal{ SafeNormalized(vertex.normal) };
+
+				Vector3 tangent{ SafeNormalized(sums[i].tangent - normal * Vector3::Dot(normal, sums[i].tangent)) };
+				if(tangent.SqrMagnitude() == 0.f)
+				{
+					// Any axis that is not parallel to the normal will do
+					const Vector3 axis{ Abs(normal.x) < 0.9f ? Vector3{ 1.f, 0.f, 0.f } : Vector3{ 0.f, 1.f, 0.f } };
+					tangent = SafeNormalized(axis - normal * Vector3::Dot(normal, axis));
+				}
+
+				const float handedness{ Vector3::Dot(Vector3::Cross(normal, tangent), sums[i].bitangent) < 0.f ? -1.f : 1.f };
+				vertex.tangent = Vector4{ tangent, handedness };
+			}
+		}
+
+		// Same sums as a single AccumulateRange over everything, bit for bit. Every triangle range accumulates into
+		// its own buffer that spans the vertex indices it touches, the reduction takes the buffer of the first range
+		// using a vertex. Vertices shared with later ranges replay those ranges' triangles on top, in order.
+		void AccumulateParallel(std::span<const Vertex> vertices, std::span<const uint32_t> indices, ThreadPool& pool, size_t rangeCount, std::vector<TangentSums>& sums)
+		{
+			assert(rangeCount <= MAX_RANGES);
+
+			struct TangentRange
+			{
+				uint32_t firstVertex{};
+				std::vector<TangentSums> sums{};
+				// Triangles using a vertex that an earlier range uses too
+				std::vector<uint32_t> replayTriangles{};
+			};
+
+			const size_t triangleCount{ indices.size() / 3 };
+			std::vector<TangentRange> ranges(rangeCount);
+			// Bit r is set when range r uses the vertex
+			std::vector<uint32_t> rangeMasks(vertices.size());
+
+			pool.ParallelForRanges(triangleCount, rangeCount, [&](size_t begin, size_t end, size_t rangeIndex)
+			{
+				if(begin == end)
+					return;
+
+				TangentRange& range{ ranges[rangeIndex] };
+				const auto [pMin, pMax] = std::minmax_element(indices.data() + begin * 3, indices.data() + end * 3);
+				range.firstVertex = *pMin;
+				range.sums.resize(*pMax - *pMin + 1);
+				AccumulateRange(vertices, indices, begin, end, range.sums.data(), range.firstVertex);
+
+				const uint32_t rangeBit{ 1u << rangeIndex };
+				for(const uint32_t index : indices.subspan(begin * 3, (end - begin) * 3))
+				{
+					const std::atomic_ref<uint32_t> mask{ rangeMasks[index] };
+					if((mask.load(std::memory_order_relaxed) & rangeBit) == 0)
+						mask.fetch_or(rangeBit, std::memory_order_relaxed);
+				}
+			});
+
+			pool.ParallelForRanges(vertices.size(), rangeCount, [&](size_t begin, size_t end, size_t)
+			{
+				for(size_t i{ begin }; i < end; ++i)
+				{
+					if(rangeMasks[i] == 0)
+						continue;
+
+					const TangentRange& range{ ranges[std::countr_zero(rangeMasks[i])] };
+					sums[i] = range.sums[i - range.firstVertex];
+				}
+			});
+
+			pool.ParallelForRanges(triangleCount, rangeCount, [&](size_t begin, size_t end, size_t rangeIndex)
+			{
+				const uint32_t earlierRanges{ (1u << rangeIndex) - 1 };
+				for(size_t triangle{ begin }; triangle < end; ++triangle)
+				{
+					const uint32_t* pTriangle{ indices.data() + triangle * 3 };
+					if(((rangeMasks[pTriangle[0]] | rangeMasks[pTriangle[1]] | rangeMasks[pTriangle[2]]) & earlierRanges) != 0)
+						ranges[rangeIndex].replayTriangles.push_back(static_cast<uint32_t>(triangle));
+				}
+			});
+
+			// Only the triangles around range borders are left, in order
+			for(size_t rangeIndex{ 1 }; rangeIndex < rangeCount; ++rangeIndex)
+			{
+				const uint32_t earlierRanges{ (1u << rangeIndex) - 1 };
+				for(const uint32_t triangle : ranges[rangeIndex].replayTriangles)
+				{
+					const uint32_t* pTriangle{ indices.data() + size_t{ triangle } * 3 };
+					const std::array<TangentSums, 3> corners{ GetCornerTangents(vertices, pTriangle) };
+					for(size_t corner{ 0 }; corner < 3; ++corner)
+					{
+						if((rangeMasks[pTriangle[corner]] & earlierRanges) != 0)
+							sums[pTriangle[corner]] += corners[corner];
+					}
+				}
+			}
+		}
+	}
+
+	namespace Utils
+	{
+		void GenerateTangents(std::span<Vertex> vertices, std::span<const uint32_t> indices, uint32_t threadCount)
+		{
+			if(threadCount == 0)
+				threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+			std::vector<TangentSums> sums(vertices.size());
+			if(threadCount > 1 && indices.size() / 3 >= MIN_PARALLEL_TRIANGLES)
+			{
+				ThreadPool& pool{ ThreadPool::GetShared() };
+				AccumulateParallel(vertices, indices, pool, std::min<size_t>(threadCount, MAX_RANGES), sums);
+				pool.ParallelForRanges(vertices.size(), threadCount, [&](size_t begin, size_t end, size_t)
+				{
+					FinishRange(vertices, sums, begin, end);
+				});
+			}
+			else
+			{
+				AccumulateRange(vertices, indices, 0, indices.size() / 3, sums.data(), 0);
+				FinishRange(vertices, sums, 0, vertices.size());
+			}
+		}
+	}
+}
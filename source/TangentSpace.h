@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "Vertex.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		// MikkTSpace style tangent frames. Every triangle's UV tangent and bitangent are projected onto the tangent
+		// plane of each corner's normal, weighted by the corner angle and summed per vertex. The sum is then
+		// orthonormalized against the normal (Gram-Schmidt).
+		// tangent.w is the handedness: bitangent = cross(normal, tangent.xyz) * tangent.w, -1 on mirrored UVs.
+		// Triangles with degenerate UVs add nothing, vertices without any tangent get an arbitrary perpendicular one.
+		// Large meshes are processed in parallel (0 uses every hardware thread), the result does not depend on it.
+		void GenerateTangents(std::span<Vertex> vertices, std::span<const uint32_t> indices, uint32_t threadCount = 0);
+	}
+}
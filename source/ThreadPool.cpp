@@ -0,0 +1,92 @@
+#include "pch.h"
+
+#include "ThreadPool.h"
+
+namespace dae
+{
+	ThreadPool::ThreadPool(uint32_t threadCount)
+	{
+		if(threadCount == 0)
+			threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+		m_Workers.reserve(threadCount - 1);
+		for(uint32_t i{ 1 }; i < threadCount; ++i)
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_IsStopping = true;
+		}
+		m_WorkAvailable.notify_all();
+
+		for(std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	void ThreadPool::ParallelFor(size_t taskCount, const std::function<void(size_t)>& task)
+	{
+		if(taskCount == 0)
+			return;
+
+		// Not worth waking anyone up
+		if(taskCount == 1 || m_Workers.empty())
+		{
+			for(size_t i{ 0 }; i < taskCount; ++i)
+				task(i);
+			return;
+		}
+
+		std::lock_guard submitLock{ m_SubmitMutex };
+		std::unique_lock lock{ m_Mutex };
+		m_pTask = &task;
+		m_TaskCount = taskCount;
+		m_NextTask = 0;
+		m_FinishedTasks = 0;
+		++m_Generation;
+		m_WorkAvailable.notify_all();
+
+		RunTasks(lock);
+		m_WorkDone.wait(lock, [this] { return m_FinishedTasks == m_TaskCount; });
+		m_pTask = nullptr;
+	}
+
+	ThreadPool& ThreadPool::GetShared()
+	{
+		static ThreadPool pool{};
+		return pool;
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		uint64_t seenGeneration{ 0 };
+		std::unique_lock lock{ m_Mutex };
+		while(true)
+		{
+			m_WorkAvailable.wait(lock, [&] { return m_IsStopping || m_Generation != seenGeneration; });
+			if(m_IsStopping)
+				return;
+
+			seenGeneration = m_Generation;
+			RunTasks(lock);
+		}
+	}
+
+	void ThreadPool::RunTasks(std::unique_lock<std::mutex>& lock)
+	{
+		while(m_NextTask < m_TaskCount)
+		{
+			const size_t index{ m_NextTask++ };
+			const std::function<void(size_t)>& task{ *m_pTask };
+
+			lock.unlock();
+			task(index);
+			lock.lock();
+
+			if(++m_FinishedTasks == m_TaskCount)
+				m_WorkDone.notify_one();
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dae
+{
+	// Fixed set of worker threads for data parallel loops (asset import, mesh processing)
+	class ThreadPool final
+	{
+	public:
+		// 0 uses every hardware thread, the calling thread counts as one of them
+		explicit ThreadPool(uint32_t threadCount = 0);
+
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) noexcept = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+		// Workers plus the calling thread
+		uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+
+		// Runs task(i) for every i in [0, taskCount) and returns when all of them finished.
+		// The calling thread works along. Tasks must not call ParallelFor on the same pool.
+		void ParallelFor(size_t taskCount, const std::function<void(size_t)>& task);
+
+		// Splits [0, count) into rangeCount contiguous ranges and runs function(begin, end, rangeIndex) on each
+		template<typename RangeFunction>
+		void ParallelForRanges(size_t count, size_t rangeCount, const RangeFunction& function)
+		{
+			ParallelFor(rangeCount, [&](size_t range)
+			{
+				function(count * range / rangeCount, count * (range + 1) / rangeCount, range);
+			});
+		}
+
+		// Lazily created pool with every hardware thread
+		static ThreadPool& GetShared();
+
+	private:
+		std::vector<std::thread> m_Workers{};
+
+		// Serializes ParallelFor calls from different threads
+		std::mutex m_SubmitMutex{};
+
+		std::mutex m_Mutex{};
+		std::condition_variable m_WorkAvailable{};
+		std::condition_variable m_WorkDone{};
+		const std::function<void(size_t)>* m_pTask{};
+		size_t m_TaskCount{};
+		size_t m_NextTask{};
+		size_t m_FinishedTasks{};
+		uint64_t m_Generation{};
+		bool m_IsStopping{};
+
+		void WorkerLoop();
+		// Runs tasks until none are left, expects m_Mutex to be locked
+		void RunTasks(std::unique_lock<std::mutex>& lock);
+	};
+}
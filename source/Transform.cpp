@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "Transform.h"
+#include <cassert>
+
+Transform::Transform(const Vector3& position, const Quaternion& rotation, const Vector3& scale):
+	m_Position{ position },
+	m_Rotation{ rotation.Normalized() },
+	m_Scale{ scale },
+	m_IsDirty{ true }
+{
+	RebuildWorldTransform();
+}
+
+void Transform::SetPosition(const Vector3& position)
+{
+	m_Position = position;
+	m_IsDirty = true;
+}
+
+void Transform::SetRotation(const Quaternion& rotation)
+{
+	m_Rotation = rotation.Normalized();
+	m_IsDirty = true;
+}
+
+void Transform::SetScale(const Vector3& scale)
+{
+	m_Scale = scale;
+	m_IsDirty = true;
+}
+
+void Transform::Translate(const Vector3& translation)
+{
+	m_Position += translation;
+	m_IsDirty = true;
+}
+
+void Transform::Rotate(const Quaternion& rotation)
+{
+	// Renormalize on every compose so the orientation never drifts away from a pure rotation
+	m_Rotation = (rotation * m_Rotation).Normalized();
+	m_IsDirty = true;
+}
+
+const Affine3x4& Transform::GetWorldTransform() const
+{
+	assert(!m_IsDirty && "Transform changed since the last UpdateWorldTransforms");
+	return m_WorldTransform;
+}
+
+void Transform::UpdateWorldTransform()
+{
+	if(m_IsDirty)
+		RebuildWorldTransform();
+}
+
+void Transform::UpdateWorldTransforms(std::span<Transform> transforms)
+{
+	for(Transform& transform : transforms)
+	{
+		if(transform.m_IsDirty)
+			transform.RebuildWorldTransform();
+	}
+}
+
+void Transform::RebuildWorldTransform()
+{
+	// Scale, then rotate, then translate (row vectors)
+	m_WorldTransform.axisX = m_Rotation.GetAxisX() * m_Scale.x;
+	m_WorldTransform.axisY = m_Rotation.GetAxisY() * m_Scale.y;
+	m_WorldTransform.axisZ = m_Rotation.GetAxisZ() * m_Scale.z;
+	m_WorldTransform.translation = m_Position;
+
+	m_IsDirty = false;
+}
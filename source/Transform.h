@@ -0,0 +1,43 @@
+#pragma once
+#include <span>
+#include "Math.h"
+
+using namespace dae;
+
+// Position / rotation / scale component. The world transform is only rebuilt when something changed,
+// keep transforms in a contiguous array and call UpdateWorldTransforms once per frame.
+class Transform final
+{
+public:
+	Transform() = default;
+	Transform(const Vector3& position, const Quaternion& rotation = {}, const Vector3& scale = { 1.f, 1.f, 1.f });
+
+	const Vector3& GetPosition() const { return m_Position; };
+	const Quaternion& GetRotation() const { return m_Rotation; };
+	const Vector3& GetScale() const { return m_Scale; };
+
+	void SetPosition(const Vector3& position);
+	void SetRotation(const Quaternion& rotation);
+	void SetScale(const Vector3& scale);
+
+	void Translate(const Vector3& translation);
+	// Applies rotation after the current rotation (world space)
+	void Rotate(const Quaternion& rotation);
+
+	bool IsDirty() const { return m_IsDirty; };
+	const Affine3x4& GetWorldTransform() const;
+
+	void UpdateWorldTransform();
+	static void UpdateWorldTransforms(std::span<Transform> transforms);
+
+private:
+	Affine3x4 m_WorldTransform{};
+
+	Vector3 m_Position{};
+	Quaternion m_Rotation{};
+	Vector3 m_Scale{ 1.f, 1.f, 1.f };
+
+	bool m_IsDirty{ false };
+
+	void RebuildWorldTransform();
+};
@@ -1,7 +1,10 @@
 #pragma once
-#include <fstream>
+#include <span>
+#include <cassert>
 #include "Math.h"
 #include "Mesh.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
 //#include <vector>
 
 namespace dae
@@ -11,154 +14,62 @@ namespace dae
 		//Just parses vertices and indices
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
-		static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
+		static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const ObjImportOptions& options, ObjImportStats* pStats = nullptr)
 		{
-			std::ifstream file(filename);
-			if(!file)
+			// Parsed straight from the mapped file, no stream or line copies
+			const MappedFile file{ filename };
+			if(!file.IsOpen())
 				return false;
 
-			std::vector<Vector3> positions{};
-			std::vector<Vector3> normals{};
-			std::vector<Vector2> UVs{};
+			return ParseOBJText(file.GetText(), vertices, indices, options, pStats);
+		}
 
-			vertices.clear();
-			indices.clear();
+		static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
+		{
+			ObjImportOptions options{};
+			options.flipAxisAndWinding = flipAxisAndWinding;
+			return ParseOBJ(filename, vertices, indices, options);
+		}
 
-			std::string sCommand;
-			// start a while iteration ending when the end of file is reached (ios::eof)
-			while(!file.eof())
-			{
-				//read the first word of the string, use the >> operator (istream::operator>>) 
-				file >> sCommand;
-				//use conditional statements to process the different commands	
-				if(sCommand == "#")
-				{
-					// Ignore Comment
-				}
-				else if(sCommand == "v")
-				{
-					//Vertex
-					float x, y, z;
-					file >> x >> y >> z;
+		// Transforms a whole mesh on the CPU (bounds, picking, culling), positions get the perspective divide
+		static void TransformVertices(const Matrix& worldViewProj, const Matrix& world, std::span<const Vertex> vertices, std::span<Vertex_Out> verticesOut)
+		{
+			assert(verticesOut.size() >= vertices.size());
 
-					positions.emplace_back(x, y, z);
-				}
-				else if(sCommand == "vt")
-				{
-					// Vertex TexCoord
-					float u, v;
-					file >> u >> v;
-					UVs.emplace_back(u, 1 - v);
-				}
-				else if(sCommand == "vn")
-				{
-					// Vertex Normal
-					float x, y, z;
-					file >> x >> y >> z;
+			// Gather into small packed batches so the Matrix batch kernels can run over them
+			constexpr size_t batchSize{ 256 };
+			Vector3 positions[batchSize];
+			Vector3 normals[batchSize];
+			Vector3 tangents[batchSize];
+			Vector4 projected[batchSize];
+			Vector4 worldPositions[batchSize];
 
-					normals.emplace_back(x, y, z);
-				}
-				else if(sCommand == "f")
+			for(size_t first{ 0 }; first < vertices.size(); first += batchSize)
+			{
+				const size_t count{ std::min(batchSize, vertices.size() - first) };
+				for(size_t i{ 0 }; i < count; ++i)
 				{
-					//if a face is read:
-					//construct the 3 vertices, add them to the vertex array
-					//add three indices to the index array
-					//add the material index as attibute to the attribute array
-					//
-					// Faces or triangles
-					Vertex vertex{};
-					size_t iPosition, iTexCoord, iNormal;
-
-					uint32_t tempIndices[3];
-					for(size_t iFace = 0; iFace < 3; iFace++)
-					{
-						// OBJ format uses 1-based arrays
-						file >> iPosition;
-						vertex.position = positions[iPosition - 1];
-
-						if('/' == file.peek())//is next in buffer ==  '/' ?
-						{
-							file.ignore();//read and ignore one element ('/')
-
-							if('/' != file.peek())
-							{
-								// Optional texture coordinate
-								file >> iTexCoord;
-								vertex.uv = UVs[iTexCoord - 1];
-							}
-
-							if('/' == file.peek())
-							{
-								file.ignore();
-
-								// Optional vertex normal
-								file >> iNormal;
-								vertex.normal = normals[iNormal - 1];
-							}
-						}
-
-						vertices.push_back(vertex);
-						tempIndices[iFace] = uint32_t(vertices.size()) - 1;
-						//indices.push_back(uint32_t(vertices.size()) - 1);
-					}
-
-					indices.push_back(tempIndices[0]);
-					if(flipAxisAndWinding)
-					{
-						indices.push_back(tempIndices[2]);
-						indices.push_back(tempIndices[1]);
-					}
-					else
-					{
-						indices.push_back(tempIndices[1]);
-						indices.push_back(tempIndices[2]);
-					}
+					const Vertex& v = vertices[first + i];
+					positions[i] = v.position;
+					normals[i] = v.normal;
+					tangents[i] = v.tangent.GetXYZ();
 				}
-				//read till end of line and ignore all remaining chars
-				file.ignore(1000, '\n');
-			}
-
-			//Cheap Tangent Calculations
-			for(uint32_t i = 0; i < indices.size(); i += 3)
-			{
-				uint32_t index0 = indices[i];
-				uint32_t index1 = indices[size_t(i) + 1];
-				uint32_t index2 = indices[size_t(i) + 2];
-
-				const Vector3& p0 = vertices[index0].position;
-				const Vector3& p1 = vertices[index1].position;
-				const Vector3& p2 = vertices[index2].position;
-				const Vector2& uv0 = vertices[index0].uv;
-				const Vector2& uv1 = vertices[index1].uv;
-				const Vector2& uv2 = vertices[index2].uv;
-
-				const Vector3 edge0 = p1 - p0;
-				const Vector3 edge1 = p2 - p0;
-				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
-				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-				float r = 1.f / Vector2::Cross(diffX, diffY);
-
-				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-				vertices[index0].tangent += tangent;
-				vertices[index1].tangent += tangent;
-				vertices[index2].tangent += tangent;
-			}
 
-			//Create the Tangents (reject)
-			for(auto& v : vertices)
-			{
-				//v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
+				worldViewProj.TransformPoints({ positions, count }, { projected, count }, true);
+				world.TransformPoints({ positions, count }, { worldPositions, count });
+				world.TransformVectors({ normals, count }, { normals, count });
+				world.TransformVectors({ tangents, count }, { tangents, count });
 
-				if(flipAxisAndWinding)
+				for(size_t i{ 0 }; i < count; ++i)
 				{
-					v.position.z *= -1.f;
-					v.normal.z *= -1.f;
-					v.tangent.z *= -1.f;
+					Vertex_Out& out = verticesOut[first + i];
+					out.position = projected[i];
+					out.worldPosition = worldPositions[i];
+					out.normal = normals[i];
+					out.tangent = Vector4{ tangents[i], vertices[first + i].tangent.w };
+					out.uv = vertices[first + i].uv;
 				}
-
 			}
-
-			return true;
 		}
 #pragma warning(pop)
 	}
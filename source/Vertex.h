@@ -0,0 +1,24 @@
+#pragma once
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+using namespace dae;
+
+struct Vertex
+{
+	Vector3 position{};
+	Vector3 normal{};
+	// w is the bitangent sign, bitangent = cross(normal, tangent.xyz) * w
+	Vector4 tangent{};
+	Vector2 uv{};
+};
+
+struct Vertex_Out
+{
+	Vector4 position{};
+	Vector4 worldPosition{};
+	Vector3 normal{};
+	Vector4 tangent{};
+	Vector2 uv{};
+};
@@ -0,0 +1,248 @@
+#include "pch.h"
+
+#include "VertexCache.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace dae
+{
+	namespace
+	{
+		constexpr uint32_t NONE{ UINT32_MAX };
+
+#pragma region Forsyth
+		// Modelled cache, a bit bigger than the real ones so the order works well on all of them
+		constexpr uint32_t CACHE_SIZE{ 32 };
+		constexpr float CACHE_DECAY_POWER{ 1.5f };
+		// The last triangle's vertices score a bit lower, they are the most likely to hit anyway
+		constexpr float LAST_TRIANGLE_SCORE{ 0.75f };
+		// Prefers vertices with few triangles left so they get finished instead of leaving holes
+		constexpr float VALENCE_BOOST_SCALE{ 2.f };
+		constexpr float VALENCE_BOOST_POWER{ 0.5f };
+		constexpr uint32_t VALENCE_TABLE_SIZE{ 32 };
+
+		const std::array<float, CACHE_SIZE> CACHE_POSITION_SCORES{ []
+		{
+			std::array<float, CACHE_SIZE> scores{};
+			for(uint32_t position{ 0 }; position < CACHE_SIZE; ++position)
+			{
+				scores[position] = position < 3
+					? LAST_TRIANGLE_SCORE
+					: std::pow(1.f - static_cast<float>(position - 3) / static_cast<float>(CACHE_SIZE - 3), CACHE_DECAY_POWER);
+			}
+			return scores;
+		}() };
+
+		const std::array<float, VALENCE_TABLE_SIZE> VALENCE_SCORES{ []
+		{
+			std::array<float, VALENCE_TABLE_SIZE> scores{};
+			for(uint32_t valence{ 1 }; valence < VALENCE_TABLE_SIZE; ++valence)
+				scores[valence] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(valence), -VALENCE_BOOST_POWER);
+			return scores;
+		}() };
+
+		// cachePosition is NONE when the vertex is not cached
+		float GetVertexScore(uint32_t cachePosition, uint32_t remainingTriangles)
+		{
+			// Nothing left to draw with it
+			if(remainingTriangles == 0)
+				return -1.f;
+
+			const float cacheScore{ cachePosition < CACHE_SIZE ? CACHE_POSITION_SCORES[cachePosition] : 0.f };
+			const float valenceScore{ remainingTriangles < VALENCE_TABLE_SIZE
+				? VALENCE_SCORES[remainingTriangles]
+				: VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER) };
+			return cacheScore + valenceScore;
+		}
+#pragma endregion
+	}
+
+	namespace Utils
+	{
+		VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize, VertexCacheType type)
+		{
+			assert(cacheSize > 0);
+
+			VertexCacheStats stats{};
+			stats.triangles = indices.size() / 3;
+			stats.vertices = vertexCount;
+
+			if(type == VertexCacheType::FIFO)
+			{
+				// A vertex is cached when fewer than cacheSize misses happened since its own
+				std::vector<size_t> missTimes(vertexCount, 0);
+				size_t time{ size_t{ cacheSize } + 1 };
+				for(const uint32_t index : indices)
+				{
+					if(time - missTimes[index] > cacheSize)
+					{
+						missTimes[index] = time++;
+						++stats.transforms;
+					}
+				}
+			}
+			else
+			{
+				// Most recently used first
+				std::vector<uint32_t> cache{};
+				cache.reserve(cacheSize + 1);
+				for(const uint32_t index : indices)
+				{
+					const auto it{ std::find(cache.begin(), cache.end(), index) };
+					if(it != cache.end())
+					{
+						std::rotate(cache.begin(), it, it + 1);
+						continue;
+					}
+
+					++stats.transforms;
+					cache.insert(cache.begin(), index);
+					if(cache.size() > cacheSize)
+						cache.pop_back();
+				}
+			}
+			return stats;
+		}
+
+		void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount)
+		{
+			const size_t triangleCount{ indices.size() / 3 };
+			if(triangleCount == 0)
+				return;
+
+			const std::vector<uint32_t> source{ indices.begin(), indices.end() };
+
+			// Triangles per vertex, the first remainingTriangles[v] of every list are the ones not emitted yet
+			std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+			for(const uint32_t index : source)
+				++remainingTriangles[index];
+
+			std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+			for(size_t v{ 0 }; v < vertexCount; ++v)
+				adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingTriangles[v];
+
+			std::vector<uint32_t> adjacency(source.size());
+			{
+				std::vector<uint32_t> fill{ adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 };
+				for(size_t i{ 0 }; i < source.size(); ++i)
+					adjacency[fill[source[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			std::vector<uint32_t> cachePositions(vertexCount, NONE);
+			std::vector<float> vertexScores(vertexCount);
+			for(size_t v{ 0 }; v < vertexCount; ++v)
+				vertexScores[v] = GetVertexScore(NONE, remainingTriangles[v]);
+
+			std::vector<float> triangleScores(triangleCount);
+			for(size_t t{ 0 }; t < triangleCount; ++t)
+				triangleScores[t] = vertexScores[source[t * 3]] + vertexScores[source[t * 3 + 1]] + vertexScores[source[t * 3 + 2]];
+
+			std::vector<bool> isEmitted(triangleCount, false);
+			// Room for a full cache plus the three vertices pushed in front of it
+			std::array<uint32_t, CACHE_SIZE + 3> cache{};
+			std::array<uint32_t, CACHE_SIZE + 3> newCache{};
+			size_t cacheCount{ 0 };
+
+			uint32_t bestTriangle{ static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin()) };
+			// Where to look for a new start when nothing in the cache has triangles left
+			size_t scanPosition{ 0 };
+
+			for(size_t output{ 0 }; output < triangleCount; ++output)
+			{
+				if(bestTriangle == NONE)
+				{
+					while(isEmitted[scanPosition])
+						++scanPosition;
+					bestTriangle = static_cast<uint32_t>(scanPosition);
+				}
+
+				const uint32_t* pTriangle{ source.data() + size_t{ bestTriangle } * 3 };
+				std::copy(pTriangle, pTriangle + 3, indices.data() + output * 3);
+				isEmitted[bestTriangle] = true;
+
+				// Swap the triangle out of the remaining part of its vertices' lists
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					const uint32_t vertex{ pTriangle[corner] };
+					uint32_t* pBegin{ adjacency.data() + adjacencyOffsets[vertex] };
+					uint32_t* pEnd{ pBegin + remainingTriangles[vertex] };
+					uint32_t* pFound{ std::find(pBegin, pEnd, bestTriangle) };
+					assert(pFound != pEnd);
+					std::swap(*pFound, pEnd[-1]);
+					--remainingTriangles[vertex];
+				}
+
+				// The triangle's vertices move to the front, the rest shifts back
+				size_t newCount{ 0 };
+				for(size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					if(std::find(newCache.begin(), newCache.begin() + newCount, pTriangle[corner]) == newCache.begin() + newCount)
+						newCache[newCount++] = pTriangle[corner];
+				}
+				for(size_t i{ 0 }; i < cacheCount; ++i)
+				{
+					if(cache[i] != pTriangle[0] && cache[i] != pTriangle[1] && cache[i] != pTriangle[2])
+						newCache[newCount++] = cache[i];
+				}
+
+				// Rescore everything that moved, including what fell out, and the triangles around it
+				for(size_t i{ 0 }; i < newCount; ++i)
+				{
+					const uint32_t vertex{ newCache[i] };
+					cachePositions[vertex] = i < CACHE_SIZE ? static_cast<uint32_t>(i) : NONE;
+
+					const float score{ GetVertexScore(cachePositions[vertex], remainingTriangles[vertex]) };
+					const float delta{ score - vertexScores[vertex] };
+					vertexScores[vertex] = score;
+
+					const uint32_t* pAdjacent{ adjacency.data() + adjacencyOffsets[vertex] };
+					for(uint32_t j{ 0 }; j < remainingTriangles[vertex]; ++j)
+						triangleScores[pAdjacent[j]] += delta;
+				}
+
+				cacheCount = std::min<size_t>(newCount, CACHE_SIZE);
+				std::swap(cache, newCache);
+
+				// The next triangle is one around the cache, a cold start comes from the scan
+				bestTriangle = NONE;
+				float bestScore{ -1.f };
+				for(size_t i{ 0 }; i < cacheCount; ++i)
+				{
+					const uint32_t vertex{ cache[i] };
+					const uint32_t* pAdjacent{ adjacency.data() + adjacencyOffsets[vertex] };
+					for(uint32_t j{ 0 }; j < remainingTriangles[vertex]; ++j)
+					{
+						if(triangleScores[pAdjacent[j]] > bestScore)
+						{
+							bestScore = triangleScores[pAdjacent[j]];
+							bestTriangle = pAdjacent[j];
+						}
+					}
+				}
+			}
+		}
+
+		size_t OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices)
+		{
+			std::vector<uint32_t> remap(vertices.size(), NONE);
+			std::vector<Vertex> reordered{};
+			reordered.reserve(vertices.size());
+
+			for(uint32_t& index : indices)
+			{
+				if(remap[index] == NONE)
+				{
+					remap[index] = static_cast<uint32_t>(reordered.size());
+					reordered.push_back(vertices[index]);
+				}
+				index = remap[index];
+			}
+
+			vertices = std::move(reordered);
+			return vertices.size();
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Vertex.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		enum class VertexCacheType
+		{
+			// Older hardware, a hit does not refresh the entry
+			FIFO,
+			LRU
+		};
+
+		struct VertexCacheStats
+		{
+			// Vertex shader invocations, one per cache miss
+			size_t transforms{};
+			size_t triangles{};
+			// Vertices in the vertex buffer
+			size_t vertices{};
+
+			// Average cache miss ratio, transforms per triangle. 3 is the worst, 0.5 the best a regular grid can get.
+			float GetACMR() const
+			{
+				return triangles > 0 ? static_cast<float>(transforms) / static_cast<float>(triangles) : 0.f;
+			}
+			// Average transform to vertex ratio, 1 is every vertex shaded exactly once
+			float GetATVR() const
+			{
+				return vertices > 0 ? static_cast<float>(transforms) / static_cast<float>(vertices) : 0.f;
+			}
+		};
+
+		// Runs the indices through a simulated post transform cache of cacheSize entries
+		VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = 16, VertexCacheType type = VertexCacheType::FIFO);
+
+		// Reorders the triangles for post transform cache hits (Forsyth's linear speed optimization).
+		// The winding of every triangle is kept.
+		void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount);
+
+		// Reorders the vertices by first use in the index buffer so the fetches go linearly through memory.
+		// Unreferenced vertices are dropped, returns the new vertex count.
+		size_t OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+	}
+}
@@ -62,6 +62,18 @@ int main(int argc, char* args[])
 					{
 						pRenderer->CycleEffectFilter();
 					}
+					if(e.key.keysym.scancode == SDL_SCANCODE_F3)
+					{
+						pRenderer->DumpOcclusionDepth("OcclusionDepth.pgm");
+					}
+					if(e.key.keysym.scancode == SDL_SCANCODE_F4)
+					{
+						pRenderer->ToggleInstancedCrowd();
+					}
+					if(e.key.keysym.scancode == SDL_SCANCODE_F5)
+					{
+						pRenderer->ToggleMeshletStats();
+					}
 
 					break;
 				default:;
@@ -81,6 +93,22 @@ int main(int argc, char* args[])
 		{
 			printTimer = 0.f;
 			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			const LodStats& lodStats{ pRenderer->GetLodStats() };
+			std::cout << "LOD: " << lodStats.drawnTriangles << " of " << lodStats.fullTriangles << " triangles drawn, "
+				<< lodStats.GetTrianglesSaved() << " saved, " << lodStats.changed << " instances switched" << std::endl;
+			const CullStats& cullStats{ pRenderer->GetCullStats() };
+			std::cout << "Culling: " << cullStats.culled << " of " << cullStats.tested << " meshes outside the frustum" << std::endl;
+			const CullStats& occlusionStats{ pRenderer->GetOcclusionStats() };
+			std::cout << "Occlusion: " << occlusionStats.culled << " of " << occlusionStats.tested << " meshes hidden" << std::endl;
+			if(pRenderer->IsMeshletStatsEnabled())
+			{
+				const MeshletCullStats& meshletStats{ pRenderer->GetMeshletStats() };
+				std::cout << "Meshlets: " << meshletStats.frustumCulledMeshlets + meshletStats.backfaceCulledMeshlets << " of " << meshletStats.meshlets
+					<< " culled, " << meshletStats.GetCulledTriangleRatio() * 100.f << "% of their triangles" << std::endl;
+			}
+			const StateStats& stateStats{ pRenderer->GetStateStats() };
+			std::cout << "State: " << stateStats.GetIssued() << " pipeline calls issued, " << stateStats.GetElided() << " redundant ones dropped, "
+				<< stateStats.draws << " draws, " << stateStats.instances << " instances" << std::endl;
 		}
 	}
 	pTimer->Stop();
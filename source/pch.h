@@ -7,6 +7,8 @@
 #include <memory>
 #define NOMINMAX  //for directx
 
+// DAE_MATH_ONLY builds the math sources without SDL / DirectX (benchmark)
+#ifndef DAE_MATH_ONLY
 // SDL Headers
 #include "SDL.h"
 #include "SDL_syswm.h"
@@ -18,6 +20,7 @@
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include <d3dx11effect.h>
+#endif
 
 // Framework Headers
 #include "Timer.h"